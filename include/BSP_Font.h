@@ -0,0 +1,163 @@
+/*
+--|----------------------------------------------------------------------------|
+--| FILE DESCRIPTION:
+--|   BSP_Font provides bitmap fonts for drawing text on displays, compiled
+--|   into the image.
+--|
+--|----------------------------------------------------------------------------|
+--| NOTES:
+--|     A glyph is stored as one byte per row, top row first, with bit 7 as
+--|     the leftmost pixel. The blank column to the right of each glyph and the
+--|     blank row below it are part of the glyph, so glyphs can be drawn back
+--|     to back.
+--|
+--|     A fixed width font gives every glyph the same width. A proportional
+--|     font has a width for each glyph, with the glyph pushed to the left of
+--|     its cell, so the next glyph starts where this one's width ends.
+--|
+--|     The fonts cover the printable ASCII characters, anything else is drawn
+--|     as '?'.
+--|
+--|----------------------------------------------------------------------------|
+--| REFERENCES:
+--|   None
+--|
+--|----------------------------------------------------------------------------|
+*/
+
+#ifndef BSP_FONT_H_INCLUDED
+#define BSP_FONT_H_INCLUDED
+
+/*
+--|----------------------------------------------------------------------------|
+--| INCLUDE FILES
+--|----------------------------------------------------------------------------|
+*/
+
+#include "Fixed_Width_Ints.h"
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC DEFINES
+--|----------------------------------------------------------------------------|
+*/
+
+/* None */
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC TYPES
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--| NAME: BSP_Font_t
+--| DESCRIPTION: a bitmap font
+*/
+typedef struct BSP_Font_Type
+{
+    const uint8_t * p_bitmaps; // height bytes per glyph, in character order
+    uint8_t first_char;        // the character of the first glyph
+    uint8_t num_glyphs;        // the number of glyphs
+    uint8_t width;             // pixels across each glyph, at most 8
+    uint8_t height;            // rows in each glyph
+    const uint8_t * p_widths;  // the width of each glyph, at most width, 0 for a fixed width font
+} BSP_Font_t;
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC CONSTANTS
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--| NAME: BSP_Font_5x7
+--| DESCRIPTION: 5x7 pixel characters in a 6x8 cell
+--| TYPE: BSP_Font_t
+*/
+extern const BSP_Font_t BSP_Font_5x7;
+
+/*
+--| NAME: BSP_Font_5x7_Proportional
+--| DESCRIPTION: the 5x7 characters with the blank columns trimmed, the digits
+--|   keep the full 6 pixel width so numbers line up and don't shift as
+--|   they change
+--| TYPE: BSP_Font_t
+*/
+extern const BSP_Font_t BSP_Font_5x7_Proportional;
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC VARIABLES
+--|----------------------------------------------------------------------------|
+*/
+
+/* None */
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC FUNCTION PROTOTYPES
+--|----------------------------------------------------------------------------|
+*/
+
+/*------------------------------------------------------------------------------
+Function Name:
+    BSP_Font_Get_Glyph
+
+Function Description:
+    Get the rows of the glyph for a character.
+
+Inputs:
+    p_font: the font.
+    c: the character.
+
+Returns:
+    const uint8_t *: the glyph rows, the '?' glyph for a character the font
+    does not have.
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+const uint8_t * BSP_Font_Get_Glyph(const BSP_Font_t * p_font, char c);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    BSP_Font_Get_Char_Width
+
+Function Description:
+    Get how far across a character takes up, including the blank column
+    after it.
+
+Inputs:
+    p_font: the font.
+    c: the character.
+
+Returns:
+    uint32_t: the width in pixels.
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+uint32_t BSP_Font_Get_Char_Width(const BSP_Font_t * p_font, char c);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    BSP_Font_Get_String_Width
+
+Function Description:
+    Get how far across a string takes up, for lining up text before it is
+    drawn.
+
+Inputs:
+    p_font: the font.
+    p_string: the null terminated string.
+
+Returns:
+    uint32_t: the width in pixels.
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+uint32_t BSP_Font_Get_String_Width(const BSP_Font_t * p_font, const char * p_string);
+
+#endif
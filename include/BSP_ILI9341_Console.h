@@ -0,0 +1,133 @@
+/*
+--|----------------------------------------------------------------------------|
+--| FILE DESCRIPTION:
+--|   BSP_ILI9341_Console provides a scrolling text console on the ILI9341
+--|   display, for log output.
+--|
+--|----------------------------------------------------------------------------|
+--| NOTES:
+--|     The console uses the whole screen in the 5x7 font, 40 columns by 40
+--|     lines. Once the screen is full, each new line uses the hardware
+--|     vertical scrolling: the oldest line is cleared, written with the new
+--|     text and scrolled to the bottom. A new line costs one line of
+--|     characters on the SPI bus, not a redraw of the screen.
+--|
+--|     Text that runs past the right edge wraps to the next line. '\n' starts
+--|     a new line and '\r' goes back to the start of the current line.
+--|
+--|     The console owns the scrolling area, don't mix it with other drawing
+--|     or with BSP_ILI9341_Scroll_Define.
+--|
+--|----------------------------------------------------------------------------|
+--| REFERENCES:
+--|   ILI9341.pdf, 8.2.29 (VSCRDEF) and 8.2.33 (VSCRSADD)
+--|
+--|----------------------------------------------------------------------------|
+*/
+
+#ifndef BSP_ILI9341_CONSOLE_H_INCLUDED
+#define BSP_ILI9341_CONSOLE_H_INCLUDED
+
+/*
+--|----------------------------------------------------------------------------|
+--| INCLUDE FILES
+--|----------------------------------------------------------------------------|
+*/
+
+#include "Fixed_Width_Ints.h"
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC DEFINES
+--|----------------------------------------------------------------------------|
+*/
+
+/* None */
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC TYPES
+--|----------------------------------------------------------------------------|
+*/
+
+/* None */
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC CONSTANTS
+--|----------------------------------------------------------------------------|
+*/
+
+/* None */
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC VARIABLES
+--|----------------------------------------------------------------------------|
+*/
+
+/* None */
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC FUNCTION PROTOTYPES
+--|----------------------------------------------------------------------------|
+*/
+
+/*------------------------------------------------------------------------------
+Function Name:
+    BSP_ILI9341_Console_Init
+
+Function Description:
+    Clear the screen and put the cursor at the top left.
+
+Inputs:
+    color: the 16 bit 5-6-5 color for the text.
+    background: the 16 bit 5-6-5 color for the background.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    BSP_ILI9341_SPI_Display_Init must be called first.
+------------------------------------------------------------------------------*/
+void BSP_ILI9341_Console_Init(uint16_t color, uint16_t background);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    BSP_ILI9341_Console_Put_Char
+
+Function Description:
+    Write a character at the cursor and move the cursor on, scrolling when
+    the screen is full.
+
+Inputs:
+    c: the character.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    BSP_ILI9341_Console_Init must be called first.
+------------------------------------------------------------------------------*/
+void BSP_ILI9341_Console_Put_Char(char c);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    BSP_ILI9341_Console_Write
+
+Function Description:
+    Write a string at the cursor.
+
+Inputs:
+    p_string: the null terminated string.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    BSP_ILI9341_Console_Init must be called first.
+------------------------------------------------------------------------------*/
+void BSP_ILI9341_Console_Write(const char * p_string);
+
+#endif
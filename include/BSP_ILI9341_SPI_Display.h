@@ -10,6 +10,24 @@
 --|     were used as references to figure out the init sequence.
 --|
 --|     This is just the very early testing phase. 
+--|
+--|     By default every draw call goes straight to the display. If a 
+--|     framebuffer is given with BSP_ILI9341_Framebuffer_Enable the draw calls
+--|     render into the framebuffer instead, and nothing reaches the display
+--|     until BSP_ILI9341_Flush is called. Only the areas touched since the last
+--|     flush are sent.
+--|
+--|     The vertical scrolling commands change which display memory row shows
+--|     at the top of the scrolling area. The draw calls always take display
+--|     memory coordinates, so once scrolled, memory row y shows on screen at
+--|     top_fixed + (y - line) modulo scroll_height, for rows in the
+--|     scrolling area.
+--|
+--|     Text is drawn a whole string at a time: the glyphs are laid out side by
+--|     side in one block of pixels and sent in one window. Glyphs are kept
+--|     already expanded to pixels in a small cache, one entry per character
+--|     code, so redrawing a field of numbers is just copies and the SPI
+--|     transfer. Drawing a character in new colors replaces its cache entry.
 --|  
 --|----------------------------------------------------------------------------|
 --| REFERENCES:
@@ -32,6 +50,7 @@
 */
 
 #include "Fixed_Width_Ints.h"
+#include "BSP_Font.h"
 
 /*
 --|----------------------------------------------------------------------------|
@@ -47,6 +66,13 @@
 #define BSP_ILI9341_TFTWIDTH  (240u)
 #define BSP_ILI9341_TFTHEIGHT (320u)
 
+/*
+--| NAME: BSP_ILI9341_FRAMEBUFFER_SIZE
+--| DESCRIPTION: the number of pixels in a full screen framebuffer
+--| TYPE: uint32_t
+*/
+#define BSP_ILI9341_FRAMEBUFFER_SIZE (BSP_ILI9341_TFTWIDTH * BSP_ILI9341_TFTHEIGHT)
+
 /*
 --| NAME: BSP_ILI9341_xxx
 --| DESCRIPTION: ILI9341 color constants (not exhaustive)
@@ -236,6 +262,60 @@ void BSP_ILI9341_Draw_Filled_Rectangle(uint32_t x,
                                        uint32_t height, 
                                        uint16_t color);
 
+/*------------------------------------------------------------------------------
+Function Name:
+    BSP_ILI9341_Draw_Line
+
+Function Description:
+    Draws a 1 pixel line of any angle on the screen.
+
+    The line is walked with Bresenham's algorithm. Each horizontal run of a
+    flat line, or vertical run of a steep one, is sent as one line.
+
+Inputs:
+    x0, y0: where the line starts.
+    x1, y1: where the line ends.
+    color: the 16 bit 5-6-5 color for the line.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    The parts off the screen are cut off.
+------------------------------------------------------------------------------*/
+void BSP_ILI9341_Draw_Line(uint32_t x0, 
+                           uint32_t y0, 
+                           uint32_t x1, 
+                           uint32_t y1, 
+                           uint16_t color);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    BSP_ILI9341_Draw_Polyline
+
+Function Description:
+    Draws 1 pixel lines joining a list of points, such as the samples of a 
+    trace.
+
+    Same as BSP_ILI9341_Draw_Line for each pair of points, but the point 
+    where two lines meet is only sent once.
+
+Inputs:
+    p_x, p_y: the coordinates of the points, in order.
+    num_points: the number of points.
+    color: the 16 bit 5-6-5 color for the lines.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    The parts off the screen are cut off.
+------------------------------------------------------------------------------*/
+void BSP_ILI9341_Draw_Polyline(const uint32_t * p_x, 
+                               const uint32_t * p_y, 
+                               uint32_t num_points, 
+                               uint16_t color);
+
 /*------------------------------------------------------------------------------
 Function Name:
     BSP_ILI9341_Draw_Rectangle_Outline
@@ -270,7 +350,8 @@ Function Name:
 Function Description:
     Draws a circular outline on the screen.
 
-    The given (x, y) coordinate is the center of the circle.
+    The given (x, y) coordinate is the center of the circle. Each run of 
+    pixels along a row or column is sent as one line.
 
 Inputs:
     x, y: the center of the circle.
@@ -281,11 +362,331 @@ Returns:
     None
 
 Assumptions/Limitations:
-    None
+    The parts off the screen are cut off.
 ------------------------------------------------------------------------------*/
 void BSP_ILI9341_Draw_Circle_Outline(uint32_t x, 
                                      uint32_t y, 
                                      uint32_t r, 
                                      uint16_t color);
 
+/*------------------------------------------------------------------------------
+Function Name:
+    BSP_ILI9341_Draw_Filled_Circle
+
+Function Description:
+    Draws a filled in circle on the screen.
+
+    The given (x, y) coordinate is the center of the circle. The middle band
+    is sent as one rectangle and the rest as one line per row.
+
+Inputs:
+    x, y: the center of the circle.
+    r: the radius of the circle in pixels. 
+    color: the 16 bit 5-6-5 color for the circle.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    The parts off the screen are cut off.
+------------------------------------------------------------------------------*/
+void BSP_ILI9341_Draw_Filled_Circle(uint32_t x, 
+                                    uint32_t y, 
+                                    uint32_t r, 
+                                    uint16_t color);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    BSP_ILI9341_Draw_Rounded_Rectangle_Outline
+
+Function Description:
+    Draws a rectangular outline with rounded corners on the screen.
+
+    The given (x, y) coordinate is the upper left corner of the rectangle.
+    Each run of pixels along a row or column is sent as one line, the 
+    straight sides are one line each.
+
+Inputs:
+    x, y: the upper left coordinates of the rectangle.
+    width: the width of the rectangle in pixels.
+    height: the height of the rectangle in pixels. 
+    r: the radius of the corners in pixels.
+    color: the 16 bit 5-6-5 color for the rectangle.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    The radius is cut down to fit when the rectangle is too small for it.
+    The parts off the screen are cut off.
+------------------------------------------------------------------------------*/
+void BSP_ILI9341_Draw_Rounded_Rectangle_Outline(uint32_t x, 
+                                                uint32_t y, 
+                                                uint32_t width, 
+                                                uint32_t height, 
+                                                uint32_t r, 
+                                                uint16_t color);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    BSP_ILI9341_Draw_Filled_Rounded_Rectangle
+
+Function Description:
+    Draws a filled in rectangle with rounded corners on the screen.
+
+    The given (x, y) coordinate is the upper left corner of the rectangle.
+    The part between the corners is sent as one rectangle and the rest as 
+    one line per row.
+
+Inputs:
+    x, y: the upper left coordinates of the rectangle.
+    width: the width of the rectangle in pixels.
+    height: the height of the rectangle in pixels. 
+    r: the radius of the corners in pixels.
+    color: the 16 bit 5-6-5 color for the rectangle.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    The radius is cut down to fit when the rectangle is too small for it.
+    The parts off the screen are cut off.
+------------------------------------------------------------------------------*/
+void BSP_ILI9341_Draw_Filled_Rounded_Rectangle(uint32_t x, 
+                                               uint32_t y, 
+                                               uint32_t width, 
+                                               uint32_t height, 
+                                               uint32_t r, 
+                                               uint16_t color);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    BSP_ILI9341_Draw_Filled_Triangle
+
+Function Description:
+    Draws a filled in triangle on the screen, one line per row.
+
+Inputs:
+    x0, y0, x1, y1, x2, y2: the corners of the triangle, in any order.
+    color: the 16 bit 5-6-5 color for the triangle.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    The parts off the screen are cut off.
+------------------------------------------------------------------------------*/
+void BSP_ILI9341_Draw_Filled_Triangle(uint32_t x0, 
+                                      uint32_t y0, 
+                                      uint32_t x1, 
+                                      uint32_t y1, 
+                                      uint32_t x2, 
+                                      uint32_t y2, 
+                                      uint16_t color);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    BSP_ILI9341_Draw_Thick_Line
+
+Function Description:
+    Draws a line of any angle and thickness on the screen, one line per row.
+
+    The line is centered on the given end points and has square ends that 
+    stop at the end points.
+
+Inputs:
+    x0, y0: where the line starts.
+    x1, y1: where the line ends.
+    thickness: the width of the line in pixels.
+    color: the 16 bit 5-6-5 color for the line.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    Lines thinner than 2 pixels are drawn with BSP_ILI9341_Draw_Line. The 
+    parts off the screen are cut off.
+------------------------------------------------------------------------------*/
+void BSP_ILI9341_Draw_Thick_Line(uint32_t x0, 
+                                 uint32_t y0, 
+                                 uint32_t x1, 
+                                 uint32_t y1, 
+                                 uint32_t thickness, 
+                                 uint16_t color);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    BSP_ILI9341_Draw_Char
+
+Function Description:
+    Draws a character, in one window and one burst of pixels.
+
+    The given (x, y) coordinate is the upper left corner of the character.
+
+Inputs:
+    x, y: the upper left corner of the character.
+    c: the character.
+    p_font: the font, see BSP_Font.h.
+    color: the 16 bit 5-6-5 color for the character.
+    background: the 16 bit 5-6-5 color for the rest of the character cell.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    Same as BSP_ILI9341_Draw_String.
+------------------------------------------------------------------------------*/
+void BSP_ILI9341_Draw_Char(uint32_t x, 
+                           uint32_t y, 
+                           char c, 
+                           const BSP_Font_t * p_font, 
+                           uint16_t color, 
+                           uint16_t background);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    BSP_ILI9341_Draw_String
+
+Function Description:
+    Draws a string on one line, in one window and one burst of pixels.
+
+    The given (x, y) coordinate is the upper left corner of the first 
+    character. Text past the right or bottom edge of the screen is cut off.
+
+Inputs:
+    x, y: the upper left corner of the string.
+    p_string: the null terminated string.
+    p_font: the font, see BSP_Font.h.
+    color: the 16 bit 5-6-5 color for the characters.
+    background: the 16 bit 5-6-5 color for the rest of the character cells.
+
+Returns:
+    uint32_t: the width drawn in pixels, 0 if nothing was drawn.
+
+Assumptions/Limitations:
+    Fonts up to 8 pixels wide and 16 high. Control characters such as '\n'
+    are drawn as '?', use BSP_ILI9341_Console for running text.
+------------------------------------------------------------------------------*/
+uint32_t BSP_ILI9341_Draw_String(uint32_t x, 
+                                 uint32_t y, 
+                                 const char * p_string, 
+                                 const BSP_Font_t * p_font, 
+                                 uint16_t color, 
+                                 uint16_t background);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    BSP_ILI9341_Scroll_Define
+
+Function Description:
+    Split the screen into a fixed area at the top, a vertical scrolling area
+    and a fixed area at the bottom.
+
+Inputs:
+    top_fixed: rows in the top fixed area.
+    scroll_height: rows in the scrolling area.
+    bottom_fixed: rows in the bottom fixed area.
+
+Returns:
+    uint32_t: true if the areas were set, false if they do not add up to 
+    BSP_ILI9341_TFTHEIGHT.
+
+Assumptions/Limitations:
+    BSP_ILI9341_SPI_Display_Init must be called first.
+------------------------------------------------------------------------------*/
+uint32_t BSP_ILI9341_Scroll_Define(uint32_t top_fixed, uint32_t scroll_height, uint32_t bottom_fixed);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    BSP_ILI9341_Scroll_To
+
+Function Description:
+    Set the display memory row shown at the top of the scrolling area. The 
+    rows after it follow, wrapping around within the scrolling area.
+
+Inputs:
+    line: the display memory row, from top_fixed to 
+    top_fixed + scroll_height - 1.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    BSP_ILI9341_Scroll_Define must be called first. Does nothing for a row
+    past the bottom of the display memory.
+------------------------------------------------------------------------------*/
+void BSP_ILI9341_Scroll_To(uint32_t line);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    BSP_ILI9341_Framebuffer_Enable
+
+Function Description:
+    Switch to framebuffer mode. From now on the draw calls render into the
+    given framebuffer and only reach the display when BSP_ILI9341_Flush is 
+    called.
+
+    The framebuffer is cleared to black and the whole screen is marked as 
+    needing a flush.
+
+Inputs:
+    p_framebuffer: pointer to BSP_ILI9341_FRAMEBUFFER_SIZE pixels of memory,
+    4 byte aligned.
+
+Returns:
+    uint32_t: true if framebuffer mode was enabled, false if the framebuffer 
+    is not 4 byte aligned or the DMA channels used for flushing could not be
+    allocated.
+
+Assumptions/Limitations:
+    BSP_ILI9341_SPI_Display_Init must be called first. Pixels are kept in the
+    framebuffer in the byte order the display wants, high byte first, so the
+    framebuffer should only be drawn to using the draw functions.
+------------------------------------------------------------------------------*/
+uint32_t BSP_ILI9341_Framebuffer_Enable(uint16_t * p_framebuffer);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    BSP_ILI9341_Framebuffer_Disable
+
+Function Description:
+    Go back to drawing straight to the display. Anything not yet flushed is 
+    thrown away.
+
+Inputs:
+    None
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+void BSP_ILI9341_Framebuffer_Disable(void);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    BSP_ILI9341_Flush
+
+Function Description:
+    Send the parts of the framebuffer that were drawn to since the last flush
+    to the display. 
+
+    Overlapping dirty rectangles are merged as they are drawn, and each dirty
+    rectangle costs one address setup and one DMA transfer, widened to start
+    and end on a pair of pixels. Pixels are sent via DMA, and the last
+    rectangle is still being sent when this returns.
+
+Inputs:
+    None
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    Does nothing if not in framebuffer mode. Drawing to an area that is still
+    being sent may tear, the area is sent again on the next flush.
+------------------------------------------------------------------------------*/
+void BSP_ILI9341_Flush(void);
+
 #endif
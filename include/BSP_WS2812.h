@@ -0,0 +1,165 @@
+/*
+--|----------------------------------------------------------------------------|
+--| FILE DESCRIPTION:
+--|   BSP_WS2812 provides an interface for driving a strip of WS2812
+--|   (NeoPixel) LEDs from a PWM channel.
+--|
+--|----------------------------------------------------------------------------|
+--| NOTES:
+--|     The PWM channel runs in serializer mode at 2.4MHz, each WS2812 bit is
+--|     sent as 3 serializer bits, 110 for a 1 and 100 for a 0, which gives
+--|     the 1.25uSec bit time with 0.42uSec or 0.83uSec high. The whole strip
+--|     goes out in one DMA transfer followed by a low reset time, the CPU
+--|     only encodes the colors, through a table, before it starts.
+--|
+--|     Init sets the PWM clock, so other PWM channels run at 2.4MHz too. The
+--|     PWM audio stream can't be used alongside the strip.
+--|
+--|     Set the pin to PWM mode with the PSP_PWM pin functions: GPIO12 or 18
+--|     for channel 1, GPIO13 or 19 for channel 2. The strip wants 5V data, a
+--|     level shifter may be needed.
+--|
+--|----------------------------------------------------------------------------|
+--| REFERENCES:
+--|   WS2812B datasheet, sequence chart and reset code
+--|   BCM2837-ARM-Peripherals.pdf page 138 (PWM serializer mode)
+--|
+--|----------------------------------------------------------------------------|
+*/
+
+#ifndef BSP_WS2812_H_INCLUDED
+#define BSP_WS2812_H_INCLUDED
+
+/*
+--|----------------------------------------------------------------------------|
+--| INCLUDE FILES
+--|----------------------------------------------------------------------------|
+*/
+
+#include "Fixed_Width_Ints.h"
+#include "PSP_PWM.h"
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC DEFINES
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--| NAME: BSP_WS2812_MAX_LEDS
+--| DESCRIPTION: the longest strip the driver has room for
+--| TYPE: uint32_t
+*/
+#define BSP_WS2812_MAX_LEDS (300u)
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC TYPES
+--|----------------------------------------------------------------------------|
+*/
+
+/* None */
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC CONSTANTS
+--|----------------------------------------------------------------------------|
+*/
+
+/* None */
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC VARIABLES
+--|----------------------------------------------------------------------------|
+*/
+
+/* None */
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC FUNCTION PROTOTYPES
+--|----------------------------------------------------------------------------|
+*/
+
+/*------------------------------------------------------------------------------
+Function Name:
+    BSP_WS2812_Init
+
+Function Description:
+    Set the PWM clock and start a channel in serializer mode for the strip,
+    with every LED off.
+
+Inputs:
+    channel: the PWM channel the strip is on.
+    num_leds: the number of LEDs on the strip.
+
+Returns:
+    uint32_t: true if the strip is ready, false if num_leds is more than
+    BSP_WS2812_MAX_LEDS or no DMA channel was free.
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+uint32_t BSP_WS2812_Init(PSP_PWM_Channel_t channel, uint32_t num_leds);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    BSP_WS2812_Set_Pixel
+
+Function Description:
+    Set the color of one LED, it shows at the next BSP_WS2812_Show.
+
+Inputs:
+    index: the LED, 0 is the one nearest the Pi.
+    red: the red level.
+    green: the green level.
+    blue: the blue level.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    Safe to call while a refresh is being sent.
+------------------------------------------------------------------------------*/
+void BSP_WS2812_Set_Pixel(uint32_t index, uint8_t red, uint8_t green, uint8_t blue);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    BSP_WS2812_Show
+
+Function Description:
+    Encode the colors and start sending them to the strip. Returns straight
+    away, the refresh takes 30uSec per LED plus 320uSec of reset.
+
+Inputs:
+    None
+
+Returns:
+    uint32_t: true if the refresh started, false if the last one is still
+    being sent.
+
+Assumptions/Limitations:
+    BSP_WS2812_Init must be called first.
+------------------------------------------------------------------------------*/
+uint32_t BSP_WS2812_Show(void);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    BSP_WS2812_Is_Busy
+
+Function Description:
+    Check if a refresh is still being sent.
+
+Inputs:
+    None
+
+Returns:
+    uint32_t: true if a refresh is being sent, else false.
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+uint32_t BSP_WS2812_Is_Busy(void);
+
+#endif
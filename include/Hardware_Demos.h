@@ -27,6 +27,13 @@
 #include "BSP_Rotary_Encoder.h"
 #include "PSP_Hardware_RNG.h"
 #include "BSP_ILI9341_SPI_Display.h"
+#include "PSP_Core.h"
+#include "PSP_IRQ.h"
+#include "PSP_Soft_Timer.h"
+#include "PSP_Perf.h"
+#include "PSP_UART_0.h"
+#include "PSP_String.h"
+#include "BSP_WS2812.h"
 
 
 
@@ -61,6 +68,42 @@ void demo_GPIO()
 
 
 
+/**
+ * Simple demo of the GPIO port functions.
+ * 
+ * Counts in binary on 8 pins, writing all 8 with one port write, and copies the snapshot of
+ * a switch to a LED.
+ * 
+ * To verify: attach LEDs to pins 4 through 11, they should count up 10 times a second. 
+ * Attach a switch to pin 21 and a LED to pin 17, the LED should follow the switch.
+ */ 
+void demo_GPIO_Port()
+{
+    const uint32_t FIRST_COUNT_PIN = 4u;
+    const uint32_t COUNT_PINS_MASK = 0xFFu << FIRST_COUNT_PIN;
+    const uint32_t LED_PIN = 17u;
+    const uint32_t SWITCH_PIN = 21u;
+    const uint32_t DELAY_TIME_uSec = 100000u;
+    uint32_t count = 0u;
+
+    PSP_GPIO_Set_Pins_Mode(COUNT_PINS_MASK | (1u << LED_PIN), PSP_GPIO_PINMODE_OUTPUT);
+    PSP_GPIO_Set_Pin_Mode(SWITCH_PIN, PSP_GPIO_PINMODE_INPUT);
+
+    while(1)
+    {
+        const uint64_t levels = PSP_GPIO_Read_All_Pins();
+
+        PSP_GPIO_Port_Write(PSP_GPIO_PORT_0, 
+                            COUNT_PINS_MASK | (1u << LED_PIN), 
+                            (count << FIRST_COUNT_PIN) | (PSP_GPIO_SNAPSHOT_PIN(levels, SWITCH_PIN) << LED_PIN));
+
+        count++;
+        PSP_Time_Delay_Microseconds(DELAY_TIME_uSec);
+    }
+}
+
+
+
 /**
  * Simple demo of hardware PWM.
  * 
@@ -131,6 +174,57 @@ void demo_SPI_0()
 
 
 
+/**
+ * Simple demo of SPI 0 with DMA.
+ * 
+ * Writes a buffer of bytes via DMA, toggling a LED while the transfer runs to
+ * show that the CPU is free while the DMA engine keeps the FIFO fed.
+ * 
+ * To verify, you'll need a logic analyzer/scope on pins 8, 10 and 11, and a 
+ * LED on pin 17.
+ */ 
+void demo_SPI_0_DMA()
+{
+    const uint32_t LED_PIN = 17u;
+    const uint32_t DELAY_TIME_uSec = 1000u;
+
+    PSP_GPIO_Set_Pin_Mode(LED_PIN, PSP_GPIO_PINMODE_OUTPUT);
+
+    PSP_SPI0_Start();
+    PSP_SPI0_Set_Clock_Divider(PSP_SPI0_Clock_Divider_64);
+    PSP_SPI0_Set_Chip_Select(PSP_SPI_0_Chip_Select_0);
+    PSP_SPI0_DMA_Init();
+
+    const uint32_t SPI_BUFFER_SIZE = 1024u;
+
+    static uint8_t spi_data_out[1024u];
+
+    for (uint32_t i = 0u; i < SPI_BUFFER_SIZE; i++)
+    {
+        spi_data_out[i] = i;
+    }
+
+    uint32_t led_val = 0u;
+
+    while(1)
+    {
+        PSP_SPI0_DMA_Transfer(spi_data_out, 0, SPI_BUFFER_SIZE);
+
+        while (PSP_SPI0_DMA_Is_Busy())
+        {
+            // the CPU is free to do other work while the transfer runs
+            led_val ^= 1u;
+            PSP_GPIO_Write_Pin(LED_PIN, led_val);
+        }
+
+        PSP_SPI0_DMA_Wait();
+
+        PSP_Time_Delay_Microseconds(DELAY_TIME_uSec);
+    }
+}
+
+
+
 /**
  * Simple demo of I2C bus.
  * 
@@ -190,6 +284,49 @@ void demo_Mini_Uart()
 
 
 
+/**
+ * Simple demo of the interrupt driven Mini Uart.
+ * 
+ * Echoes back every byte received, while a LED keeps blinking to show the main loop never 
+ * waits on the uart.
+ * 
+ * To verify: attach a LED to pin 17 and a terminal to pins 14 and 15 at 115200 baud, typed
+ * characters should come back.
+ */ 
+void demo_Mini_Uart_Interrupts()
+{
+    const uint32_t LED_PIN = 17u;
+    uint8_t buffer[64u];
+    uint32_t led_val = 0u;
+    PSP_Time_Periodic_Timer_t blink_timer = { .timeout_period_uSec = 250000u };
+
+    PSP_Time_Initialize_Timer_Counter(&blink_timer);
+
+    PSP_GPIO_Set_Pin_Mode(LED_PIN, PSP_GPIO_PINMODE_OUTPUT);
+
+    PSP_AUX_Mini_Uart_Init(PSP_AUX_Mini_Uart_Baud_Rate_115200);
+    PSP_IRQ_Init();
+    PSP_AUX_Mini_Uart_Enable_Interrupts();
+    PSP_IRQ_Enable();
+
+    PSP_AUX_Mini_Uart_Send_String("echo:\r\n");
+
+    while (1)
+    {
+        const uint32_t num_received = PSP_AUX_Mini_Uart_Read(buffer, sizeof(buffer));
+
+        PSP_AUX_Mini_Uart_Write(buffer, num_received);
+
+        if (PSP_Time_Periodic_Timer_Timeout_Occured(&blink_timer))
+        {
+            led_val ^= 1u;
+            PSP_GPIO_Write_Pin(LED_PIN, led_val);
+        }
+    }
+}
+
+
+
 /*
     Simple demo of the Rotary Encoder module.
 
@@ -347,4 +484,270 @@ void demo_ILI9341()
 
 
 
+/**
+ * Simple demo of running code on a second core.
+ * 
+ * Core 1 blinks one LED while core 0 blinks another at a different rate.
+ * 
+ * To verify: attach a LED to pin 17 and a LED to pin 27, they should blink independently.
+ */ 
+void demo_Core_1_Blink()
+{
+    const uint32_t LED_PIN = 27u;
+    const uint32_t DELAY_TIME_uSec = 250000u;
+
+    PSP_GPIO_Set_Pin_Mode(LED_PIN, PSP_GPIO_PINMODE_OUTPUT);
+
+    uint32_t led_val = 0u;
+
+    while(1)
+    {
+        led_val ^= 1u;
+        PSP_GPIO_Write_Pin(LED_PIN, led_val);
+
+        PSP_Time_Delay_Microseconds(DELAY_TIME_uSec);
+    }
+}
+
+void demo_Multicore()
+{
+    const uint32_t LED_PIN = 17u;
+    const uint32_t DELAY_TIME_uSec = 1000000u;
+
+    PSP_GPIO_Set_Pin_Mode(LED_PIN, PSP_GPIO_PINMODE_OUTPUT);
+
+    PSP_Core_Start(1u, demo_Core_1_Blink, 0);
+
+    uint32_t led_val = 0u;
+
+    while(1)
+    {
+        led_val ^= 1u;
+        PSP_GPIO_Write_Pin(LED_PIN, led_val);
+
+        PSP_Time_Delay_Microseconds(DELAY_TIME_uSec);
+    }
+}
+
+
+
+/**
+ * Simple demo of the software timers.
+ * 
+ * Two periodic timers blink two LEDs at different rates from the timer interrupt, while the 
+ * main loop sleeps.
+ * 
+ * To verify: attach a LED to pin 17 and a LED to pin 27, they should blink at 2 Hz and 5 Hz.
+ */ 
+void demo_Soft_Timer_Blink(PSP_Soft_Timer_t * p_timer)
+{
+    static uint32_t led_vals = 0u;
+
+    // the period tells the two timers apart
+    const uint32_t LED_PIN = (p_timer->period_uSec == 250000u) ? 17u : 27u;
+    const uint32_t LED_BIT = (LED_PIN == 17u) ? 1u : 2u;
+
+    led_vals ^= LED_BIT;
+    PSP_GPIO_Write_Pin(LED_PIN, (led_vals & LED_BIT) ? 1u : 0u);
+}
+
+void demo_Soft_Timer()
+{
+    static PSP_Soft_Timer_t timer_2_Hz;
+    static PSP_Soft_Timer_t timer_5_Hz;
+
+    PSP_GPIO_Set_Pin_Mode(17u, PSP_GPIO_PINMODE_OUTPUT);
+    PSP_GPIO_Set_Pin_Mode(27u, PSP_GPIO_PINMODE_OUTPUT);
+
+    PSP_IRQ_Init();
+    PSP_Soft_Timer_Init();
+    PSP_IRQ_Enable();
+
+    timer_2_Hz = (PSP_Soft_Timer_t){ 0 };
+    timer_5_Hz = (PSP_Soft_Timer_t){ 0 };
+
+    PSP_Soft_Timer_Start(&timer_2_Hz, 250000u, 250000u, demo_Soft_Timer_Blink);
+    PSP_Soft_Timer_Start(&timer_5_Hz, 100000u, 100000u, demo_Soft_Timer_Blink);
+
+    while(1)
+    {
+        PSP_Soft_Timer_Sleep_Microseconds(1000000u);
+    }
+}
+
+
+
+/**
+ * Simple demo of the profiling regions.
+ * 
+ * Measures a loop summing a buffer, first walking it in order then with a large stride, and
+ * dumps the counters of both over the mini uart once a second.
+ * 
+ * To verify: read the uart, the strided walk should show many more cache misses and cycles
+ * for the same number of instructions.
+ */ 
+void demo_Perf()
+{
+    const uint32_t BUFFER_LENGTH = 16384u;
+    const uint32_t STRIDE = 16u;
+    static uint32_t buffer[16384u];
+    volatile uint32_t sum = 0u;
+
+    PSP_AUX_Mini_Uart_Init(PSP_AUX_Mini_Uart_Baud_Rate_115200);
+    PSP_Perf_Init();
+
+    while (1)
+    {
+        PSP_PERF_REGION_BEGIN(sequential);
+        for (uint32_t i = 0u; i < BUFFER_LENGTH; i++)
+        {
+            sum += buffer[i];
+        }
+        PSP_PERF_REGION_END(sequential);
+
+        PSP_PERF_REGION_BEGIN(strided);
+        for (uint32_t start = 0u; start < STRIDE; start++)
+        {
+            for (uint32_t i = start; i < BUFFER_LENGTH; i += STRIDE)
+            {
+                sum += buffer[i];
+            }
+        }
+        PSP_PERF_REGION_END(strided);
+
+        PSP_Perf_Dump();
+        PSP_Perf_Reset();
+
+        PSP_Time_Delay_Microseconds(1000000u);
+    }
+}
+
+
+
+/**
+ * Simple demo of UART 0 with DMA.
+ * 
+ * Streams a line of telemetry at 3 Mbaud from the DMA, and echoes back anything received.
+ * 
+ * To verify: attach a 3 Mbaud capable USB serial adapter to pins 14 and 15, the line should
+ * repeat continuously and typed characters should show up in it.
+ */ 
+void demo_UART_0_DMA()
+{
+    static uint8_t line[] = "0123456789 abcdefghijklmnopqrstuvwxyz ABCDEFGHIJKLMNOPQRSTUVWXYZ\r\n";
+    uint8_t received[64u];
+
+    PSP_UART0_Init(3000000u, 0u);
+    PSP_UART0_DMA_Init();
+
+    while (1)
+    {
+        const uint32_t num_received = PSP_UART0_DMA_Read(received, sizeof(received));
+
+        if (num_received)
+        {
+            PSP_UART0_DMA_Write(received, num_received);
+        }
+
+        PSP_UART0_DMA_Write(line, sizeof(line) - 1u);
+    }
+}
+
+
+
+/**
+ * Simple demo of the memory functions.
+ * 
+ * Measures filling a display sized buffer with an RGB565 color and copying it, first with plain
+ * loops then with memset16 and memcpy, and dumps the counters over the mini uart once a second.
+ * 
+ * To verify: read the uart, the memset16 and memcpy regions should take fewer cycles than the
+ * loops, by the most in the debug profile where the compiler leaves the loops as they are.
+ */ 
+void demo_String()
+{
+    const uint32_t NUM_PIXELS = BSP_ILI9341_FRAMEBUFFER_SIZE;
+    const uint16_t COLOR = 0xF800u;
+    static uint16_t source[BSP_ILI9341_FRAMEBUFFER_SIZE];
+    static uint16_t dest[BSP_ILI9341_FRAMEBUFFER_SIZE];
+
+    PSP_AUX_Mini_Uart_Init(PSP_AUX_Mini_Uart_Baud_Rate_115200);
+    PSP_Perf_Init();
+
+    while (1)
+    {
+        PSP_PERF_REGION_BEGIN(fill_loop);
+        for (uint32_t i = 0u; i < NUM_PIXELS; i++)
+        {
+            source[i] = COLOR;
+        }
+        PSP_PERF_REGION_END(fill_loop);
+
+        PSP_PERF_REGION_BEGIN(memset16);
+        memset16(source, COLOR, NUM_PIXELS);
+        PSP_PERF_REGION_END(memset16);
+
+        PSP_PERF_REGION_BEGIN(copy_loop);
+        for (uint32_t i = 0u; i < NUM_PIXELS; i++)
+        {
+            dest[i] = source[i];
+        }
+        PSP_PERF_REGION_END(copy_loop);
+
+        PSP_PERF_REGION_BEGIN(memcpy);
+        memcpy(dest, source, sizeof(dest));
+        PSP_PERF_REGION_END(memcpy);
+
+        PSP_Perf_Dump();
+        PSP_Perf_Reset();
+
+        PSP_Time_Delay_Microseconds(1000000u);
+    }
+}
+
+
+
+
+/**
+ * Simple demo of a WS2812 LED strip.
+ * 
+ * Runs a red, green and blue dot along a 60 LED strip, refreshing every 20ms.
+ * 
+ * To verify: attach the strip data input to pin 18 through a 3.3v to 5v level shifter, the three
+ * dots should move smoothly along the strip with no flicker or wrong colors.
+ */ 
+void demo_WS2812()
+{
+    const uint32_t NUM_LEDS = 60u;
+    const uint64_t TIMER_PERIOD_uSec = 20000u;
+    uint64_t time_stamp = 0u;
+    uint32_t pos = 0u;
+
+    BSP_WS2812_Init(PSP_PWM_Channel_1, NUM_LEDS);
+    PSP_PWM_Ch1_Set_GPIO18_To_PWM_Mode();
+
+    while (1)
+    {
+        if (PSP_Time_Get_Ticks() > time_stamp)
+        {
+            time_stamp = PSP_Time_Get_Ticks() + TIMER_PERIOD_uSec;
+
+            for (uint32_t i = 0u; i < NUM_LEDS; i++)
+            {
+                BSP_WS2812_Set_Pixel(i, 0u, 0u, 0u);
+            }
+
+            BSP_WS2812_Set_Pixel(pos, 64u, 0u, 0u);
+            BSP_WS2812_Set_Pixel((pos + 20u) % NUM_LEDS, 0u, 64u, 0u);
+            BSP_WS2812_Set_Pixel((pos + 40u) % NUM_LEDS, 0u, 0u, 64u);
+
+            BSP_WS2812_Show();
+
+            pos = (pos + 1u) % NUM_LEDS;
+        }
+    }
+}
+
+
+
 #endif
@@ -12,6 +12,13 @@
 --|     Mini uart init, set baud rate, and write bytes are started, but not 
 --|     thoroughly verified. In particular, need to check that the baud rate 
 --|     enums actually result in the proper baud rates.
+--|
+--|     After PSP_AUX_Mini_Uart_Enable_Interrupts, transmit and receive are 
+--|     interrupt driven. PSP_AUX_Mini_Uart_Write and PSP_AUX_Mini_Uart_Read 
+--|     only copy to and from ring buffers and never wait, the Aux interrupt 
+--|     moves bytes between the ring buffers and the uart FIFOs. Each ring 
+--|     buffer has one producer and one consumer, so no locking is needed as 
+--|     long as only one context writes and one context reads.
 --|  
 --|----------------------------------------------------------------------------|
 --| REFERENCES:
@@ -45,6 +52,15 @@
 #define PSP_AUX_MINI_UART_TX_PIN (14u)
 #define PSP_AUX_MINI_UART_RX_PIN (15u)
 
+/*
+--| NAME: PSP_AUX_MINI_UART_<T/R>X_BUFFER_SIZE
+--| DESCRIPTION: size in bytes of the transmit and receive ring buffers used 
+--|   once interrupts are enabled, must be powers of 2
+--| TYPE: uint32_t
+*/
+#define PSP_AUX_MINI_UART_TX_BUFFER_SIZE (1024u)
+#define PSP_AUX_MINI_UART_RX_BUFFER_SIZE (256u)
+
 /*
 --|----------------------------------------------------------------------------|
 --| PUBLIC TYPES
@@ -140,7 +156,8 @@ Function Name:
     PSP_AUX_Mini_Uart_Send_Byte
 
 Function Description:
-    Send a byte of data via mini uart Tx.
+    Send a byte of data via mini uart Tx, waiting until it can be sent or, 
+    once interrupts are enabled, until it fits in the transmit ring buffer.
 
 Inputs:
     value: the value of the byte to send.
@@ -149,7 +166,8 @@ Returns:
     None.
 
 Assumptions/Limitations:
-    None
+    Once interrupts are enabled, must not be called with IRQs masked on the 
+    core that takes the Aux interrupt, the ring buffer would never drain.
 ------------------------------------------------------------------------------*/
 void PSP_AUX_Mini_Uart_Send_Byte(uint8_t value);
 
@@ -171,4 +189,66 @@ Assumptions/Limitations:
 ------------------------------------------------------------------------------*/
 void PSP_AUX_Mini_Uart_Send_String(char* c_string);
 
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_AUX_Mini_Uart_Enable_Interrupts
+
+Function Description:
+    Empty the ring buffers and switch transmit and receive over to the Aux 
+    interrupt.
+
+Inputs:
+    None
+
+Returns:
+    None.
+
+Assumptions/Limitations:
+    PSP_AUX_Mini_Uart_Init and PSP_IRQ_Init must be called first, and IRQs 
+    enabled with PSP_IRQ_Enable for any bytes to move.
+------------------------------------------------------------------------------*/
+void PSP_AUX_Mini_Uart_Enable_Interrupts(void);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_AUX_Mini_Uart_Write
+
+Function Description:
+    Queue bytes to send via mini uart Tx, without waiting.
+
+Inputs:
+    p_buffer: the bytes to send.
+    length: the number of bytes to send.
+
+Returns:
+    uint32_t: the number of bytes queued, less than length if the transmit 
+    ring buffer filled up.
+
+Assumptions/Limitations:
+    PSP_AUX_Mini_Uart_Enable_Interrupts must be called first. Only one 
+    context may write at a time.
+------------------------------------------------------------------------------*/
+uint32_t PSP_AUX_Mini_Uart_Write(const uint8_t * p_buffer, uint32_t length);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_AUX_Mini_Uart_Read
+
+Function Description:
+    Take bytes received via mini uart Rx, without waiting.
+
+Inputs:
+    p_buffer: where to put the bytes received.
+    length: the most bytes to take.
+
+Returns:
+    uint32_t: the number of bytes taken, 0 if nothing has been received.
+
+Assumptions/Limitations:
+    PSP_AUX_Mini_Uart_Enable_Interrupts must be called first. Only one 
+    context may read at a time. Bytes received while the receive ring buffer 
+    is full are dropped.
+------------------------------------------------------------------------------*/
+uint32_t PSP_AUX_Mini_Uart_Read(uint8_t * p_buffer, uint32_t length);
+
 #endif
@@ -0,0 +1,146 @@
+/*
+--|----------------------------------------------------------------------------|
+--| FILE DESCRIPTION:
+--|   PSP_Core provides functions for finding out which core is running and
+--|   for starting cores 1 to 3, each on its own entry function and stack.
+--|
+--|----------------------------------------------------------------------------|
+--| NOTES:
+--|     At power up only core 0 runs the kernel. The firmware leaves cores 1 to
+--|     3 waiting for an address in their mailbox 3, PSP_Core_Start writes the
+--|     address of _secondary_start in start.s there. _secondary_start leaves
+--|     HYP mode, loads the stack, turns on the MMU and caches when core 0 did,
+--|     then calls the entry function.
+--|
+--|     If the entry function returns the core goes to sleep and can not be
+--|     started again.
+--|
+--|     The peripheral drivers are not safe to call from more than one core at
+--|     a time. Give each core its own set of peripherals.
+--|
+--|----------------------------------------------------------------------------|
+--| REFERENCES:
+--|   QA7_rev3.4.pdf page 15 (mailboxes)
+--|   https://github.com/raspberrypi/tools/blob/master/armstubs/armstub7.S
+--|
+--|----------------------------------------------------------------------------|
+*/
+
+#ifndef PSP_CORE_H_INCLUDED
+#define PSP_CORE_H_INCLUDED
+
+/*
+--|----------------------------------------------------------------------------|
+--| INCLUDE FILES
+--|----------------------------------------------------------------------------|
+*/
+
+#include "Fixed_Width_Ints.h"
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC DEFINES
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--| NAME: PSP_CORE_NUM_CORES
+--| DESCRIPTION: the number of Cortex-A53 cores
+--| TYPE: uint32_t
+*/
+#define PSP_CORE_NUM_CORES (4u)
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC TYPES
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--| NAME: PSP_Core_Entry_t
+--| DESCRIPTION: the function a started core runs
+*/
+typedef void (*PSP_Core_Entry_t)(void);
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC CONSTANTS
+--|----------------------------------------------------------------------------|
+*/
+
+/* None */
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC VARIABLES
+--|----------------------------------------------------------------------------|
+*/
+
+/* None */
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC FUNCTION PROTOTYPES
+--|----------------------------------------------------------------------------|
+*/
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_Core_Get_ID
+
+Function Description:
+    Get the number of the core this is running on.
+
+Inputs:
+    None
+
+Returns:
+    uint32_t: the core number, 0 to 3.
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+uint32_t PSP_Core_Get_ID(void);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_Core_Start
+
+Function Description:
+    Start one of cores 1 to 3 running an entry function.
+
+Inputs:
+    core_id: the core to start, 1 to 3.
+    entry: the function for the core to run.
+    p_stack_top: the top of the core's stack, the stack grows down from here.
+    Pass 0 to use the core's own stack region from linker.ld.
+
+Returns:
+    uint32_t: true if the core was started, false if the core number or entry
+    function is invalid, or the core was already started.
+
+Assumptions/Limitations:
+    Should be called from core 0. A given stack must be 8 byte aligned and
+    must not be used by anything else.
+------------------------------------------------------------------------------*/
+uint32_t PSP_Core_Start(uint32_t core_id, PSP_Core_Entry_t entry, void * p_stack_top);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_Core_Is_Started
+
+Function Description:
+    Check whether a core has been started with PSP_Core_Start.
+
+Inputs:
+    core_id: the core to check, 0 to 3.
+
+Returns:
+    uint32_t: true if the core has been started, always true for core 0.
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+uint32_t PSP_Core_Is_Started(uint32_t core_id);
+
+#endif
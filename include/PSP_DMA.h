@@ -0,0 +1,476 @@
+/*
+--|----------------------------------------------------------------------------|
+--| FILE DESCRIPTION:
+--|   PSP_DMA provides an interface for the DMA controller. Functions are
+--|   provided for allocating DMA channels, starting a chain of control blocks
+--|   on a channel, and getting notified when the chain completes.
+--|
+--|----------------------------------------------------------------------------|
+--| NOTES:
+--|     The DMA engine only understands VideoCore bus addresses. Use
+--|     PSP_DMA_Bus_Address and PSP_DMA_Peripheral_Bus_Address to convert ARM
+--|     addresses before putting them in a control block.
+--|
+--|     With the data cache on, control blocks and source buffers must be
+--|     cleaned from the cache before starting a DMA, and destination buffers
+--|     invalidated after, see PSP_MMU.
+--|
+--|     Control blocks must be 32 byte aligned, PSP_DMA_Control_Block_t takes
+--|     care of that as long as the control blocks are declared with that type.
+--|
+--|     Channels 1, 3, 6 and 7 are used by the GPU firmware and are never
+--|     handed out. Channels 7 through 14 are "lite" channels, they are half
+--|     the bandwidth of a full channel and can not move more than 65535 bytes
+--|     in a single control block.
+--|
+--|----------------------------------------------------------------------------|
+--| REFERENCES:
+--|   BCM2837-ARM-Peripherals.pdf page 38
+--|   https://elinux.org/BCM2835_datasheet_errata#p40 (bus addresses)
+--|
+--|----------------------------------------------------------------------------|
+*/
+
+#ifndef PSP_DMA_H_INCLUDED
+#define PSP_DMA_H_INCLUDED
+
+/*
+--|----------------------------------------------------------------------------|
+--| INCLUDE FILES
+--|----------------------------------------------------------------------------|
+*/
+
+#include "Fixed_Width_Ints.h"
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC DEFINES
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--| NAME: PSP_DMA_NUM_CHANNELS
+--| DESCRIPTION: the number of DMA channels in the register block at DMA base
+--| TYPE: uint32_t
+*/
+#define PSP_DMA_NUM_CHANNELS (15u)
+
+/*
+--| NAME: PSP_DMA_NO_CHANNEL
+--| DESCRIPTION: returned by PSP_DMA_Channel_Allocate when no channel is free
+--| TYPE: uint32_t
+*/
+#define PSP_DMA_NO_CHANNEL (0xFFFFFFFFu)
+
+/*
+--| NAME: PSP_DMA_LITE_MAX_TRANSFER_LENGTH
+--| DESCRIPTION: the largest TXFR_LEN a lite channel can handle, in bytes
+--| TYPE: uint32_t
+*/
+#define PSP_DMA_LITE_MAX_TRANSFER_LENGTH (0xFFFFu)
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC TYPES
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--| NAME: PSP_DMA_Control_Block_t
+--| DESCRIPTION: structure for a DMA control block, must be 32 byte aligned
+*/
+typedef struct PSP_DMA_Control_Block_Type
+{
+    uint32_t TI;          // Transfer Information
+    uint32_t SOURCE_AD;   // Source Address (bus address)
+    uint32_t DEST_AD;     // Destination Address (bus address)
+    uint32_t TXFR_LEN;    // Transfer Length in bytes
+    uint32_t STRIDE;      // 2D Mode Stride
+    uint32_t NEXTCONBK;   // Next Control Block Address (bus address, 0 to stop)
+    uint32_t RESERVED[2]; // must be zero
+} __attribute__((aligned(32))) PSP_DMA_Control_Block_t;
+
+/*
+--| NAME: PSP_DMA_TI_Flags_enum
+--| DESCRIPTION: DMA control block Transfer Information flags
+*/
+typedef enum PSP_DMA_TI_Flags_Enumeration
+{
+    PSP_DMA_TI_NO_WIDE_BURSTS_FLAG = (1u << 26u), // Don't Do wide writes as a 2 beat burst
+    PSP_DMA_TI_SRC_IGNORE_FLAG     = (1u << 11u), // Ignore Reads
+    PSP_DMA_TI_SRC_DREQ_FLAG       = (1u << 10u), // Control Source Reads with DREQ
+    PSP_DMA_TI_SRC_WIDTH_FLAG      = (1u << 9u),  // Source Transfer Width, 1 = 128 bit
+    PSP_DMA_TI_SRC_INC_FLAG        = (1u << 8u),  // Source Address Increment
+    PSP_DMA_TI_DEST_IGNORE_FLAG    = (1u << 7u),  // Ignore Writes
+    PSP_DMA_TI_DEST_DREQ_FLAG      = (1u << 6u),  // Control Destination Writes with DREQ
+    PSP_DMA_TI_DEST_WIDTH_FLAG     = (1u << 5u),  // Destination Transfer Width, 1 = 128 bit
+    PSP_DMA_TI_DEST_INC_FLAG       = (1u << 4u),  // Destination Address Increment
+    PSP_DMA_TI_WAIT_RESP_FLAG      = (1u << 3u),  // Wait for a Write Response
+    PSP_DMA_TI_TDMODE_FLAG         = (1u << 1u),  // 2D Mode
+    PSP_DMA_TI_INTEN_FLAG          = (1u << 0u),  // Interrupt Enable
+} PSP_DMA_TI_Flags_enum;
+
+/*
+--| NAME: PSP_DMA_TI_Masks_enum
+--| DESCRIPTION: DMA control block Transfer Information multi-bit field masks
+*/
+typedef enum PSP_DMA_TI_Masks_Enumeration
+{
+    PSP_DMA_TI_WAITS_MASK             = 0x1Fu, // Add Wait Cycles [5 bits]
+    PSP_DMA_TI_WAITS_SHIFT_AMT        = 21u,   // position of WAITS in TI
+    PSP_DMA_TI_PERMAP_MASK            = 0x1Fu, // Peripheral Mapping [5 bits]
+    PSP_DMA_TI_PERMAP_SHIFT_AMT       = 16u,   // position of PERMAP in TI
+    PSP_DMA_TI_BURST_LENGTH_MASK      = 0xFu,  // Burst Transfer Length [4 bits]
+    PSP_DMA_TI_BURST_LENGTH_SHIFT_AMT = 12u,   // position of BURST_LENGTH in TI
+} PSP_DMA_TI_Masks_enum;
+
+/*
+--| NAME: PSP_DMA_Peripheral_t
+--| DESCRIPTION: DREQ peripheral numbers, used in the PERMAP field of TI
+*/
+typedef enum PSP_DMA_Peripheral_Type
+{
+    PSP_DMA_PERIPHERAL_NONE    = 0u,  // no DREQ, DMA runs flat out
+    PSP_DMA_PERIPHERAL_PCM_TX  = 2u,  // PCM TX
+    PSP_DMA_PERIPHERAL_PCM_RX  = 3u,  // PCM RX
+    PSP_DMA_PERIPHERAL_PWM     = 5u,  // PWM
+    PSP_DMA_PERIPHERAL_SPI_TX  = 6u,  // SPI 0 TX
+    PSP_DMA_PERIPHERAL_SPI_RX  = 7u,  // SPI 0 RX
+    PSP_DMA_PERIPHERAL_UART_TX = 12u, // UART 0 (PL011) TX
+    PSP_DMA_PERIPHERAL_UART_RX = 14u, // UART 0 (PL011) RX
+} PSP_DMA_Peripheral_t;
+
+/*
+--| NAME: PSP_DMA_Callback_t
+--| DESCRIPTION: function called when a channel finishes its control block chain
+*/
+typedef void (*PSP_DMA_Callback_t)(uint32_t channel);
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC CONSTANTS
+--|----------------------------------------------------------------------------|
+*/
+
+/* None */
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC VARIABLES
+--|----------------------------------------------------------------------------|
+*/
+
+/* None */
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC FUNCTION PROTOTYPES
+--|----------------------------------------------------------------------------|
+*/
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_DMA_Channel_Allocate
+
+Function Description:
+    Find a free DMA channel, enable it, reset it, and mark it as in use.
+
+    Full channels are handed out before lite channels.
+
+Inputs:
+    None
+
+Returns:
+    uint32_t: the allocated channel number, or PSP_DMA_NO_CHANNEL if every
+    usable channel is already in use.
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+uint32_t PSP_DMA_Channel_Allocate(void);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_DMA_Channel_Free
+
+Function Description:
+    Abort anything the channel is doing, forget its callback, and give the
+    channel back to the pool of free channels.
+
+Inputs:
+    channel: the channel to free.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+void PSP_DMA_Channel_Free(uint32_t channel);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_DMA_Channel_Is_Lite
+
+Function Description:
+    Check if a channel is a lite channel.
+
+Inputs:
+    channel: the channel to check.
+
+Returns:
+    uint32_t: true if the channel is a lite channel, else false.
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+uint32_t PSP_DMA_Channel_Is_Lite(uint32_t channel);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_DMA_Set_Callback
+
+Function Description:
+    Set the function to call when the channel finishes its control block
+    chain. The callback is called from PSP_DMA_Service.
+
+Inputs:
+    channel: the channel to attach the callback to.
+    callback: the function to call, or 0 for no callback.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+void PSP_DMA_Set_Callback(uint32_t channel, PSP_DMA_Callback_t callback);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_DMA_Set_Control_Block
+
+Function Description:
+    Fill in a control block for a plain, one dimensional transfer.
+
+Inputs:
+    p_control_block: the control block to fill in.
+    transfer_info: the TI word.
+    source: the source bus address.
+    dest: the destination bus address.
+    length: the number of bytes to move.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    The control block is left as the end of a chain, link it up afterwards
+    with PSP_DMA_Link_Control_Blocks if needed. The data cache is not cleaned.
+------------------------------------------------------------------------------*/
+void PSP_DMA_Set_Control_Block(PSP_DMA_Control_Block_t * p_control_block,
+                               uint32_t transfer_info,
+                               uint32_t source,
+                               uint32_t dest,
+                               uint32_t length);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_DMA_Link_Control_Blocks
+
+Function Description:
+    Chain an array of control blocks together in order, optionally looping
+    the last one back to the first so the channel runs forever.
+
+Inputs:
+    p_control_blocks: the control blocks to chain.
+    num_blocks: the number of control blocks.
+    is_loop: true to link the last control block back to the first, false
+    to leave it as the end of the chain.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    The data cache is not cleaned.
+------------------------------------------------------------------------------*/
+void PSP_DMA_Link_Control_Blocks(PSP_DMA_Control_Block_t * p_control_blocks,
+                                 uint32_t num_blocks,
+                                 uint32_t is_loop);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_DMA_Start
+
+Function Description:
+    Start a channel running the given chain of control blocks.
+
+Inputs:
+    channel: the channel to start.
+    p_control_block: pointer to the first control block in the chain.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    The channel must not be busy. Every control block in the chain must stay
+    valid until the channel is done with it.
+------------------------------------------------------------------------------*/
+void PSP_DMA_Start(uint32_t channel, PSP_DMA_Control_Block_t * p_control_block);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_DMA_Is_Busy
+
+Function Description:
+    Check if a channel is still working through its control block chain.
+
+Inputs:
+    channel: the channel to check.
+
+Returns:
+    uint32_t: true if the channel is active, else false.
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+uint32_t PSP_DMA_Is_Busy(uint32_t channel);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_DMA_Get_Dest_Address
+
+Function Description:
+    Read where a channel will write next, for following the progress of a
+    transfer that is still running.
+
+Inputs:
+    channel: the channel to check.
+
+Returns:
+    uint32_t: the bus address the channel writes to next, or 0 for an invalid
+    channel.
+
+Assumptions/Limitations:
+    Only meaningful for control blocks with PSP_DMA_TI_DEST_INC_FLAG set.
+------------------------------------------------------------------------------*/
+uint32_t PSP_DMA_Get_Dest_Address(uint32_t channel);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_DMA_Get_Control_Block_Address
+
+Function Description:
+    Read which control block a channel is working on, for following a chain
+    that loops back on itself and never finishes.
+
+Inputs:
+    channel: the channel to check.
+
+Returns:
+    uint32_t: the bus address of the current control block, or 0 for an
+    invalid channel.
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+uint32_t PSP_DMA_Get_Control_Block_Address(uint32_t channel);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_DMA_Clear_Interrupt
+
+Function Description:
+    Clear the interrupt a channel raised at the end of a control block with
+    PSP_DMA_TI_INTEN_FLAG set. For interrupt handlers of channels that are
+    not finished through PSP_DMA_Service.
+
+Inputs:
+    channel: the channel to clear.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+void PSP_DMA_Clear_Interrupt(uint32_t channel);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_DMA_Abort
+
+Function Description:
+    Stop a channel and reset it. The completion callback is not called.
+
+Inputs:
+    channel: the channel to stop.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+void PSP_DMA_Abort(uint32_t channel);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_DMA_Service
+
+Function Description:
+    Check every allocated channel for a finished control block chain and call
+    the completion callback of each channel that has finished.
+
+    Call this from the main loop, or from an interrupt handler.
+
+Inputs:
+    None
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+void PSP_DMA_Service(void);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_DMA_Bus_Address
+
+Function Description:
+    Convert the ARM address of something in RAM to the bus address the DMA
+    engine uses for it. The uncached alias is used, so the DMA engine never
+    sees stale data from the GPU L2 cache.
+
+Inputs:
+    p_memory: pointer to the memory.
+
+Returns:
+    uint32_t: the bus address.
+
+Assumptions/Limitations:
+    Only valid for RAM, use PSP_DMA_Peripheral_Bus_Address for registers.
+------------------------------------------------------------------------------*/
+uint32_t PSP_DMA_Bus_Address(const void * p_memory);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_DMA_Peripheral_Bus_Address
+
+Function Description:
+    Convert the ARM address of a peripheral register to its bus address.
+
+Inputs:
+    register_address: the ARM address of the register, for example
+    PSP_REGS_SPI_0_BASE_ADDRESS + 4 for the SPI 0 FIFO.
+
+Returns:
+    uint32_t: the bus address.
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+uint32_t PSP_DMA_Peripheral_Bus_Address(uint32_t register_address);
+
+#endif
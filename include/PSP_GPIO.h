@@ -5,6 +5,11 @@
 --|  provided for setting the pin mode of GPIO pins, reading the
 --|  level of GPIO pins, and setting the level of GPIO pins which
 --|  are set to outputs.
+--|
+--|  The port functions work on 32 pins at a time, port 0 is pins 0 to 31 and
+--|  port 1 is pins 32 to 53, bit n of a port mask is pin 32 * port + n. Each
+--|  port write is a single store to GPSETn or GPCLRn, so any number of pins
+--|  in a port change together.
 --|  
 --|----------------------------------------------------------------------------|
 --| REFERENCES:
@@ -30,7 +35,12 @@
 --|----------------------------------------------------------------------------|
 */
 
-/* None */
+/*
+--| NAME: PSP_GPIO_SNAPSHOT_PIN
+--| DESCRIPTION: the level (0 or 1) of a pin in a PSP_GPIO_Read_All_Pins snapshot
+--| TYPE: macro
+*/
+#define PSP_GPIO_SNAPSHOT_PIN(snapshot, pin_num) ((uint32_t)((snapshot) >> (pin_num)) & 1u)
 
 /*
 --|----------------------------------------------------------------------------|
@@ -56,6 +66,16 @@ typedef enum GPIO_Pin_Mode_Enumeration
     PSP_GPIO_MAX_PINMODE_VAL = PSP_GPIO_PINMODE_ALT3,
 } GPIO_Pin_Mode_enum;
 
+/*
+--| NAME: PSP_GPIO_Port_t
+--| DESCRIPTION: the two banks of 32 pins the port functions work on
+*/
+typedef enum PSP_GPIO_Port_Type
+{
+    PSP_GPIO_PORT_0 = 0u, // pins 0 to 31
+    PSP_GPIO_PORT_1 = 1u, // pins 32 to 53
+} PSP_GPIO_Port_t;
+
 /*
 --| NAME: PSP_GPIO_Edge_Detect_enum
 --| DESCRIPTION: enumeration for GPIO edge detect types
@@ -237,4 +257,126 @@ Assumptions/Limitations:
 ------------------------------------------------------------------------------*/
 PSP_GPIO_Edge_Detect_Reading_enum PSP_GPIO_Event_Detected(uint32_t pin_num);
 
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_GPIO_Set_Pins_Mode
+
+Function Description:
+    Set any number of GPIO pins to the same mode, with one update of each 
+    GPFSELn register that holds some of the pins.
+
+Inputs:
+    pin_mask: bit n set to change the mode of pin n.
+    pin_mode: the GPIO pin mode, see PSP_GPIO_Set_Pin_Mode.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    Returns without having any effect if the pin mode is invalid. Bits above 
+    pin 53 are ignored.
+------------------------------------------------------------------------------*/
+void PSP_GPIO_Set_Pins_Mode(uint64_t pin_mask, GPIO_Pin_Mode_enum pin_mode);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_GPIO_Port_Set
+
+Function Description:
+    Write the pins of a port high, in a single store.
+
+Inputs:
+    port: the port the pins are in.
+    pin_mask: bit n set to write pin 32 * port + n high, clear bits leave 
+    their pins alone.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    Returns without having any effect if the port is invalid. Only affects 
+    pins set to Output, see PSP_GPIO_Write_Pin.
+------------------------------------------------------------------------------*/
+void PSP_GPIO_Port_Set(PSP_GPIO_Port_t port, uint32_t pin_mask);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_GPIO_Port_Clear
+
+Function Description:
+    Write the pins of a port low, in a single store.
+
+Inputs:
+    port: the port the pins are in.
+    pin_mask: bit n set to write pin 32 * port + n low, clear bits leave 
+    their pins alone.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    Returns without having any effect if the port is invalid. Only affects 
+    pins set to Output, see PSP_GPIO_Write_Pin.
+------------------------------------------------------------------------------*/
+void PSP_GPIO_Port_Clear(PSP_GPIO_Port_t port, uint32_t pin_mask);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_GPIO_Port_Write
+
+Function Description:
+    Write a value to the masked pins of a port, one store to GPSETn for the 
+    pins going high and one store to GPCLRn for the pins going low.
+
+Inputs:
+    port: the port the pins are in.
+    pin_mask: bit n set to write pin 32 * port + n, clear bits leave their 
+    pins alone.
+    value: bit n is the level to write to pin 32 * port + n.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    Returns without having any effect if the port is invalid. The pins going 
+    high change a few cycles before the pins going low.
+------------------------------------------------------------------------------*/
+void PSP_GPIO_Port_Write(PSP_GPIO_Port_t port, uint32_t pin_mask, uint32_t value);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_GPIO_Port_Read
+
+Function Description:
+    Read the levels of all the pins of a port at once.
+
+Inputs:
+    port: the port to read.
+
+Returns:
+    uint32_t: bit n is the level of pin 32 * port + n.
+
+Assumptions/Limitations:
+    Returns 0 if the port is invalid.
+------------------------------------------------------------------------------*/
+uint32_t PSP_GPIO_Port_Read(PSP_GPIO_Port_t port);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_GPIO_Read_All_Pins
+
+Function Description:
+    Take a snapshot of the levels of all 54 pins, with two register reads.
+
+Inputs:
+    None
+
+Returns:
+    uint64_t: bit n is the level of pin n, see PSP_GPIO_SNAPSHOT_PIN.
+
+Assumptions/Limitations:
+    Port 0 is read just before port 1, the two halves are a few cycles apart.
+------------------------------------------------------------------------------*/
+uint64_t PSP_GPIO_Read_All_Pins(void);
+
 #endif
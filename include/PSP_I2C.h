@@ -9,7 +9,21 @@
 --|      I'll need to set up some I2C device to talk back to the Pi and run some
 --|      tests. Until then, consider reading data to be broken.
 --|
---|      TODO: Add functions to read/write more than one byte at a time.
+--|      A whole buffer goes in one transaction, with the 16 byte FIFO topped up
+--|      (or emptied) while the bus runs, so there is one start, one address and
+--|      one stop however many bytes there are. PSP_I2C_Write_Then_Read writes
+--|      a register address and reads the register back with a repeated start
+--|      in between, the usual way to read sensor registers.
+--|
+--|      After PSP_I2C_Enable_Interrupts, transactions can also be queued with
+--|      PSP_I2C_Submit and run back to back from the I2C interrupt, while the
+--|      caller gets on with other work. Don't mix the blocking calls with
+--|      queued transactions, only use them while PSP_I2C_Is_Busy is false.
+--|
+--|      Several devices can share the bus. Each one is described once by a
+--|      PSP_I2C_Device_t with its address and bus timing. Selecting a device
+--|      only writes the registers that differ from what the controller already
+--|      has, so back to back transfers to one device cost only their bytes.
 --|  
 --|----------------------------------------------------------------------------|
 --| REFERENCES:
@@ -43,13 +57,94 @@
 #define I2C_SDA_PIN (2u)
 #define I2C_SCL_PIN (3u)
 
+/*
+--| NAME: PSP_I2C_FIFO_SIZE
+--| DESCRIPTION: bytes the I2C FIFO holds
+--| TYPE: uint32_t
+*/
+#define PSP_I2C_FIFO_SIZE (16u)
+
+/*
+--| NAME: PSP_I2C_MAX_LENGTH
+--| DESCRIPTION: the most bytes in one transfer, DLEN is 16 bits
+--| TYPE: uint32_t
+*/
+#define PSP_I2C_MAX_LENGTH (0xFFFFu)
+
+/*
+--| NAME: PSP_I2C_DEFAULT_xxx
+--| DESCRIPTION: the reset values of the timing registers, DIV gives ~100 kHz
+--| TYPE: uint32_t
+*/
+#define PSP_I2C_DEFAULT_DIVIDER               (0x05DCu)
+#define PSP_I2C_DEFAULT_DELAY                 (0x00300030u)
+#define PSP_I2C_DEFAULT_CLOCK_STRETCH_TIMEOUT (0x0040u)
+
+/*
+--| NAME: PSP_I2C_SCAN_xxx_ADDRESS
+--| DESCRIPTION: the range of addresses a bus scan tries, the rest are reserved
+--| TYPE: uint32_t
+*/
+#define PSP_I2C_SCAN_FIRST_ADDRESS (0x08u)
+#define PSP_I2C_SCAN_LAST_ADDRESS  (0x77u)
+
 /*
 --|----------------------------------------------------------------------------|
 --| PUBLIC TYPES
 --|----------------------------------------------------------------------------|
 */
 
-/* None */
+/*
+--| NAME: PSP_I2C_Status_t
+--| DESCRIPTION: how an I2C transfer ended
+*/
+typedef enum I2C_Status_Type
+{
+    PSP_I2C_Status_OK                    = 0u, // all bytes transferred
+    PSP_I2C_Status_No_Ack                = 1u, // the slave did not acknowledge its address or a byte (ERR)
+    PSP_I2C_Status_Clock_Stretch_Timeout = 2u, // the slave held SCL low for too long (CLKT)
+    PSP_I2C_Status_Invalid_Length        = 3u, // the length was 0 or too long, nothing was sent
+} PSP_I2C_Status_t;
+
+/*
+--| NAME: PSP_I2C_Device_t
+--| DESCRIPTION: a device on the bus, with the bus timing it needs
+*/
+typedef struct PSP_I2C_Device_Type
+{
+    uint32_t address;               // the 7 bit slave address
+    uint32_t divider;               // DIV, SCL = core clock / divider
+    uint32_t delay;                 // DEL, falling edge delay << 16 | rising edge delay
+    uint32_t clock_stretch_timeout; // CLKT, SCL cycles the slave may stretch for, 0 for no limit
+} PSP_I2C_Device_t;
+
+struct PSP_I2C_Transaction_Type;
+
+/*
+--| NAME: PSP_I2C_Callback_t
+--| DESCRIPTION: called from the I2C interrupt when a transaction is done, 
+--|   with the transaction
+*/
+typedef void (*PSP_I2C_Callback_t)(struct PSP_I2C_Transaction_Type * p_transaction);
+
+/*
+--| NAME: PSP_I2C_Transaction_t
+--| DESCRIPTION: a queued I2C transaction, a write, a read, or a write then a
+--|   read after a repeated start. The caller fills in the first fields, the
+--|   rest are managed by PSP_I2C.
+*/
+typedef struct PSP_I2C_Transaction_Type
+{
+    const PSP_I2C_Device_t * p_device;            // the device to talk to
+    const uint8_t * p_write_buffer;               // the bytes to write first
+    uint32_t num_write_bytes;                     // 0 for a read only
+    uint8_t * p_read_buffer;                      // where to put the bytes read
+    uint32_t num_read_bytes;                      // 0 for a write only
+    PSP_I2C_Callback_t callback;                  // called when done, 0 for none
+    volatile PSP_I2C_Status_t status;             // how the transaction ended, once done
+    volatile uint32_t is_done;                    // set once the transaction is over
+    struct PSP_I2C_Transaction_Type * p_next;     // next in the queue
+} PSP_I2C_Transaction_t;
 
 /*
 --|----------------------------------------------------------------------------|
@@ -152,6 +247,70 @@ Assumptions/Limitations:
 ------------------------------------------------------------------------------*/
 void PSP_I2C_Set_Slave_Address(uint32_t address);
 
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_I2C_Device_Init
+
+Function Description:
+    Fill in a device with its address and clock divider, and the default 
+    delay and clock stretch timeout.
+
+Inputs:
+    p_device: the device.
+    address: the 7 bit address of the device.
+    divider: the clock divider, see PSP_I2C_Set_Clock_Divider.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    Change the delay and clock_stretch_timeout fields afterwards for a device
+    that needs other timing.
+------------------------------------------------------------------------------*/
+void PSP_I2C_Device_Init(PSP_I2C_Device_t * p_device, uint32_t address, uint32_t divider);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_I2C_Select_Device
+
+Function Description:
+    Make the blocking calls talk to a device. Only the address and timing
+    registers that are different from the last device are written.
+
+Inputs:
+    p_device: the device.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    Not while PSP_I2C_Is_Busy, queued transactions select their own device.
+------------------------------------------------------------------------------*/
+void PSP_I2C_Select_Device(const PSP_I2C_Device_t * p_device);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_I2C_Scan
+
+Function Description:
+    Find the devices on the bus by trying a 1 byte read from each address,
+    PSP_I2C_SCAN_FIRST_ADDRESS to PSP_I2C_SCAN_LAST_ADDRESS. A read is used
+    as the probe since it can't change a device's registers.
+
+Inputs:
+    p_addresses: where to put the addresses that answered.
+    max_addresses: the most addresses p_addresses can take.
+
+Returns:
+    uint32_t: the number of devices that answered, which can be more than
+    max_addresses.
+
+Assumptions/Limitations:
+    Uses the current bus timing. Blocks for the whole scan, about 100 uSec
+    per empty address at 100 kHz. Not while PSP_I2C_Is_Busy.
+------------------------------------------------------------------------------*/
+uint32_t PSP_I2C_Scan(uint8_t * p_addresses, uint32_t max_addresses);
+
 /*------------------------------------------------------------------------------
 Function Name:
     PSP_I2C_Write_Byte
@@ -163,12 +322,141 @@ Inputs:
     val: the byte to write.
 
 Returns:
-    None (TODO: this should return some error/ok code in the future that
-    specifies if the transmission was succesful)
+    None, use PSP_I2C_Write to find out if the slave acknowledged.
 
 Assumptions/Limitations:
     None
 ------------------------------------------------------------------------------*/
 void PSP_I2C_Write_Byte(uint8_t val);
 
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_I2C_Write
+
+Function Description:
+    Writes a buffer to the address in the I2C address register, in one 
+    transaction.
+
+Inputs:
+    p_buffer: the bytes to write.
+    num_bytes: the number of bytes, 1 to PSP_I2C_MAX_LENGTH.
+
+Returns:
+    PSP_I2C_Status_t: how the transfer ended.
+
+Assumptions/Limitations:
+    Blocks until the transfer is done.
+------------------------------------------------------------------------------*/
+PSP_I2C_Status_t PSP_I2C_Write(const uint8_t * p_buffer, uint32_t num_bytes);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_I2C_Read
+
+Function Description:
+    Reads into a buffer from the address in the I2C address register, in one
+    transaction.
+
+Inputs:
+    p_buffer: where to put the bytes read.
+    num_bytes: the number of bytes, 1 to PSP_I2C_MAX_LENGTH.
+
+Returns:
+    PSP_I2C_Status_t: how the transfer ended. On an error the buffer holds
+    whatever arrived before it.
+
+Assumptions/Limitations:
+    Blocks until the transfer is done.
+------------------------------------------------------------------------------*/
+PSP_I2C_Status_t PSP_I2C_Read(uint8_t * p_buffer, uint32_t num_bytes);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_I2C_Write_Then_Read
+
+Function Description:
+    Writes to the address in the I2C address register, then reads back from
+    it after a repeated start, without a stop in between. Usually used to
+    write a register number and read the register(s) from there on.
+
+Inputs:
+    p_write_buffer: the bytes to write.
+    num_write_bytes: the number of bytes to write, 1 to PSP_I2C_FIFO_SIZE.
+    p_read_buffer: where to put the bytes read.
+    num_read_bytes: the number of bytes to read, 1 to PSP_I2C_MAX_LENGTH.
+
+Returns:
+    PSP_I2C_Status_t: how the transfer ended.
+
+Assumptions/Limitations:
+    The controller has no repeated start of its own. The read is queued as 
+    soon as the write has started, and the controller runs it straight on
+    with a repeated start. So the whole write has to be in the FIFO up
+    front, and IRQs are masked for the few cycles until the read is queued.
+
+    Blocks until the transfer is done.
+------------------------------------------------------------------------------*/
+PSP_I2C_Status_t PSP_I2C_Write_Then_Read(const uint8_t * p_write_buffer, 
+                                         uint32_t num_write_bytes, 
+                                         uint8_t * p_read_buffer, 
+                                         uint32_t num_read_bytes);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_I2C_Enable_Interrupts
+
+Function Description:
+    Start the interrupt driven transaction queue.
+
+Inputs:
+    None
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    PSP_IRQ_Init must be called first, and IRQs enabled for the queue to run.
+------------------------------------------------------------------------------*/
+void PSP_I2C_Enable_Interrupts(void);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_I2C_Submit
+
+Function Description:
+    Add a transaction to the end of the queue. It starts straight away if 
+    the bus is idle.
+
+Inputs:
+    p_transaction: the transaction, which must stay in place, along with its
+    buffers, until it is done.
+
+Returns:
+    uint32_t: true if the transaction was queued, false if both lengths are
+    0 or either is more than PSP_I2C_MAX_LENGTH.
+
+Assumptions/Limitations:
+    PSP_I2C_Enable_Interrupts must be called first. Can be called from a
+    transaction's callback to queue another.
+------------------------------------------------------------------------------*/
+uint32_t PSP_I2C_Submit(PSP_I2C_Transaction_t * p_transaction);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_I2C_Is_Busy
+
+Function Description:
+    Check if there are queued transactions still to finish.
+
+Inputs:
+    None
+
+Returns:
+    uint32_t: true if the queue is running.
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+uint32_t PSP_I2C_Is_Busy(void);
+
 #endif
@@ -0,0 +1,323 @@
+/*
+--|----------------------------------------------------------------------------|
+--| FILE DESCRIPTION:
+--|   PSP_IRQ provides an interface for the ARM interrupt controller and the
+--|   per core local interrupt routing. Functions are provided for registering
+--|   a handler per interrupt source, enabling and disabling sources, and
+--|   masking IRQs on the calling core.
+--|
+--|----------------------------------------------------------------------------|
+--| NOTES:
+--|     Every interrupt source has a number:
+--|       0 to 63:  GPU peripheral interrupts, same numbering as the datasheet
+--|       64 to 71: ARM basic interrupts (ARM timer, doorbells, ...)
+--|       72 to 83: local interrupts of the core, bit n of the core's IRQ source
+--|                 register is source 72 + n
+--|
+--|     GPU and basic interrupts all go to one core, core 0 unless changed
+--|     with PSP_IRQ_Route_GPU_To_Core. Local interrupts are per core, enabling
+--|     or disabling one only affects the core that makes the call.
+--|
+--|     Handlers run in SVC mode with IRQs masked, on the stack of the core
+--|     that took the interrupt. A handler must clear the cause of its
+--|     interrupt in the peripheral, or it is called again straight away.
+--|
+--|     A source that fires without a registered handler is disabled.
+--|
+--|----------------------------------------------------------------------------|
+--| REFERENCES:
+--|   BCM2837-ARM-Peripherals.pdf page 109
+--|   QA7_rev3.4.pdf pages 13 to 18 (local interrupt routing)
+--|
+--|----------------------------------------------------------------------------|
+*/
+
+#ifndef PSP_IRQ_H_INCLUDED
+#define PSP_IRQ_H_INCLUDED
+
+/*
+--|----------------------------------------------------------------------------|
+--| INCLUDE FILES
+--|----------------------------------------------------------------------------|
+*/
+
+#include "Fixed_Width_Ints.h"
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC DEFINES
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--| NAME: PSP_IRQ_NUM_SOURCES
+--| DESCRIPTION: the number of interrupt sources
+--| TYPE: uint32_t
+*/
+#define PSP_IRQ_NUM_SOURCES (84u)
+
+/*
+--| NAME: PSP_IRQ_xxx_FIRST_SOURCE
+--| DESCRIPTION: the first source number of each group of sources
+--| TYPE: uint32_t
+*/
+#define PSP_IRQ_GPU_FIRST_SOURCE   (0u)
+#define PSP_IRQ_BASIC_FIRST_SOURCE (64u)
+#define PSP_IRQ_LOCAL_FIRST_SOURCE (72u)
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC TYPES
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--| NAME: PSP_IRQ_Source_t
+--| DESCRIPTION: the commonly used interrupt sources
+*/
+typedef enum IRQ_Source_Type
+{
+    PSP_IRQ_SOURCE_SYSTEM_TIMER_1 = 1u,
+    PSP_IRQ_SOURCE_SYSTEM_TIMER_3 = 3u,
+    PSP_IRQ_SOURCE_USB            = 9u,
+    PSP_IRQ_SOURCE_DMA_0          = 16u, // DMA channel n is source 16 + n, up to channel 12
+    PSP_IRQ_SOURCE_DMA_12         = 28u,
+    PSP_IRQ_SOURCE_AUX            = 29u,
+    PSP_IRQ_SOURCE_GPIO_0         = 49u,
+    PSP_IRQ_SOURCE_GPIO_1         = 50u,
+    PSP_IRQ_SOURCE_GPIO_2         = 51u,
+    PSP_IRQ_SOURCE_GPIO_3         = 52u,
+    PSP_IRQ_SOURCE_I2C            = 53u,
+    PSP_IRQ_SOURCE_SPI            = 54u,
+    PSP_IRQ_SOURCE_PCM            = 55u,
+    PSP_IRQ_SOURCE_UART           = 57u,
+
+    PSP_IRQ_SOURCE_ARM_TIMER      = 64u,
+    PSP_IRQ_SOURCE_ARM_MAILBOX    = 65u,
+    PSP_IRQ_SOURCE_ARM_DOORBELL_0 = 66u,
+    PSP_IRQ_SOURCE_ARM_DOORBELL_1 = 67u,
+
+    PSP_IRQ_SOURCE_CNTPS          = 72u, // secure physical timer
+    PSP_IRQ_SOURCE_CNTPNS         = 73u, // non secure physical timer
+    PSP_IRQ_SOURCE_CNTHP          = 74u, // hypervisor timer
+    PSP_IRQ_SOURCE_CNTV           = 75u, // virtual timer
+    PSP_IRQ_SOURCE_MAILBOX_0      = 76u, // mailbox n is source 76 + n
+    PSP_IRQ_SOURCE_MAILBOX_3      = 79u,
+    PSP_IRQ_SOURCE_PMU            = 81u,
+} PSP_IRQ_Source_t;
+
+/*
+--| NAME: PSP_IRQ_Handler_t
+--| DESCRIPTION: an interrupt handler, called with the source that fired
+*/
+typedef void (*PSP_IRQ_Handler_t)(uint32_t source);
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC CONSTANTS
+--|----------------------------------------------------------------------------|
+*/
+
+/* None */
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC VARIABLES
+--|----------------------------------------------------------------------------|
+*/
+
+/* None */
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC FUNCTION PROTOTYPES
+--|----------------------------------------------------------------------------|
+*/
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_IRQ_Init
+
+Function Description:
+    Disable every GPU and basic interrupt source, and route them to core 0.
+
+Inputs:
+    None
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    Should be called once from core 0, before any source is enabled.
+------------------------------------------------------------------------------*/
+void PSP_IRQ_Init(void);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_IRQ_Register_Handler
+
+Function Description:
+    Set the function called when an interrupt source fires.
+
+Inputs:
+    source: the interrupt source.
+    handler: the function to call, 0 for none.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    Does not enable the source, call PSP_IRQ_Enable_Source after.
+------------------------------------------------------------------------------*/
+void PSP_IRQ_Register_Handler(uint32_t source, PSP_IRQ_Handler_t handler);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_IRQ_Enable_Source
+
+Function Description:
+    Let an interrupt source interrupt the CPU.
+
+Inputs:
+    source: the interrupt source.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    Local sources are enabled for the calling core only. The GPU, AXI and
+    local timer local sources can not be enabled here, invalid sources are
+    ignored.
+------------------------------------------------------------------------------*/
+void PSP_IRQ_Enable_Source(uint32_t source);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_IRQ_Disable_Source
+
+Function Description:
+    Stop an interrupt source from interrupting the CPU.
+
+Inputs:
+    source: the interrupt source.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    Local sources are disabled for the calling core only.
+------------------------------------------------------------------------------*/
+void PSP_IRQ_Disable_Source(uint32_t source);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_IRQ_Route_GPU_To_Core
+
+Function Description:
+    Send all GPU and basic interrupts to a given core.
+
+Inputs:
+    core_id: the core to take the interrupts, 0 to 3.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+void PSP_IRQ_Route_GPU_To_Core(uint32_t core_id);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_IRQ_Enable
+
+Function Description:
+    Unmask IRQs on the calling core.
+
+Inputs:
+    None
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+void PSP_IRQ_Enable(void);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_IRQ_Disable
+
+Function Description:
+    Mask IRQs on the calling core.
+
+Inputs:
+    None
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+void PSP_IRQ_Disable(void);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_IRQ_Save_And_Disable
+
+Function Description:
+    Mask IRQs on the calling core, returning whether they were masked before.
+    Used with PSP_IRQ_Restore around a critical section, so critical sections
+    can nest.
+
+Inputs:
+    None
+
+Returns:
+    uint32_t: the previous IRQ mask state, to pass to PSP_IRQ_Restore.
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+uint32_t PSP_IRQ_Save_And_Disable(void);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_IRQ_Restore
+
+Function Description:
+    Put the IRQ mask of the calling core back the way PSP_IRQ_Save_And_Disable
+    found it.
+
+Inputs:
+    state: the value returned by PSP_IRQ_Save_And_Disable.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+void PSP_IRQ_Restore(uint32_t state);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_IRQ_Dispatch
+
+Function Description:
+    Call the handler of every pending interrupt source of the calling core.
+
+Inputs:
+    None
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    Called from the IRQ vector in start.s, not meant to be called directly.
+------------------------------------------------------------------------------*/
+void PSP_IRQ_Dispatch(void);
+
+#endif
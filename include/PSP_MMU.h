@@ -0,0 +1,204 @@
+/*
+--|----------------------------------------------------------------------------|
+--| FILE DESCRIPTION:
+--|   PSP_MMU sets up a flat (virtual address == physical address) memory map
+--|   and turns on the MMU, the instruction and data caches and branch
+--|   prediction. Functions are also provided for keeping the data cache in
+--|   step with memory that the DMA engine reads or writes.
+--|
+--|----------------------------------------------------------------------------|
+--| NOTES:
+--|     PSP_MMU_Init is called from start.s before main when the image is built
+--|     with MMU = 1 in the Makefile, application code does not need to call it.
+--|
+--|     RAM below PSP_REGS_PERIPHERAL_BASE_ADDRESS is mapped as normal write
+--|     back cacheable memory. Everything from PSP_REGS_PERIPHERAL_BASE_ADDRESS
+--|     up is mapped as device memory, so register accesses are never cached
+--|     and never executed from.
+--|
+--|     The DMA engine does not see the ARM caches. Memory the CPU wrote must be
+--|     cleaned before a DMA reads it, and memory a DMA wrote must be
+--|     invalidated before the CPU reads it. The cache functions work on whole
+--|     cache lines, so DMA buffers are best kept cache line aligned.
+--|
+--|----------------------------------------------------------------------------|
+--| REFERENCES:
+--|   ARM Architecture Reference Manual ARMv7-A, B3.5 (short descriptors)
+--|   Cortex-A53 MPCore Technical Reference Manual, 4.3 (AArch32 registers)
+--|
+--|----------------------------------------------------------------------------|
+*/
+
+#ifndef PSP_MMU_H_INCLUDED
+#define PSP_MMU_H_INCLUDED
+
+/*
+--|----------------------------------------------------------------------------|
+--| INCLUDE FILES
+--|----------------------------------------------------------------------------|
+*/
+
+#include "Fixed_Width_Ints.h"
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC DEFINES
+--|----------------------------------------------------------------------------|
+*/
+
+/* None */
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC TYPES
+--|----------------------------------------------------------------------------|
+*/
+
+/* None */
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC CONSTANTS
+--|----------------------------------------------------------------------------|
+*/
+
+/* None */
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC VARIABLES
+--|----------------------------------------------------------------------------|
+*/
+
+/* None */
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC FUNCTION PROTOTYPES
+--|----------------------------------------------------------------------------|
+*/
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_MMU_Init
+
+Function Description:
+    Build the translation table, invalidate the caches, TLBs and branch
+    predictor, then turn on the MMU, data cache, instruction cache and branch
+    prediction.
+
+Inputs:
+    None
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    Must be called in a privileged mode other than HYP, start.s takes care of
+    leaving HYP mode. Must only be called once.
+------------------------------------------------------------------------------*/
+void PSP_MMU_Init(void);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_MMU_Init_Secondary_Core
+
+Function Description:
+    Turn on the MMU, data cache, instruction cache and branch prediction on
+    core 1, 2 or 3, using the translation table core 0 built.
+
+Inputs:
+    None
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    Called from start.s when a core is released by PSP_Core_Start, after 
+    PSP_MMU_Init has run on core 0. Must be called on the core being set up.
+------------------------------------------------------------------------------*/
+void PSP_MMU_Init_Secondary_Core(void);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_MMU_Is_Enabled
+
+Function Description:
+    Check whether the MMU is on.
+
+Inputs:
+    None
+
+Returns:
+    uint32_t: true if the MMU is on, else false.
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+uint32_t PSP_MMU_Is_Enabled(void);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_MMU_Clean_Data_Cache
+
+Function Description:
+    Write any cached changes in a range of memory back to memory, so that the
+    DMA engine reads what the CPU wrote.
+
+Inputs:
+    p_start: the start of the range.
+    num_bytes: the length of the range in bytes.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    Works on whole cache lines, the lines the range starts and ends in are
+    cleaned completely. Safe to call with the data cache off.
+------------------------------------------------------------------------------*/
+void PSP_MMU_Clean_Data_Cache(const void * p_start, uint32_t num_bytes);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_MMU_Invalidate_Data_Cache
+
+Function Description:
+    Throw away anything cached for a range of memory, so that the next CPU read
+    gets what the DMA engine wrote.
+
+Inputs:
+    p_start: the start of the range.
+    num_bytes: the length of the range in bytes.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    Works on whole cache lines. Changes the CPU made to other data sharing the
+    first or last cache line of the range, and not yet cleaned, are lost.
+    Safe to call with the data cache off.
+------------------------------------------------------------------------------*/
+void PSP_MMU_Invalidate_Data_Cache(const void * p_start, uint32_t num_bytes);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_MMU_Clean_And_Invalidate_Data_Cache
+
+Function Description:
+    Write any cached changes in a range of memory back to memory and then throw
+    the cached copy away. Used on a buffer before handing it to a DMA that
+    writes to it, so no dirty line can later be written over the DMA's data.
+
+Inputs:
+    p_start: the start of the range.
+    num_bytes: the length of the range in bytes.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    Works on whole cache lines. Safe to call with the data cache off.
+------------------------------------------------------------------------------*/
+void PSP_MMU_Clean_And_Invalidate_Data_Cache(const void * p_start, uint32_t num_bytes);
+
+#endif
@@ -0,0 +1,420 @@
+/*
+--|----------------------------------------------------------------------------|
+--| FILE DESCRIPTION:
+--|   PSP_Mem provides allocators for memory with a lifetime shorter than the
+--|   program, without the fragmentation of a general purpose malloc:
+--|     - the heap, the RAM linker.ld leaves after the stacks, handed out once
+--|       and never given back, to back the other allocators
+--|     - arenas, bump allocators that are emptied all at once, such as once
+--|       per display frame
+--|     - pools of fixed size blocks, with O(1) alloc and free
+--|     - core pools, a pool for each core, where any core may free a block
+--|       without locks
+--|   Arenas and pools keep a high-water mark, the most they ever had in use.
+--|
+--|----------------------------------------------------------------------------|
+--| NOTES:
+--|     The heap, arenas and pools are not protected, use each from one core
+--|     and not from both an interrupt handler and the code it interrupts.
+--|
+--|     Core pools allocate from the pool of the calling core. A block freed on
+--|     the core that owns it goes straight back on its free list. A block
+--|     freed on another core is pushed on the owner's remote list with an
+--|     exclusive load/store, the owner takes the whole remote list back when
+--|     its free list runs out. The exclusive monitors only work on cacheable
+--|     memory, so core pools need the MMU on (MMU = 1 in the Makefile).
+--|
+--|     Usage:
+--|         static PSP_Mem_Arena_t frame_arena;
+--|         PSP_Mem_Arena_Init(&frame_arena, PSP_Mem_Heap_Alloc(0x10000u, 8u), 0x10000u);
+--|         while (1)
+--|         {
+--|             command_t * p_commands = PSP_Mem_Arena_Alloc(&frame_arena, size, 4u);
+--|             ... build and draw the frame ...
+--|             PSP_Mem_Arena_Reset(&frame_arena);
+--|         }
+--|
+--|----------------------------------------------------------------------------|
+--| REFERENCES:
+--|   ARM Architecture Reference Manual ARMv7-A, A3.4 (exclusive access)
+--|   Cortex-A53 MPCore Technical Reference Manual (internal exclusive monitor)
+--|
+--|----------------------------------------------------------------------------|
+*/
+
+#ifndef PSP_MEM_H_INCLUDED
+#define PSP_MEM_H_INCLUDED
+
+/*
+--|----------------------------------------------------------------------------|
+--| INCLUDE FILES
+--|----------------------------------------------------------------------------|
+*/
+
+#include "Fixed_Width_Ints.h"
+#include "PSP_Core.h"
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC DEFINES
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--| NAME: PSP_MEM_POOL_ALIGNMENT
+--| DESCRIPTION: the alignment of every pool block, block sizes are rounded up
+--|   to a multiple of this
+--| TYPE: uint32_t
+*/
+#define PSP_MEM_POOL_ALIGNMENT (8u)
+
+/*
+--| NAME: PSP_MEM_POOL_BUFFER_SIZE
+--| DESCRIPTION: the bytes a pool buffer needs for a number of blocks
+--| TYPE: uint32_t
+*/
+#define PSP_MEM_POOL_BUFFER_SIZE(block_size, num_blocks) \
+    ((((block_size) + PSP_MEM_POOL_ALIGNMENT - 1u) & ~(PSP_MEM_POOL_ALIGNMENT - 1u)) * (num_blocks))
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC TYPES
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--| NAME: PSP_Mem_Arena_t
+--| DESCRIPTION: a bump allocator over a buffer
+*/
+typedef struct PSP_Mem_Arena_Type
+{
+    uint8_t * p_start;   // the buffer
+    uint32_t size;       // bytes in the buffer
+    uint32_t used;       // bytes handed out since the last reset, including alignment padding
+    uint32_t high_water; // the most bytes ever used
+} PSP_Mem_Arena_t;
+
+/*
+--| NAME: PSP_Mem_Pool_t
+--| DESCRIPTION: a pool of fixed size blocks, the free blocks are linked
+--|   through their first word
+*/
+typedef struct PSP_Mem_Pool_Type
+{
+    void * p_free;       // first free block, 0 when all are in use
+    uint8_t * p_start;   // the buffer
+    uint8_t * p_end;     // one past the last block
+    uint32_t block_size; // bytes per block, a multiple of PSP_MEM_POOL_ALIGNMENT
+    uint32_t num_used;   // blocks allocated now
+    uint32_t high_water; // the most blocks ever allocated at once
+} PSP_Mem_Pool_t;
+
+/*
+--| NAME: PSP_Mem_Core_Pools_t
+--| DESCRIPTION: a pool for each core, and a list of blocks other cores have
+--|   freed back to each
+*/
+typedef struct PSP_Mem_Core_Pools_Type
+{
+    PSP_Mem_Pool_t pools[PSP_CORE_NUM_CORES];    // only used by their own core
+    void * p_remote_free[PSP_CORE_NUM_CORES];    // pushed by the other cores, taken by the owner
+} PSP_Mem_Core_Pools_t;
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC CONSTANTS
+--|----------------------------------------------------------------------------|
+*/
+
+/* None */
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC VARIABLES
+--|----------------------------------------------------------------------------|
+*/
+
+/* None */
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC FUNCTION PROTOTYPES
+--|----------------------------------------------------------------------------|
+*/
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_Mem_Heap_Alloc
+
+Function Description:
+    Take memory from the heap for good, to back an arena, a pool or a large
+    buffer.
+
+Inputs:
+    num_bytes: the number of bytes.
+    alignment: the alignment in bytes, a power of 2.
+
+Returns:
+    void *: the memory, or 0 if the alignment is not a power of 2 or the
+    heap does not have enough left.
+
+Assumptions/Limitations:
+    Heap memory can not be freed. The memory is not zeroed.
+------------------------------------------------------------------------------*/
+void * PSP_Mem_Heap_Alloc(uint32_t num_bytes, uint32_t alignment);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_Mem_Heap_Get_Free
+
+Function Description:
+    Get how much of the heap is left.
+
+Inputs:
+    None
+
+Returns:
+    uint32_t: the bytes left, before any alignment padding.
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+uint32_t PSP_Mem_Heap_Get_Free(void);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_Mem_Arena_Init
+
+Function Description:
+    Set up an empty arena over a buffer.
+
+Inputs:
+    p_arena: the arena.
+    p_buffer: the buffer.
+    size: bytes in the buffer.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+void PSP_Mem_Arena_Init(PSP_Mem_Arena_t * p_arena, void * p_buffer, uint32_t size);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_Mem_Arena_Alloc
+
+Function Description:
+    Take memory from an arena, it stays allocated until the arena is reset.
+
+Inputs:
+    p_arena: the arena.
+    num_bytes: the number of bytes.
+    alignment: the alignment in bytes, a power of 2.
+
+Returns:
+    void *: the memory, or 0 if the alignment is not a power of 2 or the
+    arena does not have enough left.
+
+Assumptions/Limitations:
+    The memory is not zeroed.
+------------------------------------------------------------------------------*/
+void * PSP_Mem_Arena_Alloc(PSP_Mem_Arena_t * p_arena, uint32_t num_bytes, uint32_t alignment);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_Mem_Arena_Reset
+
+Function Description:
+    Free everything allocated from an arena at once.
+
+Inputs:
+    p_arena: the arena.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    Nothing allocated from the arena may be used afterwards.
+------------------------------------------------------------------------------*/
+void PSP_Mem_Arena_Reset(PSP_Mem_Arena_t * p_arena);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_Mem_Arena_Get_High_Water
+
+Function Description:
+    Get the most an arena has ever had allocated between resets.
+
+Inputs:
+    p_arena: the arena.
+
+Returns:
+    uint32_t: the bytes, including alignment padding.
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+uint32_t PSP_Mem_Arena_Get_High_Water(const PSP_Mem_Arena_t * p_arena);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_Mem_Pool_Init
+
+Function Description:
+    Set up a pool with all of its blocks free.
+
+Inputs:
+    p_pool: the pool.
+    p_buffer: the buffer, PSP_MEM_POOL_BUFFER_SIZE(block_size, num_blocks)
+    bytes long.
+    block_size: bytes per block, rounded up to PSP_MEM_POOL_ALIGNMENT.
+    num_blocks: the number of blocks.
+
+Returns:
+    uint32_t: true if the pool was set up, false if the buffer is not
+    PSP_MEM_POOL_ALIGNMENT aligned or the block size or number of blocks is
+    0.
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+uint32_t PSP_Mem_Pool_Init(PSP_Mem_Pool_t * p_pool, void * p_buffer, uint32_t block_size, uint32_t num_blocks);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_Mem_Pool_Alloc
+
+Function Description:
+    Take a block from a pool.
+
+Inputs:
+    p_pool: the pool.
+
+Returns:
+    void *: the block, or 0 if all are in use.
+
+Assumptions/Limitations:
+    The block is not zeroed.
+------------------------------------------------------------------------------*/
+void * PSP_Mem_Pool_Alloc(PSP_Mem_Pool_t * p_pool);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_Mem_Pool_Free
+
+Function Description:
+    Give a block back to its pool.
+
+Inputs:
+    p_pool: the pool.
+    p_block: the block, 0 is ignored.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    The block must have come from this pool and not already be free.
+------------------------------------------------------------------------------*/
+void PSP_Mem_Pool_Free(PSP_Mem_Pool_t * p_pool, void * p_block);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_Mem_Pool_Get_High_Water
+
+Function Description:
+    Get the most blocks a pool has ever had allocated at once.
+
+Inputs:
+    p_pool: the pool.
+
+Returns:
+    uint32_t: the number of blocks.
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+uint32_t PSP_Mem_Pool_Get_High_Water(const PSP_Mem_Pool_t * p_pool);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_Mem_Core_Pools_Init
+
+Function Description:
+    Set up a pool for each core, with the buffers taken from the heap.
+
+Inputs:
+    p_core_pools: the core pools.
+    block_size: bytes per block, rounded up to PSP_MEM_POOL_ALIGNMENT.
+    num_blocks: the number of blocks in each core's pool.
+
+Returns:
+    uint32_t: true if the pools were set up, false if the block size or
+    number of blocks is 0 or the heap does not have enough left.
+
+Assumptions/Limitations:
+    Must be called before any core uses the pools.
+------------------------------------------------------------------------------*/
+uint32_t PSP_Mem_Core_Pools_Init(PSP_Mem_Core_Pools_t * p_core_pools, uint32_t block_size, uint32_t num_blocks);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_Mem_Core_Pools_Alloc
+
+Function Description:
+    Take a block from the calling core's pool.
+
+Inputs:
+    p_core_pools: the core pools.
+
+Returns:
+    void *: the block, or 0 if all of the core's blocks are in use.
+
+Assumptions/Limitations:
+    Needs the MMU on. The block is not zeroed.
+------------------------------------------------------------------------------*/
+void * PSP_Mem_Core_Pools_Alloc(PSP_Mem_Core_Pools_t * p_core_pools);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_Mem_Core_Pools_Free
+
+Function Description:
+    Give a block back to the pool of the core it was allocated on, from any
+    core.
+
+Inputs:
+    p_core_pools: the core pools.
+    p_block: the block, 0 is ignored.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    Needs the MMU on. The block must have come from these pools and not
+    already be free.
+------------------------------------------------------------------------------*/
+void PSP_Mem_Core_Pools_Free(PSP_Mem_Core_Pools_t * p_core_pools, void * p_block);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_Mem_Core_Pools_Get_High_Water
+
+Function Description:
+    Get the most blocks a core's pool has ever had allocated at once.
+
+Inputs:
+    p_core_pools: the core pools.
+    core_id: the core, 0 to 3.
+
+Returns:
+    uint32_t: the number of blocks, 0 for an invalid core.
+
+Assumptions/Limitations:
+    Blocks freed by other cores count as allocated until the owning core
+    takes them back.
+------------------------------------------------------------------------------*/
+uint32_t PSP_Mem_Core_Pools_Get_High_Water(const PSP_Mem_Core_Pools_t * p_core_pools, uint32_t core_id);
+
+#endif
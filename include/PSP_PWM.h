@@ -9,6 +9,21 @@
 --|   Only GPIO12 and GPIO18 are available as channel 1 PWM pins and only GPIO13 
 --|   and GPIO19 are available as channel 2 PWM pins on the raspberry pi 3b+ 
 --|   breakout board.
+--|
+--|   The stream functions play stereo audio with both channels fed from the
+--|   PWM FIFO by DMA, channel 1 is left and channel 2 is right. The DMA runs
+--|   round a ring of PSP_PWM_STREAM_NUM_BLOCKS blocks and raises an
+--|   interrupt at the end of each one, the CPU only has to write the next
+--|   block while the others play. A block that has not been written plays
+--|   as silence. The sample rate is the PWM clock divided by the range, for
+--|   44.1kHz use PSP_PWM_Clock_Init(PSP_PWM_Clock_Source_PLL_D, 4u) for
+--|   125MHz and a range of 2834 (44.107kHz, about 11.5 bits).
+--|
+--|   The serializer functions put one channel in serializer mode and DMA a
+--|   buffer of words into the FIFO, each word is shifted out MSB first, one
+--|   bit per PWM clock. The output goes low once the FIFO runs dry. The
+--|   stream and the serializer share the FIFO, only one can be used at a
+--|   time.
 --|  
 --|----------------------------------------------------------------------------|
 --| REFERENCES:
@@ -61,6 +76,21 @@
 */
 #define PWM_DEFAULT_DIV (4u)                                    
 
+/*
+--| NAME: PSP_PWM_STREAM_BLOCK_FRAMES
+--| DESCRIPTION: stereo frames in a stream block, 5.8ms at 44.1kHz
+--| TYPE: uint32_t
+*/
+#define PSP_PWM_STREAM_BLOCK_FRAMES (256u)
+
+/*
+--| NAME: PSP_PWM_STREAM_NUM_BLOCKS
+--| DESCRIPTION: blocks in the stream ring, one plays while the rest are
+--|   written
+--| TYPE: uint32_t
+*/
+#define PSP_PWM_STREAM_NUM_BLOCKS (4u)
+
 /*
 --|----------------------------------------------------------------------------|
 --| PUBLIC TYPES
@@ -312,4 +342,168 @@ Assumptions/Limitations:
 ------------------------------------------------------------------------------*/
 void PSP_PWM_Ch2_Set_GPIO19_To_PWM_Mode(void);
 
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_PWM_Stream_Start
+
+Function Description:
+    Start channels 1 and 2 playing from the FIFO in M/S mode, fed by a DMA
+    channel looping round the stream ring. Every block starts out silent.
+
+Inputs:
+    range: the range of both channels, at most 0x10000. Sets the sample
+    rate along with the PWM clock.
+
+Returns:
+    uint32_t: true if the stream started, false if no DMA channel with an
+    interrupt was free.
+
+Assumptions/Limitations:
+    A clock init function must be called first. IRQs must be set up with
+    PSP_IRQ_Init. Don't use PSP_PWM_Channel_Start or the write functions
+    while the stream runs.
+------------------------------------------------------------------------------*/
+uint32_t PSP_PWM_Stream_Start(uint32_t range);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_PWM_Stream_Stop
+
+Function Description:
+    Stop the stream, both channels, and give the DMA channel back.
+
+Inputs:
+    None
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+void PSP_PWM_Stream_Stop(void);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_PWM_Stream_Write_Block
+
+Function Description:
+    Queue a block of samples to play after the blocks already queued. The
+    block after the one playing is never written, the DMA may load it at
+    any moment, so after an underrun, or with only the playing block left,
+    the block is queued two blocks on from the one playing, after a block
+    of silence. Keep at least two blocks queued to play without gaps.
+
+Inputs:
+    p_frames: PSP_PWM_STREAM_BLOCK_FRAMES stereo frames of signed 16 bit
+    samples, left then right.
+
+Returns:
+    uint32_t: true if the block was queued, false if the ring is full or the
+    stream is not running.
+
+Assumptions/Limitations:
+    Call from one place only, not from more than one core or from an
+    interrupt handler as well as the main loop.
+------------------------------------------------------------------------------*/
+uint32_t PSP_PWM_Stream_Write_Block(const int16_t * p_frames);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_PWM_Stream_Get_Num_Queued_Blocks
+
+Function Description:
+    Get how many blocks are waiting to play or playing, for keeping the ring
+    topped up.
+
+Inputs:
+    None
+
+Returns:
+    uint32_t: the number of queued blocks.
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+uint32_t PSP_PWM_Stream_Get_Num_Queued_Blocks(void);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_PWM_Stream_Get_Num_Underruns
+
+Function Description:
+    Get how many times the queued blocks ran out and the stream went to
+    silence, since the stream started.
+
+Inputs:
+    None
+
+Returns:
+    uint32_t: the number of underruns.
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+uint32_t PSP_PWM_Stream_Get_Num_Underruns(void);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_PWM_Serializer_Start
+
+Function Description:
+    Start a channel in serializer mode, sending 32 bits per FIFO word, and
+    get a DMA channel to feed the FIFO.
+
+Inputs:
+    channel: the channel to start, channel 1 or 2.
+
+Returns:
+    uint32_t: true if the channel started, false if no DMA channel was free.
+
+Assumptions/Limitations:
+    A clock init function must be called first, the clock is the bit rate.
+------------------------------------------------------------------------------*/
+uint32_t PSP_PWM_Serializer_Start(PSP_PWM_Channel_t channel);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_PWM_Serializer_Write
+
+Function Description:
+    Start the DMA sending a buffer of words through the serializer. Returns
+    straight away.
+
+Inputs:
+    p_words: the words to send, the first bit out is bit 31 of the first
+    word.
+    num_words: the number of words.
+
+Returns:
+    uint32_t: true if the transfer started, false if the last one is still
+    going or the buffer is too long for the DMA channel.
+
+Assumptions/Limitations:
+    PSP_PWM_Serializer_Start must be called first. The buffer must not be
+    changed until PSP_PWM_Serializer_Is_Busy returns false.
+------------------------------------------------------------------------------*/
+uint32_t PSP_PWM_Serializer_Write(const uint32_t * p_words, uint32_t num_words);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_PWM_Serializer_Is_Busy
+
+Function Description:
+    Check if the DMA or the FIFO still has words to send.
+
+Inputs:
+    None
+
+Returns:
+    uint32_t: true if words are still to be sent, else false.
+
+Assumptions/Limitations:
+    The last word may still be shifting out when this goes false.
+------------------------------------------------------------------------------*/
+uint32_t PSP_PWM_Serializer_Is_Busy(void);
+
 #endif
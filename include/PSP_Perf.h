@@ -0,0 +1,244 @@
+/*
+--|----------------------------------------------------------------------------|
+--| FILE DESCRIPTION:
+--|   PSP_Perf provides cycle accurate profiling with the Cortex-A53
+--|   Performance Monitor Unit. Named regions of code are measured with the
+--|   begin and end macros, and the minimum, mean and maximum of each counter
+--|   over all runs of a region can be dumped over the mini UART.
+--|
+--|----------------------------------------------------------------------------|
+--| NOTES:
+--|     Besides the cycle counter, 5 event counters are set up to count
+--|     instructions retired, L1 data and instruction cache misses, L2 cache
+--|     misses and branch mispredicts.
+--|
+--|     The cycle counter is 32 bits, at 1.2 GHz a single region can be at most
+--|     about 3.5 seconds long.
+--|
+--|     Begin and end each take a few dozen cycles to read the counters, part
+--|     of that shows up in the measurement. Measure an empty region to see how
+--|     much.
+--|
+--|     The PMU is per core and the region statistics are not protected, only
+--|     profile on one core at a time.
+--|
+--|     Usage:
+--|         PSP_PERF_REGION_BEGIN(pixel_loop);
+--|         ... code to measure ...
+--|         PSP_PERF_REGION_END(pixel_loop);
+--|
+--|----------------------------------------------------------------------------|
+--| REFERENCES:
+--|   Cortex-A53 MPCore Technical Reference Manual, chapter 12 (PMU)
+--|   ARM Architecture Reference Manual ARMv7-A, C12 (Performance Monitors)
+--|
+--|----------------------------------------------------------------------------|
+*/
+
+#ifndef PSP_PERF_H_INCLUDED
+#define PSP_PERF_H_INCLUDED
+
+/*
+--|----------------------------------------------------------------------------|
+--| INCLUDE FILES
+--|----------------------------------------------------------------------------|
+*/
+
+#include "Fixed_Width_Ints.h"
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC DEFINES
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--| NAME: PSP_PERF_REGION_BEGIN
+--| DESCRIPTION: start measuring a named region, the name must be a valid C
+--|   identifier and unique within the function
+--| TYPE: macro
+*/
+#define PSP_PERF_REGION_BEGIN(name) \
+    static PSP_Perf_Region_t perf_region_##name = { #name }; \
+    PSP_Perf_Region_Begin(&perf_region_##name)
+
+/*
+--| NAME: PSP_PERF_REGION_END
+--| DESCRIPTION: stop measuring a named region, in the same scope as its begin
+--| TYPE: macro
+*/
+#define PSP_PERF_REGION_END(name) \
+    PSP_Perf_Region_End(&perf_region_##name)
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC TYPES
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--| NAME: PSP_Perf_Counter_t
+--| DESCRIPTION: the counters measured for each region
+*/
+typedef enum PSP_Perf_Counter_Type
+{
+    PSP_PERF_CYCLES = 0u,
+    PSP_PERF_INSTRUCTIONS,
+    PSP_PERF_L1D_CACHE_MISSES,
+    PSP_PERF_L1I_CACHE_MISSES,
+    PSP_PERF_L2_CACHE_MISSES,
+    PSP_PERF_BRANCH_MISPREDICTS,
+    PSP_PERF_NUM_COUNTERS
+} PSP_Perf_Counter_t;
+
+/*
+--| NAME: PSP_Perf_Region_t
+--| DESCRIPTION: the statistics of one measured region
+*/
+typedef struct PSP_Perf_Region_Type
+{
+    const char * p_name;                             // shown in the dump
+    struct PSP_Perf_Region_Type * p_next;            // next region measured, for the dump
+    uint32_t is_listed;                              // true once added to the dump list
+    uint32_t num_runs;                               // times the region has been measured
+    uint32_t start[PSP_PERF_NUM_COUNTERS];           // counter values at begin
+    uint32_t min[PSP_PERF_NUM_COUNTERS];             // smallest count of a single run
+    uint32_t max[PSP_PERF_NUM_COUNTERS];             // largest count of a single run
+    uint64_t total[PSP_PERF_NUM_COUNTERS];           // sum over all runs, for the mean
+} PSP_Perf_Region_t;
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC CONSTANTS
+--|----------------------------------------------------------------------------|
+*/
+
+/* None */
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC VARIABLES
+--|----------------------------------------------------------------------------|
+*/
+
+/* None */
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC FUNCTION PROTOTYPES
+--|----------------------------------------------------------------------------|
+*/
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_Perf_Init
+
+Function Description:
+    Set up and start the cycle counter and the event counters on the calling
+    core, and forget any regions measured so far.
+
+Inputs:
+    None
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    Must be called before any region is measured.
+------------------------------------------------------------------------------*/
+void PSP_Perf_Init(void);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_Perf_Get_Cycles
+
+Function Description:
+    Read the cycle counter.
+
+Inputs:
+    None
+
+Returns:
+    uint32_t: the number of CPU cycles since PSP_Perf_Init, wrapping at 32 bits.
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+uint32_t PSP_Perf_Get_Cycles(void);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_Perf_Region_Begin
+
+Function Description:
+    Take the starting counter values of a region.
+
+Inputs:
+    p_region: the region, the first time it is seen it is added to the dump.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    Use PSP_PERF_REGION_BEGIN rather than calling this directly. The region
+    must start out zeroed apart from its name.
+------------------------------------------------------------------------------*/
+void PSP_Perf_Region_Begin(PSP_Perf_Region_t * p_region);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_Perf_Region_End
+
+Function Description:
+    Take the ending counter values of a region and add the run to its
+    statistics.
+
+Inputs:
+    p_region: the region.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    Use PSP_PERF_REGION_END rather than calling this directly.
+------------------------------------------------------------------------------*/
+void PSP_Perf_Region_End(PSP_Perf_Region_t * p_region);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_Perf_Reset
+
+Function Description:
+    Clear the statistics of every region measured so far.
+
+Inputs:
+    None
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+void PSP_Perf_Reset(void);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_Perf_Dump
+
+Function Description:
+    Send the minimum, mean and maximum of every counter of every region over
+    the mini UART, one line per counter.
+
+Inputs:
+    None
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    The mini UART must be initialized first. Blocks until everything is sent.
+------------------------------------------------------------------------------*/
+void PSP_Perf_Dump(void);
+
+#endif
@@ -7,6 +7,7 @@
 --|----------------------------------------------------------------------------|
 --| REFERENCES:
 --|   BCM2837-ARM-Peripherals.pdf 
+--|   QA7_rev3.4.pdf (ARM local peripherals)
 --|
 --|----------------------------------------------------------------------------|
 */
@@ -20,7 +21,9 @@
 --|----------------------------------------------------------------------------|
 */
 
-/* None */
+#ifdef PSP_HOST_SIM
+#include "PSP_Sim.h"
+#endif
 
 /*
 --|----------------------------------------------------------------------------|
@@ -30,10 +33,15 @@
 
 /*
 --| NAME: PSP_REGS_PERIPHERAL_BASE_ADDRESS
---| DESCRIPTION: peripheral base address
+--| DESCRIPTION: peripheral base address, a block of host memory when built
+--|   for the host register simulator
 --| TYPE: uint32_t
 */
+#ifdef PSP_HOST_SIM
+#define PSP_REGS_PERIPHERAL_BASE_ADDRESS (PSP_Sim_Peripheral_Base)
+#else
 #define PSP_REGS_PERIPHERAL_BASE_ADDRESS (0x3F000000u)
+#endif
 
 /*
 --| NAME: PSP_REGS_xxx_ADDRESS
@@ -48,6 +56,28 @@
 #define PSP_REGS_AUX_BASE_ADDRESS          (PSP_REGS_PERIPHERAL_BASE_ADDRESS | 0x00215000u)
 #define PSP_REGS_HARDWARE_RNG_BASE_ADDRESS (PSP_REGS_PERIPHERAL_BASE_ADDRESS | 0x00104000u)
 #define PSP_REGS_PWM_CLK_MAN_BASE_ADDRESS  (PSP_REGS_PERIPHERAL_BASE_ADDRESS | 0x001010A0u)
+#define PSP_REGS_DMA_BASE_ADDRESS          (PSP_REGS_PERIPHERAL_BASE_ADDRESS | 0x00007000u)
+#define PSP_REGS_IRQ_BASE_ADDRESS          (PSP_REGS_PERIPHERAL_BASE_ADDRESS | 0x0000B200u)
+#define PSP_REGS_UART_0_BASE_ADDRESS       (PSP_REGS_PERIPHERAL_BASE_ADDRESS | 0x00201000u)
+
+/*
+--| NAME: PSP_REGS_LOCAL_PERIPHERAL_BASE_ADDRESS
+--| DESCRIPTION: base address of the ARM local peripherals (core timers, 
+--|   mailboxes and interrupt routing)
+--| TYPE: uint32_t
+*/
+#ifdef PSP_HOST_SIM
+#define PSP_REGS_LOCAL_PERIPHERAL_BASE_ADDRESS (PSP_Sim_Local_Peripheral_Base)
+#else
+#define PSP_REGS_LOCAL_PERIPHERAL_BASE_ADDRESS (0x40000000u)
+#endif
+
+/*
+--| NAME: PSP_REGS_LOCAL_xxx_ADDRESS
+--| DESCRIPTION: base address of a given ARM local peripheral
+--| TYPE: uint32_t
+*/
+#define PSP_REGS_LOCAL_MAILBOX_BASE_ADDRESS (PSP_REGS_LOCAL_PERIPHERAL_BASE_ADDRESS | 0x00000080u)
 
 /*
 --|----------------------------------------------------------------------------|
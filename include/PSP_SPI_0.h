@@ -44,6 +44,29 @@
 #define PSP_SPI_0_MOSI_PIN  (10u)
 #define PSP_SPI_0_CLK_PIN   (11u)
 
+/*
+--| NAME: PSP_SPI0_DMA_MAX_TRANSFER_LENGTH
+--| DESCRIPTION: the most bytes a single PSP_SPI0_DMA_Transfer can move
+--| TYPE: uint32_t
+*/
+#define PSP_SPI0_DMA_MAX_TRANSFER_LENGTH (8u * 0xFFFCu)
+
+/*
+--| NAME: PSP_SPI0_DMA_MAX_ROWS
+--| DESCRIPTION: the most rows a single PSP_SPI0_DMA_Transfer_Rows can send,
+--|   enough for every row of a 240 x 320 display
+--| TYPE: uint32_t
+*/
+#define PSP_SPI0_DMA_MAX_ROWS (320u)
+
+/*
+--| NAME: PSP_SPI0_DMA_RX_BUFFER_ALIGNMENT
+--| DESCRIPTION: the alignment of the Rx buffer of a DMA transfer, in bytes,
+--|   one data cache line
+--| TYPE: uint32_t
+*/
+#define PSP_SPI0_DMA_RX_BUFFER_ALIGNMENT (64u)
+
 /*
 --|----------------------------------------------------------------------------|
 --| PUBLIC TYPES
@@ -83,6 +106,12 @@ typedef enum SPI_0_Chip_Select_Type
     PSP_SPI_0_Chip_Select_1 = 1u
 } PSP_SPI_0_Chip_Select_t;
 
+/*
+--| NAME: PSP_SPI0_DMA_Callback_t
+--| DESCRIPTION: function called when a DMA transfer has completed
+*/
+typedef void (*PSP_SPI0_DMA_Callback_t)(void);
+
 /*
 --|----------------------------------------------------------------------------|
 --| PUBLIC CONSTANTS
@@ -262,6 +291,52 @@ Assumptions/Limitations:
 ------------------------------------------------------------------------------*/
 void PSP_SPI0_Send_16(uint16_t val);
 
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_SPI0_Send_16_Repeated
+
+Function Description:
+    Send the same 16 bit word many times as part of an SPI 0 transfer, such
+    as a color to fill an area of a display with. The Tx FIFO is kept topped
+    up whenever TXD shows room, so the clock runs without gaps.
+
+Inputs:
+    val: the 16 bit value to write via SPI 0, high byte first.
+    count: the number of times to send it.
+
+Returns:
+    None.
+
+Assumptions/Limitations:
+    Expects that PSP_SPI0_Begin_Transfer was called before calling this
+    function and that PSP_SPI0_End_Transfer will be called at the end of 
+    the transfer. The received bytes are thrown away, a full Rx FIFO would
+    stop the transfer.
+------------------------------------------------------------------------------*/
+void PSP_SPI0_Send_16_Repeated(uint16_t val, uint32_t count);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_SPI0_Send_Buffer
+
+Function Description:
+    Send a buffer as part of an SPI 0 transfer, keeping the Tx FIFO topped up
+    like PSP_SPI0_Send_16_Repeated.
+
+Inputs:
+    p_tx_buffer: the bytes to write via SPI 0, in the order they are sent.
+    num_bytes: the number of bytes to send.
+
+Returns:
+    None.
+
+Assumptions/Limitations:
+    Expects that PSP_SPI0_Begin_Transfer was called before calling this
+    function and that PSP_SPI0_End_Transfer will be called at the end of 
+    the transfer. The received bytes are thrown away.
+------------------------------------------------------------------------------*/
+void PSP_SPI0_Send_Buffer(const uint8_t * p_tx_buffer, uint32_t num_bytes);
+
 /*------------------------------------------------------------------------------
 Function Name:
     PSP_SPI0_Transfer_Byte
@@ -348,4 +423,154 @@ Assumptions/Limitations:
 ------------------------------------------------------------------------------*/
 void PSP_SPI0_Set_Chip_Select(PSP_SPI_0_Chip_Select_t chip_select);
 
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_SPI0_DMA_Init
+
+Function Description:
+    Allocate the two DMA channels used for DMA transfers on SPI 0, one to
+    feed the Tx FIFO and one to drain the Rx FIFO.
+
+Inputs:
+    None
+
+Returns:
+    uint32_t: true if both channels were allocated, else false.
+
+Assumptions/Limitations:
+    PSP_SPI0_Start should be called first. Only needs to be called once.
+------------------------------------------------------------------------------*/
+uint32_t PSP_SPI0_DMA_Init(void);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_SPI0_DMA_Transfer
+
+Function Description:
+    Start a DMA driven write and read of a given number of bytes and return
+    right away. The DMA engine keeps the FIFOs fed while the CPU does other
+    work.
+
+    If a previous DMA transfer is still running, this waits for it to finish
+    before starting the new one.
+
+Inputs:
+    p_Tx_buffer: pointer to the bytes to write, or 0 to write zeros.
+    p_Rx_buffer: pointer to the buffer to read into, or 0 to throw the read 
+    bytes away. Must be PSP_SPI0_DMA_RX_BUFFER_ALIGNMENT aligned.
+    num_bytes: the number of bytes to write/read, at most 
+    PSP_SPI0_DMA_MAX_TRANSFER_LENGTH.
+
+Returns:
+    uint32_t: true if the transfer was started, false if the Rx buffer is not
+    aligned or the length is out of range.
+
+Assumptions/Limitations:
+    Both buffers must stay valid and untouched until the transfer completes.
+    The Tx buffer may be read up to 3 bytes past its end.
+
+    The data cache is kept in step with both buffers. The Rx buffer must 
+    take up whole cache lines, padded out to a multiple of 
+    PSP_SPI0_DMA_RX_BUFFER_ALIGNMENT bytes, so nothing else shares its lines.
+    The cached copy of the last line is thrown away once the transfer is 
+    done.
+
+    Do not call the polled transfer functions while a DMA transfer is
+    running, call PSP_SPI0_DMA_Wait first.
+------------------------------------------------------------------------------*/
+uint32_t PSP_SPI0_DMA_Transfer(uint8_t *p_Tx_buffer, 
+                               uint8_t *p_Rx_buffer, 
+                               uint32_t num_bytes);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_SPI0_DMA_Transfer_Rows
+
+Function Description:
+    Start a DMA driven write of rows spaced out in memory, such as a
+    rectangle of a framebuffer, and return right away. The rows go out back
+    to back as one transfer, the read bytes are thrown away.
+
+    If a previous DMA transfer is still running, this waits for it to finish
+    before starting the new one.
+
+Inputs:
+    p_Tx_buffer: pointer to the first byte of the first row.
+    row_length: the number of bytes in each row.
+    row_stride: the number of bytes from the start of one row to the start 
+    of the next.
+    num_rows: the number of rows, at most PSP_SPI0_DMA_MAX_ROWS.
+
+Returns:
+    uint32_t: true if the transfer was started, else false.
+
+Assumptions/Limitations:
+    The buffer, row length and row stride must all be multiples of 4 bytes.
+    The rows must stay valid and untouched until the transfer completes.
+
+    Do not call the polled transfer functions while a DMA transfer is
+    running, call PSP_SPI0_DMA_Wait first.
+------------------------------------------------------------------------------*/
+uint32_t PSP_SPI0_DMA_Transfer_Rows(uint8_t *p_Tx_buffer, 
+                                    uint32_t row_length, 
+                                    uint32_t row_stride, 
+                                    uint32_t num_rows);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_SPI0_DMA_Is_Busy
+
+Function Description:
+    Check if a DMA transfer is still running.
+
+Inputs:
+    None
+
+Returns:
+    uint32_t: true if a DMA transfer is running, else false.
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+uint32_t PSP_SPI0_DMA_Is_Busy(void);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_SPI0_DMA_Wait
+
+Function Description:
+    Wait for the running DMA transfer, if any, to complete and put SPI 0 back
+    in polled mode.
+
+Inputs:
+    None
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+void PSP_SPI0_DMA_Wait(void);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_SPI0_DMA_Set_Callback
+
+Function Description:
+    Set a function to call once a DMA transfer has completed. The callback is
+    called either from PSP_SPI0_DMA_Wait or from PSP_DMA_Service, whichever
+    notices the completion first, and is called once per transfer.
+
+Inputs:
+    callback: the function to call, or 0 for no callback.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+void PSP_SPI0_DMA_Set_Callback(PSP_SPI0_DMA_Callback_t callback);
+
 #endif
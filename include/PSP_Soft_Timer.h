@@ -0,0 +1,207 @@
+/*
+--|----------------------------------------------------------------------------|
+--| FILE DESCRIPTION:
+--|   PSP_Soft_Timer provides any number of one shot and periodic software
+--|   timers, all driven by the System Timer Compare 1 interrupt. Each timer
+--|   calls a callback when it expires.
+--|
+--|----------------------------------------------------------------------------|
+--| NOTES:
+--|     Pending timers are kept in a hierarchical timer wheel, 6 levels of 64
+--|     slots. Level n holds the timers that differ from the current wheel time
+--|     first in bits 6n to 6n + 5 of their expiry time, so starting and
+--|     cancelling a timer are O(1). A timer is moved down a level at most 5
+--|     times on its way to expiring.
+--|
+--|     There is no periodic tick. The compare interrupt is set for the next
+--|     time something in the wheel is due, either a timer expiring or a slot
+--|     moving down a level, and nothing runs in between.
+--|
+--|     Callbacks run in the interrupt handler, with IRQs masked, on the core
+--|     that takes the System Timer interrupts. They may start and cancel
+--|     timers, including their own.
+--|
+--|     The timer structures belong to the caller, must be zeroed before first
+--|     use and must stay valid while the timer is pending. The functions must
+--|     only be used from the core that takes the System Timer interrupts.
+--|
+--|----------------------------------------------------------------------------|
+--| REFERENCES:
+--|   Varghese and Lauck, "Hashed and Hierarchical Timing Wheels", 1987
+--|   BCM2837-ARM-Peripherals.pdf page 172
+--|
+--|----------------------------------------------------------------------------|
+*/
+
+#ifndef PSP_SOFT_TIMER_H_INCLUDED
+#define PSP_SOFT_TIMER_H_INCLUDED
+
+/*
+--|----------------------------------------------------------------------------|
+--| INCLUDE FILES
+--|----------------------------------------------------------------------------|
+*/
+
+#include "Fixed_Width_Ints.h"
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC DEFINES
+--|----------------------------------------------------------------------------|
+*/
+
+/* None */
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC TYPES
+--|----------------------------------------------------------------------------|
+*/
+
+struct PSP_Soft_Timer_Type;
+
+/*
+--| NAME: PSP_Soft_Timer_Callback_t
+--| DESCRIPTION: called when a timer expires, with the timer that expired
+*/
+typedef void (*PSP_Soft_Timer_Callback_t)(struct PSP_Soft_Timer_Type * p_timer);
+
+/*
+--| NAME: PSP_Soft_Timer_t
+--| DESCRIPTION: a software timer, the fields are managed by PSP_Soft_Timer
+*/
+typedef struct PSP_Soft_Timer_Type
+{
+    struct PSP_Soft_Timer_Type * p_next; // next timer in the same wheel slot
+    struct PSP_Soft_Timer_Type * p_prev; // previous timer in the same wheel slot
+    uint64_t expiry_time_uSec;           // the System Timer Counter value to expire at
+    uint32_t period_uSec;                // time between expiries, 0 for a one shot timer
+    uint32_t wheel_slot;                 // the slot the timer is in, or not pending
+    PSP_Soft_Timer_Callback_t callback;  // called on expiry
+} PSP_Soft_Timer_t;
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC CONSTANTS
+--|----------------------------------------------------------------------------|
+*/
+
+/* None */
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC VARIABLES
+--|----------------------------------------------------------------------------|
+*/
+
+/* None */
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC FUNCTION PROTOTYPES
+--|----------------------------------------------------------------------------|
+*/
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_Soft_Timer_Init
+
+Function Description:
+    Empty the timer wheel and hook up the System Timer Compare 1 interrupt.
+
+Inputs:
+    None
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    PSP_IRQ_Init must be called first, and IRQs enabled with PSP_IRQ_Enable
+    for any timer to expire. Only needs to be called once.
+------------------------------------------------------------------------------*/
+void PSP_Soft_Timer_Init(void);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_Soft_Timer_Start
+
+Function Description:
+    Start a timer. If the timer is already pending it is restarted.
+
+Inputs:
+    p_timer: the timer to start.
+    delay_uSec: time from now until the first expiry.
+    period_uSec: time between expiries after the first, 0 for a one shot
+    timer.
+    callback: the function to call on each expiry.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    If a periodic callback is held up long enough to miss whole periods, the
+    missed expiries are skipped rather than called back to back.
+------------------------------------------------------------------------------*/
+void PSP_Soft_Timer_Start(PSP_Soft_Timer_t * p_timer,
+                          uint32_t delay_uSec,
+                          uint32_t period_uSec,
+                          PSP_Soft_Timer_Callback_t callback);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_Soft_Timer_Cancel
+
+Function Description:
+    Stop a timer. Does nothing if the timer is not pending.
+
+Inputs:
+    p_timer: the timer to stop.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+void PSP_Soft_Timer_Cancel(PSP_Soft_Timer_t * p_timer);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_Soft_Timer_Is_Pending
+
+Function Description:
+    Check whether a timer is waiting to expire.
+
+Inputs:
+    p_timer: the timer to check.
+
+Returns:
+    uint32_t: true if the timer is pending, false if it expired (one shot),
+    was cancelled or was never started.
+
+Assumptions/Limitations:
+    A timer must be zeroed before it is first used.
+------------------------------------------------------------------------------*/
+uint32_t PSP_Soft_Timer_Is_Pending(const PSP_Soft_Timer_t * p_timer);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_Soft_Timer_Sleep_Microseconds
+
+Function Description:
+    Wait for a specified number of microseconds with the core asleep, instead
+    of spinning like PSP_Time_Delay_Microseconds. Interrupts are still served
+    while sleeping.
+
+Inputs:
+    delay_time_uSec: uint32_t time in uSec to wait.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    Must not be called from a callback or an interrupt handler.
+------------------------------------------------------------------------------*/
+void PSP_Soft_Timer_Sleep_Microseconds(uint32_t delay_time_uSec);
+
+#endif
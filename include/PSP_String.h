@@ -0,0 +1,191 @@
+/*
+--|----------------------------------------------------------------------------|
+--| FILE DESCRIPTION:
+--|   PSP_String provides the C library memory functions the freestanding
+--|   build does not get, memcpy, memmove and memset, along with memset16 and
+--|   memset32 to fill a buffer with a 16 or 32 bit pattern, such as an RGB565
+--|   color.
+--|
+--|----------------------------------------------------------------------------|
+--| NOTES:
+--|     The bulk of each copy or fill is done 64 bytes at a time with 16 byte
+--|     NEON loads and stores, after lining the destination up on 16 bytes.
+--|     The source may have any alignment.
+--|
+--|     The compiler may call memcpy and memset on its own, for structure
+--|     copies and initializers. These are the ones it gets.
+--|
+--|     When built for the host register simulator (PSP_HOST_SIM), the host's
+--|     C library provides memcpy, memmove and memset, only memset16 and
+--|     memset32 come from here.
+--|
+--|----------------------------------------------------------------------------|
+--| REFERENCES:
+--|   ISO/IEC 9899:1999, 7.21.2 and 7.21.6
+--|
+--|----------------------------------------------------------------------------|
+*/
+
+#ifndef PSP_STRING_H_INCLUDED
+#define PSP_STRING_H_INCLUDED
+
+/*
+--|----------------------------------------------------------------------------|
+--| INCLUDE FILES
+--|----------------------------------------------------------------------------|
+*/
+
+#include "Fixed_Width_Ints.h"
+
+#ifdef PSP_HOST_SIM
+#include <string.h>
+#endif
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC DEFINES
+--|----------------------------------------------------------------------------|
+*/
+
+/* None */
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC TYPES
+--|----------------------------------------------------------------------------|
+*/
+
+#ifndef PSP_HOST_SIM
+/*
+--| NAME: size_t
+--| DESCRIPTION: the type the compiler uses for sizes, as in the C library
+--| TYPE: unsigned integer
+*/
+typedef __SIZE_TYPE__ size_t;
+#endif
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC CONSTANTS
+--|----------------------------------------------------------------------------|
+*/
+
+/* None */
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC VARIABLES
+--|----------------------------------------------------------------------------|
+*/
+
+/* None */
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC FUNCTION PROTOTYPES
+--|----------------------------------------------------------------------------|
+*/
+
+#ifndef PSP_HOST_SIM
+/*------------------------------------------------------------------------------
+Function Name:
+    memcpy
+
+Function Description:
+    Copy bytes from one buffer to another.
+
+Inputs:
+    p_dest: where to copy to.
+    p_src: where to copy from.
+    num_bytes: the number of bytes to copy.
+
+Returns:
+    void *: p_dest.
+
+Assumptions/Limitations:
+    The buffers must not overlap, use memmove if they might.
+------------------------------------------------------------------------------*/
+void * memcpy(void * p_dest, const void * p_src, size_t num_bytes);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    memmove
+
+Function Description:
+    Copy bytes from one buffer to another, the buffers may overlap.
+
+Inputs:
+    p_dest: where to copy to.
+    p_src: where to copy from.
+    num_bytes: the number of bytes to copy.
+
+Returns:
+    void *: p_dest.
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+void * memmove(void * p_dest, const void * p_src, size_t num_bytes);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    memset
+
+Function Description:
+    Fill a buffer with a byte.
+
+Inputs:
+    p_dest: the buffer.
+    value: the byte, only the low 8 bits are used.
+    num_bytes: the number of bytes to fill.
+
+Returns:
+    void *: p_dest.
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+void * memset(void * p_dest, int value, size_t num_bytes);
+#endif
+
+/*------------------------------------------------------------------------------
+Function Name:
+    memset16
+
+Function Description:
+    Fill a buffer with a 16 bit value, such as an RGB565 color.
+
+Inputs:
+    p_dest: the buffer.
+    value: the value.
+    count: the number of 16 bit values to fill, not bytes.
+
+Returns:
+    void *: p_dest.
+
+Assumptions/Limitations:
+    p_dest must be 2 byte aligned.
+------------------------------------------------------------------------------*/
+void * memset16(void * p_dest, uint16_t value, size_t count);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    memset32
+
+Function Description:
+    Fill a buffer with a 32 bit value.
+
+Inputs:
+    p_dest: the buffer.
+    value: the value.
+    count: the number of 32 bit values to fill, not bytes.
+
+Returns:
+    void *: p_dest.
+
+Assumptions/Limitations:
+    p_dest must be 4 byte aligned.
+------------------------------------------------------------------------------*/
+void * memset32(void * p_dest, uint32_t value, size_t count);
+
+#endif
@@ -47,6 +47,17 @@ typedef struct PSP_Time_Periodic_Timer_Type
     uint64_t last_timeout_time_uSec; // the time in mSec when the last timeout occured
 } PSP_Time_Periodic_Timer_t;
 
+/*
+--| NAME: PSP_Time_Compare_t
+--| DESCRIPTION: the system timer compare channels free for the ARM to use,
+--|   channels 0 and 2 are used by the GPU
+*/
+typedef enum PSP_Time_Compare_Type
+{
+    PSP_TIME_COMPARE_1 = 1u, // System Timer Compare 1, interrupt source 1
+    PSP_TIME_COMPARE_3 = 3u, // System Timer Compare 3, interrupt source 3
+} PSP_Time_Compare_t;
+
 /*
 --|----------------------------------------------------------------------------|
 --| PUBLIC CONSTANTS
@@ -149,4 +160,62 @@ Assumptions/Limitations:
 ------------------------------------------------------------------------------*/
 uint32_t PSP_Time_Periodic_Timer_Timeout_Occured(PSP_Time_Periodic_Timer_t * pCounter);
 
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_Time_Set_Compare
+
+Function Description:
+    Clear the match flag of a compare channel and set the time it next 
+    matches. The channel matches, and raises its interrupt if enabled, when 
+    the lower 32 bits of the System Timer Counter equal the match time.
+
+Inputs:
+    compare: the compare channel.
+    match_time_uSec: the lower 32 bits of the counter value to match.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    A match time that has already passed only matches once the counter wraps
+    around, about 71 minutes later.
+------------------------------------------------------------------------------*/
+void PSP_Time_Set_Compare(PSP_Time_Compare_t compare, uint32_t match_time_uSec);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_Time_Clear_Compare_Match
+
+Function Description:
+    Clear the match flag, and so the interrupt, of a compare channel.
+
+Inputs:
+    compare: the compare channel.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+void PSP_Time_Clear_Compare_Match(PSP_Time_Compare_t compare);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_Time_Compare_Matched
+
+Function Description:
+    Check the match flag of a compare channel.
+
+Inputs:
+    compare: the compare channel.
+
+Returns:
+    uint32_t: true if the channel has matched since its flag was cleared.
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+uint32_t PSP_Time_Compare_Matched(PSP_Time_Compare_t compare);
+
 #endif
@@ -0,0 +1,348 @@
+/*
+--|----------------------------------------------------------------------------|
+--| FILE DESCRIPTION:
+--|   PSP_UART_0 provides an interface for UART 0, the ARM PL011 UART. Unlike
+--|   the aux mini uart it has a fractional baud rate divisor fed by its own
+--|   clock, 16 byte FIFOs with configurable trigger levels, hardware flow
+--|   control, and DMA requests for both Tx and Rx.
+--|
+--|----------------------------------------------------------------------------|
+--| NOTES:
+--|     UART 0 uses GPIO pins 14 and 15, the same pins as the aux mini uart,
+--|     so only one of the two can be used at a time.
+--|
+--|     The UART clock is set by the firmware from init_uart_clock in
+--|     config.txt, 48 MHz by default on the Pi 3B+. Baud rates up to
+--|     PSP_UART0_CLOCK_HZ / 16 can be set, 3 Mbaud at the default clock. For
+--|     faster rates raise init_uart_clock and PSP_UART0_CLOCK_HZ together.
+--|
+--|     The DMA moves one 32 bit word per UART byte, the PL011 data register
+--|     only takes or gives 8 bits of it. PSP_UART0_DMA_Write spreads the bytes
+--|     out into words before starting the DMA, and received words keep their
+--|     error flags until PSP_UART0_DMA_Read packs them back into bytes.
+--|
+--|     Once PSP_UART0_DMA_Init has been called, the Rx DMA runs continuously
+--|     into a ring buffer of PSP_UART0_DMA_RX_BUFFER_LENGTH bytes. If more
+--|     than that is received between calls to PSP_UART0_DMA_Read, the oldest
+--|     bytes are overwritten.
+--|
+--|----------------------------------------------------------------------------|
+--| REFERENCES:
+--|   BCM2837-ARM-Peripherals.pdf page 175
+--|   PrimeCell UART (PL011) Technical Reference Manual, r1p5
+--|
+--|----------------------------------------------------------------------------|
+*/
+
+#ifndef PSP_UART_0_H_INCLUDED
+#define PSP_UART_0_H_INCLUDED
+
+/*
+--|----------------------------------------------------------------------------|
+--| INCLUDE FILES
+--|----------------------------------------------------------------------------|
+*/
+
+#include "Fixed_Width_Ints.h"
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC DEFINES
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--| NAME: PSP_UART_0_xxx_PIN
+--| DESCRIPTION: GPIO pin numbers used by UART 0, CTS and RTS only with flow
+--|   control
+--| TYPE: uint32_t
+*/
+#define PSP_UART_0_TX_PIN  (14u)
+#define PSP_UART_0_RX_PIN  (15u)
+#define PSP_UART_0_CTS_PIN (16u)
+#define PSP_UART_0_RTS_PIN (17u)
+
+/*
+--| NAME: PSP_UART0_CLOCK_HZ
+--| DESCRIPTION: the UART reference clock, must match init_uart_clock
+--| TYPE: uint32_t
+*/
+#define PSP_UART0_CLOCK_HZ (48000000u)
+
+/*
+--| NAME: PSP_UART0_DMA_MAX_TRANSFER_LENGTH
+--| DESCRIPTION: the most bytes a single PSP_UART0_DMA_Write can send
+--| TYPE: uint32_t
+*/
+#define PSP_UART0_DMA_MAX_TRANSFER_LENGTH (4096u)
+
+/*
+--| NAME: PSP_UART0_DMA_RX_BUFFER_LENGTH
+--| DESCRIPTION: the number of received bytes the Rx DMA ring buffer holds
+--| TYPE: uint32_t
+*/
+#define PSP_UART0_DMA_RX_BUFFER_LENGTH (1024u)
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC TYPES
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--| NAME: PSP_UART0_FIFO_Level_t
+--| DESCRIPTION: FIFO fill levels that trigger an interrupt or DMA request,
+--|   Tx triggers at or below the level, Rx at or above it
+*/
+typedef enum PSP_UART0_FIFO_Level_Type
+{
+    PSP_UART0_FIFO_LEVEL_1_8 = 0b000u, // 2 of 16 bytes
+    PSP_UART0_FIFO_LEVEL_1_4 = 0b001u, // 4 of 16 bytes
+    PSP_UART0_FIFO_LEVEL_1_2 = 0b010u, // 8 of 16 bytes
+    PSP_UART0_FIFO_LEVEL_3_4 = 0b011u, // 12 of 16 bytes
+    PSP_UART0_FIFO_LEVEL_7_8 = 0b100u, // 14 of 16 bytes
+} PSP_UART0_FIFO_Level_t;
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC CONSTANTS
+--|----------------------------------------------------------------------------|
+*/
+
+/* None */
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC VARIABLES
+--|----------------------------------------------------------------------------|
+*/
+
+/* None */
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC FUNCTION PROTOTYPES
+--|----------------------------------------------------------------------------|
+*/
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_UART0_Init
+
+Function Description:
+    Initialize UART 0 for 8 data bits, no parity and 1 stop bit with the FIFOs
+    on, set GPIO pins 14 and 15 (and 16 and 17 with flow control) to their
+    UART 0 alt modes, and set the baud rate.
+
+Inputs:
+    baud_rate: the baud rate, in bits per second.
+    flow_control: true to use the CTS and RTS lines, else false.
+
+Returns:
+    uint32_t: true if the baud rate can be reached from PSP_UART0_CLOCK_HZ,
+    else false and the UART is left disabled.
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+uint32_t PSP_UART0_Init(uint32_t baud_rate, uint32_t flow_control);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_UART0_Set_Baud_Rate
+
+Function Description:
+    Set the baud rate. The UART is stopped while the divisor changes, after
+    the byte being sent, if any, has gone out. The FIFOs are emptied.
+
+Inputs:
+    baud_rate: the baud rate, in bits per second. The divisor is
+    PSP_UART0_CLOCK_HZ / (16 * baud_rate) with 6 fractional bits, so the
+    error is under 0.5% well past 3 Mbaud.
+
+Returns:
+    uint32_t: true if the baud rate was set, false if it is out of range
+    and nothing was changed.
+
+Assumptions/Limitations:
+    Do not call while a DMA transfer is running.
+------------------------------------------------------------------------------*/
+uint32_t PSP_UART0_Set_Baud_Rate(uint32_t baud_rate);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_UART0_Set_FIFO_Levels
+
+Function Description:
+    Set the FIFO fill levels at which the Tx and Rx DMA requests trigger.
+
+Inputs:
+    tx_level: the Tx FIFO level, at or below which more data is requested.
+    rx_level: the Rx FIFO level, at or above which data is handed over.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    Both levels are 1/2 after PSP_UART0_Init.
+------------------------------------------------------------------------------*/
+void PSP_UART0_Set_FIFO_Levels(PSP_UART0_FIFO_Level_t tx_level, PSP_UART0_FIFO_Level_t rx_level);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_UART0_Send_Byte
+
+Function Description:
+    Send a byte, waiting until there is room for it in the Tx FIFO.
+
+Inputs:
+    value: the value of the byte to send.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    Do not call while a DMA write is running, call PSP_UART0_DMA_Tx_Wait
+    first.
+------------------------------------------------------------------------------*/
+void PSP_UART0_Send_Byte(uint8_t value);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_UART0_Send_String
+
+Function Description:
+    Send a C-String, waiting until all of it is in the Tx FIFO.
+
+Inputs:
+    c_string: the C-String to send.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    Do not call while a DMA write is running, call PSP_UART0_DMA_Tx_Wait
+    first.
+------------------------------------------------------------------------------*/
+void PSP_UART0_Send_String(char * c_string);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_UART0_Receive_Byte
+
+Function Description:
+    Take a byte from the Rx FIFO, without waiting.
+
+Inputs:
+    p_value: where to put the byte received.
+
+Returns:
+    uint32_t: true if a byte was received, false if the Rx FIFO was empty.
+
+Assumptions/Limitations:
+    Not for use once PSP_UART0_DMA_Init has been called, the Rx DMA takes
+    every byte, use PSP_UART0_DMA_Read instead.
+------------------------------------------------------------------------------*/
+uint32_t PSP_UART0_Receive_Byte(uint8_t * p_value);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_UART0_DMA_Init
+
+Function Description:
+    Allocate the two DMA channels used by UART 0, turn on the UART DMA
+    requests, and start the Rx DMA filling its ring buffer.
+
+Inputs:
+    None
+
+Returns:
+    uint32_t: true if both DMA channels were allocated, else false.
+
+Assumptions/Limitations:
+    PSP_UART0_Init must be called first.
+------------------------------------------------------------------------------*/
+uint32_t PSP_UART0_DMA_Init(void);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_UART0_DMA_Write
+
+Function Description:
+    Start a DMA driven send of a given number of bytes and return once it is
+    running. The bytes are copied, the buffer can be reused right away.
+
+    If a previous DMA write is still running, this copies the bytes first and
+    then waits for it to finish before starting the new one.
+
+Inputs:
+    p_buffer: the bytes to send.
+    length: the number of bytes to send, at most
+    PSP_UART0_DMA_MAX_TRANSFER_LENGTH.
+
+Returns:
+    uint32_t: true if the write was started, false if the DMA isn't set up
+    or length is 0 or too large.
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+uint32_t PSP_UART0_DMA_Write(const uint8_t * p_buffer, uint32_t length);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_UART0_DMA_Tx_Is_Busy
+
+Function Description:
+    Check if a DMA write is still running.
+
+Inputs:
+    None
+
+Returns:
+    uint32_t: true if a DMA write is running, else false.
+
+Assumptions/Limitations:
+    The last bytes may still be in the Tx FIFO once the DMA is done.
+------------------------------------------------------------------------------*/
+uint32_t PSP_UART0_DMA_Tx_Is_Busy(void);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_UART0_DMA_Tx_Wait
+
+Function Description:
+    Wait for the running DMA write, if any, to finish.
+
+Inputs:
+    None
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    The last bytes may still be in the Tx FIFO once the DMA is done.
+------------------------------------------------------------------------------*/
+void PSP_UART0_DMA_Tx_Wait(void);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_UART0_DMA_Read
+
+Function Description:
+    Take bytes the Rx DMA has received, without waiting.
+
+Inputs:
+    p_buffer: where to put the bytes received.
+    length: the most bytes to take.
+
+Returns:
+    uint32_t: the number of bytes taken, 0 if nothing has been received.
+
+Assumptions/Limitations:
+    PSP_UART0_DMA_Init must be called first. Bytes received with a framing,
+    parity or break error are passed on as they are.
+------------------------------------------------------------------------------*/
+uint32_t PSP_UART0_DMA_Read(uint8_t * p_buffer, uint32_t length);
+
+#endif
@@ -0,0 +1,563 @@
+/*
+--|----------------------------------------------------------------------------|
+--| FILE DESCRIPTION:
+--|   PSP_Sim.c provides the simulated peripheral block and the trapping of
+--|   accesses to it, along with host stand ins for the PSP_MMU and PSP_IRQ
+--|   modules, which can't run off the Pi.
+--|
+--|----------------------------------------------------------------------------|
+--| NOTES:
+--|     The peripheral block is one shared memory object mapped twice. The
+--|     drivers use the first mapping, in which the modelled pages are kept
+--|     inaccessible. The models use the second, which is always accessible.
+--|
+--|     A driver access to a modelled page faults. On a read, the model puts
+--|     the value to be read into the register first. The page is then opened
+--|     up, read only for a read, and the access is single stepped with the
+--|     x86 trap flag. A read-modify-write instruction faults a second time on
+--|     its write and is handled as a write. Once the instruction is done the
+--|     page is closed again and, on a write, the model is given the value
+--|     written.
+--|
+--|----------------------------------------------------------------------------|
+--| REFERENCES:
+--|   Intel 64 and IA-32 Architectures Software Developer's Manual, Vol. 3A,
+--|     4.7 (page fault error code) and 17.3.1.4 (single step)
+--|
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--|----------------------------------------------------------------------------|
+--| INCLUDE FILES
+--|----------------------------------------------------------------------------|
+*/
+
+#define _GNU_SOURCE
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <ucontext.h>
+#include <unistd.h>
+
+#include "PSP_Sim.h"
+#include "PSP_Sim_Models.h"
+#include "PSP_IRQ.h"
+#include "PSP_MMU.h"
+
+#if !defined(__x86_64__) || !defined(__linux__)
+#error "PSP_Sim only runs on x86-64 Linux"
+#endif
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE DEFINES
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--| NAME: SIM_EFLAGS_TRAP_FLAG
+--| DESCRIPTION: the x86 EFLAGS trap flag, traps after every instruction
+--| TYPE: uint64_t
+*/
+#define SIM_EFLAGS_TRAP_FLAG (1ull << 8u)
+
+/*
+--| NAME: SIM_PAGE_FAULT_WRITE_FLAG
+--| DESCRIPTION: the page fault error code bit set for a write
+--| TYPE: uint64_t
+*/
+#define SIM_PAGE_FAULT_WRITE_FLAG (1ull << 1u)
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE TYPES
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--| NAME: Sim_Access_t
+--| DESCRIPTION: the trapped access being single stepped
+*/
+typedef struct Sim_Access_Type
+{
+    uint32_t is_pending; // true between the fault and the single step trap
+    uint32_t is_write;   // true if the instruction writes the register
+    uint32_t offset;     // the register offset in the peripheral block
+} Sim_Access_t;
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE CONSTANTS
+--|----------------------------------------------------------------------------|
+*/
+
+/* None */
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE VARIABLES
+--|----------------------------------------------------------------------------|
+*/
+
+uintptr_t PSP_Sim_Peripheral_Base = 0u;
+uintptr_t PSP_Sim_Local_Peripheral_Base = 0u;
+PSP_Sim_Stats_t sim_stats;
+
+/*
+--| NAME: sim_shared_memory
+--| DESCRIPTION: file descriptor of the shared memory behind both mappings
+--| TYPE: int
+*/
+static int sim_shared_memory = -1;
+
+/*
+--| NAME: p_model_view
+--| DESCRIPTION: the models' mapping of the peripheral block
+--| TYPE: uint8_t *
+*/
+static uint8_t * p_model_view = 0;
+
+/*
+--| NAME: sim_local_peripherals
+--| DESCRIPTION: the ARM local peripheral block, plain memory
+--| TYPE: uint8_t[]
+*/
+static uint8_t sim_local_peripherals[PSP_SIM_LOCAL_PERIPHERAL_BLOCK_SIZE] __attribute__((aligned(SIM_PAGE_SIZE)));
+
+/*
+--| NAME: pending_access
+--| DESCRIPTION: the access being single stepped
+--| TYPE: Sim_Access_t
+*/
+static volatile Sim_Access_t pending_access;
+
+/*
+--| NAME: irq_handlers
+--| DESCRIPTION: the handlers registered with PSP_IRQ_Register_Handler
+--| TYPE: PSP_IRQ_Handler_t[]
+*/
+static PSP_IRQ_Handler_t irq_handlers[PSP_IRQ_NUM_SOURCES];
+
+/*
+--| NAME: irq_source_enabled
+--| DESCRIPTION: true for each source enabled with PSP_IRQ_Enable_Source
+--| TYPE: uint8_t[]
+*/
+static uint8_t irq_source_enabled[PSP_IRQ_NUM_SOURCES];
+
+/*
+--| NAME: irqs_masked
+--| DESCRIPTION: true while IRQs are masked, as they are out of reset
+--| TYPE: uint32_t
+*/
+static uint32_t irqs_masked = 1u;
+
+/*
+--| NAME: read_hook
+--| DESCRIPTION: the hook set with PSP_Sim_Set_Read_Hook
+--| TYPE: PSP_Sim_Read_Hook_t
+*/
+static PSP_Sim_Read_Hook_t read_hook;
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE HELPER FUNCTION PROTOTYPES
+--|----------------------------------------------------------------------------|
+*/
+
+/*------------------------------------------------------------------------------
+Function Name:
+    Sim_Init
+
+Function Description:
+    Map the peripheral block and install the fault and trap handlers. Runs
+    before main.
+
+Parameters:
+    None
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    Exits the program if the host won't give it the memory.
+------------------------------------------------------------------------------*/
+__attribute__((constructor)) static void Sim_Init(void);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    Sim_Protect_Page
+
+Function Description:
+    Set the access the drivers have to a page of the peripheral block.
+
+Parameters:
+    offset: an offset within the page.
+    protection: PROT_NONE, PROT_READ or PROT_READ | PROT_WRITE.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+static void Sim_Protect_Page(uint32_t offset, int protection);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    Sim_Fault_Handler
+
+Function Description:
+    SIGSEGV handler, starts a trapped access. Faults outside the peripheral
+    block are passed on to the default handler.
+
+Parameters:
+    signal_number, p_info, p_context: as given to an SA_SIGINFO handler.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+static void Sim_Fault_Handler(int signal_number, siginfo_t * p_info, void * p_context);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    Sim_Trap_Handler
+
+Function Description:
+    SIGTRAP handler, finishes a trapped access once it has been stepped.
+    Other traps are passed on to the default handler.
+
+Parameters:
+    signal_number, p_info, p_context: as given to an SA_SIGINFO handler.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+static void Sim_Trap_Handler(int signal_number, siginfo_t * p_info, void * p_context);
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC FUNCTION DEFINITIONS
+--|----------------------------------------------------------------------------|
+*/
+
+void PSP_Sim_Reset(void)
+{
+    // throw the pages away, they come back zeroed
+    if ((ftruncate(sim_shared_memory, 0) != 0) ||
+        (ftruncate(sim_shared_memory, PSP_SIM_PERIPHERAL_BLOCK_SIZE) != 0))
+    {
+        perror("PSP_Sim: resetting the peripheral block");
+        exit(EXIT_FAILURE);
+    }
+
+    for (uint32_t i = 0u; i < PSP_SIM_LOCAL_PERIPHERAL_BLOCK_SIZE; i++)
+    {
+        sim_local_peripherals[i] = 0u;
+    }
+
+    sim_stats = (PSP_Sim_Stats_t){ 0u };
+
+    Sim_Models_Reset();
+
+    for (uint32_t i = 0u; i < SIM_NUM_MODELLED_PAGES; i++)
+    {
+        Sim_Protect_Page(sim_modelled_pages[i], PROT_NONE);
+    }
+
+    PSP_IRQ_Init();
+    irqs_masked = 1u;
+    read_hook = 0;
+}
+
+void PSP_Sim_Get_Stats(PSP_Sim_Stats_t * p_stats)
+{
+    *p_stats = sim_stats;
+}
+
+void PSP_Sim_Set_Read_Hook(PSP_Sim_Read_Hook_t hook)
+{
+    read_hook = hook;
+}
+
+void PSP_Sim_Service_Interrupts(void)
+{
+    if (!irqs_masked)
+    {
+        // handlers run with IRQs masked, like they do on the Pi
+        irqs_masked = 1u;
+        PSP_IRQ_Dispatch();
+        irqs_masked = 0u;
+    }
+}
+
+void PSP_Sim_Wait_For_Interrupt(void)
+{
+    PSP_Sim_Time_Advance(1u);
+
+    // handlers run with IRQs masked, like they do on the Pi
+    const uint32_t was_masked = irqs_masked;
+
+    irqs_masked = 1u;
+    PSP_IRQ_Dispatch();
+    irqs_masked = was_masked;
+}
+
+vuint32_t * Sim_Register(uint32_t offset)
+{
+    return (vuint32_t *)&p_model_view[offset & ~3u];
+}
+
+/*
+--| The PSP_MMU functions, the host has no caches to maintain
+*/
+
+void PSP_MMU_Init(void)
+{
+}
+
+void PSP_MMU_Init_Secondary_Core(void)
+{
+}
+
+uint32_t PSP_MMU_Is_Enabled(void)
+{
+    return 0u;
+}
+
+void PSP_MMU_Clean_Data_Cache(const void * p_start, uint32_t num_bytes)
+{
+}
+
+void PSP_MMU_Invalidate_Data_Cache(const void * p_start, uint32_t num_bytes)
+{
+}
+
+void PSP_MMU_Clean_And_Invalidate_Data_Cache(const void * p_start, uint32_t num_bytes)
+{
+}
+
+/*
+--| The PSP_IRQ functions, handlers are called from PSP_Sim_Service_Interrupts
+*/
+
+void PSP_IRQ_Init(void)
+{
+    for (uint32_t source = 0u; source < PSP_IRQ_NUM_SOURCES; source++)
+    {
+        irq_handlers[source] = 0;
+        irq_source_enabled[source] = 0u;
+    }
+}
+
+void PSP_IRQ_Register_Handler(uint32_t source, PSP_IRQ_Handler_t handler)
+{
+    if (source < PSP_IRQ_NUM_SOURCES)
+    {
+        irq_handlers[source] = handler;
+    }
+    else
+    {
+        /* invalid source, do nothing */
+    }
+}
+
+void PSP_IRQ_Enable_Source(uint32_t source)
+{
+    if (source < PSP_IRQ_NUM_SOURCES)
+    {
+        irq_source_enabled[source] = 1u;
+    }
+    else
+    {
+        /* invalid source, do nothing */
+    }
+}
+
+void PSP_IRQ_Disable_Source(uint32_t source)
+{
+    if (source < PSP_IRQ_NUM_SOURCES)
+    {
+        irq_source_enabled[source] = 0u;
+    }
+    else
+    {
+        /* invalid source, do nothing */
+    }
+}
+
+void PSP_IRQ_Route_GPU_To_Core(uint32_t core_id)
+{
+}
+
+void PSP_IRQ_Enable(void)
+{
+    irqs_masked = 0u;
+}
+
+void PSP_IRQ_Disable(void)
+{
+    irqs_masked = 1u;
+}
+
+uint32_t PSP_IRQ_Save_And_Disable(void)
+{
+    const uint32_t state = irqs_masked;
+
+    irqs_masked = 1u;
+
+    return state;
+}
+
+void PSP_IRQ_Restore(uint32_t state)
+{
+    irqs_masked = state;
+}
+
+void PSP_IRQ_Dispatch(void)
+{
+    for (uint32_t source = 0u; source < PSP_IRQ_NUM_SOURCES; source++)
+    {
+        if (irq_source_enabled[source] && irq_handlers[source] && Sim_Models_Is_Interrupt_Pending(source))
+        {
+            irq_handlers[source](source);
+        }
+    }
+}
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE HELPER FUNCTION DEFINITIONS
+--|----------------------------------------------------------------------------|
+*/
+
+static void Sim_Init(void)
+{
+    const size_t block_size = PSP_SIM_PERIPHERAL_BLOCK_SIZE;
+
+    sim_shared_memory = memfd_create("psp_sim_peripherals", 0);
+
+    // reserve twice the size, so a block aligned to its size fits somewhere in it
+    uint8_t * p_reserved = mmap(0, 2u * block_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+
+    if ((sim_shared_memory < 0) || (ftruncate(sim_shared_memory, block_size) != 0) || (p_reserved == MAP_FAILED))
+    {
+        perror("PSP_Sim: creating the peripheral block");
+        exit(EXIT_FAILURE);
+    }
+
+    const uintptr_t aligned_block = ((uintptr_t)p_reserved + block_size - 1u) & ~(uintptr_t)(block_size - 1u);
+
+    void * p_driver_view = mmap((void *)aligned_block, block_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, sim_shared_memory, 0);
+
+    p_model_view = mmap(0, block_size, PROT_READ | PROT_WRITE, MAP_SHARED, sim_shared_memory, 0);
+
+    if ((p_driver_view == MAP_FAILED) || (p_model_view == MAP_FAILED))
+    {
+        perror("PSP_Sim: mapping the peripheral block");
+        exit(EXIT_FAILURE);
+    }
+
+    PSP_Sim_Peripheral_Base = aligned_block;
+    PSP_Sim_Local_Peripheral_Base = (uintptr_t)sim_local_peripherals;
+
+    struct sigaction action = { 0 };
+
+    action.sa_flags = SA_SIGINFO;
+    sigemptyset(&action.sa_mask);
+
+    action.sa_sigaction = Sim_Fault_Handler;
+    sigaction(SIGSEGV, &action, 0);
+
+    action.sa_sigaction = Sim_Trap_Handler;
+    sigaction(SIGTRAP, &action, 0);
+
+    PSP_Sim_Reset();
+}
+
+static void Sim_Protect_Page(uint32_t offset, int protection)
+{
+    const uintptr_t page = PSP_Sim_Peripheral_Base + (offset & ~(SIM_PAGE_SIZE - 1u));
+
+    mprotect((void *)page, SIM_PAGE_SIZE, protection);
+}
+
+static void Sim_Fault_Handler(int signal_number, siginfo_t * p_info, void * p_context)
+{
+    ucontext_t * p_ucontext = p_context;
+
+    const uintptr_t address = (uintptr_t)p_info->si_addr;
+
+    if ((address < PSP_Sim_Peripheral_Base) || (address >= (PSP_Sim_Peripheral_Base + PSP_SIM_PERIPHERAL_BLOCK_SIZE)))
+    {
+        // not ours, a real crash, let it fault again and die
+        signal(SIGSEGV, SIG_DFL);
+        return;
+    }
+
+    const uint32_t offset = (uint32_t)(address - PSP_Sim_Peripheral_Base) & ~3u;
+
+    if (p_ucontext->uc_mcontext.gregs[REG_ERR] & SIM_PAGE_FAULT_WRITE_FLAG)
+    {
+        sim_stats.register_writes++;
+
+        Sim_Protect_Page(offset, PROT_READ | PROT_WRITE);
+
+        pending_access.is_write = 1u;
+    }
+    else
+    {
+        sim_stats.register_reads++;
+
+        Sim_Models_Read(offset);
+        Sim_Protect_Page(offset, PROT_READ);
+
+        pending_access.is_write = 0u;
+    }
+
+    pending_access.offset = offset;
+    pending_access.is_pending = 1u;
+
+    p_ucontext->uc_mcontext.gregs[REG_EFL] |= SIM_EFLAGS_TRAP_FLAG;
+}
+
+static void Sim_Trap_Handler(int signal_number, siginfo_t * p_info, void * p_context)
+{
+    ucontext_t * p_ucontext = p_context;
+
+    if (!pending_access.is_pending)
+    {
+        // not ours, e.g. a breakpoint
+        signal(SIGTRAP, SIG_DFL);
+        raise(SIGTRAP);
+        return;
+    }
+
+    p_ucontext->uc_mcontext.gregs[REG_EFL] &= ~SIM_EFLAGS_TRAP_FLAG;
+
+    pending_access.is_pending = 0u;
+
+    Sim_Protect_Page(pending_access.offset, PROT_NONE);
+
+    if (pending_access.is_write)
+    {
+        Sim_Models_Write(pending_access.offset);
+    }
+    else if (read_hook)
+    {
+        read_hook(pending_access.offset);
+    }
+    else
+    {
+        /* a read with no hook, do nothing */
+    }
+}
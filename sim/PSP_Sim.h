@@ -0,0 +1,524 @@
+/*
+--|----------------------------------------------------------------------------|
+--| FILE DESCRIPTION:
+--|   PSP_Sim is a host side register simulator. Built with PSP_HOST_SIM
+--|   defined, PSP_REGS points the peripheral base address at a block of host
+--|   memory instead of 0x3F000000, so the unmodified drivers can run as a
+--|   normal Linux program. Accesses to the modelled peripherals are trapped
+--|   and passed to behavioral models of:
+--|     - the System Timer, running on a virtual microsecond clock
+--|     - the GPIO pins, with injectable inputs and event detection
+--|     - SPI 0, with 64 byte Tx and Rx FIFOs and its DMA mode
+--|     - the mini UART, with captured Tx and injectable Rx bytes
+--|     - the PWM FIFO, feeding the words played to a sink
+--|     - the DMA engine, paced by the SPI 0 and PWM DREQs
+--|     - an ILI9341 display on SPI 0, decoding commands and pixel writes
+--|
+--|----------------------------------------------------------------------------|
+--| NOTES:
+--|     Build with $ make host TARGET=[name of a program in sim/examples] from
+--|     within the build directory. Only the drivers for the modelled
+--|     peripherals are built, the MMU and IRQ modules are replaced by stubs.
+--|
+--|     Only x86-64 Linux is supported. A trapped register access is one
+--|     page fault plus one single step trap, tens of microseconds on the host,
+--|     so time the drivers by their register accesses and SPI bytes rather
+--|     than by the host clock.
+--|
+--|     The System Timer only moves when it is read, or by
+--|     PSP_Sim_Time_Advance. Each read moves it 1 uSec, and reads with no
+--|     register write in between, a busy wait, move it in steps that double
+--|     up to 1 mSec, so delays and timeouts finish after a few hundred reads
+--|     rather than in real time.
+--|
+--|     The DMA engine sees host memory through the bus address the drivers
+--|     give it, which only keeps the low 30 bits of an address. The program is
+--|     linked -no-pie so static buffers are low enough, DMA buffers and
+--|     control blocks must be static, not on the stack or from malloc.
+--|
+--|     The PWM clock is taken to be 1 MHz whatever the clock manager is set
+--|     to, so each channel on the FIFO plays a word every RNG microseconds.
+--|
+--|     Interrupt handlers registered with PSP_IRQ are only called from
+--|     PSP_Sim_Service_Interrupts, never in the middle of the program.
+--|
+--|     SPI devices and the models run inside the fault handler, so a device
+--|     callback must not access the simulated registers.
+--|
+--|----------------------------------------------------------------------------|
+--| REFERENCES:
+--|   BCM2837-ARM-Peripherals.pdf
+--|   ILI9341 datasheet, V1.11
+--|
+--|----------------------------------------------------------------------------|
+*/
+
+#ifndef PSP_SIM_H_INCLUDED
+#define PSP_SIM_H_INCLUDED
+
+/*
+--|----------------------------------------------------------------------------|
+--| INCLUDE FILES
+--|----------------------------------------------------------------------------|
+*/
+
+#include "Fixed_Width_Ints.h"
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC DEFINES
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--| NAME: PSP_SIM_PERIPHERAL_BLOCK_SIZE
+--| DESCRIPTION: size of the simulated peripheral block, 0x3F000000 to
+--|   0x3FFFFFFF on the Pi
+--| TYPE: uint32_t
+*/
+#define PSP_SIM_PERIPHERAL_BLOCK_SIZE (0x01000000u)
+
+/*
+--| NAME: PSP_SIM_LOCAL_PERIPHERAL_BLOCK_SIZE
+--| DESCRIPTION: size of the simulated ARM local peripheral block, which is
+--|   plain memory
+--| TYPE: uint32_t
+*/
+#define PSP_SIM_LOCAL_PERIPHERAL_BLOCK_SIZE (0x1000u)
+
+/*
+--| NAME: PSP_SIM_ILI9341_MAX_SIZE
+--| DESCRIPTION: rows and columns of the simulated display memory, large
+--|   enough for the 240 x 320 panel in either orientation
+--| TYPE: uint32_t
+*/
+#define PSP_SIM_ILI9341_MAX_SIZE (320u)
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC TYPES
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--| NAME: PSP_Sim_SPI_Device_t
+--| DESCRIPTION: a device on the SPI 0 bus, called for each byte clocked out
+--|   while its chip select is active, returns the byte clocked back in
+*/
+typedef uint8_t (*PSP_Sim_SPI_Device_t)(uint8_t mosi_byte);
+
+/*
+--| NAME: PSP_Sim_PWM_Sink_t
+--| DESCRIPTION: called for each word the PWM channels take from the FIFO,
+--|   channel 1 and channel 2 in turn when both use it
+*/
+typedef void (*PSP_Sim_PWM_Sink_t)(uint32_t word);
+
+/*
+--| NAME: PSP_Sim_Read_Hook_t
+--| DESCRIPTION: called once a trapped read of a modelled register is done,
+--|   with the register offset in the peripheral block
+*/
+typedef void (*PSP_Sim_Read_Hook_t)(uint32_t offset);
+
+/*
+--| NAME: PSP_Sim_Stats_t
+--| DESCRIPTION: counts kept by the simulator, for benchmarking
+*/
+typedef struct PSP_Sim_Stats_Type
+{
+    uint64_t register_reads;      // trapped reads of modelled registers
+    uint64_t register_writes;     // trapped writes of modelled registers
+    uint64_t spi0_bytes;          // bytes clocked out on SPI 0
+    uint64_t dma_bytes;           // bytes moved by the DMA engine
+    uint64_t ili9341_commands;    // commands decoded by the display
+    uint64_t ili9341_pixels;      // pixels written to display memory
+    uint64_t mini_uart_tx_bytes;  // bytes sent by the mini UART
+    uint64_t pwm_words;           // words played from the PWM FIFO
+} PSP_Sim_Stats_t;
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC CONSTANTS
+--|----------------------------------------------------------------------------|
+*/
+
+/* None */
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC VARIABLES
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--| NAME: PSP_Sim_Peripheral_Base
+--| DESCRIPTION: host address of the simulated peripheral block, aligned to
+--|   its size so register offsets can be or'ed in like on the Pi
+--| TYPE: uintptr_t
+*/
+extern uintptr_t PSP_Sim_Peripheral_Base;
+
+/*
+--| NAME: PSP_Sim_Local_Peripheral_Base
+--| DESCRIPTION: host address of the simulated ARM local peripheral block
+--| TYPE: uintptr_t
+*/
+extern uintptr_t PSP_Sim_Local_Peripheral_Base;
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC FUNCTION PROTOTYPES
+--|----------------------------------------------------------------------------|
+*/
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_Sim_Reset
+
+Function Description:
+    Put every register and model back to its power on state, detach the SPI
+    devices, zero the virtual clock and the stats.
+
+Inputs:
+    None
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    The simulator sets itself up before main, this is only needed to start a
+    program over from a clean state.
+------------------------------------------------------------------------------*/
+void PSP_Sim_Reset(void);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_Sim_Get_Stats
+
+Function Description:
+    Get the counts kept since the last reset.
+
+Inputs:
+    p_stats: where to put the counts.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+void PSP_Sim_Get_Stats(PSP_Sim_Stats_t * p_stats);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_Sim_Time_Get
+
+Function Description:
+    Get the virtual System Timer count, without moving it.
+
+Inputs:
+    None
+
+Returns:
+    uint64_t: the count, in microseconds.
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+uint64_t PSP_Sim_Time_Get(void);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_Sim_Time_Advance
+
+Function Description:
+    Move the virtual System Timer forward, setting the match flag of any
+    compare register passed.
+
+Inputs:
+    delta_uSec: time to move forward, in microseconds.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+void PSP_Sim_Time_Advance(uint64_t delta_uSec);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_Sim_GPIO_Set_Input
+
+Function Description:
+    Drive a pin from outside. The level is seen on the pin while it is not
+    an output, and edge and level detection are applied.
+
+Inputs:
+    pin_num: the pin, 0 to 53.
+    level: true for high, false for low.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    All inputs start low.
+------------------------------------------------------------------------------*/
+void PSP_Sim_GPIO_Set_Input(uint32_t pin_num, uint32_t level);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_Sim_GPIO_Get_Level
+
+Function Description:
+    Get the level of a pin, as GPLEV would read it.
+
+Inputs:
+    pin_num: the pin, 0 to 53.
+
+Returns:
+    uint32_t: true if the pin is high, else false.
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+uint32_t PSP_Sim_GPIO_Get_Level(uint32_t pin_num);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_Sim_SPI0_Attach
+
+Function Description:
+    Put a device on one of the SPI 0 chip selects, replacing any device
+    already there.
+
+Inputs:
+    chip_select: the chip select, 0 to 2.
+    device: the device, 0 to leave the chip select empty. An empty chip
+    select reads back 0xFF.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    See the notes, the device must not access the simulated registers.
+------------------------------------------------------------------------------*/
+void PSP_Sim_SPI0_Attach(uint32_t chip_select, PSP_Sim_SPI_Device_t device);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_Sim_Mini_Uart_Inject
+
+Function Description:
+    Queue bytes to be received by the mini UART.
+
+Inputs:
+    p_bytes: the bytes.
+    length: the number of bytes.
+
+Returns:
+    uint32_t: the number of bytes queued, fewer than length if the queue
+    filled up.
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+uint32_t PSP_Sim_Mini_Uart_Inject(const uint8_t * p_bytes, uint32_t length);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_Sim_Mini_Uart_Take_Tx
+
+Function Description:
+    Take the bytes the mini UART has sent since the last call.
+
+Inputs:
+    p_bytes: where to put the bytes.
+    length: the most bytes to take.
+
+Returns:
+    uint32_t: the number of bytes taken.
+
+Assumptions/Limitations:
+    Only the most recent bytes are kept, older ones are dropped once the
+    capture buffer fills.
+------------------------------------------------------------------------------*/
+uint32_t PSP_Sim_Mini_Uart_Take_Tx(uint8_t * p_bytes, uint32_t length);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_Sim_Mini_Uart_Set_Echo
+
+Function Description:
+    Also copy every byte the mini UART sends to the host's stdout.
+
+Inputs:
+    enable: true to echo, false to only capture.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    Echo is off after a reset.
+------------------------------------------------------------------------------*/
+void PSP_Sim_Mini_Uart_Set_Echo(uint32_t enable);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_Sim_ILI9341_Attach
+
+Function Description:
+    Put the ILI9341 model on an SPI 0 chip select, with its D/C line on a
+    GPIO pin. The model starts out reset, asleep and with the display off.
+
+Inputs:
+    chip_select: the chip select, 0 to 2.
+    dc_pin_num: the GPIO pin driving D/C, low for commands.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    Only one display can be attached.
+------------------------------------------------------------------------------*/
+void PSP_Sim_ILI9341_Attach(uint32_t chip_select, uint32_t dc_pin_num);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_Sim_ILI9341_Get_Pixel
+
+Function Description:
+    Read a pixel of the display memory.
+
+Inputs:
+    column, page: the pixel, in the coordinates the CASET and PASET commands
+    address, which are the driver's x and y whatever the MADCTL rotation.
+
+Returns:
+    uint16_t: the 5-6-5 color, 0 outside of the display memory.
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+uint16_t PSP_Sim_ILI9341_Get_Pixel(uint32_t column, uint32_t page);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_Sim_ILI9341_Is_Display_On
+
+Function Description:
+    Check whether the display has been woken up and turned on.
+
+Inputs:
+    None
+
+Returns:
+    uint32_t: true after SLPOUT and DISPON, else false.
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+uint32_t PSP_Sim_ILI9341_Is_Display_On(void);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_Sim_ILI9341_Get_Register
+
+Function Description:
+    Get the first parameter byte last sent with a command, e.g. MADCTL 0x36
+    or COLMOD 0x3A.
+
+Inputs:
+    command: the command.
+
+Returns:
+    uint8_t: the parameter, 0 if it hasn't been sent since reset.
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+uint8_t PSP_Sim_ILI9341_Get_Register(uint8_t command);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_Sim_PWM_Attach
+
+Function Description:
+    Set where the words played from the PWM FIFO go, replacing any sink
+    already set.
+
+Inputs:
+    sink: the sink, 0 to drop the words.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    See the notes, the sink must not access the simulated registers.
+------------------------------------------------------------------------------*/
+void PSP_Sim_PWM_Attach(PSP_Sim_PWM_Sink_t sink);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_Sim_Set_Read_Hook
+
+Function Description:
+    Set a function to call after every trapped read of a modelled register,
+    e.g. to move the virtual clock on between two accesses of a driver and
+    so land a DMA or interrupt event in the window between them.
+
+Inputs:
+    hook: the hook, 0 for none.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    The hook runs inside the trap handler, it may call PSP_Sim_Time_Advance
+    but must not access the simulated registers. Cleared by a reset.
+------------------------------------------------------------------------------*/
+void PSP_Sim_Set_Read_Hook(PSP_Sim_Read_Hook_t hook);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_Sim_Service_Interrupts
+
+Function Description:
+    Call the registered handler of every enabled interrupt source that is
+    pending: System Timer compares 1 and 3, the DMA channels, aux and GPIO.
+
+Inputs:
+    None
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    Does nothing while interrupts are disabled with PSP_IRQ_Disable or
+    PSP_IRQ_Save_And_Disable. A source is serviced at most once per call.
+------------------------------------------------------------------------------*/
+void PSP_Sim_Service_Interrupts(void);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PSP_Sim_Wait_For_Interrupt
+
+Function Description:
+    Stand in for WFI. Moves the virtual clock on 1 uSec and calls the
+    handler of every enabled interrupt source that is pending, as the Pi
+    does once a core woken by WFI unmasks IRQs.
+
+Inputs:
+    None
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    Handlers are called even while interrupts are disabled, WFI is called
+    with them masked.
+------------------------------------------------------------------------------*/
+void PSP_Sim_Wait_For_Interrupt(void);
+
+#endif
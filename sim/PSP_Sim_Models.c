@@ -0,0 +1,1731 @@
+/*
+--|----------------------------------------------------------------------------|
+--| FILE DESCRIPTION:
+--|   PSP_Sim_Models.c provides the behavioral models of the simulated
+--|   peripherals: the System Timer, GPIO, SPI 0, the PWM FIFO, the mini
+--|   UART, the DMA engine, and an ILI9341 display hanging off SPI 0.
+--|
+--|----------------------------------------------------------------------------|
+--| NOTES:
+--|     Registers without a model behave as plain memory. Read only status
+--|     bits are recomputed before every read of their register, and
+--|     write 1 to clear bits are kept in shadow copies, since a write
+--|     overwrites the whole register.
+--|
+--|     SPI 0 clocks a byte out the moment it reaches the front of the Tx
+--|     FIFO, as long as TA is set and the Rx FIFO has room for the byte
+--|     clocked in. With the Rx FIFO full the transfer stalls, as it does on
+--|     the Pi.
+--|
+--|     The PWM channels take their words from the FIFO as the System Timer
+--|     moves on, a word per channel every RNG1 microseconds, and the DMA
+--|     tops the FIFO up after each. Only the FIFO is modelled, the words go
+--|     to the sink rather than being turned into pulses.
+--|
+--|     DMA channels run as soon as they are activated. A control block paced
+--|     by the SPI 0 or PWM DREQs moves a word whenever the FIFOs would
+--|     request one, other peripherals never request, so their control blocks
+--|     stall.
+--|
+--|----------------------------------------------------------------------------|
+--| REFERENCES:
+--|   BCM2837-ARM-Peripherals.pdf pages 10 (mini UART), 40 (DMA), 89 (GPIO),
+--|     138 (PWM), 148 (SPI), 172 (System Timer)
+--|   ILI9341 datasheet, V1.11, chapter 8
+--|
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--|----------------------------------------------------------------------------|
+--| INCLUDE FILES
+--|----------------------------------------------------------------------------|
+*/
+
+#include <string.h>
+#include <unistd.h>
+
+#include "PSP_Sim_Models.h"
+#include "PSP_IRQ.h"
+#include "PSP_DMA.h"
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE DEFINES
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--| NAME: SIM_xxx_OFFSET
+--| DESCRIPTION: offset of each modelled peripheral in the peripheral block
+--| TYPE: uint32_t
+*/
+#define SIM_SYSTEM_TIMER_OFFSET (0x003000u)
+#define SIM_DMA_OFFSET          (0x007000u)
+#define SIM_GPIO_OFFSET         (0x200000u)
+#define SIM_SPI0_OFFSET         (0x204000u)
+#define SIM_PWM_OFFSET          (0x20C000u)
+#define SIM_AUX_OFFSET          (0x215000u)
+
+/*
+--| NAME: SIM_TIMER_MAX_STEP_uSec
+--| DESCRIPTION: the most the System Timer moves on one read in a busy wait
+--| TYPE: uint32_t
+*/
+#define SIM_TIMER_MAX_STEP_uSec (1000u)
+
+/*
+--| NAME: SIM_GPIO_NUM_PINS
+--| DESCRIPTION: the number of GPIO pins
+--| TYPE: uint32_t
+*/
+#define SIM_GPIO_NUM_PINS (54u)
+
+/*
+--| NAME: SIM_SPI0_FIFO_SIZE
+--| DESCRIPTION: depth of each of the SPI 0 FIFOs, in bytes
+--| TYPE: uint32_t
+*/
+#define SIM_SPI0_FIFO_SIZE (64u)
+
+/*
+--| NAME: SIM_SPI0_NUM_CHIP_SELECTS
+--| DESCRIPTION: the number of SPI 0 chip selects
+--| TYPE: uint32_t
+*/
+#define SIM_SPI0_NUM_CHIP_SELECTS (3u)
+
+/*
+--| NAME: SIM_PWM_FIFO_SIZE
+--| DESCRIPTION: depth of the PWM FIFO, in words
+--| TYPE: uint32_t
+*/
+#define SIM_PWM_FIFO_SIZE (8u)
+
+/*
+--| NAME: SIM_DMA_NUM_CHANNELS
+--| DESCRIPTION: channels in the DMA register page, channel 15 is elsewhere
+--| TYPE: uint32_t
+*/
+#define SIM_DMA_NUM_CHANNELS (15u)
+
+/*
+--| NAME: SIM_DMA_MAX_WORDS_PER_RUN
+--| DESCRIPTION: the most words moved before returning to the program, so a
+--|   control block chain that loops on itself can't hang the simulator
+--| TYPE: uint32_t
+*/
+#define SIM_DMA_MAX_WORDS_PER_RUN (1u << 20u)
+
+/*
+--| NAME: SIM_MINI_UART_xX_SIZE
+--| DESCRIPTION: size of the mini UART Rx queue and Tx capture buffer
+--| TYPE: uint32_t
+*/
+#define SIM_MINI_UART_RX_SIZE (1024u)
+#define SIM_MINI_UART_TX_SIZE (4096u)
+
+/*
+--| NAME: SIM_ILI9341_xxx
+--| DESCRIPTION: the ILI9341 commands the model acts on
+--| TYPE: uint8_t
+*/
+#define SIM_ILI9341_SWRESET (0x01u)
+#define SIM_ILI9341_SLPIN   (0x10u)
+#define SIM_ILI9341_SLPOUT  (0x11u)
+#define SIM_ILI9341_DISPOFF (0x28u)
+#define SIM_ILI9341_DISPON  (0x29u)
+#define SIM_ILI9341_CASET   (0x2Au)
+#define SIM_ILI9341_PASET   (0x2Bu)
+#define SIM_ILI9341_RAMWR   (0x2Cu)
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE TYPES
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--| NAME: Sim_Register_Offsets_enum
+--| DESCRIPTION: register offsets within each modelled peripheral
+*/
+enum Sim_Register_Offsets_enum
+{
+    SIM_TIMER_CS  = 0x00u,
+    SIM_TIMER_CLO = 0x04u,
+    SIM_TIMER_CHI = 0x08u,
+    SIM_TIMER_C0  = 0x0Cu,
+
+    SIM_GPIO_GPFSEL0 = 0x00u,
+    SIM_GPIO_GPSET0  = 0x1Cu,
+    SIM_GPIO_GPCLR0  = 0x28u,
+    SIM_GPIO_GPLEV0  = 0x34u,
+    SIM_GPIO_GPEDS0  = 0x40u,
+    SIM_GPIO_GPREN0  = 0x4Cu,
+    SIM_GPIO_GPFEN0  = 0x58u,
+    SIM_GPIO_GPHEN0  = 0x64u,
+    SIM_GPIO_GPLEN0  = 0x70u,
+    SIM_GPIO_GPAREN0 = 0x7Cu,
+    SIM_GPIO_GPAFEN0 = 0x88u,
+
+    SIM_SPI0_CS   = 0x00u,
+    SIM_SPI0_FIFO = 0x04u,
+    SIM_SPI0_DLEN = 0x0Cu,
+
+    SIM_PWM_CTL  = 0x00u,
+    SIM_PWM_STA  = 0x04u,
+    SIM_PWM_DMAC = 0x08u,
+    SIM_PWM_RNG1 = 0x10u,
+    SIM_PWM_FIF1 = 0x18u,
+
+    SIM_DMA_CS         = 0x00u,
+    SIM_DMA_CONBLK_AD  = 0x04u,
+    SIM_DMA_TI         = 0x08u,
+    SIM_DMA_SOURCE_AD  = 0x0Cu,
+    SIM_DMA_DEST_AD    = 0x10u,
+    SIM_DMA_TXFR_LEN   = 0x14u,
+    SIM_DMA_STRIDE     = 0x18u,
+    SIM_DMA_NEXTCONBK  = 0x1Cu,
+    SIM_DMA_DEBUG      = 0x20u,
+    SIM_DMA_CHANNEL    = 0x100u, // channel n's registers are at n times this
+    SIM_DMA_INT_STATUS = 0xFE0u,
+
+    SIM_AUX_IRQ     = 0x00u,
+    SIM_AUX_ENABLES = 0x04u,
+    SIM_AUX_MU_IO   = 0x40u,
+    SIM_AUX_MU_IER  = 0x44u,
+    SIM_AUX_MU_IIR  = 0x48u,
+    SIM_AUX_MU_LCR  = 0x4Cu,
+    SIM_AUX_MU_LSR  = 0x54u,
+    SIM_AUX_MU_STAT = 0x64u,
+};
+
+/*
+--| NAME: Sim_Flags_enum
+--| DESCRIPTION: register bits used by the models
+*/
+enum Sim_Flags_enum
+{
+    SIM_SPI0_CS_CHIP_SEL_MASK = 0x3u,
+    SIM_SPI0_CS_CLEAR_TX_FLAG = (1u << 4u),
+    SIM_SPI0_CS_CLEAR_RX_FLAG = (1u << 5u),
+    SIM_SPI0_CS_TA_FLAG       = (1u << 7u),
+    SIM_SPI0_CS_DMAEN_FLAG    = (1u << 8u),
+    SIM_SPI0_CS_DONE_FLAG     = (1u << 16u),
+    SIM_SPI0_CS_RXD_FLAG      = (1u << 17u),
+    SIM_SPI0_CS_TXD_FLAG      = (1u << 18u),
+    SIM_SPI0_CS_RXR_FLAG      = (1u << 19u),
+    SIM_SPI0_CS_RXF_FLAG      = (1u << 20u),
+    SIM_SPI0_CS_HEADER_MASK   = 0xFFu,     // the CS bits a DMA header sets
+
+    SIM_PWM_CTL_PWEN1_FLAG = (1u << 0u),
+    SIM_PWM_CTL_USEF1_FLAG = (1u << 5u),
+    SIM_PWM_CTL_CLRF1_FLAG = (1u << 6u),
+    SIM_PWM_CTL_PWEN2_FLAG = (1u << 8u),
+    SIM_PWM_CTL_USEF2_FLAG = (1u << 13u),
+    SIM_PWM_STA_FULL1_FLAG = (1u << 0u),
+    SIM_PWM_STA_EMPT1_FLAG = (1u << 1u),
+    SIM_PWM_DMAC_DREQ_MASK = 0xFFu,
+    SIM_PWM_DMAC_ENAB_FLAG = (1u << 31u),
+
+    SIM_DMA_CS_ACTIVE_FLAG = (1u << 0u),
+    SIM_DMA_CS_END_FLAG    = (1u << 1u),
+    SIM_DMA_CS_INT_FLAG    = (1u << 2u),
+    SIM_DMA_CS_ABORT_FLAG  = (1u << 30u),
+    SIM_DMA_CS_RESET_FLAG  = (1u << 31u),
+    SIM_DMA_CS_RW_MASK     = 0x30FF0000u, // priorities, WAIT_FOR_OUTSTANDING_WRITES and DISDEBUG
+
+    SIM_AUX_IRQ_MUART_FLAG         = (1u << 0u),
+    SIM_AUX_ENABLES_MUART_FLAG     = (1u << 0u),
+    SIM_AUX_MU_IER_RX_FLAG         = (1u << 0u),
+    SIM_AUX_MU_IER_TX_FLAG         = (1u << 1u),
+    SIM_AUX_MU_IIR_NO_PENDING_FLAG = (1u << 0u),
+    SIM_AUX_MU_IIR_TX_EMPTY        = (0b01u << 1u),
+    SIM_AUX_MU_IIR_RX_VALID        = (0b10u << 1u),
+    SIM_AUX_MU_IIR_CLEAR_RX_FLAG   = (1u << 1u),
+    SIM_AUX_MU_IIR_FIFOS_ON        = 0xC0u,
+    SIM_AUX_MU_LCR_DLAB_FLAG       = (1u << 7u),
+    SIM_AUX_MU_LSR_DATA_READY_FLAG = (1u << 0u),
+    SIM_AUX_MU_LSR_TX_EMPTY_FLAG   = (1u << 5u),
+    SIM_AUX_MU_LSR_TX_IDLE_FLAG    = (1u << 6u),
+    SIM_AUX_MU_STAT_IDLE_FLAGS     = 0x30Eu,    // space available, both idle, Tx FIFO empty and Tx done
+    SIM_AUX_MU_STAT_SYMBOL_FLAG    = (1u << 0u),
+    SIM_AUX_MU_STAT_RX_LEVEL_SHIFT = 16u,
+    SIM_AUX_MU_FIFO_SIZE           = 8u,
+};
+
+/*
+--| NAME: Sim_Byte_FIFO_t
+--| DESCRIPTION: a byte FIFO, size must be a power of 2
+*/
+typedef struct Sim_Byte_FIFO_Type
+{
+    uint8_t * p_bytes;
+    uint32_t size;
+    uint32_t head; // bytes put in, wrapping
+    uint32_t tail; // bytes taken out, wrapping
+} Sim_Byte_FIFO_t;
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE CONSTANTS
+--|----------------------------------------------------------------------------|
+*/
+
+const uint32_t sim_modelled_pages[SIM_NUM_MODELLED_PAGES] =
+{
+    SIM_SYSTEM_TIMER_OFFSET,
+    SIM_DMA_OFFSET,
+    SIM_GPIO_OFFSET,
+    SIM_SPI0_OFFSET,
+    SIM_PWM_OFFSET,
+    SIM_AUX_OFFSET,
+};
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE VARIABLES
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--| NAME: timer_uSec, timer_step_uSec, timer_match_flags
+--| DESCRIPTION: the virtual System Timer count, how far the next read moves
+--|   it, and the compare match flags of CS. The count is volatile as the
+--|   fault handler moves it on behind the back of code reading it
+--| TYPE: uint64_t, uint32_t, uint32_t
+*/
+static volatile uint64_t timer_uSec;
+static uint32_t timer_step_uSec;
+static uint32_t timer_match_flags;
+
+/*
+--| NAME: gpio_outputs, gpio_inputs, gpio_levels, gpio_events
+--| DESCRIPTION: per bank, the output latches set by GPSET and GPCLR, the
+--|   levels driven from outside, the last pin levels seen, and the event
+--|   detect status of GPEDS
+--| TYPE: uint32_t[2]
+*/
+static uint32_t gpio_outputs[2u];
+static uint32_t gpio_inputs[2u];
+static uint32_t gpio_levels[2u];
+static uint32_t gpio_events[2u];
+
+/*
+--| NAME: spi0_tx_bytes, spi0_rx_bytes, spi0_tx, spi0_rx
+--| DESCRIPTION: the SPI 0 FIFOs
+--| TYPE: uint8_t[], Sim_Byte_FIFO_t
+*/
+static uint8_t spi0_tx_bytes[SIM_SPI0_FIFO_SIZE];
+static uint8_t spi0_rx_bytes[SIM_SPI0_FIFO_SIZE];
+static Sim_Byte_FIFO_t spi0_tx = { spi0_tx_bytes, SIM_SPI0_FIFO_SIZE, 0u, 0u };
+static Sim_Byte_FIFO_t spi0_rx = { spi0_rx_bytes, SIM_SPI0_FIFO_SIZE, 0u, 0u };
+
+/*
+--| NAME: spi0_dma_bytes_left
+--| DESCRIPTION: bytes of the current DMA chunk the Tx FIFO still takes, the
+--|   next FIFO write in DMA mode is a header once this is 0
+--| TYPE: uint32_t
+*/
+static uint32_t spi0_dma_bytes_left;
+
+/*
+--| NAME: spi0_devices
+--| DESCRIPTION: the device on each chip select
+--| TYPE: PSP_Sim_SPI_Device_t[]
+*/
+static PSP_Sim_SPI_Device_t spi0_devices[SIM_SPI0_NUM_CHIP_SELECTS];
+
+/*
+--| NAME: pwm_fifo_words, pwm_fifo_head, pwm_fifo_tail
+--| DESCRIPTION: the PWM FIFO, and the words put in and taken out, wrapping
+--| TYPE: uint32_t[], uint32_t, uint32_t
+*/
+static uint32_t pwm_fifo_words[SIM_PWM_FIFO_SIZE];
+static uint32_t pwm_fifo_head;
+static uint32_t pwm_fifo_tail;
+
+/*
+--| NAME: pwm_clock_uSec
+--| DESCRIPTION: time since the channels last took their words
+--| TYPE: uint64_t
+*/
+static uint64_t pwm_clock_uSec;
+
+/*
+--| NAME: pwm_sink
+--| DESCRIPTION: where the words played go
+--| TYPE: PSP_Sim_PWM_Sink_t
+*/
+static PSP_Sim_PWM_Sink_t pwm_sink;
+
+/*
+--| NAME: dma_block_loaded, dma_end_int_flags, dma_is_running
+--| DESCRIPTION: per channel, true once the control block at CONBLK_AD has
+--|   been loaded, and the END and INT flags of CS; true while the channels
+--|   are being run, so a DMA write into SPI 0 doesn't start another run
+--| TYPE: uint32_t[], uint32_t[], uint32_t
+*/
+static uint32_t dma_block_loaded[SIM_DMA_NUM_CHANNELS];
+static uint32_t dma_end_int_flags[SIM_DMA_NUM_CHANNELS];
+static uint32_t dma_is_running;
+
+/*
+--| NAME: mini_uart_rx_bytes, mini_uart_tx_bytes, mini_uart_rx, mini_uart_tx
+--| DESCRIPTION: the bytes waiting to be received and the bytes sent
+--| TYPE: uint8_t[], Sim_Byte_FIFO_t
+*/
+static uint8_t mini_uart_rx_bytes[SIM_MINI_UART_RX_SIZE];
+static uint8_t mini_uart_tx_bytes[SIM_MINI_UART_TX_SIZE];
+static Sim_Byte_FIFO_t mini_uart_rx = { mini_uart_rx_bytes, SIM_MINI_UART_RX_SIZE, 0u, 0u };
+static Sim_Byte_FIFO_t mini_uart_tx = { mini_uart_tx_bytes, SIM_MINI_UART_TX_SIZE, 0u, 0u };
+
+/*
+--| NAME: mini_uart_echo
+--| DESCRIPTION: true to copy sent bytes to stdout
+--| TYPE: uint32_t
+*/
+static uint32_t mini_uart_echo;
+
+/*
+--| NAME: ili9341
+--| DESCRIPTION: the state of the ILI9341 model
+--| TYPE: struct
+*/
+static struct
+{
+    uint32_t dc_pin_num;           // GPIO pin on D/C
+    uint8_t command;               // last command received
+    uint32_t num_params;           // parameter bytes received since
+    uint8_t params[4u];            // the first parameter bytes
+    uint8_t registers[256u];       // first parameter of every command
+    uint32_t column_start;         // CASET window
+    uint32_t column_end;
+    uint32_t page_start;           // PASET window
+    uint32_t page_end;
+    uint32_t column;               // next pixel written
+    uint32_t page;
+    uint32_t is_asleep;            // true until SLPOUT
+    uint32_t is_display_on;        // true after DISPON
+    uint16_t memory[PSP_SIM_ILI9341_MAX_SIZE][PSP_SIM_ILI9341_MAX_SIZE]; // [page][column]
+} ili9341;
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE HELPER FUNCTION PROTOTYPES
+--|----------------------------------------------------------------------------|
+*/
+
+static uint32_t FIFO_Count(const Sim_Byte_FIFO_t * p_fifo);
+static uint32_t FIFO_Put(Sim_Byte_FIFO_t * p_fifo, uint8_t value);
+static uint8_t FIFO_Take(Sim_Byte_FIFO_t * p_fifo);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    Sim_Bus_Read, Sim_Bus_Write
+
+Function Description:
+    Read or write a modelled register as the DMA engine does, through the
+    model but without trapping.
+
+Parameters:
+    offset: the register offset in the peripheral block.
+    value: the value to write.
+
+Returns:
+    uint32_t: the value read.
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+static uint32_t Sim_Bus_Read(uint32_t offset);
+static void Sim_Bus_Write(uint32_t offset, uint32_t value);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    Timer_Read, Timer_Write, Timer_Advance
+
+Function Description:
+    The System Timer model. Reads of CLO and CHI move the clock forward,
+    CS match flags are cleared by writing a 1.
+
+Parameters:
+    reg: the register offset within the System Timer.
+    delta_uSec: time to move forward.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+static void Timer_Read(uint32_t reg);
+static void Timer_Write(uint32_t reg);
+static void Timer_Advance(uint64_t delta_uSec);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    GPIO_Read, GPIO_Write, GPIO_Update
+
+Function Description:
+    The GPIO model. GPIO_Update works out the pin levels from the function
+    selects, output latches and inputs, and latches any events detected.
+
+Parameters:
+    reg: the register offset within GPIO.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    Only the input and output functions are modelled, a pin in an alt
+    function reads its input level.
+------------------------------------------------------------------------------*/
+static void GPIO_Read(uint32_t reg);
+static void GPIO_Write(uint32_t reg);
+static void GPIO_Update(void);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    SPI0_Read, SPI0_Write, SPI0_Clock, SPI0_Tx_DREQ, SPI0_Rx_DREQ
+
+Function Description:
+    The SPI 0 model. SPI0_Clock shifts out what it can and updates the
+    status bits of CS. The DREQ functions tell whether the FIFOs would
+    request a word from the DMA.
+
+Parameters:
+    reg: the register offset within SPI 0.
+
+Returns:
+    uint32_t: for the DREQs, true if a word is requested.
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+static void SPI0_Read(uint32_t reg);
+static void SPI0_Write(uint32_t reg);
+static void SPI0_Clock(void);
+static uint32_t SPI0_Tx_DREQ(void);
+static uint32_t SPI0_Rx_DREQ(void);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PWM_Read, PWM_Write, PWM_Clock, PWM_DREQ
+
+Function Description:
+    The PWM FIFO model. PWM_Clock has the channels that use the FIFO take a
+    word each per period, and lets the DMA top it up. PWM_DREQ tells whether
+    the FIFO would request a word from the DMA.
+
+Parameters:
+    reg: the register offset within the PWM.
+    delta_uSec: time the clock moved forward.
+
+Returns:
+    uint32_t: for the DREQ, true if a word is requested.
+
+Assumptions/Limitations:
+    Both channels play at the RNG1 rate. A channel finding the FIFO empty
+    plays nothing, the error flags are not modelled.
+------------------------------------------------------------------------------*/
+static void PWM_Read(uint32_t reg);
+static void PWM_Write(uint32_t reg);
+static void PWM_Clock(uint64_t delta_uSec);
+static uint32_t PWM_DREQ(void);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    DMA_Write, DMA_Run, DMA_Step
+
+Function Description:
+    The DMA engine model. DMA_Run steps every active channel until none can
+    move. DMA_Step moves one word for a DREQ paced control block, or the
+    rest of the control block otherwise.
+
+Parameters:
+    reg: the register offset within the DMA page.
+    channel: the channel to step.
+
+Returns:
+    uint32_t: for DMA_Step, the number of words moved.
+
+Assumptions/Limitations:
+    2D mode and 128 bit wide transfers are not modelled.
+------------------------------------------------------------------------------*/
+static void DMA_Write(uint32_t reg);
+static void DMA_Run(void);
+static uint32_t DMA_Step(uint32_t channel);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    Aux_Read, Aux_Write, Aux_Is_Mini_Uart_Pending
+
+Function Description:
+    The mini UART model. Bytes are sent the moment they are written.
+
+Parameters:
+    reg: the register offset within the aux peripherals.
+
+Returns:
+    uint32_t: true if the mini UART interrupt is asserted.
+
+Assumptions/Limitations:
+    The aux SPIs are not modelled.
+------------------------------------------------------------------------------*/
+static void Aux_Read(uint32_t reg);
+static void Aux_Write(uint32_t reg);
+static uint32_t Aux_Is_Mini_Uart_Pending(void);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    ILI9341_Reset, ILI9341_SPI_Byte
+
+Function Description:
+    The ILI9341 model, a PSP_Sim_SPI_Device_t.
+
+Parameters:
+    mosi_byte: a command with D/C low, a parameter or pixel byte with it
+    high.
+
+Returns:
+    uint8_t: always 0, reads are not modelled.
+
+Assumptions/Limitations:
+    Only 16 bit pixels are modelled.
+------------------------------------------------------------------------------*/
+static void ILI9341_Reset(void);
+static uint8_t ILI9341_SPI_Byte(uint8_t mosi_byte);
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC FUNCTION DEFINITIONS
+--|----------------------------------------------------------------------------|
+*/
+
+void Sim_Models_Reset(void)
+{
+    timer_uSec = 0u;
+    timer_step_uSec = 1u;
+    timer_match_flags = 0u;
+
+    for (uint32_t bank = 0u; bank < 2u; bank++)
+    {
+        gpio_outputs[bank] = 0u;
+        gpio_inputs[bank] = 0u;
+        gpio_levels[bank] = 0u;
+        gpio_events[bank] = 0u;
+    }
+
+    spi0_tx.head = spi0_tx.tail = 0u;
+    spi0_rx.head = spi0_rx.tail = 0u;
+    spi0_dma_bytes_left = 0u;
+
+    for (uint32_t chip_select = 0u; chip_select < SIM_SPI0_NUM_CHIP_SELECTS; chip_select++)
+    {
+        spi0_devices[chip_select] = 0;
+    }
+
+    pwm_fifo_head = pwm_fifo_tail = 0u;
+    pwm_clock_uSec = 0u;
+    pwm_sink = 0;
+
+    for (uint32_t channel = 0u; channel < SIM_DMA_NUM_CHANNELS; channel++)
+    {
+        dma_block_loaded[channel] = 0u;
+        dma_end_int_flags[channel] = 0u;
+    }
+
+    dma_is_running = 0u;
+
+    mini_uart_rx.head = mini_uart_rx.tail = 0u;
+    mini_uart_tx.head = mini_uart_tx.tail = 0u;
+    mini_uart_echo = 0u;
+
+    ili9341.dc_pin_num = SIM_GPIO_NUM_PINS;
+    ILI9341_Reset();
+
+    // reset values of the status registers
+    SPI0_Clock();
+    PWM_Read(SIM_PWM_STA);
+    Aux_Read(SIM_AUX_MU_LSR);
+    Aux_Read(SIM_AUX_MU_IIR);
+    Aux_Read(SIM_AUX_MU_STAT);
+}
+
+void Sim_Models_Read(uint32_t offset)
+{
+    const uint32_t page = offset & ~(SIM_PAGE_SIZE - 1u);
+    const uint32_t reg = offset & (SIM_PAGE_SIZE - 1u);
+
+    switch (page)
+    {
+        case SIM_SYSTEM_TIMER_OFFSET:
+            Timer_Read(reg);
+            break;
+        case SIM_GPIO_OFFSET:
+            GPIO_Read(reg);
+            break;
+        case SIM_SPI0_OFFSET:
+            SPI0_Read(reg);
+            break;
+        case SIM_PWM_OFFSET:
+            PWM_Read(reg);
+            break;
+        case SIM_AUX_OFFSET:
+            Aux_Read(reg);
+            break;
+        default:
+            /* plain memory, do nothing */
+            break;
+    }
+}
+
+void Sim_Models_Write(uint32_t offset)
+{
+    const uint32_t page = offset & ~(SIM_PAGE_SIZE - 1u);
+    const uint32_t reg = offset & (SIM_PAGE_SIZE - 1u);
+
+    // a write means the program is doing something, not busy waiting
+    timer_step_uSec = 1u;
+
+    switch (page)
+    {
+        case SIM_SYSTEM_TIMER_OFFSET:
+            Timer_Write(reg);
+            break;
+        case SIM_DMA_OFFSET:
+            DMA_Write(reg);
+            break;
+        case SIM_GPIO_OFFSET:
+            GPIO_Write(reg);
+            break;
+        case SIM_SPI0_OFFSET:
+            SPI0_Write(reg);
+            break;
+        case SIM_PWM_OFFSET:
+            PWM_Write(reg);
+            break;
+        case SIM_AUX_OFFSET:
+            Aux_Write(reg);
+            break;
+        default:
+            /* plain memory, do nothing */
+            break;
+    }
+}
+
+uint32_t Sim_Models_Is_Interrupt_Pending(uint32_t source)
+{
+    uint32_t retval = 0u;
+
+    if ((source == PSP_IRQ_SOURCE_SYSTEM_TIMER_1) || (source == PSP_IRQ_SOURCE_SYSTEM_TIMER_3))
+    {
+        retval = timer_match_flags & (1u << source);
+    }
+    else if ((PSP_IRQ_SOURCE_DMA_0 <= source) && (source <= PSP_IRQ_SOURCE_DMA_12))
+    {
+        retval = dma_end_int_flags[source - PSP_IRQ_SOURCE_DMA_0] & SIM_DMA_CS_INT_FLAG;
+    }
+    else if (source == PSP_IRQ_SOURCE_AUX)
+    {
+        retval = Aux_Is_Mini_Uart_Pending();
+    }
+    else if (source == PSP_IRQ_SOURCE_GPIO_0)
+    {
+        retval = gpio_events[0];
+    }
+    else if (source == PSP_IRQ_SOURCE_GPIO_1)
+    {
+        retval = gpio_events[1];
+    }
+    else if (source == PSP_IRQ_SOURCE_GPIO_3)
+    {
+        retval = gpio_events[0] | gpio_events[1];
+    }
+    else
+    {
+        /* no model drives this source, do nothing */
+    }
+
+    return retval != 0u;
+}
+
+uint64_t PSP_Sim_Time_Get(void)
+{
+    return timer_uSec;
+}
+
+void PSP_Sim_Time_Advance(uint64_t delta_uSec)
+{
+    Timer_Advance(delta_uSec);
+}
+
+void PSP_Sim_GPIO_Set_Input(uint32_t pin_num, uint32_t level)
+{
+    if (pin_num < SIM_GPIO_NUM_PINS)
+    {
+        const uint32_t bank = pin_num / 32u;
+        const uint32_t pin_flag = 1u << (pin_num % 32u);
+
+        if (level)
+        {
+            gpio_inputs[bank] |= pin_flag;
+        }
+        else
+        {
+            gpio_inputs[bank] &= ~pin_flag;
+        }
+
+        GPIO_Update();
+    }
+    else
+    {
+        /* invalid pin, do nothing */
+    }
+}
+
+uint32_t PSP_Sim_GPIO_Get_Level(uint32_t pin_num)
+{
+    uint32_t retval = 0u;
+
+    if (pin_num < SIM_GPIO_NUM_PINS)
+    {
+        GPIO_Update();
+
+        retval = (gpio_levels[pin_num / 32u] >> (pin_num % 32u)) & 1u;
+    }
+
+    return retval;
+}
+
+void PSP_Sim_SPI0_Attach(uint32_t chip_select, PSP_Sim_SPI_Device_t device)
+{
+    if (chip_select < SIM_SPI0_NUM_CHIP_SELECTS)
+    {
+        spi0_devices[chip_select] = device;
+    }
+    else
+    {
+        /* invalid chip select, do nothing */
+    }
+}
+
+void PSP_Sim_PWM_Attach(PSP_Sim_PWM_Sink_t sink)
+{
+    pwm_sink = sink;
+}
+
+uint32_t PSP_Sim_Mini_Uart_Inject(const uint8_t * p_bytes, uint32_t length)
+{
+    uint32_t num_queued = 0u;
+
+    while ((num_queued < length) && FIFO_Put(&mini_uart_rx, p_bytes[num_queued]))
+    {
+        num_queued++;
+    }
+
+    return num_queued;
+}
+
+uint32_t PSP_Sim_Mini_Uart_Take_Tx(uint8_t * p_bytes, uint32_t length)
+{
+    uint32_t num_taken = 0u;
+
+    while ((num_taken < length) && FIFO_Count(&mini_uart_tx))
+    {
+        p_bytes[num_taken++] = FIFO_Take(&mini_uart_tx);
+    }
+
+    return num_taken;
+}
+
+void PSP_Sim_Mini_Uart_Set_Echo(uint32_t enable)
+{
+    mini_uart_echo = enable;
+}
+
+void PSP_Sim_ILI9341_Attach(uint32_t chip_select, uint32_t dc_pin_num)
+{
+    ili9341.dc_pin_num = dc_pin_num;
+    ILI9341_Reset();
+
+    PSP_Sim_SPI0_Attach(chip_select, ILI9341_SPI_Byte);
+}
+
+uint16_t PSP_Sim_ILI9341_Get_Pixel(uint32_t column, uint32_t page)
+{
+    uint16_t retval = 0u;
+
+    if ((column < PSP_SIM_ILI9341_MAX_SIZE) && (page < PSP_SIM_ILI9341_MAX_SIZE))
+    {
+        retval = ili9341.memory[page][column];
+    }
+
+    return retval;
+}
+
+uint32_t PSP_Sim_ILI9341_Is_Display_On(void)
+{
+    return !ili9341.is_asleep && ili9341.is_display_on;
+}
+
+uint8_t PSP_Sim_ILI9341_Get_Register(uint8_t command)
+{
+    return ili9341.registers[command];
+}
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE HELPER FUNCTION DEFINITIONS
+--|----------------------------------------------------------------------------|
+*/
+
+static uint32_t FIFO_Count(const Sim_Byte_FIFO_t * p_fifo)
+{
+    return p_fifo->head - p_fifo->tail;
+}
+
+static uint32_t FIFO_Put(Sim_Byte_FIFO_t * p_fifo, uint8_t value)
+{
+    uint32_t retval = 0u;
+
+    if (FIFO_Count(p_fifo) < p_fifo->size)
+    {
+        p_fifo->p_bytes[p_fifo->head++ & (p_fifo->size - 1u)] = value;
+        retval = 1u;
+    }
+
+    return retval;
+}
+
+static uint8_t FIFO_Take(Sim_Byte_FIFO_t * p_fifo)
+{
+    uint8_t retval = 0u;
+
+    if (FIFO_Count(p_fifo))
+    {
+        retval = p_fifo->p_bytes[p_fifo->tail++ & (p_fifo->size - 1u)];
+    }
+
+    return retval;
+}
+
+static uint32_t Sim_Bus_Read(uint32_t offset)
+{
+    Sim_Models_Read(offset);
+
+    return SIM_REG(offset);
+}
+
+static void Sim_Bus_Write(uint32_t offset, uint32_t value)
+{
+    SIM_REG(offset) = value;
+
+    Sim_Models_Write(offset);
+}
+
+static void Timer_Read(uint32_t reg)
+{
+    if ((reg == SIM_TIMER_CLO) || (reg == SIM_TIMER_CHI))
+    {
+        Timer_Advance(timer_step_uSec);
+
+        // keep speeding up until something is written
+        if (timer_step_uSec < SIM_TIMER_MAX_STEP_uSec)
+        {
+            timer_step_uSec *= 2u;
+        }
+    }
+
+    SIM_REG(SIM_SYSTEM_TIMER_OFFSET + SIM_TIMER_CS) = timer_match_flags;
+}
+
+static void Timer_Write(uint32_t reg)
+{
+    if (reg == SIM_TIMER_CS)
+    {
+        timer_match_flags &= ~SIM_REG(SIM_SYSTEM_TIMER_OFFSET + SIM_TIMER_CS);
+    }
+
+    // CS and the counter are read only
+    SIM_REG(SIM_SYSTEM_TIMER_OFFSET + SIM_TIMER_CS) = timer_match_flags;
+    SIM_REG(SIM_SYSTEM_TIMER_OFFSET + SIM_TIMER_CLO) = (uint32_t)timer_uSec;
+    SIM_REG(SIM_SYSTEM_TIMER_OFFSET + SIM_TIMER_CHI) = (uint32_t)(timer_uSec >> 32u);
+}
+
+static void Timer_Advance(uint64_t delta_uSec)
+{
+    const uint32_t old_low = (uint32_t)timer_uSec;
+
+    timer_uSec += delta_uSec;
+
+    for (uint32_t channel = 0u; channel < 4u; channel++)
+    {
+        const uint32_t compare = SIM_REG(SIM_SYSTEM_TIMER_OFFSET + SIM_TIMER_C0 + (4u * channel));
+
+        // the compare value was passed if it is in (old, new]
+        if ((delta_uSec > 0xFFFFFFFFull) || ((uint64_t)(uint32_t)(compare - old_low - 1u) < delta_uSec))
+        {
+            timer_match_flags |= 1u << channel;
+        }
+    }
+
+    SIM_REG(SIM_SYSTEM_TIMER_OFFSET + SIM_TIMER_CLO) = (uint32_t)timer_uSec;
+    SIM_REG(SIM_SYSTEM_TIMER_OFFSET + SIM_TIMER_CHI) = (uint32_t)(timer_uSec >> 32u);
+
+    PWM_Clock(delta_uSec);
+}
+
+static void GPIO_Read(uint32_t reg)
+{
+    if (((SIM_GPIO_GPLEV0 <= reg) && (reg < SIM_GPIO_GPLEV0 + 8u)) ||
+        ((SIM_GPIO_GPEDS0 <= reg) && (reg < SIM_GPIO_GPEDS0 + 8u)))
+    {
+        GPIO_Update();
+    }
+}
+
+static void GPIO_Write(uint32_t reg)
+{
+    const uint32_t value = SIM_REG(SIM_GPIO_OFFSET + reg);
+
+    if ((SIM_GPIO_GPSET0 <= reg) && (reg < SIM_GPIO_GPSET0 + 8u))
+    {
+        gpio_outputs[(reg - SIM_GPIO_GPSET0) / 4u] |= value;
+        SIM_REG(SIM_GPIO_OFFSET + reg) = 0u;
+    }
+    else if ((SIM_GPIO_GPCLR0 <= reg) && (reg < SIM_GPIO_GPCLR0 + 8u))
+    {
+        gpio_outputs[(reg - SIM_GPIO_GPCLR0) / 4u] &= ~value;
+        SIM_REG(SIM_GPIO_OFFSET + reg) = 0u;
+    }
+    else if ((SIM_GPIO_GPEDS0 <= reg) && (reg < SIM_GPIO_GPEDS0 + 8u))
+    {
+        gpio_events[(reg - SIM_GPIO_GPEDS0) / 4u] &= ~value;
+    }
+    else
+    {
+        /* function selects and detect enables are plain registers */
+    }
+
+    GPIO_Update();
+}
+
+static void GPIO_Update(void)
+{
+    uint32_t is_output[2u] = { 0u, 0u };
+
+    for (uint32_t pin_num = 0u; pin_num < SIM_GPIO_NUM_PINS; pin_num++)
+    {
+        const uint32_t function_select = SIM_REG(SIM_GPIO_OFFSET + SIM_GPIO_GPFSEL0 + (4u * (pin_num / 10u)));
+
+        if (((function_select >> (3u * (pin_num % 10u))) & 0b111u) == 0b001u)
+        {
+            is_output[pin_num / 32u] |= 1u << (pin_num % 32u);
+        }
+    }
+
+    for (uint32_t bank = 0u; bank < 2u; bank++)
+    {
+        const uint32_t bank_offset = SIM_GPIO_OFFSET + (4u * bank);
+        const uint32_t pins_mask = (bank == 0u) ? 0xFFFFFFFFu : ((1u << (SIM_GPIO_NUM_PINS - 32u)) - 1u);
+
+        const uint32_t level = ((gpio_outputs[bank] & is_output[bank]) | (gpio_inputs[bank] & ~is_output[bank])) & pins_mask;
+        const uint32_t rising = level & ~gpio_levels[bank];
+        const uint32_t falling = gpio_levels[bank] & ~level;
+
+        gpio_events[bank] |= (rising & (SIM_REG(bank_offset + SIM_GPIO_GPREN0) | SIM_REG(bank_offset + SIM_GPIO_GPAREN0))) |
+                             (falling & (SIM_REG(bank_offset + SIM_GPIO_GPFEN0) | SIM_REG(bank_offset + SIM_GPIO_GPAFEN0))) |
+                             (level & SIM_REG(bank_offset + SIM_GPIO_GPHEN0)) |
+                             (~level & pins_mask & SIM_REG(bank_offset + SIM_GPIO_GPLEN0));
+
+        gpio_levels[bank] = level;
+
+        SIM_REG(bank_offset + SIM_GPIO_GPLEV0) = level;
+        SIM_REG(bank_offset + SIM_GPIO_GPEDS0) = gpio_events[bank];
+    }
+}
+
+static void SPI0_Read(uint32_t reg)
+{
+    if (reg == SIM_SPI0_FIFO)
+    {
+        uint32_t value = FIFO_Take(&spi0_rx);
+
+        // in DMA mode the FIFO is read a word, 4 bytes, at a time
+        if (SIM_REG(SIM_SPI0_OFFSET + SIM_SPI0_CS) & SIM_SPI0_CS_DMAEN_FLAG)
+        {
+            for (uint32_t i = 1u; i < 4u; i++)
+            {
+                value |= (uint32_t)FIFO_Take(&spi0_rx) << (8u * i);
+            }
+        }
+
+        SIM_REG(SIM_SPI0_OFFSET + SIM_SPI0_FIFO) = value;
+    }
+
+    SPI0_Clock();
+    DMA_Run();
+}
+
+static void SPI0_Write(uint32_t reg)
+{
+    const uint32_t value = SIM_REG(SIM_SPI0_OFFSET + reg);
+    vuint32_t * p_cs = Sim_Register(SIM_SPI0_OFFSET + SIM_SPI0_CS);
+
+    if (reg == SIM_SPI0_CS)
+    {
+        if (value & SIM_SPI0_CS_CLEAR_TX_FLAG)
+        {
+            spi0_tx.tail = spi0_tx.head;
+            spi0_dma_bytes_left = 0u;
+        }
+
+        if (value & SIM_SPI0_CS_CLEAR_RX_FLAG)
+        {
+            spi0_rx.tail = spi0_rx.head;
+        }
+
+        // CLEAR is one shot
+        *p_cs = value & ~(SIM_SPI0_CS_CLEAR_TX_FLAG | SIM_SPI0_CS_CLEAR_RX_FLAG);
+    }
+    else if (reg == SIM_SPI0_FIFO)
+    {
+        if (!(*p_cs & SIM_SPI0_CS_DMAEN_FLAG))
+        {
+            FIFO_Put(&spi0_tx, (uint8_t)value);
+        }
+        else if (spi0_dma_bytes_left == 0u)
+        {
+            // a header, sets DLEN and the low byte of CS, TA included
+            spi0_dma_bytes_left = value >> 16u;
+            SIM_REG(SIM_SPI0_OFFSET + SIM_SPI0_DLEN) = spi0_dma_bytes_left;
+            *p_cs = (*p_cs & ~SIM_SPI0_CS_HEADER_MASK) | (value & SIM_SPI0_CS_HEADER_MASK);
+        }
+        else
+        {
+            // data, only DLEN bytes are sent, the rest of the last word is dropped
+            for (uint32_t i = 0u; (i < 4u) && spi0_dma_bytes_left; i++, spi0_dma_bytes_left--)
+            {
+                FIFO_Put(&spi0_tx, (uint8_t)(value >> (8u * i)));
+            }
+        }
+    }
+    else
+    {
+        /* CLK, DLEN, LTOH and DC are plain registers */
+    }
+
+    SPI0_Clock();
+    DMA_Run();
+}
+
+static void SPI0_Clock(void)
+{
+    vuint32_t * p_cs = Sim_Register(SIM_SPI0_OFFSET + SIM_SPI0_CS);
+
+    while ((*p_cs & SIM_SPI0_CS_TA_FLAG) && FIFO_Count(&spi0_tx) && (FIFO_Count(&spi0_rx) < SIM_SPI0_FIFO_SIZE))
+    {
+        const uint8_t mosi_byte = FIFO_Take(&spi0_tx);
+        const PSP_Sim_SPI_Device_t device = spi0_devices[(*p_cs & SIM_SPI0_CS_CHIP_SEL_MASK) % SIM_SPI0_NUM_CHIP_SELECTS];
+
+        FIFO_Put(&spi0_rx, device ? device(mosi_byte) : 0xFFu);
+
+        sim_stats.spi0_bytes++;
+    }
+
+    const uint32_t is_done = (FIFO_Count(&spi0_tx) == 0u) && (spi0_dma_bytes_left == 0u);
+
+    // in DMA mode TA drops once DLEN bytes are out, ready for the next header
+    if ((*p_cs & SIM_SPI0_CS_DMAEN_FLAG) && is_done)
+    {
+        *p_cs &= ~SIM_SPI0_CS_TA_FLAG;
+    }
+
+    uint32_t status = 0u;
+
+    if ((*p_cs & SIM_SPI0_CS_TA_FLAG) && is_done)
+    {
+        status |= SIM_SPI0_CS_DONE_FLAG;
+    }
+
+    if (FIFO_Count(&spi0_tx) < SIM_SPI0_FIFO_SIZE)
+    {
+        status |= SIM_SPI0_CS_TXD_FLAG;
+    }
+
+    if (FIFO_Count(&spi0_rx))
+    {
+        status |= SIM_SPI0_CS_RXD_FLAG;
+    }
+
+    if (FIFO_Count(&spi0_rx) >= ((3u * SIM_SPI0_FIFO_SIZE) / 4u))
+    {
+        status |= SIM_SPI0_CS_RXR_FLAG;
+    }
+
+    if (FIFO_Count(&spi0_rx) == SIM_SPI0_FIFO_SIZE)
+    {
+        status |= SIM_SPI0_CS_RXF_FLAG;
+    }
+
+    const uint32_t status_mask = SIM_SPI0_CS_DONE_FLAG | SIM_SPI0_CS_RXD_FLAG | SIM_SPI0_CS_TXD_FLAG |
+                                 SIM_SPI0_CS_RXR_FLAG | SIM_SPI0_CS_RXF_FLAG;
+
+    *p_cs = (*p_cs & ~status_mask) | status;
+}
+
+static uint32_t SPI0_Tx_DREQ(void)
+{
+    // room for a word, headers included
+    return FIFO_Count(&spi0_tx) <= (SIM_SPI0_FIFO_SIZE - 4u);
+}
+
+static uint32_t SPI0_Rx_DREQ(void)
+{
+    const uint32_t is_done = (FIFO_Count(&spi0_tx) == 0u) && (spi0_dma_bytes_left == 0u);
+
+    // a word, or the last bytes once the transfer is done
+    return (FIFO_Count(&spi0_rx) >= 4u) || (is_done && FIFO_Count(&spi0_rx));
+}
+
+static void PWM_Read(uint32_t reg)
+{
+    const uint32_t count = pwm_fifo_head - pwm_fifo_tail;
+
+    if (reg == SIM_PWM_STA)
+    {
+        SIM_REG(SIM_PWM_OFFSET + SIM_PWM_STA) = ((count == SIM_PWM_FIFO_SIZE) ? SIM_PWM_STA_FULL1_FLAG : 0u) |
+                                                ((count == 0u) ? SIM_PWM_STA_EMPT1_FLAG : 0u);
+    }
+}
+
+static void PWM_Write(uint32_t reg)
+{
+    const uint32_t value = SIM_REG(SIM_PWM_OFFSET + reg);
+
+    if (reg == SIM_PWM_CTL)
+    {
+        if (value & SIM_PWM_CTL_CLRF1_FLAG)
+        {
+            pwm_fifo_tail = pwm_fifo_head;
+        }
+
+        // CLRF1 is one shot
+        SIM_REG(SIM_PWM_OFFSET + SIM_PWM_CTL) = value & ~SIM_PWM_CTL_CLRF1_FLAG;
+    }
+    else if (reg == SIM_PWM_FIF1)
+    {
+        if ((pwm_fifo_head - pwm_fifo_tail) < SIM_PWM_FIFO_SIZE)
+        {
+            pwm_fifo_words[pwm_fifo_head++ % SIM_PWM_FIFO_SIZE] = value;
+        }
+    }
+    else
+    {
+        /* DMAC and the ranges are plain registers */
+    }
+
+    PWM_Read(SIM_PWM_STA);
+    DMA_Run();
+}
+
+static void PWM_Clock(uint64_t delta_uSec)
+{
+    const uint32_t ctl = SIM_REG(SIM_PWM_OFFSET + SIM_PWM_CTL);
+    const uint32_t range = SIM_REG(SIM_PWM_OFFSET + SIM_PWM_RNG1);
+    const uint32_t channel_1_flags = SIM_PWM_CTL_PWEN1_FLAG | SIM_PWM_CTL_USEF1_FLAG;
+    const uint32_t channel_2_flags = SIM_PWM_CTL_PWEN2_FLAG | SIM_PWM_CTL_USEF2_FLAG;
+    const uint32_t num_channels = ((ctl & channel_1_flags) == channel_1_flags) +
+                                  ((ctl & channel_2_flags) == channel_2_flags);
+
+    if (num_channels && range)
+    {
+        pwm_clock_uSec += delta_uSec;
+
+        while (pwm_clock_uSec >= range)
+        {
+            pwm_clock_uSec -= range;
+
+            // with both channels on the FIFO they take its words in turn
+            for (uint32_t i = 0u; (i < num_channels) && (pwm_fifo_head != pwm_fifo_tail); i++)
+            {
+                const uint32_t word = pwm_fifo_words[pwm_fifo_tail++ % SIM_PWM_FIFO_SIZE];
+
+                if (pwm_sink)
+                {
+                    pwm_sink(word);
+                }
+
+                sim_stats.pwm_words++;
+            }
+
+            DMA_Run();
+        }
+
+        PWM_Read(SIM_PWM_STA);
+    }
+    else
+    {
+        pwm_clock_uSec = 0u;
+    }
+}
+
+static uint32_t PWM_DREQ(void)
+{
+    const uint32_t dmac = SIM_REG(SIM_PWM_OFFSET + SIM_PWM_DMAC);
+
+    // below the DREQ threshold
+    return (dmac & SIM_PWM_DMAC_ENAB_FLAG) && ((pwm_fifo_head - pwm_fifo_tail) < (dmac & SIM_PWM_DMAC_DREQ_MASK));
+}
+
+static void DMA_Write(uint32_t reg)
+{
+    const uint32_t channel = reg / SIM_DMA_CHANNEL;
+    const uint32_t channel_reg = reg % SIM_DMA_CHANNEL;
+
+    if (channel < SIM_DMA_NUM_CHANNELS)
+    {
+        const uint32_t channel_offset = SIM_DMA_OFFSET + (channel * SIM_DMA_CHANNEL);
+        const uint32_t value = SIM_REG(channel_offset + channel_reg);
+
+        if (channel_reg == SIM_DMA_CS)
+        {
+            if (value & SIM_DMA_CS_RESET_FLAG)
+            {
+                for (uint32_t i = SIM_DMA_CS; i <= SIM_DMA_DEBUG; i += 4u)
+                {
+                    SIM_REG(channel_offset + i) = 0u;
+                }
+
+                dma_block_loaded[channel] = 0u;
+                dma_end_int_flags[channel] = 0u;
+            }
+            else
+            {
+                dma_end_int_flags[channel] &= ~(value & (SIM_DMA_CS_END_FLAG | SIM_DMA_CS_INT_FLAG));
+
+                uint32_t cs = (value & (SIM_DMA_CS_RW_MASK | SIM_DMA_CS_ACTIVE_FLAG)) | dma_end_int_flags[channel];
+
+                // abort drops the current control block
+                if (value & SIM_DMA_CS_ABORT_FLAG)
+                {
+                    dma_block_loaded[channel] = 0u;
+                    cs &= ~SIM_DMA_CS_ACTIVE_FLAG;
+                }
+
+                SIM_REG(channel_offset + SIM_DMA_CS) = cs;
+            }
+        }
+        else if (channel_reg == SIM_DMA_CONBLK_AD)
+        {
+            // loaded when the channel is next activated
+            dma_block_loaded[channel] = 0u;
+        }
+        else if (channel_reg == SIM_DMA_DEBUG)
+        {
+            // the error flags clear by writing a 1
+            SIM_REG(channel_offset + SIM_DMA_DEBUG) = 0u;
+        }
+        else
+        {
+            /* the control block registers are read only, written by loading a block */
+        }
+    }
+
+    DMA_Run();
+}
+
+static void DMA_Run(void)
+{
+    if (!dma_is_running)
+    {
+        dma_is_running = 1u;
+
+        uint32_t num_words = 0u;
+        uint32_t words_moved;
+
+        do
+        {
+            words_moved = 0u;
+
+            for (uint32_t channel = 0u; channel < SIM_DMA_NUM_CHANNELS; channel++)
+            {
+                words_moved += DMA_Step(channel);
+            }
+
+            num_words += words_moved;
+        } while (words_moved && (num_words < SIM_DMA_MAX_WORDS_PER_RUN));
+
+        uint32_t int_status = 0u;
+
+        for (uint32_t channel = 0u; channel < SIM_DMA_NUM_CHANNELS; channel++)
+        {
+            if (dma_end_int_flags[channel] & SIM_DMA_CS_INT_FLAG)
+            {
+                int_status |= 1u << channel;
+            }
+        }
+
+        SIM_REG(SIM_DMA_OFFSET + SIM_DMA_INT_STATUS) = int_status;
+
+        dma_is_running = 0u;
+    }
+}
+
+static uint32_t DMA_Step(uint32_t channel)
+{
+    const uint32_t channel_offset = SIM_DMA_OFFSET + (channel * SIM_DMA_CHANNEL);
+    vuint32_t * p_cs = Sim_Register(channel_offset + SIM_DMA_CS);
+
+    uint32_t num_words = 0u;
+
+    if (!(*p_cs & SIM_DMA_CS_ACTIVE_FLAG))
+    {
+        return 0u;
+    }
+
+    if (!dma_block_loaded[channel])
+    {
+        const uint32_t control_block_address = SIM_REG(channel_offset + SIM_DMA_CONBLK_AD);
+
+        if (control_block_address == 0u)
+        {
+            *p_cs &= ~SIM_DMA_CS_ACTIVE_FLAG;
+            return 0u;
+        }
+
+        // RAM bus addresses map straight back to the host address they came from
+        const uint32_t * p_control_block = (const uint32_t *)(uintptr_t)(control_block_address & 0x3FFFFFFFu);
+
+        for (uint32_t i = 0u; i < 6u; i++)
+        {
+            SIM_REG(channel_offset + SIM_DMA_TI + (4u * i)) = p_control_block[i];
+        }
+
+        dma_block_loaded[channel] = 1u;
+    }
+
+    const uint32_t transfer_info = SIM_REG(channel_offset + SIM_DMA_TI);
+    const uint32_t peripheral = (transfer_info >> PSP_DMA_TI_PERMAP_SHIFT_AMT) & PSP_DMA_TI_PERMAP_MASK;
+    const uint32_t is_paced = transfer_info & (PSP_DMA_TI_SRC_DREQ_FLAG | PSP_DMA_TI_DEST_DREQ_FLAG);
+
+    while (SIM_REG(channel_offset + SIM_DMA_TXFR_LEN))
+    {
+        if (is_paced)
+        {
+            const uint32_t is_requested = ((peripheral == PSP_DMA_PERIPHERAL_SPI_TX) && SPI0_Tx_DREQ()) ||
+                                          ((peripheral == PSP_DMA_PERIPHERAL_SPI_RX) && SPI0_Rx_DREQ()) ||
+                                          ((peripheral == PSP_DMA_PERIPHERAL_PWM) && PWM_DREQ());
+
+            if (!is_requested || num_words)
+            {
+                break;
+            }
+        }
+
+        const uint32_t source = SIM_REG(channel_offset + SIM_DMA_SOURCE_AD);
+        const uint32_t dest = SIM_REG(channel_offset + SIM_DMA_DEST_AD);
+        const uint32_t length = SIM_REG(channel_offset + SIM_DMA_TXFR_LEN);
+        const uint32_t num_bytes = (length < 4u) ? length : 4u;
+
+        uint32_t word = 0u;
+
+        if (transfer_info & PSP_DMA_TI_SRC_IGNORE_FLAG)
+        {
+            /* nothing read */
+        }
+        else if ((source & 0xFF000000u) == 0x7E000000u)
+        {
+            word = Sim_Bus_Read(source & 0x00FFFFFFu);
+        }
+        else
+        {
+            memcpy(&word, (const void *)(uintptr_t)(source & 0x3FFFFFFFu), num_bytes);
+        }
+
+        if (transfer_info & PSP_DMA_TI_DEST_IGNORE_FLAG)
+        {
+            /* nothing written */
+        }
+        else if ((dest & 0xFF000000u) == 0x7E000000u)
+        {
+            Sim_Bus_Write(dest & 0x00FFFFFFu, word);
+        }
+        else
+        {
+            memcpy((void *)(uintptr_t)(dest & 0x3FFFFFFFu), &word, num_bytes);
+        }
+
+        if (transfer_info & PSP_DMA_TI_SRC_INC_FLAG)
+        {
+            SIM_REG(channel_offset + SIM_DMA_SOURCE_AD) = source + num_bytes;
+        }
+
+        if (transfer_info & PSP_DMA_TI_DEST_INC_FLAG)
+        {
+            SIM_REG(channel_offset + SIM_DMA_DEST_AD) = dest + num_bytes;
+        }
+
+        SIM_REG(channel_offset + SIM_DMA_TXFR_LEN) = length - num_bytes;
+
+        sim_stats.dma_bytes += num_bytes;
+        num_words++;
+    }
+
+    if (SIM_REG(channel_offset + SIM_DMA_TXFR_LEN) == 0u)
+    {
+        dma_end_int_flags[channel] |= SIM_DMA_CS_END_FLAG;
+
+        if (transfer_info & PSP_DMA_TI_INTEN_FLAG)
+        {
+            dma_end_int_flags[channel] |= SIM_DMA_CS_INT_FLAG;
+        }
+
+        const uint32_t next_control_block = SIM_REG(channel_offset + SIM_DMA_NEXTCONBK);
+
+        SIM_REG(channel_offset + SIM_DMA_CONBLK_AD) = next_control_block;
+        dma_block_loaded[channel] = 0u;
+
+        *p_cs |= dma_end_int_flags[channel];
+
+        if (next_control_block == 0u)
+        {
+            *p_cs &= ~SIM_DMA_CS_ACTIVE_FLAG;
+        }
+
+        // loading the next block counts as progress
+        num_words++;
+    }
+
+    return num_words;
+}
+
+static void Aux_Read(uint32_t reg)
+{
+    const uint32_t is_pending = Aux_Is_Mini_Uart_Pending();
+    const uint32_t rx_count = FIFO_Count(&mini_uart_rx);
+
+    if ((reg == SIM_AUX_MU_IO) && !(SIM_REG(SIM_AUX_OFFSET + SIM_AUX_MU_LCR) & SIM_AUX_MU_LCR_DLAB_FLAG))
+    {
+        SIM_REG(SIM_AUX_OFFSET + SIM_AUX_MU_IO) = FIFO_Take(&mini_uart_rx);
+    }
+    else if (reg == SIM_AUX_IRQ)
+    {
+        SIM_REG(SIM_AUX_OFFSET + SIM_AUX_IRQ) = is_pending ? SIM_AUX_IRQ_MUART_FLAG : 0u;
+    }
+    else if (reg == SIM_AUX_MU_IIR)
+    {
+        uint32_t iir = SIM_AUX_MU_IIR_FIFOS_ON;
+
+        if (!is_pending)
+        {
+            iir |= SIM_AUX_MU_IIR_NO_PENDING_FLAG;
+        }
+        else if ((SIM_REG(SIM_AUX_OFFSET + SIM_AUX_MU_IER) & SIM_AUX_MU_IER_RX_FLAG) && rx_count)
+        {
+            iir |= SIM_AUX_MU_IIR_RX_VALID;
+        }
+        else
+        {
+            iir |= SIM_AUX_MU_IIR_TX_EMPTY;
+        }
+
+        SIM_REG(SIM_AUX_OFFSET + SIM_AUX_MU_IIR) = iir;
+    }
+    else if (reg == SIM_AUX_MU_LSR)
+    {
+        SIM_REG(SIM_AUX_OFFSET + SIM_AUX_MU_LSR) = SIM_AUX_MU_LSR_TX_EMPTY_FLAG |
+                                                   SIM_AUX_MU_LSR_TX_IDLE_FLAG |
+                                                   (rx_count ? SIM_AUX_MU_LSR_DATA_READY_FLAG : 0u);
+    }
+    else if (reg == SIM_AUX_MU_STAT)
+    {
+        const uint32_t rx_level = (rx_count < SIM_AUX_MU_FIFO_SIZE) ? rx_count : SIM_AUX_MU_FIFO_SIZE;
+
+        SIM_REG(SIM_AUX_OFFSET + SIM_AUX_MU_STAT) = SIM_AUX_MU_STAT_IDLE_FLAGS |
+                                                    (rx_count ? SIM_AUX_MU_STAT_SYMBOL_FLAG : 0u) |
+                                                    (rx_level << SIM_AUX_MU_STAT_RX_LEVEL_SHIFT);
+    }
+    else
+    {
+        /* plain register, do nothing */
+    }
+}
+
+static void Aux_Write(uint32_t reg)
+{
+    const uint32_t value = SIM_REG(SIM_AUX_OFFSET + reg);
+
+    if ((reg == SIM_AUX_MU_IO) && !(SIM_REG(SIM_AUX_OFFSET + SIM_AUX_MU_LCR) & SIM_AUX_MU_LCR_DLAB_FLAG))
+    {
+        const uint8_t byte = (uint8_t)value;
+
+        // keep the newest bytes
+        if (FIFO_Count(&mini_uart_tx) == mini_uart_tx.size)
+        {
+            FIFO_Take(&mini_uart_tx);
+        }
+
+        FIFO_Put(&mini_uart_tx, byte);
+
+        if (mini_uart_echo)
+        {
+            (void)!write(STDOUT_FILENO, &byte, 1u);
+        }
+
+        sim_stats.mini_uart_tx_bytes++;
+    }
+    else if (reg == SIM_AUX_MU_IIR)
+    {
+        if (value & SIM_AUX_MU_IIR_CLEAR_RX_FLAG)
+        {
+            mini_uart_rx.tail = mini_uart_rx.head;
+        }
+    }
+    else
+    {
+        /* plain register, do nothing */
+    }
+
+    // status registers read back their current state
+    Aux_Read(SIM_AUX_MU_IIR);
+    Aux_Read(SIM_AUX_MU_LSR);
+    Aux_Read(SIM_AUX_MU_STAT);
+}
+
+static uint32_t Aux_Is_Mini_Uart_Pending(void)
+{
+    const uint32_t ier = SIM_REG(SIM_AUX_OFFSET + SIM_AUX_MU_IER);
+    const uint32_t is_enabled = SIM_REG(SIM_AUX_OFFSET + SIM_AUX_ENABLES) & SIM_AUX_ENABLES_MUART_FLAG;
+
+    // the Tx FIFO is always empty, so a Tx interrupt is always pending when enabled
+    return is_enabled && ((ier & SIM_AUX_MU_IER_TX_FLAG) ||
+                          ((ier & SIM_AUX_MU_IER_RX_FLAG) && FIFO_Count(&mini_uart_rx)));
+}
+
+static void ILI9341_Reset(void)
+{
+    ili9341.command = 0u;
+    ili9341.num_params = 0u;
+    ili9341.column_start = 0u;
+    ili9341.column_end = 239u;
+    ili9341.page_start = 0u;
+    ili9341.page_end = 319u;
+    ili9341.column = 0u;
+    ili9341.page = 0u;
+    ili9341.is_asleep = 1u;
+    ili9341.is_display_on = 0u;
+
+    memset(ili9341.registers, 0, sizeof(ili9341.registers));
+}
+
+static uint8_t ILI9341_SPI_Byte(uint8_t mosi_byte)
+{
+    const uint32_t dc_pin_num = ili9341.dc_pin_num;
+    const uint32_t is_data = (dc_pin_num < SIM_GPIO_NUM_PINS) &&
+                             ((gpio_levels[dc_pin_num / 32u] >> (dc_pin_num % 32u)) & 1u);
+
+    if (!is_data)
+    {
+        ili9341.command = mosi_byte;
+        ili9341.num_params = 0u;
+
+        sim_stats.ili9341_commands++;
+
+        switch (mosi_byte)
+        {
+            case SIM_ILI9341_SWRESET:
+                ILI9341_Reset();
+                ili9341.command = mosi_byte;
+                break;
+            case SIM_ILI9341_SLPIN:
+                ili9341.is_asleep = 1u;
+                break;
+            case SIM_ILI9341_SLPOUT:
+                ili9341.is_asleep = 0u;
+                break;
+            case SIM_ILI9341_DISPOFF:
+                ili9341.is_display_on = 0u;
+                break;
+            case SIM_ILI9341_DISPON:
+                ili9341.is_display_on = 1u;
+                break;
+            case SIM_ILI9341_RAMWR:
+                ili9341.column = ili9341.column_start;
+                ili9341.page = ili9341.page_start;
+                break;
+            default:
+                /* not modelled, do nothing */
+                break;
+        }
+    }
+    else if (ili9341.command == SIM_ILI9341_RAMWR)
+    {
+        // pixels are 2 bytes, high byte first
+        if (ili9341.num_params == 0u)
+        {
+            ili9341.params[0] = mosi_byte;
+            ili9341.num_params = 1u;
+        }
+        else
+        {
+            if ((ili9341.column < PSP_SIM_ILI9341_MAX_SIZE) && (ili9341.page < PSP_SIM_ILI9341_MAX_SIZE))
+            {
+                ili9341.memory[ili9341.page][ili9341.column] = ((uint16_t)ili9341.params[0] << 8u) | mosi_byte;
+            }
+
+            ili9341.num_params = 0u;
+            sim_stats.ili9341_pixels++;
+
+            // fill the window a row at a time, wrapping back to the start
+            if (++ili9341.column > ili9341.column_end)
+            {
+                ili9341.column = ili9341.column_start;
+
+                if (++ili9341.page > ili9341.page_end)
+                {
+                    ili9341.page = ili9341.page_start;
+                }
+            }
+        }
+    }
+    else
+    {
+        if (ili9341.num_params == 0u)
+        {
+            ili9341.registers[ili9341.command] = mosi_byte;
+        }
+
+        if (ili9341.num_params < sizeof(ili9341.params))
+        {
+            ili9341.params[ili9341.num_params] = mosi_byte;
+        }
+
+        ili9341.num_params++;
+
+        if (ili9341.num_params == 4u)
+        {
+            const uint32_t start = ((uint32_t)ili9341.params[0] << 8u) | ili9341.params[1];
+            const uint32_t end = ((uint32_t)ili9341.params[2] << 8u) | ili9341.params[3];
+
+            if (ili9341.command == SIM_ILI9341_CASET)
+            {
+                ili9341.column_start = start;
+                ili9341.column_end = end;
+            }
+            else if (ili9341.command == SIM_ILI9341_PASET)
+            {
+                ili9341.page_start = start;
+                ili9341.page_end = end;
+            }
+            else
+            {
+                /* not modelled, do nothing */
+            }
+        }
+    }
+
+    return 0u;
+}
@@ -0,0 +1,193 @@
+/*
+--|----------------------------------------------------------------------------|
+--| FILE DESCRIPTION:
+--|   PSP_Sim_Models is the interface between the register trapping in
+--|   PSP_Sim.c and the peripheral models in PSP_Sim_Models.c. It is private
+--|   to the simulator, programs use PSP_Sim.h.
+--|
+--|----------------------------------------------------------------------------|
+--| NOTES:
+--|     Offsets are from the start of the peripheral block, a register at
+--|     0x3F204000 on the Pi is at offset 0x204000.
+--|
+--|----------------------------------------------------------------------------|
+--| REFERENCES:
+--|   BCM2837-ARM-Peripherals.pdf
+--|
+--|----------------------------------------------------------------------------|
+*/
+
+#ifndef PSP_SIM_MODELS_H_INCLUDED
+#define PSP_SIM_MODELS_H_INCLUDED
+
+/*
+--|----------------------------------------------------------------------------|
+--| INCLUDE FILES
+--|----------------------------------------------------------------------------|
+*/
+
+#include "PSP_Sim.h"
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC DEFINES
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--| NAME: SIM_PAGE_SIZE
+--| DESCRIPTION: host page size, accesses are trapped a page at a time
+--| TYPE: uint32_t
+*/
+#define SIM_PAGE_SIZE (0x1000u)
+
+/*
+--| NAME: SIM_NUM_MODELLED_PAGES
+--| DESCRIPTION: the number of peripheral block pages that have a model
+--| TYPE: uint32_t
+*/
+#define SIM_NUM_MODELLED_PAGES (6u)
+
+/*
+--| NAME: SIM_REG
+--| DESCRIPTION: a simulated register, seen by the models without trapping
+--| TYPE: vuint32_t
+*/
+#define SIM_REG(offset) (*Sim_Register(offset))
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC TYPES
+--|----------------------------------------------------------------------------|
+*/
+
+/* None */
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC CONSTANTS
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--| NAME: sim_modelled_pages
+--| DESCRIPTION: offsets of the peripheral block pages that have a model,
+--|   every access to these is trapped
+--| TYPE: uint32_t[]
+*/
+extern const uint32_t sim_modelled_pages[SIM_NUM_MODELLED_PAGES];
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC VARIABLES
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--| NAME: sim_stats
+--| DESCRIPTION: the counts returned by PSP_Sim_Get_Stats
+--| TYPE: PSP_Sim_Stats_t
+*/
+extern PSP_Sim_Stats_t sim_stats;
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC FUNCTION PROTOTYPES
+--|----------------------------------------------------------------------------|
+*/
+
+/*------------------------------------------------------------------------------
+Function Name:
+    Sim_Register
+
+Function Description:
+    Get an untrapped view of a simulated register.
+
+Inputs:
+    offset: the register offset in the peripheral block.
+
+Returns:
+    vuint32_t *: the register.
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+vuint32_t * Sim_Register(uint32_t offset);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    Sim_Models_Reset
+
+Function Description:
+    Put every model back to its power on state, with its registers at their
+    reset values.
+
+Inputs:
+    None
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    The registers must already be zeroed.
+------------------------------------------------------------------------------*/
+void Sim_Models_Reset(void);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    Sim_Models_Read
+
+Function Description:
+    Called before a trapped read of a modelled register, so the model can
+    put the value to be read into it.
+
+Inputs:
+    offset: the register offset in the peripheral block.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+void Sim_Models_Read(uint32_t offset);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    Sim_Models_Write
+
+Function Description:
+    Called after a trapped write of a modelled register, with the value
+    written in the register, so the model can act on it.
+
+Inputs:
+    offset: the register offset in the peripheral block.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+void Sim_Models_Write(uint32_t offset);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    Sim_Models_Is_Interrupt_Pending
+
+Function Description:
+    Check whether a model is asserting an interrupt.
+
+Inputs:
+    source: a PSP_IRQ_Source_t.
+
+Returns:
+    uint32_t: true if the source is asserted, false if not or if no model
+    drives it.
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+uint32_t Sim_Models_Is_Interrupt_Pending(uint32_t source);
+
+#endif
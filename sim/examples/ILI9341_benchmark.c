@@ -0,0 +1,1045 @@
+/*
+--|----------------------------------------------------------------------------|
+--| FILE DESCRIPTION:
+--|   ILI9341_benchmark.c runs the ILI9341 driver on the host register
+--|   simulator. It draws the same rectangles straight to the display and
+--|   through the DMA flushed framebuffer, then flushes a small widget on its
+--|   own. It checks what ended up in the display memory, and prints what each
+--|   way cost in register accesses and SPI bytes.
+--|
+--|   Then it draws lines and shapes, checks each against a reference
+--|   rasterization, and prints what each one cost.
+--|
+--|   It also echoes a line through the interrupt driven mini UART.
+--|
+--|----------------------------------------------------------------------------|
+--| HARDWARE SETUP:
+--|   None, this runs on Linux. Build it from within the build directory:
+--|   $ make host TARGET=ILI9341_benchmark
+--|   $ ../bin/ILI9341_benchmark_host
+--|
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--|----------------------------------------------------------------------------|
+--| INCLUDE FILES
+--|----------------------------------------------------------------------------|
+*/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "BSP_ILI9341_SPI_Display.h"
+#include "PSP_Aux_Mini_UART.h"
+#include "PSP_IRQ.h"
+#include "PSP_SPI_0.h"
+#include "PSP_Sim.h"
+
+/*
+--|----------------------------------------------------------------------------|
+--| DEFINES
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--| NAME: DC_PIN_NUMBER
+--| DESCRIPTION: the pin number for the display D/C pin
+--| TYPE: uint32_t
+*/
+#define DC_PIN_NUMBER (25u)
+
+/*
+--| NAME: NUM_RECTANGLES
+--| DESCRIPTION: the number of rectangles drawn each way
+--| TYPE: uint32_t
+*/
+#define NUM_RECTANGLES (5u)
+
+/*
+--| NAME: NUM_SHAPES
+--| DESCRIPTION: the number of lines and shapes drawn and checked
+--| TYPE: uint32_t
+*/
+#define NUM_SHAPES (20u)
+
+/*
+--| NAME: NUM_TRACE_POINTS
+--| DESCRIPTION: the number of points in the polyline trace, one per column
+--| TYPE: uint32_t
+*/
+#define NUM_TRACE_POINTS (BSP_ILI9341_TFTWIDTH)
+
+/*
+--| NAME: SHAPE_COLOR
+--| DESCRIPTION: the color the shapes are drawn in, on a black background
+--| TYPE: uint16_t
+*/
+#define SHAPE_COLOR (0xFFFFu)
+
+/*
+--| NAME: SHAPE_MARGIN
+--| DESCRIPTION: pixels around a shape that are cleared and checked as well,
+--|   to catch pixels drawn where they shouldn't be
+--| TYPE: int32_t
+*/
+#define SHAPE_MARGIN (4)
+
+/*
+--|----------------------------------------------------------------------------|
+--| TYPES
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--| NAME: Shape_Kind_enum
+--| DESCRIPTION: the kinds of shapes, and what their arguments are
+*/
+typedef enum Shape_Kind_Enumeration
+{
+    SHAPE_LINE,                  // x0, y0, x1, y1
+    SHAPE_TRACE,                 // none, the points come from Make_Trace
+    SHAPE_CIRCLE_OUTLINE,        // x, y, r
+    SHAPE_FILLED_CIRCLE,         // x, y, r
+    SHAPE_ROUNDED_OUTLINE,       // x, y, width, height, r
+    SHAPE_FILLED_ROUNDED,        // x, y, width, height, r
+    SHAPE_FILLED_TRIANGLE,       // x0, y0, x1, y1, x2, y2
+    SHAPE_THICK_LINE,            // x0, y0, x1, y1, thickness
+} Shape_Kind_enum;
+
+/*
+--| NAME: Expect_enum
+--| DESCRIPTION: what a pixel of the reference rasterization must be
+*/
+typedef enum Expect_Enumeration
+{
+    EXPECT_OFF    = 0u, // must be the background
+    EXPECT_ON     = 1u, // must be the shape color
+    EXPECT_EITHER = 2u, // on the edge, rounding decides
+} Expect_enum;
+
+/*
+--| NAME: Shape_t
+--| DESCRIPTION: a shape to draw and check
+*/
+typedef struct Shape_Type
+{
+    const char * p_name;
+    Shape_Kind_enum kind;
+    int32_t args[6u];
+} Shape_t;
+
+/*
+--|----------------------------------------------------------------------------|
+--| CONSTANTS
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--| NAME: rectangles
+--| DESCRIPTION: x, y, width, height and color of each rectangle drawn, the
+--|   last is a small widget that starts on an odd column
+--| TYPE: uint32_t[][]
+*/
+static const uint32_t rectangles[NUM_RECTANGLES][5u] =
+{
+    {   0u,   0u, 240u, 320u, 0x0000u },
+    {  10u,  20u, 100u,  50u, 0xF800u },
+    {  60u,  40u,  30u, 200u, 0x07E0u },
+    { 200u, 300u,  40u,  20u, 0x001Fu },
+    {  33u, 101u,  31u,  30u, 0xFFE0u },
+};
+
+/*
+--| NAME: shapes
+--| DESCRIPTION: the lines and shapes drawn and checked, the flat thick
+--|   lines and thin triangle have edges flatter than 45 degrees
+--| TYPE: Shape_t[]
+*/
+static const Shape_t shapes[NUM_SHAPES] =
+{
+    { "line ENE",      SHAPE_LINE,            {  10, 10, 200,  60          } },
+    { "line NNE",      SHAPE_LINE,            {  20, 10,  60, 250          } },
+    { "line WNW",      SHAPE_LINE,            { 230, 90,   5,  70          } },
+    { "line SSW",      SHAPE_LINE,            { 120, 300, 100, 20          } },
+    { "line diagonal", SHAPE_LINE,            {  10, 10, 200, 200          } },
+    { "line flat",     SHAPE_LINE,            { 200, 40,  30,  40          } },
+    { "line clipped",  SHAPE_LINE,            { 200, 280, 260, 330         } },
+    { "trace",         SHAPE_TRACE,           {  0                         } },
+    { "circle r9",     SHAPE_CIRCLE_OUTLINE,  { 120, 160,   9              } },
+    { "circle r100",   SHAPE_CIRCLE_OUTLINE,  { 120, 160, 100              } },
+    { "filled r9",     SHAPE_FILLED_CIRCLE,   {  50,  50,   9              } },
+    { "filled r50",    SHAPE_FILLED_CIRCLE,   { 120, 160,  50              } },
+    { "round rect",    SHAPE_ROUNDED_OUTLINE, {  20,  30, 150,  80, 12     } },
+    { "round fill",    SHAPE_FILLED_ROUNDED,  {  20,  30, 150,  80, 12     } },
+    { "triangle",      SHAPE_FILLED_TRIANGLE, {  30,  40, 150, 100, 80, 200 } },
+    { "triangle thin", SHAPE_FILLED_TRIANGLE, {  10, 100, 230, 102, 120, 104 } },
+    { "thick 3 flat",  SHAPE_THICK_LINE,      {  10,  10, 200,  12,  3     } },
+    { "thick 5",       SHAPE_THICK_LINE,      {  10,  10, 200,  30,  5     } },
+    { "thick 4 steep", SHAPE_THICK_LINE,      { 100,  20, 120, 250,  4     } },
+    { "thick 6 45deg", SHAPE_THICK_LINE,      {  20,  20, 150, 150,  6     } },
+};
+
+/*
+--|----------------------------------------------------------------------------|
+--| VARIABLES
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--| NAME: framebuffer
+--| DESCRIPTION: the framebuffer, static so the simulated DMA can reach it
+--| TYPE: uint16_t[]
+*/
+static uint16_t framebuffer[BSP_ILI9341_FRAMEBUFFER_SIZE] __attribute__((aligned(4)));
+
+/*
+--| NAME: expected
+--| DESCRIPTION: the reference rasterization of the shape being checked
+--| TYPE: uint8_t[][]
+*/
+static uint8_t expected[BSP_ILI9341_TFTHEIGHT][BSP_ILI9341_TFTWIDTH];
+
+/*
+--| NAME: trace_x, trace_y
+--| DESCRIPTION: the points of the polyline trace
+--| TYPE: uint32_t[]
+*/
+static uint32_t trace_x[NUM_TRACE_POINTS];
+static uint32_t trace_y[NUM_TRACE_POINTS];
+
+/*
+--|----------------------------------------------------------------------------|
+--| FUNCTION PROTOTYPES
+--|----------------------------------------------------------------------------|
+*/
+
+/*------------------------------------------------------------------------------
+Function Name:
+    main
+
+Function Description:
+    Draw the rectangles both ways and report the results.
+
+Parameters:
+    None
+
+Returns:
+    int: 0 if the display memory held the expected pixels both times, else 1.
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+int main(void);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    Draw_Rectangles
+
+Function Description:
+    Draw some of the rectangles, in order.
+
+Parameters:
+    first: the first rectangle to draw.
+    num_rectangles: the number of rectangles to draw.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+void Draw_Rectangles(uint32_t first, uint32_t num_rectangles);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    Count_Wrong_Pixels
+
+Function Description:
+    Compare the display memory against what the rectangles should have left
+    in it.
+
+Parameters:
+    None
+
+Returns:
+    uint32_t: the number of pixels that differ.
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+uint32_t Count_Wrong_Pixels(void);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    Print_Stats
+
+Function Description:
+    Print the simulator counts since the last reset of the counts.
+
+Parameters:
+    p_name: what was measured.
+    p_start: the counts at the start.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+void Print_Stats(const char * p_name, const PSP_Sim_Stats_t * p_start);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    Check_Shape
+
+Function Description:
+    Clear the area of a shape, draw it, print what it cost and compare the
+    display memory against the reference rasterization.
+
+Parameters:
+    p_shape: the shape.
+
+Returns:
+    uint32_t: the number of pixels that are wrong, plus the number of rows
+    or columns of a thick line that are too thin.
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+uint32_t Check_Shape(const Shape_t * p_shape);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    Make_Trace
+
+Function Description:
+    Fill in the trace points, one period of a sine wave across the screen
+    from Bhaskara's approximation.
+
+Parameters:
+    None
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+void Make_Trace(void);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    Expect_Shape
+
+Function Description:
+    Fill in the reference rasterization of a shape.
+
+Parameters:
+    p_shape: the shape.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+void Expect_Shape(const Shape_t * p_shape);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    Expect_Line
+
+Function Description:
+    Mark the pixels of a line as on, walked one pixel at a time with
+    Bresenham's algorithm, starting at the first end.
+
+Parameters:
+    x0, y0: where the line starts.
+    x1, y1: where the line ends.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    Pixels off the screen are skipped.
+------------------------------------------------------------------------------*/
+void Expect_Line(int32_t x0, int32_t y0, int32_t x1, int32_t y1);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    Expect_Round
+
+Function Description:
+    Mark the pixels of a rectangle with rounded corners, given by the 
+    centers of its corner arcs. Pixels well inside the edge are on for a 
+    filled shape, pixels within rounding of the edge can be either, the rest
+    are off. The straight sides and the outline pixels rounding can't go 
+    either way on are on.
+
+Parameters:
+    left, top, right, bottom: the centers of the corner arcs.
+    r: the radius of the corners.
+    is_filled: true for a filled shape, false for the outline.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+void Expect_Round(int32_t left, int32_t top, int32_t right, int32_t bottom, int32_t r, uint32_t is_filled);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    Expect_Polygon
+
+Function Description:
+    Mark the pixels of a filled convex polygon. Pixels with their centers 
+    inside and the outline drawn through the corners in order are on, pixels
+    more than one pixel outside an edge are off, the rest can be either.
+
+Parameters:
+    p_x, p_y: the corners, in order around the polygon.
+    num_points: the number of corners.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+void Expect_Polygon(const double * p_x, const double * p_y, uint32_t num_points);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    Expect_Thick_Line
+
+Function Description:
+    Mark the pixels of a thick line. Pixels within half a pixel of the middle
+    are on, pixels more than a pixel past the sides or ends are off, the 
+    rest can be either.
+
+Parameters:
+    x0, y0: where the line starts.
+    x1, y1: where the line ends.
+    thickness: the width of the line in pixels.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+void Expect_Thick_Line(int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t thickness);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    Count_Thin_Parts
+
+Function Description:
+    Count the columns across a flat thick line, or rows across a steep one,
+    that have fewer pixels on than the thickness. The ends are left out, 
+    they are cut square to the line. Only pixels the reference lets be on
+    are counted, the rest of the screen holds earlier shapes.
+
+Parameters:
+    p_shape: the thick line.
+
+Returns:
+    uint32_t: the number of columns or rows that are too thin.
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+uint32_t Count_Thin_Parts(const Shape_t * p_shape);
+
+/*
+--|----------------------------------------------------------------------------|
+--| FUNCTION DEFINITIONS
+--|----------------------------------------------------------------------------|
+*/
+
+int main(void)
+{
+    uint32_t num_failures = 0u;
+    PSP_Sim_Stats_t start;
+
+    PSP_Sim_ILI9341_Attach(0u, DC_PIN_NUMBER);
+
+    PSP_Sim_Get_Stats(&start);
+    BSP_ILI9341_SPI_Display_Init(DC_PIN_NUMBER);
+    Print_Stats("init", &start);
+
+    if (!PSP_Sim_ILI9341_Is_Display_On())
+    {
+        printf("the display was not turned on\n");
+        num_failures++;
+    }
+
+    // straight to the display
+    PSP_Sim_Get_Stats(&start);
+    Draw_Rectangles(0u, NUM_RECTANGLES);
+    Print_Stats("direct", &start);
+
+    uint32_t num_wrong = Count_Wrong_Pixels();
+
+    if (num_wrong)
+    {
+        printf("direct: %u wrong pixels\n", num_wrong);
+        num_failures++;
+    }
+
+    // through the framebuffer, drawn in a different color first so a missed flush shows
+    BSP_ILI9341_Draw_Filled_Rectangle(0u, 0u, BSP_ILI9341_TFTWIDTH, BSP_ILI9341_TFTHEIGHT, 0xFFFFu);
+
+    if (!BSP_ILI9341_Framebuffer_Enable(framebuffer))
+    {
+        printf("framebuffer: could not enable\n");
+        return 1;
+    }
+
+    PSP_Sim_Get_Stats(&start);
+    Draw_Rectangles(0u, NUM_RECTANGLES - 1u);
+    BSP_ILI9341_Flush();
+    PSP_SPI0_DMA_Wait();
+    Print_Stats("framebuffer", &start);
+
+    // the widget on its own, narrower than the screen so its rows are spaced out in the framebuffer
+    PSP_Sim_Get_Stats(&start);
+    Draw_Rectangles(NUM_RECTANGLES - 1u, 1u);
+    BSP_ILI9341_Flush();
+    BSP_ILI9341_Framebuffer_Disable();
+    Print_Stats("widget flush", &start);
+
+    num_wrong = Count_Wrong_Pixels();
+
+    if (num_wrong)
+    {
+        printf("framebuffer: %u wrong pixels\n", num_wrong);
+        num_failures++;
+    }
+
+    // the lines and shapes, straight to the display
+    Make_Trace();
+
+    for (uint32_t i = 0u; i < NUM_SHAPES; i++)
+    {
+        num_wrong = Check_Shape(&shapes[i]);
+
+        if (num_wrong)
+        {
+            printf("%s: %u wrong pixels\n", shapes[i].p_name, num_wrong);
+            num_failures++;
+        }
+    }
+
+    // echo a line through the mini UART
+    static const char line[] = "hello from the mini UART\r\n";
+    char sent[sizeof(line)] = { 0 };
+
+    PSP_AUX_Mini_Uart_Init(PSP_AUX_Mini_Uart_Baud_Rate_115200);
+    PSP_AUX_Mini_Uart_Enable_Interrupts();
+    PSP_IRQ_Enable();
+
+    PSP_Sim_Mini_Uart_Inject((const uint8_t *)line, sizeof(line) - 1u);
+
+    for (uint32_t i = 0u; i < sizeof(line) - 1u; i++)
+    {
+        uint8_t byte;
+
+        while (!PSP_AUX_Mini_Uart_Read(&byte, 1u))
+        {
+            // on the host, interrupts only happen when asked for
+            PSP_Sim_Service_Interrupts();
+        }
+
+        PSP_AUX_Mini_Uart_Send_Byte(byte);
+    }
+
+    // let the handler empty the Tx ring buffer
+    PSP_Sim_Service_Interrupts();
+    PSP_Sim_Mini_Uart_Take_Tx((uint8_t *)sent, sizeof(sent) - 1u);
+
+    if (strcmp(sent, line))
+    {
+        printf("mini UART: echoed \"%s\"\n", sent);
+        num_failures++;
+    }
+
+    printf("virtual time: %llu uSec\n", (unsigned long long)PSP_Sim_Time_Get());
+    printf("%s\n", num_failures ? "FAILED" : "passed");
+
+    return num_failures ? 1 : 0;
+}
+
+void Draw_Rectangles(uint32_t first, uint32_t num_rectangles)
+{
+    for (uint32_t i = first; i < first + num_rectangles; i++)
+    {
+        BSP_ILI9341_Draw_Filled_Rectangle(rectangles[i][0],
+                                          rectangles[i][1],
+                                          rectangles[i][2],
+                                          rectangles[i][3],
+                                          (uint16_t)rectangles[i][4]);
+    }
+}
+
+uint32_t Count_Wrong_Pixels(void)
+{
+    uint32_t num_wrong = 0u;
+
+    for (uint32_t y = 0u; y < BSP_ILI9341_TFTHEIGHT; y++)
+    {
+        for (uint32_t x = 0u; x < BSP_ILI9341_TFTWIDTH; x++)
+        {
+            uint16_t expected = 0u;
+
+            // the last rectangle drawn over a pixel wins
+            for (uint32_t i = 0u; i < NUM_RECTANGLES; i++)
+            {
+                if ((x >= rectangles[i][0]) && (x < rectangles[i][0] + rectangles[i][2]) &&
+                    (y >= rectangles[i][1]) && (y < rectangles[i][1] + rectangles[i][3]))
+                {
+                    expected = (uint16_t)rectangles[i][4];
+                }
+            }
+
+            if (PSP_Sim_ILI9341_Get_Pixel(x, y) != expected)
+            {
+                num_wrong++;
+            }
+        }
+    }
+
+    return num_wrong;
+}
+
+void Print_Stats(const char * p_name, const PSP_Sim_Stats_t * p_start)
+{
+    PSP_Sim_Stats_t end;
+
+    PSP_Sim_Get_Stats(&end);
+
+    printf("%-14s register reads %8llu  writes %8llu  SPI bytes %8llu  DMA bytes %8llu  pixels %8llu\n",
+           p_name,
+           (unsigned long long)(end.register_reads - p_start->register_reads),
+           (unsigned long long)(end.register_writes - p_start->register_writes),
+           (unsigned long long)(end.spi0_bytes - p_start->spi0_bytes),
+           (unsigned long long)(end.dma_bytes - p_start->dma_bytes),
+           (unsigned long long)(end.ili9341_pixels - p_start->ili9341_pixels));
+}
+
+uint32_t Check_Shape(const Shape_t * p_shape)
+{
+    const int32_t * p_args = p_shape->args;
+    uint32_t num_wrong = 0u;
+    PSP_Sim_Stats_t start;
+
+    memset(expected, EXPECT_OFF, sizeof(expected));
+    Expect_Shape(p_shape);
+
+    // clear around everything the shape may touch
+    int32_t x_min = BSP_ILI9341_TFTWIDTH;
+    int32_t y_min = BSP_ILI9341_TFTHEIGHT;
+    int32_t x_max = -1;
+    int32_t y_max = -1;
+
+    for (int32_t y = 0; y < (int32_t)BSP_ILI9341_TFTHEIGHT; y++)
+    {
+        for (int32_t x = 0; x < (int32_t)BSP_ILI9341_TFTWIDTH; x++)
+        {
+            if (expected[y][x] != EXPECT_OFF)
+            {
+                x_min = (x < x_min) ? x : x_min;
+                x_max = (x > x_max) ? x : x_max;
+                y_min = (y < y_min) ? y : y_min;
+                y_max = (y > y_max) ? y : y_max;
+            }
+        }
+    }
+
+    x_min = (x_min - SHAPE_MARGIN < 0) ? 0 : x_min - SHAPE_MARGIN;
+    y_min = (y_min - SHAPE_MARGIN < 0) ? 0 : y_min - SHAPE_MARGIN;
+    x_max = (x_max + SHAPE_MARGIN >= (int32_t)BSP_ILI9341_TFTWIDTH) ? (int32_t)BSP_ILI9341_TFTWIDTH - 1 : x_max + SHAPE_MARGIN;
+    y_max = (y_max + SHAPE_MARGIN >= (int32_t)BSP_ILI9341_TFTHEIGHT) ? (int32_t)BSP_ILI9341_TFTHEIGHT - 1 : y_max + SHAPE_MARGIN;
+
+    BSP_ILI9341_Draw_Filled_Rectangle(x_min, y_min, x_max - x_min + 1, y_max - y_min + 1, 0x0000u);
+
+    PSP_Sim_Get_Stats(&start);
+
+    switch (p_shape->kind)
+    {
+        case SHAPE_LINE:
+            BSP_ILI9341_Draw_Line(p_args[0], p_args[1], p_args[2], p_args[3], SHAPE_COLOR);
+            break;
+
+        case SHAPE_TRACE:
+            BSP_ILI9341_Draw_Polyline(trace_x, trace_y, NUM_TRACE_POINTS, SHAPE_COLOR);
+            break;
+
+        case SHAPE_CIRCLE_OUTLINE:
+            BSP_ILI9341_Draw_Circle_Outline(p_args[0], p_args[1], p_args[2], SHAPE_COLOR);
+            break;
+
+        case SHAPE_FILLED_CIRCLE:
+            BSP_ILI9341_Draw_Filled_Circle(p_args[0], p_args[1], p_args[2], SHAPE_COLOR);
+            break;
+
+        case SHAPE_ROUNDED_OUTLINE:
+            BSP_ILI9341_Draw_Rounded_Rectangle_Outline(p_args[0], p_args[1], p_args[2], p_args[3], p_args[4], SHAPE_COLOR);
+            break;
+
+        case SHAPE_FILLED_ROUNDED:
+            BSP_ILI9341_Draw_Filled_Rounded_Rectangle(p_args[0], p_args[1], p_args[2], p_args[3], p_args[4], SHAPE_COLOR);
+            break;
+
+        case SHAPE_FILLED_TRIANGLE:
+            BSP_ILI9341_Draw_Filled_Triangle(p_args[0], p_args[1], p_args[2], p_args[3], p_args[4], p_args[5], SHAPE_COLOR);
+            break;
+
+        case SHAPE_THICK_LINE:
+            BSP_ILI9341_Draw_Thick_Line(p_args[0], p_args[1], p_args[2], p_args[3], p_args[4], SHAPE_COLOR);
+            break;
+    }
+
+    Print_Stats(p_shape->p_name, &start);
+
+    for (int32_t y = y_min; y <= y_max; y++)
+    {
+        for (int32_t x = x_min; x <= x_max; x++)
+        {
+            const uint32_t is_on = (PSP_Sim_ILI9341_Get_Pixel(x, y) == SHAPE_COLOR);
+
+            if (((expected[y][x] == EXPECT_ON) && !is_on) || ((expected[y][x] == EXPECT_OFF) && is_on))
+            {
+                num_wrong++;
+            }
+        }
+    }
+
+    if (p_shape->kind == SHAPE_THICK_LINE)
+    {
+        num_wrong += Count_Thin_Parts(p_shape);
+    }
+
+    return num_wrong;
+}
+
+void Make_Trace(void)
+{
+    for (uint32_t i = 0u; i < NUM_TRACE_POINTS; i++)
+    {
+        // degrees into the half period, and which half
+        const int32_t degrees = (int32_t)((i * 360u) / NUM_TRACE_POINTS) % 180;
+        const int32_t sign = ((i * 360u) / NUM_TRACE_POINTS < 180u) ? -1 : 1;
+        const int32_t product = degrees * (180 - degrees);
+
+        trace_x[i] = i;
+        trace_y[i] = 160 + sign * ((100 * 4 * product) / (40500 - product));
+    }
+}
+
+void Expect_Shape(const Shape_t * p_shape)
+{
+    const int32_t * p_args = p_shape->args;
+
+    switch (p_shape->kind)
+    {
+        case SHAPE_LINE:
+            Expect_Line(p_args[0], p_args[1], p_args[2], p_args[3]);
+            break;
+
+        case SHAPE_TRACE:
+            for (uint32_t i = 1u; i < NUM_TRACE_POINTS; i++)
+            {
+                Expect_Line(trace_x[i - 1u], trace_y[i - 1u], trace_x[i], trace_y[i]);
+            }
+            break;
+
+        case SHAPE_CIRCLE_OUTLINE:
+        case SHAPE_FILLED_CIRCLE:
+            Expect_Round(p_args[0], p_args[1], p_args[0], p_args[1], p_args[2], p_shape->kind == SHAPE_FILLED_CIRCLE);
+            break;
+
+        case SHAPE_ROUNDED_OUTLINE:
+        case SHAPE_FILLED_ROUNDED:
+            Expect_Round(p_args[0] + p_args[4],
+                         p_args[1] + p_args[4],
+                         p_args[0] + p_args[2] - 1 - p_args[4],
+                         p_args[1] + p_args[3] - 1 - p_args[4],
+                         p_args[4],
+                         p_shape->kind == SHAPE_FILLED_ROUNDED);
+            break;
+
+        case SHAPE_FILLED_TRIANGLE:
+        {
+            const double xs[3u] = { p_args[0], p_args[2], p_args[4] };
+            const double ys[3u] = { p_args[1], p_args[3], p_args[5] };
+
+            Expect_Polygon(xs, ys, 3u);
+
+            // the fill holds the outline, drawn the same way round
+            for (uint32_t i = 0u; i < 3u; i++)
+            {
+                const uint32_t j = (i + 1u) % 3u;
+
+                Expect_Line(p_args[2u * i], p_args[2u * i + 1u], p_args[2u * j], p_args[2u * j + 1u]);
+            }
+            break;
+        }
+
+        case SHAPE_THICK_LINE:
+            Expect_Thick_Line(p_args[0], p_args[1], p_args[2], p_args[3], p_args[4]);
+            break;
+    }
+}
+
+void Expect_Line(int32_t x0, int32_t y0, int32_t x1, int32_t y1)
+{
+    const int32_t dx = (x1 > x0) ? (x1 - x0) : (x0 - x1);
+    const int32_t dy = (y1 > y0) ? (y1 - y0) : (y0 - y1);
+    const int32_t sx = (x1 > x0) ? 1 : -1;
+    const int32_t sy = (y1 > y0) ? 1 : -1;
+    const int32_t major = (dx >= dy) ? dx : dy;
+    const int32_t minor = (dx >= dy) ? dy : dx;
+
+    int32_t err = major / 2;
+    int32_t x = x0;
+    int32_t y = y0;
+
+    for (int32_t i = 0; i <= major; i++)
+    {
+        if ((x >= 0) && (x < (int32_t)BSP_ILI9341_TFTWIDTH) && (y >= 0) && (y < (int32_t)BSP_ILI9341_TFTHEIGHT))
+        {
+            expected[y][x] = EXPECT_ON;
+        }
+
+        err -= minor;
+
+        if (err < 0)
+        {
+            err += major;
+
+            if (dx >= dy)
+            {
+                y += sy;
+            }
+            else
+            {
+                x += sx;
+            }
+        }
+
+        if (dx >= dy)
+        {
+            x += sx;
+        }
+        else
+        {
+            y += sy;
+        }
+    }
+}
+
+void Expect_Round(int32_t left, int32_t top, int32_t right, int32_t bottom, int32_t r, uint32_t is_filled)
+{
+    const double inner = (r - 0.75) * (r - 0.75);
+    const double outer = (r + 0.75) * (r + 0.75);
+
+    for (int32_t y = 0; y < (int32_t)BSP_ILI9341_TFTHEIGHT; y++)
+    {
+        for (int32_t x = 0; x < (int32_t)BSP_ILI9341_TFTWIDTH; x++)
+        {
+            // how far out from the rectangle between the corner centers
+            const int32_t dx = (x < left) ? (left - x) : ((x > right) ? (x - right) : 0);
+            const int32_t dy = (y < top) ? (top - y) : ((y > bottom) ? (y - bottom) : 0);
+            const double d_squared = (double)(dx * dx + dy * dy);
+
+            if (d_squared > outer)
+            {
+                expected[y][x] = EXPECT_OFF;
+            }
+            else if ((dx == 0) || (dy == 0))
+            {
+                // the straight sides are exact
+                const int32_t d = dx + dy;
+
+                expected[y][x] = (is_filled ? (d <= r) : (d == r)) ? EXPECT_ON : EXPECT_OFF;
+            }
+            else if (is_filled && (d_squared <= inner))
+            {
+                expected[y][x] = EXPECT_ON;
+            }
+            else if (!is_filled && (d_squared < inner))
+            {
+                expected[y][x] = EXPECT_OFF;
+            }
+            else
+            {
+                expected[y][x] = EXPECT_EITHER;
+            }
+        }
+    }
+
+    // along each octant of the arcs, the pixel nearest the circle is on unless it is close to a tie
+    for (int32_t a = 1; a < r; a++)
+    {
+        const int32_t v = r * r - a * a;
+        int32_t b = 0;
+
+        while ((b + 1) * (b + 1) <= v)
+        {
+            b++;
+        }
+
+        if (v > (b + 0.6) * (b + 0.6))
+        {
+            b++;
+        }
+        else if (v >= (b + 0.4) * (b + 0.4))
+        {
+            continue;
+        }
+        else
+        {
+            /* ... do nothing */
+        }
+
+        if (a > b)
+        {
+            continue;
+        }
+
+        const int32_t xs[8u] = { right + a, left - a, right + a, left - a, right + b, left - b, right + b, left - b };
+        const int32_t ys[8u] = { bottom + b, bottom + b, top - b, top - b, bottom + a, bottom + a, top - a, top - a };
+
+        for (uint32_t i = 0u; i < 8u; i++)
+        {
+            if ((xs[i] >= 0) && (xs[i] < (int32_t)BSP_ILI9341_TFTWIDTH) && (ys[i] >= 0) && (ys[i] < (int32_t)BSP_ILI9341_TFTHEIGHT))
+            {
+                expected[ys[i]][xs[i]] = EXPECT_ON;
+            }
+        }
+    }
+}
+
+void Expect_Polygon(const double * p_x, const double * p_y, uint32_t num_points)
+{
+    // the corners go round one way or the other, inside is on the same side of every edge
+    double area = 0.0;
+
+    for (uint32_t i = 0u; i < num_points; i++)
+    {
+        const uint32_t j = (i + 1u) % num_points;
+
+        area += p_x[i] * p_y[j] - p_x[j] * p_y[i];
+    }
+
+    const double orientation = (area < 0.0) ? -1.0 : 1.0;
+
+    for (int32_t y = 0; y < (int32_t)BSP_ILI9341_TFTHEIGHT; y++)
+    {
+        for (int32_t x = 0; x < (int32_t)BSP_ILI9341_TFTWIDTH; x++)
+        {
+            uint32_t is_inside = 1u;
+            uint32_t is_far_outside = 0u;
+
+            for (uint32_t i = 0u; i < num_points; i++)
+            {
+                const uint32_t j = (i + 1u) % num_points;
+                const double ex = p_x[j] - p_x[i];
+                const double ey = p_y[j] - p_y[i];
+
+                // positive inside, the square of the distance is side^2 / length^2
+                const double side = orientation * (ex * (y - p_y[i]) - ey * (x - p_x[i]));
+
+                if (side < 0.0)
+                {
+                    is_inside = 0u;
+
+                    if (side * side > ex * ex + ey * ey)
+                    {
+                        is_far_outside = 1u;
+                    }
+                }
+            }
+
+            expected[y][x] = is_inside ? EXPECT_ON : (is_far_outside ? EXPECT_OFF : EXPECT_EITHER);
+        }
+    }
+}
+
+void Expect_Thick_Line(int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t thickness)
+{
+    const double dx = x1 - x0;
+    const double dy = y1 - y0;
+    const double length_squared = dx * dx + dy * dy;
+    const double half = thickness / 2.0;
+
+    for (int32_t y = 0; y < (int32_t)BSP_ILI9341_TFTHEIGHT; y++)
+    {
+        for (int32_t x = 0; x < (int32_t)BSP_ILI9341_TFTWIDTH; x++)
+        {
+            // across and along the line, both scaled by the length
+            const double across = dx * (y - y0) - dy * (x - x0);
+            const double along = dx * (x - x0) + dy * (y - y0);
+            const double across_squared = across * across;
+
+            if ((across_squared > (half + 1.0) * (half + 1.0) * length_squared) ||
+                (along < -(half + 1.0) * (half + 1.0) * length_squared) ||
+                (along > length_squared + (half + 1.0) * (half + 1.0) * length_squared))
+            {
+                expected[y][x] = EXPECT_OFF;
+            }
+            else if ((across_squared <= 0.25 * length_squared) && (along >= 0.0) && (along <= length_squared))
+            {
+                expected[y][x] = EXPECT_ON;
+            }
+            else
+            {
+                expected[y][x] = EXPECT_EITHER;
+            }
+        }
+    }
+}
+
+uint32_t Count_Thin_Parts(const Shape_t * p_shape)
+{
+    const int32_t * p_args = p_shape->args;
+    const int32_t dx = (p_args[2] > p_args[0]) ? (p_args[2] - p_args[0]) : (p_args[0] - p_args[2]);
+    const int32_t dy = (p_args[3] > p_args[1]) ? (p_args[3] - p_args[1]) : (p_args[1] - p_args[3]);
+    const uint32_t is_flat = (dx >= dy);
+    const int32_t thickness = p_args[4];
+
+    // the columns of a flat line or the rows of a steep one, less the square ends
+    const int32_t start = is_flat ? ((p_args[0] < p_args[2]) ? p_args[0] : p_args[2]) :
+                                    ((p_args[1] < p_args[3]) ? p_args[1] : p_args[3]);
+    const int32_t end = start + (is_flat ? dx : dy);
+
+    uint32_t num_thin = 0u;
+
+    for (int32_t i = start + thickness; i <= end - thickness; i++)
+    {
+        uint32_t num_on = 0u;
+        const uint32_t num_across = is_flat ? BSP_ILI9341_TFTHEIGHT : BSP_ILI9341_TFTWIDTH;
+
+        for (uint32_t j = 0u; j < num_across; j++)
+        {
+            const uint32_t x = is_flat ? (uint32_t)i : j;
+            const uint32_t y = is_flat ? j : (uint32_t)i;
+
+            if ((expected[y][x] != EXPECT_OFF) && (PSP_Sim_ILI9341_Get_Pixel(x, y) == SHAPE_COLOR))
+            {
+                num_on++;
+            }
+        }
+
+        if (num_on < (uint32_t)thickness)
+        {
+            num_thin++;
+        }
+    }
+
+    return num_thin;
+}
@@ -0,0 +1,511 @@
+/*
+--|----------------------------------------------------------------------------|
+--| FILE DESCRIPTION:
+--|   PWM_Stream_benchmark.c runs the PWM stream on the host register
+--|   simulator and checks every block written is played once, whole, and in
+--|   order. Each block holds a single value, so the words played show which
+--|   block the DMA fed the FIFO, or that it fed it silence.
+--|
+--|   After a run of steady streaming it writes a block while only the
+--|   playing block is queued, which must go two blocks on, after a block of
+--|   silence, and then writes one while the DMA moves on to the next block
+--|   between Write_Block reading the playing block and queuing its own. A
+--|   read hook moves the virtual clock on a whole block there. A block
+--|   queued where the DMA has already loaded silence is never heard.
+--|
+--|----------------------------------------------------------------------------|
+--| HARDWARE SETUP:
+--|   None, this runs on Linux. Build it from within the build directory:
+--|   $ make host TARGET=PWM_Stream_benchmark
+--|   $ ../bin/PWM_Stream_benchmark_host
+--|
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--|----------------------------------------------------------------------------|
+--| INCLUDE FILES
+--|----------------------------------------------------------------------------|
+*/
+
+#include <stdio.h>
+#include <unistd.h>
+
+#include "PSP_IRQ.h"
+#include "PSP_PWM.h"
+#include "PSP_Sim.h"
+
+/*
+--|----------------------------------------------------------------------------|
+--| DEFINES
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--| NAME: RANGE, SILENCE_WORD
+--| DESCRIPTION: the range of both channels, and the word silence plays
+--| TYPE: uint32_t
+*/
+#define RANGE        (64u)
+#define SILENCE_WORD (RANGE / 2u)
+
+/*
+--| NAME: BLOCK_WORDS, BLOCK_uSec
+--| DESCRIPTION: the words in a block, and how long it plays for with the
+--|   simulator's 1 MHz PWM clock
+--| TYPE: uint32_t
+*/
+#define BLOCK_WORDS (PSP_PWM_STREAM_BLOCK_FRAMES * 2u)
+#define BLOCK_uSec  (PSP_PWM_STREAM_BLOCK_FRAMES * RANGE)
+
+/*
+--| NAME: NUM_STEADY_BLOCKS, NUM_FINAL_BLOCKS
+--| DESCRIPTION: the blocks streamed back to back at the start, and after
+--|   the blocks written with only the playing block left
+--| TYPE: uint32_t
+*/
+#define NUM_STEADY_BLOCKS (40u)
+#define NUM_FINAL_BLOCKS  (4u)
+
+/*
+--| NAME: RETRY_WORDS
+--| DESCRIPTION: the words played between tries at writing to a full ring
+--| TYPE: uint32_t
+*/
+#define RETRY_WORDS (BLOCK_WORDS / 4u)
+
+/*
+--| NAME: MAX_PERIODS
+--| DESCRIPTION: the most block periods recorded
+--| TYPE: uint32_t
+*/
+#define MAX_PERIODS (128u)
+
+/*
+--| NAME: DMA_PAGE_OFFSET, DMA_CONBLK_AD
+--| DESCRIPTION: the DMA register page in the peripheral block, and the
+--|   offset of CONBLK_AD within each channel's registers
+--| TYPE: uint32_t
+*/
+#define DMA_PAGE_OFFSET (0x007000u)
+#define DMA_CONBLK_AD   (0x04u)
+
+/*
+--| NAME: ALARM_SECONDS
+--| DESCRIPTION: real time after which a hung run is stopped
+--| TYPE: uint32_t
+*/
+#define ALARM_SECONDS (60u)
+
+/*
+--|----------------------------------------------------------------------------|
+--| TYPES
+--|----------------------------------------------------------------------------|
+*/
+
+/* None */
+
+/*
+--|----------------------------------------------------------------------------|
+--| CONSTANTS
+--|----------------------------------------------------------------------------|
+*/
+
+/* None */
+
+/*
+--|----------------------------------------------------------------------------|
+--| VARIABLES
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--| NAME: frames
+--| DESCRIPTION: the block being written
+--| TYPE: int16_t[]
+*/
+static int16_t frames[BLOCK_WORDS];
+
+/*
+--| NAME: period_first_words, period_is_torn, num_words_played
+--| DESCRIPTION: per block period, the first word played and whether any
+--|   other word differed from it, and the words played so far
+--| TYPE: uint32_t[], uint8_t[], uint32_t
+*/
+static uint32_t period_first_words[MAX_PERIODS];
+static uint8_t period_is_torn[MAX_PERIODS];
+static uint32_t num_words_played;
+
+/*
+--| NAME: expected_gaps, num_blocks_written, last_period
+--| DESCRIPTION: per block written, the silent periods expected before it,
+--|   the number of blocks written, and the period the last one plays in
+--| TYPE: uint32_t[], uint32_t, uint32_t
+*/
+static uint32_t expected_gaps[MAX_PERIODS];
+static uint32_t num_blocks_written;
+static uint32_t last_period;
+
+/*
+--| NAME: is_hook_armed
+--| DESCRIPTION: true to move the clock on at the next read of CONBLK_AD
+--| TYPE: uint32_t
+*/
+static volatile uint32_t is_hook_armed;
+
+/*
+--|----------------------------------------------------------------------------|
+--| FUNCTION PROTOTYPES
+--|----------------------------------------------------------------------------|
+*/
+
+/*------------------------------------------------------------------------------
+Function Name:
+    main
+
+Function Description:
+    Stream the blocks, check what was played and print the results.
+
+Parameters:
+    None
+
+Returns:
+    int: 0 if every check passed, else 1.
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+int main(void);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    Play_Word
+
+Function Description:
+    PWM sink, records the word played in its block period.
+
+Parameters:
+    word: the word.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+void Play_Word(uint32_t word);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    Move_DMA_On
+
+Function Description:
+    Read hook, once armed moves the clock on a whole block right after the
+    next read of a DMA CONBLK_AD, so the DMA moves on a block before the
+    program's next access.
+
+Parameters:
+    offset: the register read.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+void Move_DMA_On(uint32_t offset);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    Write_Block
+
+Function Description:
+    Write the next block, each word of it the block's own value.
+
+Parameters:
+    expected_gap: the silent periods expected before it plays.
+
+Returns:
+    uint32_t: what PSP_PWM_Stream_Write_Block returned.
+
+Assumptions/Limitations:
+    The block is only counted as written if it was queued.
+------------------------------------------------------------------------------*/
+uint32_t Write_Block(uint32_t expected_gap);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    Queue_Block
+
+Function Description:
+    Write the next block, waiting for room in the ring.
+
+Parameters:
+    expected_gap: the silent periods expected before it plays.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+void Queue_Block(uint32_t expected_gap);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    Block_Word
+
+Function Description:
+    Get the word every sample of a block plays as, never the silence word.
+
+Parameters:
+    block_num: the block, counting from the first written.
+
+Returns:
+    uint32_t: the word.
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+uint32_t Block_Word(uint32_t block_num);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    Run_Until_Word
+
+Function Description:
+    Let the virtual clock run, taking the stream interrupts, until a number
+    of words have been played.
+
+Parameters:
+    num_words: the words played to run until.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+void Run_Until_Word(uint32_t num_words);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    Check_Periods
+
+Function Description:
+    Check each block played whole, once and in order, after the silent
+    periods expected before it.
+
+Parameters:
+    None
+
+Returns:
+    uint32_t: the number of failures.
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+uint32_t Check_Periods(void);
+
+/*
+--|----------------------------------------------------------------------------|
+--| FUNCTION DEFINITIONS
+--|----------------------------------------------------------------------------|
+*/
+
+int main(void)
+{
+    uint32_t num_failures = 0u;
+    PSP_Sim_Stats_t stats;
+
+    alarm(ALARM_SECONDS);
+
+    PSP_Sim_PWM_Attach(Play_Word);
+    PSP_Sim_Set_Read_Hook(Move_DMA_On);
+
+    if (!PSP_PWM_Stream_Start(RANGE))
+    {
+        printf("no DMA channel for the stream\n");
+        return 1;
+    }
+
+    PSP_IRQ_Enable();
+
+    // block 0 is playing silence, so the first block goes on block 2
+    Queue_Block(2u);
+
+    for (uint32_t i = 1u; i < NUM_STEADY_BLOCKS; i++)
+    {
+        Queue_Block(0u);
+    }
+
+    // halfway through the last block, the block after it may be loaded any moment
+    Run_Until_Word((last_period * BLOCK_WORDS) + (BLOCK_WORDS / 2u));
+
+    if (!Write_Block(1u))
+    {
+        printf("write with only the playing block queued failed\n");
+        num_failures++;
+    }
+
+    // and again, with the DMA moving on to the next block while it is written
+    Run_Until_Word((last_period * BLOCK_WORDS) + (BLOCK_WORDS / 2u));
+
+    is_hook_armed = 1u;
+
+    if (!Write_Block(2u))
+    {
+        printf("write with the DMA moving on failed\n");
+        num_failures++;
+    }
+
+    if (is_hook_armed)
+    {
+        printf("the DMA never moved on\n");
+        num_failures++;
+    }
+
+    for (uint32_t i = 0u; i < NUM_FINAL_BLOCKS; i++)
+    {
+        Queue_Block(0u);
+    }
+
+    // play it all, and a period of silence after
+    Run_Until_Word((last_period + 2u) * BLOCK_WORDS);
+
+    PSP_PWM_Stream_Stop();
+    PSP_Sim_Get_Stats(&stats);
+
+    num_failures += Check_Periods();
+
+    printf("blocks written %8u  underruns %8u\n", num_blocks_written, PSP_PWM_Stream_Get_Num_Underruns());
+    printf("words played   %8llu  register reads %8llu  writes %8llu\n",
+           (unsigned long long)stats.pwm_words,
+           (unsigned long long)stats.register_reads,
+           (unsigned long long)stats.register_writes);
+    printf("virtual time: %llu uSec\n", (unsigned long long)PSP_Sim_Time_Get());
+    printf("%s\n", num_failures ? "FAILED" : "passed");
+
+    return num_failures ? 1 : 0;
+}
+
+void Play_Word(uint32_t word)
+{
+    const uint32_t period = num_words_played / BLOCK_WORDS;
+
+    if (period < MAX_PERIODS)
+    {
+        if ((num_words_played % BLOCK_WORDS) == 0u)
+        {
+            period_first_words[period] = word;
+        }
+        else if (word != period_first_words[period])
+        {
+            period_is_torn[period] = 1u;
+        }
+        else
+        {
+            /* the same as the rest of the period, do nothing */
+        }
+    }
+
+    num_words_played++;
+}
+
+void Move_DMA_On(uint32_t offset)
+{
+    if (is_hook_armed &&
+        ((offset & ~0xFFFu) == DMA_PAGE_OFFSET) &&
+        ((offset & 0xFFu) == DMA_CONBLK_AD))
+    {
+        is_hook_armed = 0u;
+        PSP_Sim_Time_Advance(BLOCK_uSec);
+    }
+}
+
+uint32_t Write_Block(uint32_t expected_gap)
+{
+    const int16_t sample = (int16_t)((int32_t)(Block_Word(num_blocks_written) * (65536u / RANGE)) - 32768);
+
+    for (uint32_t i = 0u; i < BLOCK_WORDS; i++)
+    {
+        frames[i] = sample;
+    }
+
+    const uint32_t retval = PSP_PWM_Stream_Write_Block(frames);
+
+    if (retval && (num_blocks_written < MAX_PERIODS))
+    {
+        expected_gaps[num_blocks_written++] = expected_gap;
+        last_period += expected_gap + ((num_blocks_written > 1u) ? 1u : 0u);
+    }
+
+    return retval;
+}
+
+void Queue_Block(uint32_t expected_gap)
+{
+    // try again a few times a block, as a program feeding the stream would
+    while (!Write_Block(expected_gap))
+    {
+        Run_Until_Word(num_words_played + RETRY_WORDS);
+    }
+}
+
+uint32_t Block_Word(uint32_t block_num)
+{
+    // 1 to 31, silence is 32
+    return 1u + (block_num % (SILENCE_WORD - 1u));
+}
+
+void Run_Until_Word(uint32_t num_words)
+{
+    while (num_words_played < num_words)
+    {
+        PSP_Sim_Wait_For_Interrupt();
+    }
+}
+
+uint32_t Check_Periods(void)
+{
+    uint32_t num_failures = 0u;
+    uint32_t block_num = 0u;
+    uint32_t gap = 0u;
+
+    for (uint32_t period = 0u; (period < MAX_PERIODS) && (period < (num_words_played / BLOCK_WORDS)); period++)
+    {
+        if (period_is_torn[period])
+        {
+            printf("period %u: torn\n", period);
+            num_failures++;
+        }
+        else if (period_first_words[period] == SILENCE_WORD)
+        {
+            gap++;
+        }
+        else if ((block_num < num_blocks_written) && (period_first_words[period] == Block_Word(block_num)))
+        {
+            if (gap != expected_gaps[block_num])
+            {
+                printf("block %u: %u silent periods before it, expected %u\n", block_num, gap, expected_gaps[block_num]);
+                num_failures++;
+            }
+
+            block_num++;
+            gap = 0u;
+        }
+        else
+        {
+            printf("period %u: played %u, expected block %u\n", period, period_first_words[period], block_num);
+            num_failures++;
+        }
+    }
+
+    if (block_num != num_blocks_written)
+    {
+        printf("%u of %u blocks played\n", block_num, num_blocks_written);
+        num_failures++;
+    }
+
+    return num_failures;
+}
@@ -0,0 +1,368 @@
+/*
+--|----------------------------------------------------------------------------|
+--| FILE DESCRIPTION:
+--|   Soft_Timer_benchmark.c runs the software timer wheel on the host
+--|   register simulator. It starts one shot timers with delays on either
+--|   side of each wheel level, a periodic timer, a cancelled timer and a
+--|   sleep, checks each expires on time, and prints what starting a timer
+--|   cost in register accesses.
+--|
+--|   Setting the compare takes several microseconds of virtual time on the
+--|   simulator, so timers due almost at once check that the compare is never
+--|   left set to a time already gone by, which would leave the wheel waiting
+--|   for the counter to wrap. A run that hangs is stopped by an alarm.
+--|
+--|----------------------------------------------------------------------------|
+--| HARDWARE SETUP:
+--|   None, this runs on Linux. Build it from within the build directory:
+--|   $ make host TARGET=Soft_Timer_benchmark
+--|   $ ../bin/Soft_Timer_benchmark_host
+--|
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--|----------------------------------------------------------------------------|
+--| INCLUDE FILES
+--|----------------------------------------------------------------------------|
+*/
+
+#include <stdio.h>
+#include <unistd.h>
+
+#include "PSP_IRQ.h"
+#include "PSP_Sim.h"
+#include "PSP_Soft_Timer.h"
+
+/*
+--|----------------------------------------------------------------------------|
+--| DEFINES
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--| NAME: NUM_ONE_SHOTS
+--| DESCRIPTION: the number of one shot timers
+--| TYPE: uint32_t
+*/
+#define NUM_ONE_SHOTS (16u)
+
+/*
+--| NAME: LATE_LIMIT_uSec
+--| DESCRIPTION: the most a timer may expire after its time. The simulator
+--|   moves the System Timer on further with each read that comes without a
+--|   write between, up to 1 mSec, so the reads of starting a timer and taking
+--|   its interrupt cost up to a few hundred microseconds of virtual time
+--| TYPE: uint32_t
+*/
+#define LATE_LIMIT_uSec (1000u)
+
+/*
+--| NAME: PERIOD_uSec, NUM_PERIODS
+--| DESCRIPTION: the period of the periodic timer, and how many times it
+--|   expires before its callback cancels it
+--| TYPE: uint32_t
+*/
+#define PERIOD_uSec (1000u)
+#define NUM_PERIODS (20u)
+
+/*
+--| NAME: SLEEP_uSec
+--| DESCRIPTION: how long to sleep for
+--| TYPE: uint32_t
+*/
+#define SLEEP_uSec (2000u)
+
+/*
+--| NAME: ALARM_SECONDS
+--| DESCRIPTION: real time after which a hung run is stopped
+--| TYPE: uint32_t
+*/
+#define ALARM_SECONDS (60u)
+
+/*
+--|----------------------------------------------------------------------------|
+--| TYPES
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--| NAME: Test_Timer_t
+--| DESCRIPTION: a timer and what its callback saw
+*/
+typedef struct Test_Timer_Type
+{
+    PSP_Soft_Timer_t timer;           // must be first, the callback gets a pointer to it
+    uint64_t start_uSec;              // the time just before the timer was started
+    uint64_t fired_uSec[NUM_PERIODS]; // the time of each expiry
+    uint32_t num_fired;               // the number of expiries
+} Test_Timer_t;
+
+/*
+--|----------------------------------------------------------------------------|
+--| CONSTANTS
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--| NAME: one_shot_delays
+--| DESCRIPTION: the delay of each one shot timer, due at once, on either
+--|   side of the first slots and of levels 1 to 3
+--| TYPE: uint32_t[]
+*/
+static const uint32_t one_shot_delays[NUM_ONE_SHOTS] =
+{
+    0u, 1u, 2u, 5u, 63u, 64u, 65u, 4095u, 4096u, 4097u,
+    100000u, 262143u, 262144u, 262145u, 300007u, 1000003u,
+};
+
+/*
+--|----------------------------------------------------------------------------|
+--| VARIABLES
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--| NAME: one_shots, periodic, cancelled
+--| DESCRIPTION: the timers
+--| TYPE: Test_Timer_t
+*/
+static Test_Timer_t one_shots[NUM_ONE_SHOTS];
+static Test_Timer_t periodic;
+static Test_Timer_t cancelled;
+
+/*
+--| NAME: latest_uSec
+--| DESCRIPTION: how late the latest expiry came
+--| TYPE: uint64_t
+*/
+static uint64_t latest_uSec;
+
+/*
+--|----------------------------------------------------------------------------|
+--| FUNCTION PROTOTYPES
+--|----------------------------------------------------------------------------|
+*/
+
+/*------------------------------------------------------------------------------
+Function Name:
+    main
+
+Function Description:
+    Run the timers, check them and print the results.
+
+Parameters:
+    None
+
+Returns:
+    int: 0 if every check passed, else 1.
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+int main(void);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    Record_Expiry
+
+Function Description:
+    Timer callback, records the time of the expiry. The periodic timer
+    cancels itself once it has expired NUM_PERIODS times.
+
+Parameters:
+    p_timer: the timer that expired.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+void Record_Expiry(PSP_Soft_Timer_t * p_timer);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    Check_Expiry
+
+Function Description:
+    Check that an expiry came on time, and keep track of the latest.
+
+Parameters:
+    p_name: what expired.
+    due_uSec: the earliest time it may expire.
+    fired_uSec: the time it expired.
+
+Returns:
+    uint32_t: 1 if it was early or late, else 0.
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+uint32_t Check_Expiry(const char * p_name, uint64_t due_uSec, uint64_t fired_uSec);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    Run_Until
+
+Function Description:
+    Let the virtual clock run, taking the timer interrupts, until a time.
+
+Parameters:
+    end_uSec: the time to run until.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+void Run_Until(uint64_t end_uSec);
+
+/*
+--|----------------------------------------------------------------------------|
+--| FUNCTION DEFINITIONS
+--|----------------------------------------------------------------------------|
+*/
+
+int main(void)
+{
+    uint32_t num_failures = 0u;
+    PSP_Sim_Stats_t start;
+    PSP_Sim_Stats_t end;
+
+    // a compare that is never set right leaves the wheel waiting forever
+    alarm(ALARM_SECONDS);
+
+    PSP_Soft_Timer_Init();
+    PSP_IRQ_Enable();
+
+    // the one shots, started back to back
+    PSP_Sim_Get_Stats(&start);
+
+    for (uint32_t i = 0u; i < NUM_ONE_SHOTS; i++)
+    {
+        one_shots[i].start_uSec = PSP_Sim_Time_Get();
+        PSP_Soft_Timer_Start(&one_shots[i].timer, one_shot_delays[i], 0u, Record_Expiry);
+
+        // on the Pi an interrupt that is due is taken as soon as Start unmasks them
+        PSP_Sim_Service_Interrupts();
+    }
+
+    PSP_Sim_Get_Stats(&end);
+
+    printf("start          register reads %8llu  writes %8llu  per timer\n",
+           (unsigned long long)((end.register_reads - start.register_reads) / NUM_ONE_SHOTS),
+           (unsigned long long)((end.register_writes - start.register_writes) / NUM_ONE_SHOTS));
+
+    Run_Until(one_shots[NUM_ONE_SHOTS - 1u].start_uSec + one_shot_delays[NUM_ONE_SHOTS - 1u] + LATE_LIMIT_uSec);
+
+    for (uint32_t i = 0u; i < NUM_ONE_SHOTS; i++)
+    {
+        if (one_shots[i].num_fired != 1u)
+        {
+            printf("one shot %u uSec: expired %u times\n", one_shot_delays[i], one_shots[i].num_fired);
+            num_failures++;
+        }
+        else
+        {
+            num_failures += Check_Expiry("one shot",
+                                         one_shots[i].start_uSec + one_shot_delays[i],
+                                         one_shots[i].fired_uSec[0]);
+        }
+    }
+
+    // a periodic timer, each expiry is due a whole number of periods after the first
+    periodic.start_uSec = PSP_Sim_Time_Get();
+    PSP_Soft_Timer_Start(&periodic.timer, PERIOD_uSec, PERIOD_uSec, Record_Expiry);
+
+    // and one cancelled before it is due
+    cancelled.start_uSec = PSP_Sim_Time_Get();
+    PSP_Soft_Timer_Start(&cancelled.timer, PERIOD_uSec / 2u, 0u, Record_Expiry);
+    PSP_Soft_Timer_Cancel(&cancelled.timer);
+
+    Run_Until(periodic.start_uSec + (NUM_PERIODS + 2u) * PERIOD_uSec);
+
+    if (periodic.num_fired != NUM_PERIODS)
+    {
+        printf("periodic: expired %u times\n", periodic.num_fired);
+        num_failures++;
+    }
+    else
+    {
+        for (uint32_t i = 0u; i < NUM_PERIODS; i++)
+        {
+            num_failures += Check_Expiry("periodic",
+                                         periodic.start_uSec + (i + 1u) * PERIOD_uSec,
+                                         periodic.fired_uSec[i]);
+        }
+    }
+
+    if (cancelled.num_fired || PSP_Soft_Timer_Is_Pending(&cancelled.timer))
+    {
+        printf("cancelled: expired %u times\n", cancelled.num_fired);
+        num_failures++;
+    }
+
+    // sleeping, the timer interrupt wakes the core
+    const uint64_t sleep_start_uSec = PSP_Sim_Time_Get();
+
+    PSP_Soft_Timer_Sleep_Microseconds(SLEEP_uSec);
+
+    num_failures += Check_Expiry("sleep", sleep_start_uSec + SLEEP_uSec, PSP_Sim_Time_Get());
+
+    printf("latest expiry  %8llu uSec late\n", (unsigned long long)latest_uSec);
+    printf("virtual time: %llu uSec\n", (unsigned long long)PSP_Sim_Time_Get());
+    printf("%s\n", num_failures ? "FAILED" : "passed");
+
+    return num_failures ? 1 : 0;
+}
+
+void Record_Expiry(PSP_Soft_Timer_t * p_timer)
+{
+    Test_Timer_t * p_test_timer = (Test_Timer_t *)p_timer;
+
+    if (p_test_timer->num_fired < NUM_PERIODS)
+    {
+        p_test_timer->fired_uSec[p_test_timer->num_fired] = PSP_Sim_Time_Get();
+    }
+
+    p_test_timer->num_fired++;
+
+    if ((p_test_timer == &periodic) && (periodic.num_fired == NUM_PERIODS))
+    {
+        PSP_Soft_Timer_Cancel(p_timer);
+    }
+}
+
+uint32_t Check_Expiry(const char * p_name, uint64_t due_uSec, uint64_t fired_uSec)
+{
+    uint32_t retval = 0u;
+
+    if ((fired_uSec < due_uSec) || (fired_uSec > due_uSec + LATE_LIMIT_uSec))
+    {
+        printf("%s: due at %llu uSec, expired at %llu uSec\n",
+               p_name,
+               (unsigned long long)due_uSec,
+               (unsigned long long)fired_uSec);
+        retval = 1u;
+    }
+    else if ((fired_uSec - due_uSec) > latest_uSec)
+    {
+        latest_uSec = fired_uSec - due_uSec;
+    }
+    else
+    {
+        /* on time, do nothing */
+    }
+
+    return retval;
+}
+
+void Run_Until(uint64_t end_uSec)
+{
+    while (PSP_Sim_Time_Get() < end_uSec)
+    {
+        PSP_Sim_Wait_For_Interrupt();
+    }
+}
@@ -0,0 +1,392 @@
+/*
+--|----------------------------------------------------------------------------|
+--| FILE DESCRIPTION:
+--|   BSP_Font.c provides the font data and glyph lookup.
+--|
+--|----------------------------------------------------------------------------|
+--| REFERENCES:
+--|   see BSP_Font.h
+--|
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--|----------------------------------------------------------------------------|
+--| INCLUDE FILES
+--|----------------------------------------------------------------------------|
+*/
+
+#include "BSP_Font.h"
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE DEFINES
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--| NAME: FONT_MISSING_CHAR
+--| DESCRIPTION: drawn in place of a character the font does not have
+--| TYPE: char
+*/
+#define FONT_MISSING_CHAR ('?')
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE TYPES
+--|----------------------------------------------------------------------------|
+*/
+
+/* None */
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE CONSTANTS
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--| NAME: font_5x7_bitmaps
+--| DESCRIPTION: the glyphs of BSP_Font_5x7, ' ' to '~'
+--| TYPE: uint8_t[]
+*/
+static const uint8_t font_5x7_bitmaps[95u * 8u] =
+{
+    0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, // 0x20 ' '
+    0x20u, 0x20u, 0x20u, 0x20u, 0x20u, 0x00u, 0x20u, 0x00u, // 0x21 '!'
+    0x50u, 0x50u, 0x50u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, // 0x22 '"'
+    0x50u, 0x50u, 0xF8u, 0x50u, 0xF8u, 0x50u, 0x50u, 0x00u, // 0x23 '#'
+    0x20u, 0x78u, 0xA0u, 0x70u, 0x28u, 0xF0u, 0x20u, 0x00u, // 0x24 '$'
+    0xC0u, 0xC8u, 0x10u, 0x20u, 0x40u, 0x98u, 0x18u, 0x00u, // 0x25 '%'
+    0x60u, 0x90u, 0xA0u, 0x40u, 0xA8u, 0x90u, 0x68u, 0x00u, // 0x26 '&'
+    0x20u, 0x20u, 0x40u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, // 0x27 '''
+    0x10u, 0x20u, 0x40u, 0x40u, 0x40u, 0x20u, 0x10u, 0x00u, // 0x28 '('
+    0x40u, 0x20u, 0x10u, 0x10u, 0x10u, 0x20u, 0x40u, 0x00u, // 0x29 ')'
+    0x00u, 0x20u, 0xA8u, 0x70u, 0xA8u, 0x20u, 0x00u, 0x00u, // 0x2A '*'
+    0x00u, 0x20u, 0x20u, 0xF8u, 0x20u, 0x20u, 0x00u, 0x00u, // 0x2B '+'
+    0x00u, 0x00u, 0x00u, 0x00u, 0x60u, 0x20u, 0x40u, 0x00u, // 0x2C ','
+    0x00u, 0x00u, 0x00u, 0xF8u, 0x00u, 0x00u, 0x00u, 0x00u, // 0x2D '-'
+    0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x60u, 0x60u, 0x00u, // 0x2E '.'
+    0x00u, 0x08u, 0x10u, 0x20u, 0x40u, 0x80u, 0x00u, 0x00u, // 0x2F '/'
+    0x70u, 0x88u, 0x98u, 0xA8u, 0xC8u, 0x88u, 0x70u, 0x00u, // 0x30 '0'
+    0x20u, 0x60u, 0x20u, 0x20u, 0x20u, 0x20u, 0x70u, 0x00u, // 0x31 '1'
+    0x70u, 0x88u, 0x08u, 0x10u, 0x20u, 0x40u, 0xF8u, 0x00u, // 0x32 '2'
+    0xF8u, 0x10u, 0x20u, 0x10u, 0x08u, 0x88u, 0x70u, 0x00u, // 0x33 '3'
+    0x10u, 0x30u, 0x50u, 0x90u, 0xF8u, 0x10u, 0x10u, 0x00u, // 0x34 '4'
+    0xF8u, 0x80u, 0xF0u, 0x08u, 0x08u, 0x88u, 0x70u, 0x00u, // 0x35 '5'
+    0x30u, 0x40u, 0x80u, 0xF0u, 0x88u, 0x88u, 0x70u, 0x00u, // 0x36 '6'
+    0xF8u, 0x08u, 0x10u, 0x20u, 0x40u, 0x40u, 0x40u, 0x00u, // 0x37 '7'
+    0x70u, 0x88u, 0x88u, 0x70u, 0x88u, 0x88u, 0x70u, 0x00u, // 0x38 '8'
+    0x70u, 0x88u, 0x88u, 0x78u, 0x08u, 0x10u, 0x60u, 0x00u, // 0x39 '9'
+    0x00u, 0x60u, 0x60u, 0x00u, 0x60u, 0x60u, 0x00u, 0x00u, // 0x3A ':'
+    0x00u, 0x60u, 0x60u, 0x00u, 0x60u, 0x20u, 0x40u, 0x00u, // 0x3B ';'
+    0x10u, 0x20u, 0x40u, 0x80u, 0x40u, 0x20u, 0x10u, 0x00u, // 0x3C '<'
+    0x00u, 0x00u, 0xF8u, 0x00u, 0xF8u, 0x00u, 0x00u, 0x00u, // 0x3D '='
+    0x40u, 0x20u, 0x10u, 0x08u, 0x10u, 0x20u, 0x40u, 0x00u, // 0x3E '>'
+    0x70u, 0x88u, 0x08u, 0x10u, 0x20u, 0x00u, 0x20u, 0x00u, // 0x3F '?'
+    0x70u, 0x88u, 0x08u, 0x68u, 0xA8u, 0xA8u, 0x70u, 0x00u, // 0x40 '@'
+    0x70u, 0x88u, 0x88u, 0xF8u, 0x88u, 0x88u, 0x88u, 0x00u, // 0x41 'A'
+    0xF0u, 0x88u, 0x88u, 0xF0u, 0x88u, 0x88u, 0xF0u, 0x00u, // 0x42 'B'
+    0x70u, 0x88u, 0x80u, 0x80u, 0x80u, 0x88u, 0x70u, 0x00u, // 0x43 'C'
+    0xE0u, 0x90u, 0x88u, 0x88u, 0x88u, 0x90u, 0xE0u, 0x00u, // 0x44 'D'
+    0xF8u, 0x80u, 0x80u, 0xF0u, 0x80u, 0x80u, 0xF8u, 0x00u, // 0x45 'E'
+    0xF8u, 0x80u, 0x80u, 0xF0u, 0x80u, 0x80u, 0x80u, 0x00u, // 0x46 'F'
+    0x70u, 0x88u, 0x80u, 0xB8u, 0x88u, 0x88u, 0x78u, 0x00u, // 0x47 'G'
+    0x88u, 0x88u, 0x88u, 0xF8u, 0x88u, 0x88u, 0x88u, 0x00u, // 0x48 'H'
+    0x70u, 0x20u, 0x20u, 0x20u, 0x20u, 0x20u, 0x70u, 0x00u, // 0x49 'I'
+    0x38u, 0x10u, 0x10u, 0x10u, 0x10u, 0x90u, 0x60u, 0x00u, // 0x4A 'J'
+    0x88u, 0x90u, 0xA0u, 0xC0u, 0xA0u, 0x90u, 0x88u, 0x00u, // 0x4B 'K'
+    0x80u, 0x80u, 0x80u, 0x80u, 0x80u, 0x80u, 0xF8u, 0x00u, // 0x4C 'L'
+    0x88u, 0xD8u, 0xA8u, 0xA8u, 0x88u, 0x88u, 0x88u, 0x00u, // 0x4D 'M'
+    0x88u, 0x88u, 0xC8u, 0xA8u, 0x98u, 0x88u, 0x88u, 0x00u, // 0x4E 'N'
+    0x70u, 0x88u, 0x88u, 0x88u, 0x88u, 0x88u, 0x70u, 0x00u, // 0x4F 'O'
+    0xF0u, 0x88u, 0x88u, 0xF0u, 0x80u, 0x80u, 0x80u, 0x00u, // 0x50 'P'
+    0x70u, 0x88u, 0x88u, 0x88u, 0xA8u, 0x90u, 0x68u, 0x00u, // 0x51 'Q'
+    0xF0u, 0x88u, 0x88u, 0xF0u, 0xA0u, 0x90u, 0x88u, 0x00u, // 0x52 'R'
+    0x78u, 0x80u, 0x80u, 0x70u, 0x08u, 0x08u, 0xF0u, 0x00u, // 0x53 'S'
+    0xF8u, 0x20u, 0x20u, 0x20u, 0x20u, 0x20u, 0x20u, 0x00u, // 0x54 'T'
+    0x88u, 0x88u, 0x88u, 0x88u, 0x88u, 0x88u, 0x70u, 0x00u, // 0x55 'U'
+    0x88u, 0x88u, 0x88u, 0x88u, 0x88u, 0x50u, 0x20u, 0x00u, // 0x56 'V'
+    0x88u, 0x88u, 0x88u, 0xA8u, 0xA8u, 0xA8u, 0x50u, 0x00u, // 0x57 'W'
+    0x88u, 0x88u, 0x50u, 0x20u, 0x50u, 0x88u, 0x88u, 0x00u, // 0x58 'X'
+    0x88u, 0x88u, 0x88u, 0x50u, 0x20u, 0x20u, 0x20u, 0x00u, // 0x59 'Y'
+    0xF8u, 0x08u, 0x10u, 0x20u, 0x40u, 0x80u, 0xF8u, 0x00u, // 0x5A 'Z'
+    0x70u, 0x40u, 0x40u, 0x40u, 0x40u, 0x40u, 0x70u, 0x00u, // 0x5B '['
+    0x00u, 0x80u, 0x40u, 0x20u, 0x10u, 0x08u, 0x00u, 0x00u, // 0x5C backslash
+    0x70u, 0x10u, 0x10u, 0x10u, 0x10u, 0x10u, 0x70u, 0x00u, // 0x5D ']'
+    0x20u, 0x50u, 0x88u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, // 0x5E '^'
+    0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0xF8u, 0x00u, // 0x5F '_'
+    0x40u, 0x20u, 0x10u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, // 0x60 '`'
+    0x00u, 0x00u, 0x70u, 0x08u, 0x78u, 0x88u, 0x78u, 0x00u, // 0x61 'a'
+    0x80u, 0x80u, 0xB0u, 0xC8u, 0x88u, 0x88u, 0xF0u, 0x00u, // 0x62 'b'
+    0x00u, 0x00u, 0x70u, 0x80u, 0x80u, 0x88u, 0x70u, 0x00u, // 0x63 'c'
+    0x08u, 0x08u, 0x68u, 0x98u, 0x88u, 0x88u, 0x78u, 0x00u, // 0x64 'd'
+    0x00u, 0x00u, 0x70u, 0x88u, 0xF8u, 0x80u, 0x70u, 0x00u, // 0x65 'e'
+    0x30u, 0x48u, 0x40u, 0xE0u, 0x40u, 0x40u, 0x40u, 0x00u, // 0x66 'f'
+    0x00u, 0x78u, 0x88u, 0x88u, 0x78u, 0x08u, 0x70u, 0x00u, // 0x67 'g'
+    0x80u, 0x80u, 0xB0u, 0xC8u, 0x88u, 0x88u, 0x88u, 0x00u, // 0x68 'h'
+    0x20u, 0x00u, 0x60u, 0x20u, 0x20u, 0x20u, 0x70u, 0x00u, // 0x69 'i'
+    0x10u, 0x00u, 0x30u, 0x10u, 0x10u, 0x90u, 0x60u, 0x00u, // 0x6A 'j'
+    0x80u, 0x80u, 0x90u, 0xA0u, 0xC0u, 0xA0u, 0x90u, 0x00u, // 0x6B 'k'
+    0x60u, 0x20u, 0x20u, 0x20u, 0x20u, 0x20u, 0x70u, 0x00u, // 0x6C 'l'
+    0x00u, 0x00u, 0xD0u, 0xA8u, 0xA8u, 0x88u, 0x88u, 0x00u, // 0x6D 'm'
+    0x00u, 0x00u, 0xB0u, 0xC8u, 0x88u, 0x88u, 0x88u, 0x00u, // 0x6E 'n'
+    0x00u, 0x00u, 0x70u, 0x88u, 0x88u, 0x88u, 0x70u, 0x00u, // 0x6F 'o'
+    0x00u, 0x00u, 0xF0u, 0x88u, 0xF0u, 0x80u, 0x80u, 0x00u, // 0x70 'p'
+    0x00u, 0x00u, 0x68u, 0x98u, 0x78u, 0x08u, 0x08u, 0x00u, // 0x71 'q'
+    0x00u, 0x00u, 0xB0u, 0xC8u, 0x80u, 0x80u, 0x80u, 0x00u, // 0x72 'r'
+    0x00u, 0x00u, 0x70u, 0x80u, 0x70u, 0x08u, 0xF0u, 0x00u, // 0x73 's'
+    0x40u, 0x40u, 0xE0u, 0x40u, 0x40u, 0x48u, 0x30u, 0x00u, // 0x74 't'
+    0x00u, 0x00u, 0x88u, 0x88u, 0x88u, 0x98u, 0x68u, 0x00u, // 0x75 'u'
+    0x00u, 0x00u, 0x88u, 0x88u, 0x88u, 0x50u, 0x20u, 0x00u, // 0x76 'v'
+    0x00u, 0x00u, 0x88u, 0x88u, 0xA8u, 0xA8u, 0x50u, 0x00u, // 0x77 'w'
+    0x00u, 0x00u, 0x88u, 0x50u, 0x20u, 0x50u, 0x88u, 0x00u, // 0x78 'x'
+    0x00u, 0x00u, 0x88u, 0x88u, 0x78u, 0x08u, 0x70u, 0x00u, // 0x79 'y'
+    0x00u, 0x00u, 0xF8u, 0x10u, 0x20u, 0x40u, 0xF8u, 0x00u, // 0x7A 'z'
+    0x10u, 0x20u, 0x20u, 0x40u, 0x20u, 0x20u, 0x10u, 0x00u, // 0x7B '{'
+    0x20u, 0x20u, 0x20u, 0x20u, 0x20u, 0x20u, 0x20u, 0x00u, // 0x7C '|'
+    0x40u, 0x20u, 0x20u, 0x10u, 0x20u, 0x20u, 0x40u, 0x00u, // 0x7D '}'
+    0x00u, 0x00u, 0x40u, 0xA8u, 0x10u, 0x00u, 0x00u, 0x00u, // 0x7E '~'
+};
+
+/*
+--| NAME: BSP_Font_5x7
+--| DESCRIPTION: declared in BSP_Font.h
+--| TYPE: BSP_Font_t
+*/
+const BSP_Font_t BSP_Font_5x7 =
+{
+    font_5x7_bitmaps,
+    ' ',
+    95u,
+    6u,
+    8u,
+    0,
+};
+
+/*
+--| NAME: font_5x7_proportional_bitmaps
+--| DESCRIPTION: the glyphs of BSP_Font_5x7_Proportional, ' ' to '~'
+--| TYPE: uint8_t[]
+*/
+static const uint8_t font_5x7_proportional_bitmaps[95u * 8u] =
+{
+    0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, // 0x20 ' '
+    0x80u, 0x80u, 0x80u, 0x80u, 0x80u, 0x00u, 0x80u, 0x00u, // 0x21 '!'
+    0xA0u, 0xA0u, 0xA0u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, // 0x22 '"'
+    0x50u, 0x50u, 0xF8u, 0x50u, 0xF8u, 0x50u, 0x50u, 0x00u, // 0x23 '#'
+    0x20u, 0x78u, 0xA0u, 0x70u, 0x28u, 0xF0u, 0x20u, 0x00u, // 0x24 '$'
+    0xC0u, 0xC8u, 0x10u, 0x20u, 0x40u, 0x98u, 0x18u, 0x00u, // 0x25 '%'
+    0x60u, 0x90u, 0xA0u, 0x40u, 0xA8u, 0x90u, 0x68u, 0x00u, // 0x26 '&'
+    0x40u, 0x40u, 0x80u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, // 0x27 '''
+    0x20u, 0x40u, 0x80u, 0x80u, 0x80u, 0x40u, 0x20u, 0x00u, // 0x28 '('
+    0x80u, 0x40u, 0x20u, 0x20u, 0x20u, 0x40u, 0x80u, 0x00u, // 0x29 ')'
+    0x00u, 0x20u, 0xA8u, 0x70u, 0xA8u, 0x20u, 0x00u, 0x00u, // 0x2A '*'
+    0x00u, 0x20u, 0x20u, 0xF8u, 0x20u, 0x20u, 0x00u, 0x00u, // 0x2B '+'
+    0x00u, 0x00u, 0x00u, 0x00u, 0xC0u, 0x40u, 0x80u, 0x00u, // 0x2C ','
+    0x00u, 0x00u, 0x00u, 0xF8u, 0x00u, 0x00u, 0x00u, 0x00u, // 0x2D '-'
+    0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0xC0u, 0xC0u, 0x00u, // 0x2E '.'
+    0x00u, 0x08u, 0x10u, 0x20u, 0x40u, 0x80u, 0x00u, 0x00u, // 0x2F '/'
+    0x70u, 0x88u, 0x98u, 0xA8u, 0xC8u, 0x88u, 0x70u, 0x00u, // 0x30 '0'
+    0x20u, 0x60u, 0x20u, 0x20u, 0x20u, 0x20u, 0x70u, 0x00u, // 0x31 '1'
+    0x70u, 0x88u, 0x08u, 0x10u, 0x20u, 0x40u, 0xF8u, 0x00u, // 0x32 '2'
+    0xF8u, 0x10u, 0x20u, 0x10u, 0x08u, 0x88u, 0x70u, 0x00u, // 0x33 '3'
+    0x10u, 0x30u, 0x50u, 0x90u, 0xF8u, 0x10u, 0x10u, 0x00u, // 0x34 '4'
+    0xF8u, 0x80u, 0xF0u, 0x08u, 0x08u, 0x88u, 0x70u, 0x00u, // 0x35 '5'
+    0x30u, 0x40u, 0x80u, 0xF0u, 0x88u, 0x88u, 0x70u, 0x00u, // 0x36 '6'
+    0xF8u, 0x08u, 0x10u, 0x20u, 0x40u, 0x40u, 0x40u, 0x00u, // 0x37 '7'
+    0x70u, 0x88u, 0x88u, 0x70u, 0x88u, 0x88u, 0x70u, 0x00u, // 0x38 '8'
+    0x70u, 0x88u, 0x88u, 0x78u, 0x08u, 0x10u, 0x60u, 0x00u, // 0x39 '9'
+    0x00u, 0xC0u, 0xC0u, 0x00u, 0xC0u, 0xC0u, 0x00u, 0x00u, // 0x3A ':'
+    0x00u, 0xC0u, 0xC0u, 0x00u, 0xC0u, 0x40u, 0x80u, 0x00u, // 0x3B ';'
+    0x10u, 0x20u, 0x40u, 0x80u, 0x40u, 0x20u, 0x10u, 0x00u, // 0x3C '<'
+    0x00u, 0x00u, 0xF8u, 0x00u, 0xF8u, 0x00u, 0x00u, 0x00u, // 0x3D '='
+    0x80u, 0x40u, 0x20u, 0x10u, 0x20u, 0x40u, 0x80u, 0x00u, // 0x3E '>'
+    0x70u, 0x88u, 0x08u, 0x10u, 0x20u, 0x00u, 0x20u, 0x00u, // 0x3F '?'
+    0x70u, 0x88u, 0x08u, 0x68u, 0xA8u, 0xA8u, 0x70u, 0x00u, // 0x40 '@'
+    0x70u, 0x88u, 0x88u, 0xF8u, 0x88u, 0x88u, 0x88u, 0x00u, // 0x41 'A'
+    0xF0u, 0x88u, 0x88u, 0xF0u, 0x88u, 0x88u, 0xF0u, 0x00u, // 0x42 'B'
+    0x70u, 0x88u, 0x80u, 0x80u, 0x80u, 0x88u, 0x70u, 0x00u, // 0x43 'C'
+    0xE0u, 0x90u, 0x88u, 0x88u, 0x88u, 0x90u, 0xE0u, 0x00u, // 0x44 'D'
+    0xF8u, 0x80u, 0x80u, 0xF0u, 0x80u, 0x80u, 0xF8u, 0x00u, // 0x45 'E'
+    0xF8u, 0x80u, 0x80u, 0xF0u, 0x80u, 0x80u, 0x80u, 0x00u, // 0x46 'F'
+    0x70u, 0x88u, 0x80u, 0xB8u, 0x88u, 0x88u, 0x78u, 0x00u, // 0x47 'G'
+    0x88u, 0x88u, 0x88u, 0xF8u, 0x88u, 0x88u, 0x88u, 0x00u, // 0x48 'H'
+    0xE0u, 0x40u, 0x40u, 0x40u, 0x40u, 0x40u, 0xE0u, 0x00u, // 0x49 'I'
+    0x38u, 0x10u, 0x10u, 0x10u, 0x10u, 0x90u, 0x60u, 0x00u, // 0x4A 'J'
+    0x88u, 0x90u, 0xA0u, 0xC0u, 0xA0u, 0x90u, 0x88u, 0x00u, // 0x4B 'K'
+    0x80u, 0x80u, 0x80u, 0x80u, 0x80u, 0x80u, 0xF8u, 0x00u, // 0x4C 'L'
+    0x88u, 0xD8u, 0xA8u, 0xA8u, 0x88u, 0x88u, 0x88u, 0x00u, // 0x4D 'M'
+    0x88u, 0x88u, 0xC8u, 0xA8u, 0x98u, 0x88u, 0x88u, 0x00u, // 0x4E 'N'
+    0x70u, 0x88u, 0x88u, 0x88u, 0x88u, 0x88u, 0x70u, 0x00u, // 0x4F 'O'
+    0xF0u, 0x88u, 0x88u, 0xF0u, 0x80u, 0x80u, 0x80u, 0x00u, // 0x50 'P'
+    0x70u, 0x88u, 0x88u, 0x88u, 0xA8u, 0x90u, 0x68u, 0x00u, // 0x51 'Q'
+    0xF0u, 0x88u, 0x88u, 0xF0u, 0xA0u, 0x90u, 0x88u, 0x00u, // 0x52 'R'
+    0x78u, 0x80u, 0x80u, 0x70u, 0x08u, 0x08u, 0xF0u, 0x00u, // 0x53 'S'
+    0xF8u, 0x20u, 0x20u, 0x20u, 0x20u, 0x20u, 0x20u, 0x00u, // 0x54 'T'
+    0x88u, 0x88u, 0x88u, 0x88u, 0x88u, 0x88u, 0x70u, 0x00u, // 0x55 'U'
+    0x88u, 0x88u, 0x88u, 0x88u, 0x88u, 0x50u, 0x20u, 0x00u, // 0x56 'V'
+    0x88u, 0x88u, 0x88u, 0xA8u, 0xA8u, 0xA8u, 0x50u, 0x00u, // 0x57 'W'
+    0x88u, 0x88u, 0x50u, 0x20u, 0x50u, 0x88u, 0x88u, 0x00u, // 0x58 'X'
+    0x88u, 0x88u, 0x88u, 0x50u, 0x20u, 0x20u, 0x20u, 0x00u, // 0x59 'Y'
+    0xF8u, 0x08u, 0x10u, 0x20u, 0x40u, 0x80u, 0xF8u, 0x00u, // 0x5A 'Z'
+    0xE0u, 0x80u, 0x80u, 0x80u, 0x80u, 0x80u, 0xE0u, 0x00u, // 0x5B '['
+    0x00u, 0x80u, 0x40u, 0x20u, 0x10u, 0x08u, 0x00u, 0x00u, // 0x5C backslash
+    0xE0u, 0x20u, 0x20u, 0x20u, 0x20u, 0x20u, 0xE0u, 0x00u, // 0x5D ']'
+    0x20u, 0x50u, 0x88u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, // 0x5E '^'
+    0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0xF8u, 0x00u, // 0x5F '_'
+    0x80u, 0x40u, 0x20u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, // 0x60 '`'
+    0x00u, 0x00u, 0x70u, 0x08u, 0x78u, 0x88u, 0x78u, 0x00u, // 0x61 'a'
+    0x80u, 0x80u, 0xB0u, 0xC8u, 0x88u, 0x88u, 0xF0u, 0x00u, // 0x62 'b'
+    0x00u, 0x00u, 0x70u, 0x80u, 0x80u, 0x88u, 0x70u, 0x00u, // 0x63 'c'
+    0x08u, 0x08u, 0x68u, 0x98u, 0x88u, 0x88u, 0x78u, 0x00u, // 0x64 'd'
+    0x00u, 0x00u, 0x70u, 0x88u, 0xF8u, 0x80u, 0x70u, 0x00u, // 0x65 'e'
+    0x30u, 0x48u, 0x40u, 0xE0u, 0x40u, 0x40u, 0x40u, 0x00u, // 0x66 'f'
+    0x00u, 0x78u, 0x88u, 0x88u, 0x78u, 0x08u, 0x70u, 0x00u, // 0x67 'g'
+    0x80u, 0x80u, 0xB0u, 0xC8u, 0x88u, 0x88u, 0x88u, 0x00u, // 0x68 'h'
+    0x40u, 0x00u, 0xC0u, 0x40u, 0x40u, 0x40u, 0xE0u, 0x00u, // 0x69 'i'
+    0x10u, 0x00u, 0x30u, 0x10u, 0x10u, 0x90u, 0x60u, 0x00u, // 0x6A 'j'
+    0x80u, 0x80u, 0x90u, 0xA0u, 0xC0u, 0xA0u, 0x90u, 0x00u, // 0x6B 'k'
+    0xC0u, 0x40u, 0x40u, 0x40u, 0x40u, 0x40u, 0xE0u, 0x00u, // 0x6C 'l'
+    0x00u, 0x00u, 0xD0u, 0xA8u, 0xA8u, 0x88u, 0x88u, 0x00u, // 0x6D 'm'
+    0x00u, 0x00u, 0xB0u, 0xC8u, 0x88u, 0x88u, 0x88u, 0x00u, // 0x6E 'n'
+    0x00u, 0x00u, 0x70u, 0x88u, 0x88u, 0x88u, 0x70u, 0x00u, // 0x6F 'o'
+    0x00u, 0x00u, 0xF0u, 0x88u, 0xF0u, 0x80u, 0x80u, 0x00u, // 0x70 'p'
+    0x00u, 0x00u, 0x68u, 0x98u, 0x78u, 0x08u, 0x08u, 0x00u, // 0x71 'q'
+    0x00u, 0x00u, 0xB0u, 0xC8u, 0x80u, 0x80u, 0x80u, 0x00u, // 0x72 'r'
+    0x00u, 0x00u, 0x70u, 0x80u, 0x70u, 0x08u, 0xF0u, 0x00u, // 0x73 's'
+    0x40u, 0x40u, 0xE0u, 0x40u, 0x40u, 0x48u, 0x30u, 0x00u, // 0x74 't'
+    0x00u, 0x00u, 0x88u, 0x88u, 0x88u, 0x98u, 0x68u, 0x00u, // 0x75 'u'
+    0x00u, 0x00u, 0x88u, 0x88u, 0x88u, 0x50u, 0x20u, 0x00u, // 0x76 'v'
+    0x00u, 0x00u, 0x88u, 0x88u, 0xA8u, 0xA8u, 0x50u, 0x00u, // 0x77 'w'
+    0x00u, 0x00u, 0x88u, 0x50u, 0x20u, 0x50u, 0x88u, 0x00u, // 0x78 'x'
+    0x00u, 0x00u, 0x88u, 0x88u, 0x78u, 0x08u, 0x70u, 0x00u, // 0x79 'y'
+    0x00u, 0x00u, 0xF8u, 0x10u, 0x20u, 0x40u, 0xF8u, 0x00u, // 0x7A 'z'
+    0x20u, 0x40u, 0x40u, 0x80u, 0x40u, 0x40u, 0x20u, 0x00u, // 0x7B '{'
+    0x80u, 0x80u, 0x80u, 0x80u, 0x80u, 0x80u, 0x80u, 0x00u, // 0x7C '|'
+    0x80u, 0x40u, 0x40u, 0x20u, 0x40u, 0x40u, 0x80u, 0x00u, // 0x7D '}'
+    0x00u, 0x00u, 0x40u, 0xA8u, 0x10u, 0x00u, 0x00u, 0x00u, // 0x7E '~'
+};
+
+/*
+--| NAME: font_5x7_proportional_widths
+--| DESCRIPTION: the widths of the glyphs of BSP_Font_5x7_Proportional
+--| TYPE: uint8_t[]
+*/
+static const uint8_t font_5x7_proportional_widths[95u] =
+{
+    3u, 2u, 4u, 6u, 6u, 6u, 6u, 3u, // 0x20 to 0x27
+    4u, 4u, 6u, 6u, 3u, 6u, 3u, 6u, // 0x28 to 0x2F
+    6u, 6u, 6u, 6u, 6u, 6u, 6u, 6u, // 0x30 to 0x37
+    6u, 6u, 3u, 3u, 5u, 6u, 5u, 6u, // 0x38 to 0x3F
+    6u, 6u, 6u, 6u, 6u, 6u, 6u, 6u, // 0x40 to 0x47
+    6u, 4u, 6u, 6u, 6u, 6u, 6u, 6u, // 0x48 to 0x4F
+    6u, 6u, 6u, 6u, 6u, 6u, 6u, 6u, // 0x50 to 0x57
+    6u, 6u, 6u, 4u, 6u, 4u, 6u, 6u, // 0x58 to 0x5F
+    4u, 6u, 6u, 6u, 6u, 6u, 6u, 6u, // 0x60 to 0x67
+    6u, 4u, 5u, 5u, 4u, 6u, 6u, 6u, // 0x68 to 0x6F
+    6u, 6u, 6u, 6u, 6u, 6u, 6u, 6u, // 0x70 to 0x77
+    6u, 6u, 6u, 4u, 2u, 4u, 6u, // 0x78 to 0x7E
+};
+
+/*
+--| NAME: BSP_Font_5x7_Proportional
+--| DESCRIPTION: declared in BSP_Font.h
+--| TYPE: BSP_Font_t
+*/
+const BSP_Font_t BSP_Font_5x7_Proportional =
+{
+    font_5x7_proportional_bitmaps,
+    ' ',
+    95u,
+    6u,
+    8u,
+    font_5x7_proportional_widths,
+};
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE VARIABLES
+--|----------------------------------------------------------------------------|
+*/
+
+/* None */
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE HELPER FUNCTION PROTOTYPES
+--|----------------------------------------------------------------------------|
+*/
+
+/*------------------------------------------------------------------------------
+Function Name:
+    Font_Get_Index
+
+Function Description:
+    Get the index of the glyph for a character.
+
+Parameters:
+    p_font: the font.
+    c: the character.
+
+Returns:
+    uint32_t: the glyph index, the index of '?' for a character the font
+    does not have.
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+uint32_t Font_Get_Index(const BSP_Font_t * p_font, char c);
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC FUNCTION DEFINITIONS
+--|----------------------------------------------------------------------------|
+*/
+
+const uint8_t * BSP_Font_Get_Glyph(const BSP_Font_t * p_font, char c)
+{
+    return &p_font->p_bitmaps[Font_Get_Index(p_font, c) * p_font->height];
+}
+
+uint32_t BSP_Font_Get_Char_Width(const BSP_Font_t * p_font, char c)
+{
+    uint32_t retval = p_font->width;
+
+    if (p_font->p_widths)
+    {
+        retval = p_font->p_widths[Font_Get_Index(p_font, c)];
+    }
+
+    return retval;
+}
+
+uint32_t BSP_Font_Get_String_Width(const BSP_Font_t * p_font, const char * p_string)
+{
+    uint32_t width = 0u;
+
+    for (uint32_t i = 0u; p_string[i] != '\0'; i++)
+    {
+        width += BSP_Font_Get_Char_Width(p_font, p_string[i]);
+    }
+
+    return width;
+}
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE HELPER FUNCTION DEFINITIONS
+--|----------------------------------------------------------------------------|
+*/
+
+uint32_t Font_Get_Index(const BSP_Font_t * p_font, char c)
+{
+    uint32_t index = (uint8_t)c - (uint32_t)p_font->first_char;
+
+    if (index >= p_font->num_glyphs)
+    {
+        index = (uint32_t)(FONT_MISSING_CHAR - p_font->first_char);
+    }
+
+    return index;
+}
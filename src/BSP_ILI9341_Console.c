@@ -0,0 +1,221 @@
+/*
+--|----------------------------------------------------------------------------|
+--| FILE DESCRIPTION:
+--|   BSP_ILI9341_Console.c provides the implementation for the scrolling
+--|   text console.
+--|
+--|----------------------------------------------------------------------------|
+--| REFERENCES:
+--|   see BSP_ILI9341_Console.h
+--|
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--|----------------------------------------------------------------------------|
+--| INCLUDE FILES
+--|----------------------------------------------------------------------------|
+*/
+
+#include "BSP_ILI9341_Console.h"
+#include "BSP_ILI9341_SPI_Display.h"
+#include "BSP_Font.h"
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE DEFINES
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--| NAME: CONSOLE_FONT
+--| DESCRIPTION: the font the console writes in
+--| TYPE: BSP_Font_t
+*/
+#define CONSOLE_FONT (BSP_Font_5x7)
+
+/*
+--| NAME: CONSOLE_CHAR_WIDTH, CONSOLE_CHAR_HEIGHT
+--| DESCRIPTION: the size of a character cell, in pixels
+--| TYPE: uint32_t
+*/
+#define CONSOLE_CHAR_WIDTH  (6u)
+#define CONSOLE_CHAR_HEIGHT (8u)
+
+/*
+--| NAME: CONSOLE_NUM_COLUMNS, CONSOLE_NUM_LINES
+--| DESCRIPTION: the size of the console, in characters
+--| TYPE: uint32_t
+*/
+#define CONSOLE_NUM_COLUMNS (BSP_ILI9341_TFTWIDTH / CONSOLE_CHAR_WIDTH)
+#define CONSOLE_NUM_LINES   (BSP_ILI9341_TFTHEIGHT / CONSOLE_CHAR_HEIGHT)
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE TYPES
+--|----------------------------------------------------------------------------|
+*/
+
+/* None */
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE CONSTANTS
+--|----------------------------------------------------------------------------|
+*/
+
+/* None */
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE VARIABLES
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--| NAME: text_color, background_color
+--| DESCRIPTION: the console colors
+--| TYPE: uint16_t
+*/
+static uint16_t text_color;
+static uint16_t background_color;
+
+/*
+--| NAME: cursor_column, cursor_line
+--| DESCRIPTION: where the next character goes, the line counts display
+--|   memory lines, not lines on screen
+--| TYPE: uint32_t
+*/
+static uint32_t cursor_column;
+static uint32_t cursor_line;
+
+/*
+--| NAME: top_line
+--| DESCRIPTION: the display memory line shown at the top of the screen
+--| TYPE: uint32_t
+*/
+static uint32_t top_line;
+
+/*
+--| NAME: is_screen_full
+--| DESCRIPTION: true once every line has been written, new lines scroll
+--| TYPE: uint32_t
+*/
+static uint32_t is_screen_full;
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE HELPER FUNCTION PROTOTYPES
+--|----------------------------------------------------------------------------|
+*/
+
+/*------------------------------------------------------------------------------
+Function Name:
+    Console_New_Line
+
+Function Description:
+    Move the cursor to the start of the next line. When the screen is full,
+    clear the oldest line and scroll it to the bottom to be the next line.
+
+Parameters:
+    None
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+void Console_New_Line(void);
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC FUNCTION DEFINITIONS
+--|----------------------------------------------------------------------------|
+*/
+
+void BSP_ILI9341_Console_Init(uint16_t color, uint16_t background)
+{
+    text_color = color;
+    background_color = background;
+
+    cursor_column = 0u;
+    cursor_line = 0u;
+    top_line = 0u;
+    is_screen_full = 0u;
+
+    BSP_ILI9341_Scroll_Define(0u, BSP_ILI9341_TFTHEIGHT, 0u);
+    BSP_ILI9341_Scroll_To(0u);
+
+    BSP_ILI9341_Draw_Filled_Rectangle(0u, 0u, BSP_ILI9341_TFTWIDTH, BSP_ILI9341_TFTHEIGHT, background_color);
+}
+
+void BSP_ILI9341_Console_Put_Char(char c)
+{
+    if (c == '\n')
+    {
+        Console_New_Line();
+    }
+    else if (c == '\r')
+    {
+        cursor_column = 0u;
+    }
+    else
+    {
+        // wrap only once there is a character for the next line, so a full line and a '\n'
+        // don't leave an empty line
+        if (cursor_column == CONSOLE_NUM_COLUMNS)
+        {
+            Console_New_Line();
+        }
+
+        BSP_ILI9341_Draw_Char(cursor_column * CONSOLE_CHAR_WIDTH,
+                              cursor_line * CONSOLE_CHAR_HEIGHT,
+                              c,
+                              &CONSOLE_FONT,
+                              text_color,
+                              background_color);
+
+        cursor_column++;
+    }
+}
+
+void BSP_ILI9341_Console_Write(const char * p_string)
+{
+    for (uint32_t i = 0u; p_string[i] != '\0'; i++)
+    {
+        BSP_ILI9341_Console_Put_Char(p_string[i]);
+    }
+}
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE HELPER FUNCTION DEFINITIONS
+--|----------------------------------------------------------------------------|
+*/
+
+void Console_New_Line(void)
+{
+    cursor_column = 0u;
+
+    if (!is_screen_full && (cursor_line + 1u < CONSOLE_NUM_LINES))
+    {
+        cursor_line++;
+    }
+    else
+    {
+        is_screen_full = 1u;
+
+        // the oldest line is at the top of the screen, reuse it as the new bottom line
+        cursor_line = top_line;
+        top_line = (top_line + 1u) % CONSOLE_NUM_LINES;
+
+        BSP_ILI9341_Draw_Filled_Rectangle(0u,
+                                          cursor_line * CONSOLE_CHAR_HEIGHT,
+                                          BSP_ILI9341_TFTWIDTH,
+                                          CONSOLE_CHAR_HEIGHT,
+                                          background_color);
+
+        BSP_ILI9341_Scroll_To(top_line * CONSOLE_CHAR_HEIGHT);
+    }
+}
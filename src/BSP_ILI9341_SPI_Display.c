@@ -86,7 +86,44 @@
 #define ILI9341_DC_PIN_WRITE_COMMAND 0u
 #define ILI9341_DC_PIN_WRITE_DATA    1u
 
-#define FIFO_SEND_LIMIT 16u
+/*
+--| NAME: MAX_DIRTY_RECTS
+--| DESCRIPTION: the most dirty rectangles tracked between flushes
+--| TYPE: uint32_t
+*/
+#define MAX_DIRTY_RECTS (8u)
+
+/*
+--| NAME: BYTES_PER_PIXEL
+--| DESCRIPTION: 16 bit 5-6-5 color
+--| TYPE: uint32_t
+*/
+#define BYTES_PER_PIXEL (2u)
+
+/*
+--| NAME: SWAP_BYTES_16
+--| DESCRIPTION: puts the high byte of a color first in memory, the order the
+--|   display wants it
+--| TYPE: uint16_t
+*/
+#define SWAP_BYTES_16(val) ((uint16_t)(((val) >> 8u) | ((val) << 8u)))
+
+/*
+--| NAME: MAX_GLYPH_WIDTH, MAX_GLYPH_HEIGHT, MAX_GLYPH_PIXELS
+--| DESCRIPTION: the biggest glyph that can be drawn
+--| TYPE: uint32_t
+*/
+#define MAX_GLYPH_WIDTH  (8u)
+#define MAX_GLYPH_HEIGHT (16u)
+#define MAX_GLYPH_PIXELS (MAX_GLYPH_WIDTH * MAX_GLYPH_HEIGHT)
+
+/*
+--| NAME: GLYPH_CACHE_SIZE
+--| DESCRIPTION: the number of expanded glyphs kept, a power of 2 so a
+--|   character code picks its entry with a mask
+--| TYPE: uint32_t
+*/
+#define GLYPH_CACHE_SIZE (32u)
 
 /*
 --|----------------------------------------------------------------------------|
@@ -94,7 +131,37 @@
 --|----------------------------------------------------------------------------|
 */
 
-/* None */
+/*
+--| NAME: ILI9341_Rect_t
+--| DESCRIPTION: a rectangle given by its inclusive corners
+*/
+typedef struct ILI9341_Rect_Type
+{
+    uint16_t x0; // left
+    uint16_t y0; // top
+    uint16_t x1; // right
+    uint16_t y1; // bottom
+} ILI9341_Rect_t;
+
+/*
+--| NAME: ILI9341_Glyph_t
+--| DESCRIPTION: a glyph expanded to pixels in given colors
+*/
+typedef struct ILI9341_Glyph_Type
+{
+    const BSP_Font_t * p_font;         // 0 when the entry is empty
+    uint16_t color;                    // the colors the glyph was expanded in
+    uint16_t background;
+    char c;                            // the character
+    uint16_t pixels[MAX_GLYPH_PIXELS]; // font width pixels per row, in the display's byte order
+} ILI9341_Glyph_t;
+
+/*
+--| NAME: ILI9341_Run_Handler_t
+--| DESCRIPTION: something to do with each run of a line, given by its
+--|   inclusive corners
+*/
+typedef void (*ILI9341_Run_Handler_t)(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint16_t color);
 
 /*
 --|----------------------------------------------------------------------------|
@@ -112,6 +179,45 @@
 
 static uint32_t DC_PIN;
 
+/*
+--| NAME: p_framebuffer
+--| DESCRIPTION: the framebuffer being drawn to, 0 when drawing to the display
+--| TYPE: uint16_t *
+*/
+static uint16_t * p_framebuffer = 0;
+
+/*
+--| NAME: dirty_rects, num_dirty_rects
+--| DESCRIPTION: the areas of the framebuffer drawn to since the last flush
+--| TYPE: ILI9341_Rect_t[], uint32_t
+*/
+static ILI9341_Rect_t dirty_rects[MAX_DIRTY_RECTS];
+static uint32_t num_dirty_rects = 0u;
+
+/*
+--| NAME: glyph_cache
+--| DESCRIPTION: recently drawn glyphs, indexed by character code
+--| TYPE: ILI9341_Glyph_t[]
+*/
+static ILI9341_Glyph_t glyph_cache[GLYPH_CACHE_SIZE];
+
+/*
+--| NAME: string_pixels
+--| DESCRIPTION: where a string is laid out before it is sent, one screen
+--|   width of the tallest font
+--| TYPE: uint16_t[]
+*/
+static uint16_t string_pixels[BSP_ILI9341_TFTWIDTH * MAX_GLYPH_HEIGHT];
+
+/*
+--| NAME: span_lefts, span_rights
+--| DESCRIPTION: the furthest left and right the edges of a convex polygon
+--|   reach on each row of the screen
+--| TYPE: int32_t[]
+*/
+static int32_t span_lefts[BSP_ILI9341_TFTHEIGHT];
+static int32_t span_rights[BSP_ILI9341_TFTHEIGHT];
+
 /*
 --|----------------------------------------------------------------------------|
 --| PRIVATE HELPER FUNCTION PROTOTYPES
@@ -198,6 +304,311 @@ Assumptions/Limitations:
 ------------------------------------------------------------------------------*/
 void BSP_ILI9341_Send_Pixel_Data(uint16_t x, uint16_t y, uint16_t color);
 
+/*------------------------------------------------------------------------------
+Function Name:
+    ILI9341_Framebuffer_Fill
+
+Function Description:
+    Fill a rectangle of the framebuffer with a color and mark it dirty. The 
+    rectangle is clipped to the screen.
+
+Parameters:
+    x, y: the upper left coordinates of the rectangle.
+    width, height: the size of the rectangle in pixels.
+    color: the 16 bit 5-6-5 color to fill with.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    Assumes framebuffer mode is enabled.
+------------------------------------------------------------------------------*/
+void ILI9341_Framebuffer_Fill(uint32_t x, 
+                              uint32_t y, 
+                              uint32_t width, 
+                              uint32_t height, 
+                              uint16_t color);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    ILI9341_Framebuffer_Copy
+
+Function Description:
+    Copy a block of pixels into the framebuffer and mark it dirty. The block
+    is clipped to the screen.
+
+Parameters:
+    x, y: the upper left coordinates of the block.
+    width, height: the size of the block in pixels.
+    p_pixels: width * height pixels, row by row, already in the display's
+    byte order.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    Assumes framebuffer mode is enabled.
+------------------------------------------------------------------------------*/
+void ILI9341_Framebuffer_Copy(uint32_t x, 
+                              uint32_t y, 
+                              uint32_t width, 
+                              uint32_t height, 
+                              const uint16_t * p_pixels);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    ILI9341_Get_Glyph_Pixels
+
+Function Description:
+    Get the pixels of a glyph in the given colors, from the glyph cache if
+    it is there, else expanded from the font into the cache.
+
+Parameters:
+    p_font: the font.
+    c: the character.
+    color: the 16 bit 5-6-5 color for the character.
+    background: the 16 bit 5-6-5 color for the rest of the character cell.
+
+Returns:
+    const uint16_t *: the font's width * height pixels, row by row, in the
+    display's byte order. Good until the next call.
+
+Assumptions/Limitations:
+    Assumes the font fits in MAX_GLYPH_WIDTH by MAX_GLYPH_HEIGHT.
+------------------------------------------------------------------------------*/
+const uint16_t * ILI9341_Get_Glyph_Pixels(const BSP_Font_t * p_font, 
+                                          char c, 
+                                          uint16_t color, 
+                                          uint16_t background);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    ILI9341_Fill_Clipped
+
+Function Description:
+    Fill a rectangle given by its inclusive corners, cut off at the edges of
+    the screen. Used for the spans of the shapes, which can go off the screen
+    on any side.
+
+Parameters:
+    x0, y0: the upper left corner.
+    x1, y1: the lower right corner.
+    color: the 16 bit 5-6-5 color to fill with.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+void ILI9341_Fill_Clipped(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint16_t color);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    ILI9341_Walk_Line_Runs
+
+Function Description:
+    Walk a line with Bresenham's algorithm and hand it over a run at a time. 
+    Along the major axis the minor coordinate steps at most once per pixel,
+    so each row of a flat line (or column of a steep one) is a single run.
+
+Parameters:
+    x0, y0: where the line starts.
+    x1, y1: where the line ends.
+    is_end_drawn: true to include the end point, false to stop one pixel 
+    short of it so joined lines don't draw their shared points twice.
+    color: the 16 bit 5-6-5 color for the line.
+    run_handler: called with each run, ILI9341_Fill_Clipped to draw it.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+void ILI9341_Walk_Line_Runs(int32_t x0, 
+                            int32_t y0, 
+                            int32_t x1, 
+                            int32_t y1, 
+                            uint32_t is_end_drawn, 
+                            uint16_t color,
+                            ILI9341_Run_Handler_t run_handler);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    ILI9341_Add_Span_Run
+
+Function Description:
+    Widen the spans of the rows a run of a polygon edge covers, so they 
+    reach the run. A run handler for ILI9341_Walk_Line_Runs.
+
+Parameters:
+    x0, y0: the top left of the run.
+    x1, y1: the bottom right of the run.
+    color: unused.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    Rows off the screen are skipped.
+------------------------------------------------------------------------------*/
+void ILI9341_Add_Span_Run(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint16_t color);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    ILI9341_Draw_Round_Shape
+
+Function Description:
+    Draw a rectangle with rounded corners, given by the centers of its corner
+    arcs. A circle is the case where all four centers are the same point.
+
+    The midpoint circle walk gives the arc as runs of pixels that share a row
+    (or, past 45 degrees, a column). Each run is drawn as one span on all 
+    four corners at once.
+
+Parameters:
+    left, top, right, bottom: the centers of the corner arcs.
+    r: the radius of the corners.
+    is_filled: true to fill the shape, false for the outline.
+    color: the 16 bit 5-6-5 color for the shape.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    Assumes left <= right and top <= bottom.
+------------------------------------------------------------------------------*/
+void ILI9341_Draw_Round_Shape(int32_t left, 
+                              int32_t top, 
+                              int32_t right, 
+                              int32_t bottom, 
+                              int32_t r, 
+                              uint32_t is_filled, 
+                              uint16_t color);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    ILI9341_Fill_Convex
+
+Function Description:
+    Fill a convex polygon one row at a time. The edges are walked as lines,
+    and each row is filled from the furthest left pixel of an edge on that
+    row to the furthest right.
+
+Parameters:
+    p_x, p_y: the corners, in order around the polygon.
+    num_points: the number of corners.
+    color: the 16 bit 5-6-5 color to fill with.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    The polygon must be convex. The fill covers the outline drawn with 
+    BSP_ILI9341_Draw_Line through the corners in the same order.
+------------------------------------------------------------------------------*/
+void ILI9341_Fill_Convex(const int32_t * p_x, 
+                         const int32_t * p_y, 
+                         uint32_t num_points, 
+                         uint16_t color);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    ILI9341_Divide_Rounded
+
+Function Description:
+    Divide, rounding to the nearest whole number.
+
+Parameters:
+    numerator: the number to divide.
+    denominator: the number to divide by.
+
+Returns:
+    int32_t: the rounded result.
+
+Assumptions/Limitations:
+    The denominator must be more than 0.
+------------------------------------------------------------------------------*/
+int32_t ILI9341_Divide_Rounded(int32_t numerator, int32_t denominator);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    ILI9341_Square_Root
+
+Function Description:
+    Integer square root, one result bit at a time.
+
+Parameters:
+    val: the number.
+
+Returns:
+    uint32_t: the square root, rounded down.
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+uint32_t ILI9341_Square_Root(uint32_t val);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    ILI9341_Mark_Dirty
+
+Function Description:
+    Add a rectangle to the dirty list, merging it with any dirty rectangles it
+    overlaps. If the list is full the rectangle is merged with whichever dirty
+    rectangle grows the least.
+
+Parameters:
+    p_rect: the rectangle to add.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    Assumes the rectangle is already clipped to the screen.
+------------------------------------------------------------------------------*/
+void ILI9341_Mark_Dirty(const ILI9341_Rect_t * p_rect);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    ILI9341_Rect_Area
+
+Function Description:
+    Get the area of a rectangle.
+
+Parameters:
+    p_rect: the rectangle.
+
+Returns:
+    uint32_t: the area in pixels.
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+uint32_t ILI9341_Rect_Area(const ILI9341_Rect_t * p_rect);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    ILI9341_Rect_Union
+
+Function Description:
+    Get the smallest rectangle that covers two rectangles.
+
+Parameters:
+    p_a, p_b: the rectangles to cover.
+    p_union: where to put the result.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+void ILI9341_Rect_Union(const ILI9341_Rect_t * p_a, 
+                        const ILI9341_Rect_t * p_b, 
+                        ILI9341_Rect_t * p_union);
+
 /*
 --|----------------------------------------------------------------------------|
 --| PUBLIC FUNCTION DEFINITIONS
@@ -346,6 +757,12 @@ void BSP_ILI9341_Set_Window(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1)
 
 void BSP_ILI9341_Draw_Pixel(uint32_t x, uint32_t y, uint16_t color)
 {
+    if (p_framebuffer)
+    {
+        ILI9341_Framebuffer_Fill(x, y, 1u, 1u, color);
+        return;
+    }
+
     PSP_SPI0_Begin_Transfer();
     BSP_ILI9341_Send_Pixel_Data(x, y, color);
     PSP_SPI0_End_Transfer();
@@ -356,21 +773,17 @@ void BSP_ILI9341_Draw_Horizontal_Line(uint32_t x,
                                       uint32_t length, 
                                       uint16_t color)
 {
+    if (p_framebuffer)
+    {
+        ILI9341_Framebuffer_Fill(x, y, length, 1u, color);
+        return;
+    }
+
     PSP_SPI0_Begin_Transfer();
 
     BSP_ILI9341_Send_Address(x, y, x + length - 1u, y);
 
-    for (int i = 0u; i < length; i++)
-    {
-        PSP_SPI0_Send_16(color);
-
-        // break up the transfer if it gets long
-        if (i % FIFO_SEND_LIMIT == 0u)
-        {
-            PSP_SPI0_End_Transfer();
-            PSP_SPI0_Begin_Transfer();
-        }
-    }
+    PSP_SPI0_Send_16_Repeated(color, length);
 
     PSP_SPI0_End_Transfer();
 }
@@ -380,21 +793,17 @@ void BSP_ILI9341_Draw_Vertical_Line(uint32_t x,
                                     uint32_t height, 
                                     uint16_t color)
 {
+    if (p_framebuffer)
+    {
+        ILI9341_Framebuffer_Fill(x, y, 1u, height, color);
+        return;
+    }
+
     PSP_SPI0_Begin_Transfer();
 
     BSP_ILI9341_Send_Address(x, y, x, y + height - 1u);
 
-    for (int i = 0u; i < height; i++)
-    {
-        PSP_SPI0_Send_16(color);
-
-        // break up the transfer if it gets long
-        if (i % FIFO_SEND_LIMIT == 0u)
-        {
-            PSP_SPI0_End_Transfer();
-            PSP_SPI0_Begin_Transfer();
-        }
-    }
+    PSP_SPI0_Send_16_Repeated(color, height);
 
     PSP_SPI0_End_Transfer();
 }
@@ -405,25 +814,52 @@ void BSP_ILI9341_Draw_Filled_Rectangle(uint32_t x,
                                        uint32_t height, 
                                        uint16_t color)
 {
+    if (p_framebuffer)
+    {
+        ILI9341_Framebuffer_Fill(x, y, width, height, color);
+        return;
+    }
+
     PSP_SPI0_Begin_Transfer();
 
     BSP_ILI9341_Send_Address(x, y, x + width - 1u, y + height - 1u);
 
-    const uint32_t num_pixels = width * height;
+    // one transfer for the whole rectangle, the FIFO stays topped up until the last pixel
+    PSP_SPI0_Send_16_Repeated(color, width * height);
 
-    for (uint32_t i = 0u; i < num_pixels; i++)
-    {
-        PSP_SPI0_Send_16(color);
+    PSP_SPI0_End_Transfer();
+}
 
-        // break up the transfer if it gets long
-        if (i % FIFO_SEND_LIMIT == 0u)
-        {
-            PSP_SPI0_End_Transfer();
-            PSP_SPI0_Begin_Transfer();
-        }
+void BSP_ILI9341_Draw_Line(uint32_t x0, 
+                           uint32_t y0, 
+                           uint32_t x1, 
+                           uint32_t y1, 
+                           uint16_t color)
+{
+    ILI9341_Walk_Line_Runs(x0, y0, x1, y1, 1u, color, ILI9341_Fill_Clipped);
+}
+
+void BSP_ILI9341_Draw_Polyline(const uint32_t * p_x, 
+                               const uint32_t * p_y, 
+                               uint32_t num_points, 
+                               uint16_t color)
+{
+    if (num_points == 1u)
+    {
+        ILI9341_Walk_Line_Runs(p_x[0], p_y[0], p_x[0], p_y[0], 1u, color, ILI9341_Fill_Clipped);
     }
 
-    PSP_SPI0_End_Transfer();
+    for (uint32_t i = 1u; i < num_points; i++)
+    {
+        // each line stops short of the next one's start, the last one draws its end
+        ILI9341_Walk_Line_Runs(p_x[i - 1u], 
+                               p_y[i - 1u], 
+                               p_x[i], 
+                               p_y[i], 
+                               i == num_points - 1u, 
+                               color, 
+                               ILI9341_Fill_Clipped);
+    }
 }
 
 void BSP_ILI9341_Draw_Rectangle_Outline(uint32_t x, 
@@ -444,38 +880,320 @@ void BSP_ILI9341_Draw_Circle_Outline(uint32_t x,
                                      uint32_t r, 
                                      uint16_t color)
 {
-    int16_t f = 1 - r;
-    int16_t ddF_x = 1;
-    int16_t ddF_y = -2 * r;
-    int16_t x_ = 0;
-    int16_t y_ = r;
-
-    BSP_ILI9341_Draw_Pixel(x    , y + r, color);
-    BSP_ILI9341_Draw_Pixel(x    , y - r, color);
-    BSP_ILI9341_Draw_Pixel(x + r, y    , color);
-    BSP_ILI9341_Draw_Pixel(x - r, y    , color);
+    ILI9341_Draw_Round_Shape(x, y, x, y, r, 0u, color);
+}
 
-    while (x_ < y_) 
-    {
-        if (f >= 0) 
-        {
-            y_--;
-            ddF_y += 2;
-            f += ddF_y;
+void BSP_ILI9341_Draw_Filled_Circle(uint32_t x, 
+                                    uint32_t y, 
+                                    uint32_t r, 
+                                    uint16_t color)
+{
+    ILI9341_Draw_Round_Shape(x, y, x, y, r, 1u, color);
+}
+
+void BSP_ILI9341_Draw_Rounded_Rectangle_Outline(uint32_t x, 
+                                                uint32_t y, 
+                                                uint32_t width, 
+                                                uint32_t height, 
+                                                uint32_t r, 
+                                                uint16_t color)
+{
+    if ((width > 0u) && (height > 0u))
+    {
+        const uint32_t max_r = (((width < height) ? width : height) - 1u) / 2u;
+
+        if (r > max_r)
+        {
+            r = max_r;
         }
 
-        x_++;
-        ddF_x += 2;
-        f += ddF_x;
+        ILI9341_Draw_Round_Shape(x + r, y + r, x + width - 1u - r, y + height - 1u - r, r, 0u, color);
+    }
+    else
+    {
+        /* ... do nothing */
+    }
+}
+
+void BSP_ILI9341_Draw_Filled_Rounded_Rectangle(uint32_t x, 
+                                               uint32_t y, 
+                                               uint32_t width, 
+                                               uint32_t height, 
+                                               uint32_t r, 
+                                               uint16_t color)
+{
+    if ((width > 0u) && (height > 0u))
+    {
+        const uint32_t max_r = (((width < height) ? width : height) - 1u) / 2u;
 
-        BSP_ILI9341_Draw_Pixel(x + x_, y + y_, color);
-        BSP_ILI9341_Draw_Pixel(x - x_, y + y_, color);
-        BSP_ILI9341_Draw_Pixel(x + x_, y - y_, color);
-        BSP_ILI9341_Draw_Pixel(x - x_, y - y_, color);
-        BSP_ILI9341_Draw_Pixel(x + y_, y + x_, color);
-        BSP_ILI9341_Draw_Pixel(x - y_, y + x_, color);
-        BSP_ILI9341_Draw_Pixel(x + y_, y - x_, color);
-        BSP_ILI9341_Draw_Pixel(x - y_, y - x_, color);
+        if (r > max_r)
+        {
+            r = max_r;
+        }
+
+        ILI9341_Draw_Round_Shape(x + r, y + r, x + width - 1u - r, y + height - 1u - r, r, 1u, color);
+    }
+    else
+    {
+        /* ... do nothing */
+    }
+}
+
+void BSP_ILI9341_Draw_Filled_Triangle(uint32_t x0, 
+                                      uint32_t y0, 
+                                      uint32_t x1, 
+                                      uint32_t y1, 
+                                      uint32_t x2, 
+                                      uint32_t y2, 
+                                      uint16_t color)
+{
+    const int32_t xs[3u] = { x0, x1, x2 };
+    const int32_t ys[3u] = { y0, y1, y2 };
+
+    ILI9341_Fill_Convex(xs, ys, 3u, color);
+}
+
+void BSP_ILI9341_Draw_Thick_Line(uint32_t x0, 
+                                 uint32_t y0, 
+                                 uint32_t x1, 
+                                 uint32_t y1, 
+                                 uint32_t thickness, 
+                                 uint16_t color)
+{
+    // a line one pixel thick is just the line
+    if (thickness < 2u)
+    {
+        BSP_ILI9341_Draw_Line(x0, y0, x1, y1, color);
+        return;
+    }
+
+    const int32_t dx = (int32_t)x1 - (int32_t)x0;
+    const int32_t dy = (int32_t)y1 - (int32_t)y0;
+    const int32_t length = ILI9341_Square_Root(dx * dx + dy * dy);
+
+    // pixel centers from -side_a to +side_b across the line, thickness pixels in all
+    const int32_t side_a = (thickness - 1u) / 2u;
+    const int32_t side_b = (thickness - 1u) - side_a;
+
+    if (length == 0)
+    {
+        ILI9341_Fill_Clipped(x0 - side_a, y0 - side_a, x0 + side_b, y0 + side_b, color);
+        return;
+    }
+
+    // offsets of the two sides, along the unit vector (-dy, dx) / length across the line
+    const int32_t ax = ILI9341_Divide_Rounded(-dy * side_a, length);
+    const int32_t ay = ILI9341_Divide_Rounded(dx * side_a, length);
+    const int32_t bx = ILI9341_Divide_Rounded(-dy * side_b, length);
+    const int32_t by = ILI9341_Divide_Rounded(dx * side_b, length);
+
+    const int32_t xs[4u] = { x0 + ax, x1 + ax, x1 - bx, x0 - bx };
+    const int32_t ys[4u] = { y0 + ay, y1 + ay, y1 - by, y0 - by };
+
+    ILI9341_Fill_Convex(xs, ys, 4u, color);
+}
+
+void BSP_ILI9341_Draw_Char(uint32_t x, 
+                           uint32_t y, 
+                           char c, 
+                           const BSP_Font_t * p_font, 
+                           uint16_t color, 
+                           uint16_t background)
+{
+    const char string[2u] = { c, '\0' };
+
+    (void)BSP_ILI9341_Draw_String(x, y, string, p_font, color, background);
+}
+
+uint32_t BSP_ILI9341_Draw_String(uint32_t x, 
+                                 uint32_t y, 
+                                 const char * p_string, 
+                                 const BSP_Font_t * p_font, 
+                                 uint16_t color, 
+                                 uint16_t background)
+{
+    if ((p_font->width > MAX_GLYPH_WIDTH) || (p_font->height > MAX_GLYPH_HEIGHT))
+    {
+        return 0u;
+    }
+
+    if ((x >= BSP_ILI9341_TFTWIDTH) || (y >= BSP_ILI9341_TFTHEIGHT))
+    {
+        return 0u;
+    }
+
+    uint32_t width = BSP_Font_Get_String_Width(p_font, p_string);
+
+    if (width > BSP_ILI9341_TFTWIDTH - x)
+    {
+        width = BSP_ILI9341_TFTWIDTH - x;
+    }
+
+    if (width == 0u)
+    {
+        return 0u;
+    }
+
+    // lay the glyphs out side by side, the block is width pixels across
+    uint32_t column = 0u;
+
+    for (uint32_t i = 0u; (p_string[i] != '\0') && (column < width); i++)
+    {
+        const uint16_t * p_glyph = ILI9341_Get_Glyph_Pixels(p_font, p_string[i], color, background);
+        uint32_t glyph_width = BSP_Font_Get_Char_Width(p_font, p_string[i]);
+
+        if (glyph_width > width - column)
+        {
+            glyph_width = width - column;
+        }
+
+        for (uint32_t row = 0u; row < p_font->height; row++)
+        {
+            const uint16_t * p_src = &p_glyph[row * p_font->width];
+            uint16_t * p_dst = &string_pixels[row * width + column];
+
+            for (uint32_t j = 0u; j < glyph_width; j++)
+            {
+                p_dst[j] = p_src[j];
+            }
+        }
+
+        column += glyph_width;
+    }
+
+    if (p_framebuffer)
+    {
+        ILI9341_Framebuffer_Copy(x, y, width, p_font->height, string_pixels);
+        return width;
+    }
+
+    uint32_t height = p_font->height;
+
+    if (height > BSP_ILI9341_TFTHEIGHT - y)
+    {
+        height = BSP_ILI9341_TFTHEIGHT - y;
+    }
+
+    // the rows are back to back in the block, so the whole string is one burst
+    PSP_SPI0_Begin_Transfer();
+
+    BSP_ILI9341_Send_Address(x, y, x + width - 1u, y + height - 1u);
+    PSP_SPI0_Send_Buffer((const uint8_t *)string_pixels, width * height * BYTES_PER_PIXEL);
+
+    PSP_SPI0_End_Transfer();
+
+    return width;
+}
+
+uint32_t BSP_ILI9341_Scroll_Define(uint32_t top_fixed, uint32_t scroll_height, uint32_t bottom_fixed)
+{
+    uint32_t retval = 0u;
+
+    if (top_fixed + scroll_height + bottom_fixed == BSP_ILI9341_TFTHEIGHT)
+    {
+        // the polled command can't share SPI 0 with a running flush
+        if (p_framebuffer)
+        {
+            PSP_SPI0_DMA_Wait();
+        }
+
+        PSP_SPI0_Begin_Transfer();
+        ILI9341_Send_Command(BSP_ILI9341_VSCRDEF);
+        PSP_SPI0_Send_16(top_fixed);
+        PSP_SPI0_Send_16(scroll_height);
+        PSP_SPI0_Send_16(bottom_fixed);
+        PSP_SPI0_End_Transfer();
+
+        retval = 1u;
+    }
+
+    return retval;
+}
+
+void BSP_ILI9341_Scroll_To(uint32_t line)
+{
+    if (line < BSP_ILI9341_TFTHEIGHT)
+    {
+        if (p_framebuffer)
+        {
+            PSP_SPI0_DMA_Wait();
+        }
+
+        PSP_SPI0_Begin_Transfer();
+        ILI9341_Send_Command(BSP_ILI9341_VSCRSADD);
+        PSP_SPI0_Send_16(line);
+        PSP_SPI0_End_Transfer();
+    }
+}
+
+uint32_t BSP_ILI9341_Framebuffer_Enable(uint16_t * p_new_framebuffer)
+{
+    uint32_t retval = 0u;
+
+    // the flush DMA moves whole words of the framebuffer
+    if (!((uint32_t)p_new_framebuffer & 3u) && PSP_SPI0_DMA_Init())
+    {
+        p_framebuffer = p_new_framebuffer;
+        num_dirty_rects = 0u;
+
+        // start from a known state, the whole screen gets sent on the first flush
+        ILI9341_Framebuffer_Fill(0u, 0u, BSP_ILI9341_TFTWIDTH, BSP_ILI9341_TFTHEIGHT, BSP_ILI9341_BLACK);
+
+        retval = 1u;
+    }
+
+    return retval;
+}
+
+void BSP_ILI9341_Framebuffer_Disable(void)
+{
+    // the polled draw calls can't share SPI 0 with a running flush
+    PSP_SPI0_DMA_Wait();
+
+    p_framebuffer = 0;
+    num_dirty_rects = 0u;
+}
+
+void BSP_ILI9341_Flush(void)
+{
+    if (p_framebuffer)
+    {
+        for (uint32_t i = 0u; i < num_dirty_rects; i++)
+        {
+            const ILI9341_Rect_t * p_rect = &dirty_rects[i];
+
+            // widen to whole pairs of pixels, so every row is whole words for the DMA
+            const uint32_t x0 = p_rect->x0 & ~1u;
+            const uint32_t x1 = p_rect->x1 | 1u;
+
+            const uint32_t width  = x1 - x0 + 1u;
+            const uint32_t height = p_rect->y1 - p_rect->y0 + 1u;
+
+            // the address goes out polled, so the previous rectangle has to be done first
+            PSP_SPI0_DMA_Wait();
+
+            PSP_SPI0_Begin_Transfer();
+            BSP_ILI9341_Send_Address(x0, p_rect->y0, x1, p_rect->y1);
+            PSP_SPI0_End_Transfer();
+
+            uint16_t * p_first_pixel = &p_framebuffer[p_rect->y0 * BSP_ILI9341_TFTWIDTH + x0];
+
+            if (width == BSP_ILI9341_TFTWIDTH)
+            {
+                // full width rows are back to back in the framebuffer, send them all at once
+                PSP_SPI0_DMA_Transfer((uint8_t *)p_first_pixel, 0, width * height * BYTES_PER_PIXEL);
+            }
+            else
+            {
+                // the display keeps filling the window, one chain of row blocks sends the lot
+                PSP_SPI0_DMA_Transfer_Rows((uint8_t *)p_first_pixel,
+                                           width * BYTES_PER_PIXEL,
+                                           BSP_ILI9341_TFTWIDTH * BYTES_PER_PIXEL,
+                                           height);
+            }
+        }
+
+        num_dirty_rects = 0u;
     }
 }
 
@@ -520,3 +1238,501 @@ void BSP_ILI9341_Send_Pixel_Data(uint16_t x, uint16_t y, uint16_t color)
     BSP_ILI9341_Send_Address(x, y, x, y);
     PSP_SPI0_Send_16(color);
 }
+
+void ILI9341_Framebuffer_Fill(uint32_t x, 
+                              uint32_t y, 
+                              uint32_t width, 
+                              uint32_t height, 
+                              uint16_t color)
+{
+    // clip to the screen, coordinates that went negative wrap around and get clipped too
+    if ((x >= BSP_ILI9341_TFTWIDTH) || (y >= BSP_ILI9341_TFTHEIGHT))
+    {
+        return;
+    }
+
+    if (width > BSP_ILI9341_TFTWIDTH - x)
+    {
+        width = BSP_ILI9341_TFTWIDTH - x;
+    }
+
+    if (height > BSP_ILI9341_TFTHEIGHT - y)
+    {
+        height = BSP_ILI9341_TFTHEIGHT - y;
+    }
+
+    if ((width == 0u) || (height == 0u))
+    {
+        return;
+    }
+
+    const uint16_t swapped_color = SWAP_BYTES_16(color);
+
+    for (uint32_t row = y; row < y + height; row++)
+    {
+        uint16_t * p_pixel = &p_framebuffer[row * BSP_ILI9341_TFTWIDTH + x];
+
+        for (uint32_t i = 0u; i < width; i++)
+        {
+            p_pixel[i] = swapped_color;
+        }
+    }
+
+    const ILI9341_Rect_t rect = { x, y, x + width - 1u, y + height - 1u };
+
+    ILI9341_Mark_Dirty(&rect);
+}
+
+void ILI9341_Framebuffer_Copy(uint32_t x, 
+                              uint32_t y, 
+                              uint32_t width, 
+                              uint32_t height, 
+                              const uint16_t * p_pixels)
+{
+    if ((x >= BSP_ILI9341_TFTWIDTH) || (y >= BSP_ILI9341_TFTHEIGHT))
+    {
+        return;
+    }
+
+    // the source rows keep their full width when the block is clipped
+    const uint32_t stride = width;
+
+    if (width > BSP_ILI9341_TFTWIDTH - x)
+    {
+        width = BSP_ILI9341_TFTWIDTH - x;
+    }
+
+    if (height > BSP_ILI9341_TFTHEIGHT - y)
+    {
+        height = BSP_ILI9341_TFTHEIGHT - y;
+    }
+
+    if ((width == 0u) || (height == 0u))
+    {
+        return;
+    }
+
+    for (uint32_t row = 0u; row < height; row++)
+    {
+        uint16_t * p_pixel = &p_framebuffer[(y + row) * BSP_ILI9341_TFTWIDTH + x];
+
+        for (uint32_t i = 0u; i < width; i++)
+        {
+            p_pixel[i] = p_pixels[row * stride + i];
+        }
+    }
+
+    const ILI9341_Rect_t rect = { x, y, x + width - 1u, y + height - 1u };
+
+    ILI9341_Mark_Dirty(&rect);
+}
+
+const uint16_t * ILI9341_Get_Glyph_Pixels(const BSP_Font_t * p_font, 
+                                          char c, 
+                                          uint16_t color, 
+                                          uint16_t background)
+{
+    ILI9341_Glyph_t * p_entry = &glyph_cache[(uint8_t)c & (GLYPH_CACHE_SIZE - 1u)];
+
+    if ((p_entry->p_font != p_font) || 
+        (p_entry->c != c) || 
+        (p_entry->color != color) || 
+        (p_entry->background != background))
+    {
+        const uint8_t * p_bits = BSP_Font_Get_Glyph(p_font, c);
+        const uint16_t swapped_color = SWAP_BYTES_16(color);
+        const uint16_t swapped_background = SWAP_BYTES_16(background);
+
+        for (uint32_t row = 0u; row < p_font->height; row++)
+        {
+            for (uint32_t column = 0u; column < p_font->width; column++)
+            {
+                p_entry->pixels[row * p_font->width + column] = (p_bits[row] & (0x80u >> column)) ? swapped_color : swapped_background;
+            }
+        }
+
+        p_entry->p_font = p_font;
+        p_entry->c = c;
+        p_entry->color = color;
+        p_entry->background = background;
+    }
+
+    return p_entry->pixels;
+}
+
+void ILI9341_Fill_Clipped(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint16_t color)
+{
+    if (x0 < 0)
+    {
+        x0 = 0;
+    }
+
+    if (y0 < 0)
+    {
+        y0 = 0;
+    }
+
+    if (x1 > (int32_t)BSP_ILI9341_TFTWIDTH - 1)
+    {
+        x1 = (int32_t)BSP_ILI9341_TFTWIDTH - 1;
+    }
+
+    if (y1 > (int32_t)BSP_ILI9341_TFTHEIGHT - 1)
+    {
+        y1 = (int32_t)BSP_ILI9341_TFTHEIGHT - 1;
+    }
+
+    if ((x0 <= x1) && (y0 <= y1))
+    {
+        BSP_ILI9341_Draw_Filled_Rectangle(x0, y0, x1 - x0 + 1, y1 - y0 + 1, color);
+    }
+    else
+    {
+        /* ... do nothing, all off the screen */
+    }
+}
+
+void ILI9341_Walk_Line_Runs(int32_t x0, 
+                            int32_t y0, 
+                            int32_t x1, 
+                            int32_t y1, 
+                            uint32_t is_end_drawn, 
+                            uint16_t color,
+                            ILI9341_Run_Handler_t run_handler)
+{
+    const int32_t dx = (x1 > x0) ? (x1 - x0) : (x0 - x1);
+    const int32_t dy = (y1 > y0) ? (y1 - y0) : (y0 - y1);
+    const int32_t sx = (x1 > x0) ? 1 : -1;
+    const int32_t sy = (y1 > y0) ? 1 : -1;
+
+    // walk the major axis, the minor one steps when the error runs out
+    const uint32_t is_flat = (dx >= dy);
+    const int32_t major = is_flat ? dx : dy;
+    const int32_t minor = is_flat ? dy : dx;
+    const int32_t num_pixels = major + (is_end_drawn ? 1 : 0);
+
+    int32_t err = major / 2;
+    int32_t x = x0;
+    int32_t y = y0;
+    int32_t run_x = x0;
+    int32_t run_y = y0;
+
+    for (int32_t i = 0; i < num_pixels; i++)
+    {
+        // the pixel at (x, y) is the end of the run so far
+        const int32_t end_x = x;
+        const int32_t end_y = y;
+        uint32_t is_minor_step = 0u;
+
+        err -= minor;
+
+        if (err < 0)
+        {
+            err += major;
+            is_minor_step = 1u;
+        }
+
+        if (is_flat)
+        {
+            x += sx;
+            y += is_minor_step ? sy : 0;
+        }
+        else
+        {
+            y += sy;
+            x += is_minor_step ? sx : 0;
+        }
+
+        if (is_minor_step || (i == num_pixels - 1))
+        {
+            run_handler((run_x < end_x) ? run_x : end_x, 
+                        (run_y < end_y) ? run_y : end_y, 
+                        (run_x < end_x) ? end_x : run_x, 
+                        (run_y < end_y) ? end_y : run_y, 
+                        color);
+
+            run_x = x;
+            run_y = y;
+        }
+    }
+}
+
+void ILI9341_Add_Span_Run(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint16_t color)
+{
+    (void)color;
+
+    const int32_t y_first = (y0 < 0) ? 0 : y0;
+    const int32_t y_last = (y1 > (int32_t)BSP_ILI9341_TFTHEIGHT - 1) ? (int32_t)BSP_ILI9341_TFTHEIGHT - 1 : y1;
+
+    for (int32_t y = y_first; y <= y_last; y++)
+    {
+        if (x0 < span_lefts[y])
+        {
+            span_lefts[y] = x0;
+        }
+
+        if (x1 > span_rights[y])
+        {
+            span_rights[y] = x1;
+        }
+    }
+}
+
+void ILI9341_Draw_Round_Shape(int32_t left, 
+                              int32_t top, 
+                              int32_t right, 
+                              int32_t bottom, 
+                              int32_t r, 
+                              uint32_t is_filled, 
+                              uint16_t color)
+{
+    if (is_filled)
+    {
+        // the band between the corner centers is all one rectangle
+        ILI9341_Fill_Clipped(left - r, top, right + r, bottom, color);
+    }
+
+    // midpoint circle walk of the arc from the top (0, r) round to 45 degrees
+    int32_t cx = 0;
+    int32_t cy = r;
+    int32_t d = 1 - r;
+    int32_t run_start = 0;
+
+    while (cx <= cy)
+    {
+        const int32_t run_cy = cy;
+
+        if (d < 0)
+        {
+            d += 2 * cx + 3;
+        }
+        else
+        {
+            d += 2 * (cx - cy) + 5;
+            cy--;
+        }
+
+        cx++;
+
+        // the run is done when the walk moves to the next row or reaches 45 degrees
+        if ((cy != run_cy) || (cx > cy))
+        {
+            // run_start..run_end across at run_cy away from the centers
+            const int32_t run_end = cx - 1;
+
+            if (is_filled)
+            {
+                // the row run_cy out has the run's far end as its edge
+                if (run_cy > 0)
+                {
+                    ILI9341_Fill_Clipped(left - run_end, top - run_cy, right + run_end, top - run_cy, color);
+                    ILI9341_Fill_Clipped(left - run_end, bottom + run_cy, right + run_end, bottom + run_cy, color);
+                }
+
+                // mirrored past 45 degrees, each row the run crosses has run_cy as its edge
+                for (int32_t k = (run_start > 0) ? run_start : 1; (k <= run_end) && (k < run_cy); k++)
+                {
+                    ILI9341_Fill_Clipped(left - run_cy, top - k, right + run_cy, top - k, color);
+                    ILI9341_Fill_Clipped(left - run_cy, bottom + k, right + run_cy, bottom + k, color);
+                }
+            }
+            else if (run_start == 0)
+            {
+                // the first run joins up across the straight sides
+                ILI9341_Fill_Clipped(left - run_end, top - run_cy, right + run_end, top - run_cy, color);
+                ILI9341_Fill_Clipped(left - run_end, bottom + run_cy, right + run_end, bottom + run_cy, color);
+                ILI9341_Fill_Clipped(left - run_cy, top - run_end, left - run_cy, bottom + run_end, color);
+                ILI9341_Fill_Clipped(right + run_cy, top - run_end, right + run_cy, bottom + run_end, color);
+            }
+            else
+            {
+                // a row run on each corner, and the mirrored column runs past 45 degrees
+                ILI9341_Fill_Clipped(left - run_end, top - run_cy, left - run_start, top - run_cy, color);
+                ILI9341_Fill_Clipped(right + run_start, top - run_cy, right + run_end, top - run_cy, color);
+                ILI9341_Fill_Clipped(left - run_end, bottom + run_cy, left - run_start, bottom + run_cy, color);
+                ILI9341_Fill_Clipped(right + run_start, bottom + run_cy, right + run_end, bottom + run_cy, color);
+
+                ILI9341_Fill_Clipped(left - run_cy, top - run_end, left - run_cy, top - run_start, color);
+                ILI9341_Fill_Clipped(right + run_cy, top - run_end, right + run_cy, top - run_start, color);
+                ILI9341_Fill_Clipped(left - run_cy, bottom + run_start, left - run_cy, bottom + run_end, color);
+                ILI9341_Fill_Clipped(right + run_cy, bottom + run_start, right + run_cy, bottom + run_end, color);
+            }
+
+            run_start = cx;
+        }
+    }
+}
+
+void ILI9341_Fill_Convex(const int32_t * p_x, 
+                         const int32_t * p_y, 
+                         uint32_t num_points, 
+                         uint16_t color)
+{
+    int32_t y_min = p_y[0];
+    int32_t y_max = p_y[0];
+
+    for (uint32_t i = 1u; i < num_points; i++)
+    {
+        if (p_y[i] < y_min)
+        {
+            y_min = p_y[i];
+        }
+
+        if (p_y[i] > y_max)
+        {
+            y_max = p_y[i];
+        }
+    }
+
+    // rows off the screen can be skipped, columns get clipped per span
+    if (y_min < 0)
+    {
+        y_min = 0;
+    }
+
+    if (y_max > (int32_t)BSP_ILI9341_TFTHEIGHT - 1)
+    {
+        y_max = (int32_t)BSP_ILI9341_TFTHEIGHT - 1;
+    }
+
+    for (int32_t y = y_min; y <= y_max; y++)
+    {
+        span_lefts[y] = 0x7FFFFFFF;
+        span_rights[y] = -0x7FFFFFFF;
+    }
+
+    // every row between the top and bottom corners is crossed by an edge, so every span gets set
+    for (uint32_t i = 0u; i < num_points; i++)
+    {
+        const uint32_t j = (i + 1u == num_points) ? 0u : i + 1u;
+
+        ILI9341_Walk_Line_Runs(p_x[i], p_y[i], p_x[j], p_y[j], 1u, color, ILI9341_Add_Span_Run);
+    }
+
+    for (int32_t y = y_min; y <= y_max; y++)
+    {
+        ILI9341_Fill_Clipped(span_lefts[y], y, span_rights[y], y, color);
+    }
+}
+
+int32_t ILI9341_Divide_Rounded(int32_t numerator, int32_t denominator)
+{
+    int32_t retval;
+
+    // C division rounds towards 0, so round the size and put the sign back
+    if (numerator >= 0)
+    {
+        retval = (numerator + denominator / 2) / denominator;
+    }
+    else
+    {
+        retval = -((-numerator + denominator / 2) / denominator);
+    }
+
+    return retval;
+}
+
+uint32_t ILI9341_Square_Root(uint32_t val)
+{
+    uint32_t root = 0u;
+    uint32_t bit = 1u << 30u;
+
+    while (bit > val)
+    {
+        bit >>= 2u;
+    }
+
+    while (bit != 0u)
+    {
+        if (val >= root + bit)
+        {
+            val -= root + bit;
+            root = (root >> 1u) + bit;
+        }
+        else
+        {
+            root >>= 1u;
+        }
+
+        bit >>= 2u;
+    }
+
+    return root;
+}
+
+void ILI9341_Mark_Dirty(const ILI9341_Rect_t * p_rect)
+{
+    ILI9341_Rect_t rect = *p_rect;
+    ILI9341_Rect_t merged;
+
+    // merge with any dirty rectangle where the merge costs no extra pixels, a merge can make
+    // the rectangle overlap ones that were already checked so start over after each merge
+    uint32_t i = 0u;
+
+    while (i < num_dirty_rects)
+    {
+        ILI9341_Rect_Union(&rect, &dirty_rects[i], &merged);
+
+        if (ILI9341_Rect_Area(&merged) <= ILI9341_Rect_Area(&rect) + ILI9341_Rect_Area(&dirty_rects[i]))
+        {
+            rect = merged;
+
+            // remove the rectangle that was merged by moving the last one into its slot
+            num_dirty_rects--;
+            dirty_rects[i] = dirty_rects[num_dirty_rects];
+
+            i = 0u;
+        }
+        else
+        {
+            i++;
+        }
+    }
+
+    if (num_dirty_rects < MAX_DIRTY_RECTS)
+    {
+        dirty_rects[num_dirty_rects] = rect;
+        num_dirty_rects++;
+    }
+    else
+    {
+        // out of room, merge with whichever rectangle grows the least
+        uint32_t best_index = 0u;
+        uint32_t best_growth = 0xFFFFFFFFu;
+
+        for (i = 0u; i < num_dirty_rects; i++)
+        {
+            ILI9341_Rect_Union(&rect, &dirty_rects[i], &merged);
+
+            const uint32_t growth = ILI9341_Rect_Area(&merged) - ILI9341_Rect_Area(&dirty_rects[i]);
+
+            if (growth < best_growth)
+            {
+                best_growth = growth;
+                best_index = i;
+            }
+        }
+
+        ILI9341_Rect_Union(&rect, &dirty_rects[best_index], &dirty_rects[best_index]);
+    }
+}
+
+uint32_t ILI9341_Rect_Area(const ILI9341_Rect_t * p_rect)
+{
+    return (uint32_t)(p_rect->x1 - p_rect->x0 + 1u) * (uint32_t)(p_rect->y1 - p_rect->y0 + 1u);
+}
+
+void ILI9341_Rect_Union(const ILI9341_Rect_t * p_a, 
+                        const ILI9341_Rect_t * p_b, 
+                        ILI9341_Rect_t * p_union)
+{
+    const ILI9341_Rect_t result = 
+    {
+        (p_a->x0 < p_b->x0) ? p_a->x0 : p_b->x0,
+        (p_a->y0 < p_b->y0) ? p_a->y0 : p_b->y0,
+        (p_a->x1 > p_b->x1) ? p_a->x1 : p_b->x1,
+        (p_a->y1 > p_b->y1) ? p_a->y1 : p_b->y1,
+    };
+
+    *p_union = result;
+}
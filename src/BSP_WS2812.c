@@ -0,0 +1,261 @@
+/*
+--|----------------------------------------------------------------------------|
+--| FILE DESCRIPTION:
+--|   BSP_WS2812.c provides the implementation for WS2812 LED strips.
+--|
+--|----------------------------------------------------------------------------|
+--| REFERENCES:
+--|   see BSP_WS2812.h
+--|
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--|----------------------------------------------------------------------------|
+--| INCLUDE FILES
+--|----------------------------------------------------------------------------|
+*/
+
+#include "BSP_WS2812.h"
+#include "PSP_PWM.h"
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE DEFINES
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--| NAME: WS2812_PWM_CLOCK_DIV
+--| DESCRIPTION: divides the 19.2MHz oscillator down to 2.4MHz, 3 serializer
+--|   bits per 800kHz WS2812 bit
+--| TYPE: uint32_t
+*/
+#define WS2812_PWM_CLOCK_DIV (8u)
+
+/*
+--| NAME: WS2812_BYTES_PER_LED
+--| DESCRIPTION: green, red and blue, in the order the strip takes them
+--| TYPE: uint32_t
+*/
+#define WS2812_BYTES_PER_LED (3u)
+
+/*
+--| NAME: WS2812_BITS_PER_BYTE
+--| DESCRIPTION: serializer bits to send one color byte
+--| TYPE: uint32_t
+*/
+#define WS2812_BITS_PER_BYTE (24u)
+
+/*
+--| NAME: WS2812_RESET_WORDS
+--| DESCRIPTION: low words sent after the colors, 320uSec, over the 280uSec
+--|   the strip needs to latch even if the last word is still shifting out
+--|   when the next refresh starts
+--| TYPE: uint32_t
+*/
+#define WS2812_RESET_WORDS (24u)
+
+/*
+--| NAME: WS2812_MAX_WORDS
+--| DESCRIPTION: serializer words for the longest strip plus the reset
+--| TYPE: uint32_t
+*/
+#define WS2812_MAX_WORDS ((((BSP_WS2812_MAX_LEDS * WS2812_BYTES_PER_LED * WS2812_BITS_PER_BYTE) + 31u) / 32u) + \
+                          WS2812_RESET_WORDS)
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE TYPES
+--|----------------------------------------------------------------------------|
+*/
+
+/* None */
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE CONSTANTS
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--| NAME: encoding_table
+--| DESCRIPTION: the serializer bits for each color byte, MSB first, 110 for
+--|   a 1 bit and 100 for a 0 bit, in the low 24 bits
+--| TYPE: uint32_t[]
+*/
+static const uint32_t encoding_table[256u] =
+{
+    0x924924u, 0x924926u, 0x924934u, 0x924936u, 0x9249A4u, 0x9249A6u, 0x9249B4u, 0x9249B6u,
+    0x924D24u, 0x924D26u, 0x924D34u, 0x924D36u, 0x924DA4u, 0x924DA6u, 0x924DB4u, 0x924DB6u,
+    0x926924u, 0x926926u, 0x926934u, 0x926936u, 0x9269A4u, 0x9269A6u, 0x9269B4u, 0x9269B6u,
+    0x926D24u, 0x926D26u, 0x926D34u, 0x926D36u, 0x926DA4u, 0x926DA6u, 0x926DB4u, 0x926DB6u,
+    0x934924u, 0x934926u, 0x934934u, 0x934936u, 0x9349A4u, 0x9349A6u, 0x9349B4u, 0x9349B6u,
+    0x934D24u, 0x934D26u, 0x934D34u, 0x934D36u, 0x934DA4u, 0x934DA6u, 0x934DB4u, 0x934DB6u,
+    0x936924u, 0x936926u, 0x936934u, 0x936936u, 0x9369A4u, 0x9369A6u, 0x9369B4u, 0x9369B6u,
+    0x936D24u, 0x936D26u, 0x936D34u, 0x936D36u, 0x936DA4u, 0x936DA6u, 0x936DB4u, 0x936DB6u,
+    0x9A4924u, 0x9A4926u, 0x9A4934u, 0x9A4936u, 0x9A49A4u, 0x9A49A6u, 0x9A49B4u, 0x9A49B6u,
+    0x9A4D24u, 0x9A4D26u, 0x9A4D34u, 0x9A4D36u, 0x9A4DA4u, 0x9A4DA6u, 0x9A4DB4u, 0x9A4DB6u,
+    0x9A6924u, 0x9A6926u, 0x9A6934u, 0x9A6936u, 0x9A69A4u, 0x9A69A6u, 0x9A69B4u, 0x9A69B6u,
+    0x9A6D24u, 0x9A6D26u, 0x9A6D34u, 0x9A6D36u, 0x9A6DA4u, 0x9A6DA6u, 0x9A6DB4u, 0x9A6DB6u,
+    0x9B4924u, 0x9B4926u, 0x9B4934u, 0x9B4936u, 0x9B49A4u, 0x9B49A6u, 0x9B49B4u, 0x9B49B6u,
+    0x9B4D24u, 0x9B4D26u, 0x9B4D34u, 0x9B4D36u, 0x9B4DA4u, 0x9B4DA6u, 0x9B4DB4u, 0x9B4DB6u,
+    0x9B6924u, 0x9B6926u, 0x9B6934u, 0x9B6936u, 0x9B69A4u, 0x9B69A6u, 0x9B69B4u, 0x9B69B6u,
+    0x9B6D24u, 0x9B6D26u, 0x9B6D34u, 0x9B6D36u, 0x9B6DA4u, 0x9B6DA6u, 0x9B6DB4u, 0x9B6DB6u,
+    0xD24924u, 0xD24926u, 0xD24934u, 0xD24936u, 0xD249A4u, 0xD249A6u, 0xD249B4u, 0xD249B6u,
+    0xD24D24u, 0xD24D26u, 0xD24D34u, 0xD24D36u, 0xD24DA4u, 0xD24DA6u, 0xD24DB4u, 0xD24DB6u,
+    0xD26924u, 0xD26926u, 0xD26934u, 0xD26936u, 0xD269A4u, 0xD269A6u, 0xD269B4u, 0xD269B6u,
+    0xD26D24u, 0xD26D26u, 0xD26D34u, 0xD26D36u, 0xD26DA4u, 0xD26DA6u, 0xD26DB4u, 0xD26DB6u,
+    0xD34924u, 0xD34926u, 0xD34934u, 0xD34936u, 0xD349A4u, 0xD349A6u, 0xD349B4u, 0xD349B6u,
+    0xD34D24u, 0xD34D26u, 0xD34D34u, 0xD34D36u, 0xD34DA4u, 0xD34DA6u, 0xD34DB4u, 0xD34DB6u,
+    0xD36924u, 0xD36926u, 0xD36934u, 0xD36936u, 0xD369A4u, 0xD369A6u, 0xD369B4u, 0xD369B6u,
+    0xD36D24u, 0xD36D26u, 0xD36D34u, 0xD36D36u, 0xD36DA4u, 0xD36DA6u, 0xD36DB4u, 0xD36DB6u,
+    0xDA4924u, 0xDA4926u, 0xDA4934u, 0xDA4936u, 0xDA49A4u, 0xDA49A6u, 0xDA49B4u, 0xDA49B6u,
+    0xDA4D24u, 0xDA4D26u, 0xDA4D34u, 0xDA4D36u, 0xDA4DA4u, 0xDA4DA6u, 0xDA4DB4u, 0xDA4DB6u,
+    0xDA6924u, 0xDA6926u, 0xDA6934u, 0xDA6936u, 0xDA69A4u, 0xDA69A6u, 0xDA69B4u, 0xDA69B6u,
+    0xDA6D24u, 0xDA6D26u, 0xDA6D34u, 0xDA6D36u, 0xDA6DA4u, 0xDA6DA6u, 0xDA6DB4u, 0xDA6DB6u,
+    0xDB4924u, 0xDB4926u, 0xDB4934u, 0xDB4936u, 0xDB49A4u, 0xDB49A6u, 0xDB49B4u, 0xDB49B6u,
+    0xDB4D24u, 0xDB4D26u, 0xDB4D34u, 0xDB4D36u, 0xDB4DA4u, 0xDB4DA6u, 0xDB4DB4u, 0xDB4DB6u,
+    0xDB6924u, 0xDB6926u, 0xDB6934u, 0xDB6936u, 0xDB69A4u, 0xDB69A6u, 0xDB69B4u, 0xDB69B6u,
+    0xDB6D24u, 0xDB6D26u, 0xDB6D34u, 0xDB6D36u, 0xDB6DA4u, 0xDB6DA6u, 0xDB6DB4u, 0xDB6DB6u,
+};
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE VARIABLES
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--| NAME: num_strip_leds
+--| DESCRIPTION: the number of LEDs on the strip
+--| TYPE: uint32_t
+*/
+static uint32_t num_strip_leds = 0u;
+
+/*
+--| NAME: led_bytes
+--| DESCRIPTION: the colors set so far, in the order the strip takes them
+--| TYPE: uint8_t[]
+*/
+static uint8_t led_bytes[BSP_WS2812_MAX_LEDS * WS2812_BYTES_PER_LED];
+
+/*
+--| NAME: serializer_words
+--| DESCRIPTION: the encoded strip the DMA sends, cache line aligned so
+--|   cleaning it never touches anything else
+--| TYPE: uint32_t[]
+*/
+static uint32_t serializer_words[WS2812_MAX_WORDS] __attribute__((aligned(64)));
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE HELPER FUNCTION PROTOTYPES
+--|----------------------------------------------------------------------------|
+*/
+
+/* None */
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC FUNCTION DEFINITIONS
+--|----------------------------------------------------------------------------|
+*/
+
+uint32_t BSP_WS2812_Init(PSP_PWM_Channel_t channel, uint32_t num_leds)
+{
+    uint32_t retval = 0u;
+
+    if (num_leds <= BSP_WS2812_MAX_LEDS)
+    {
+        num_strip_leds = num_leds;
+
+        for (uint32_t i = 0u; i < (num_leds * WS2812_BYTES_PER_LED); i++)
+        {
+            led_bytes[i] = 0u;
+        }
+
+        PSP_PWM_Clock_Init(PSP_PWM_Clock_Source_OSCILLATOR, WS2812_PWM_CLOCK_DIV);
+
+        if (PSP_PWM_Serializer_Start(channel))
+        {
+            retval = BSP_WS2812_Show();
+        }
+    }
+    else
+    {
+        /* too many LEDs, do nothing */
+    }
+
+    return retval;
+}
+
+void BSP_WS2812_Set_Pixel(uint32_t index, uint8_t red, uint8_t green, uint8_t blue)
+{
+    if (index < num_strip_leds)
+    {
+        uint8_t * p_led = &led_bytes[index * WS2812_BYTES_PER_LED];
+
+        p_led[0] = green;
+        p_led[1] = red;
+        p_led[2] = blue;
+    }
+    else
+    {
+        /* invalid index, do nothing */
+    }
+}
+
+uint32_t BSP_WS2812_Show(void)
+{
+    uint32_t retval = 0u;
+
+    if (!PSP_PWM_Serializer_Is_Busy())
+    {
+        uint64_t bits = 0u;
+        uint32_t num_bits = 0u;
+        uint32_t num_words = 0u;
+
+        // 24 bits go in per byte and a word comes out whenever 32 have built up, the
+        // leftover never reaches 32 so the accumulator never holds more than 55 bits
+        for (uint32_t i = 0u; i < (num_strip_leds * WS2812_BYTES_PER_LED); i++)
+        {
+            bits = (bits << WS2812_BITS_PER_BYTE) | encoding_table[led_bytes[i]];
+            num_bits += WS2812_BITS_PER_BYTE;
+
+            if (num_bits >= 32u)
+            {
+                num_bits -= 32u;
+                serializer_words[num_words++] = (uint32_t)(bits >> num_bits);
+            }
+        }
+
+        // the last bits go at the top of a word, the zeros under them start the reset
+        if (num_bits)
+        {
+            serializer_words[num_words++] = (uint32_t)(bits << (32u - num_bits));
+        }
+
+        for (uint32_t i = 0u; i < WS2812_RESET_WORDS; i++)
+        {
+            serializer_words[num_words++] = 0u;
+        }
+
+        retval = PSP_PWM_Serializer_Write(serializer_words, num_words);
+    }
+
+    return retval;
+}
+
+uint32_t BSP_WS2812_Is_Busy(void)
+{
+    return PSP_PWM_Serializer_Is_Busy();
+}
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE HELPER FUNCTION DEFINITIONS
+--|----------------------------------------------------------------------------|
+*/
+
+/* None */
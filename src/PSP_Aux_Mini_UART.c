@@ -19,6 +19,7 @@
 #include "PSP_Aux_Mini_UART.h"
 #include "PSP_GPIO.h"
 #include "PSP_REGS.h"
+#include "PSP_IRQ.h"
 
 /*
 --|----------------------------------------------------------------------------|
@@ -33,6 +34,26 @@
 */
 #define AUX ((volatile Aux_Peripherals_t *)PSP_REGS_AUX_BASE_ADDRESS)
 
+/*
+--| NAME: MINI_UART_<T/R>X_BUFFER_MASK
+--| DESCRIPTION: masks a free running ring buffer index down to a position
+--| TYPE: uint32_t
+*/
+#define MINI_UART_TX_BUFFER_MASK (PSP_AUX_MINI_UART_TX_BUFFER_SIZE - 1u)
+#define MINI_UART_RX_BUFFER_MASK (PSP_AUX_MINI_UART_RX_BUFFER_SIZE - 1u)
+
+/*
+--| NAME: MINI_UART_DMB
+--| DESCRIPTION: data memory barrier, orders ring buffer data accesses against 
+--|   the index updates that publish them
+--| TYPE: macro
+*/
+#ifdef PSP_HOST_SIM
+#define MINI_UART_DMB() __sync_synchronize()
+#else
+#define MINI_UART_DMB() __asm__ volatile ("dmb" : : : "memory")
+#endif
+
 /*
 --|----------------------------------------------------------------------------|
 --| PRIVATE TYPES
@@ -113,8 +134,9 @@ typedef enum Aux_Peripherals_MU_IER_MS8_Masks_Enumeration
 */
 typedef enum Aux_Peripherals_MU_IER_Flags_Enumeration
 {
-    Aux_Peripherals_MU_IER_ENAB_TRANS_INTS_FLAG = (1u << 1u),  // enable transmit interrupts [rw]
-    Aux_Peripherals_MU_IER_ENAB_REC_INTS_FLAG   = (1u << 0u),  // enable recieve interrupts [rw]
+    Aux_Peripherals_MU_IER_ENAB_REC_ERRATA_FLAGS = (3u << 2u),  // must also be set for recieve interrupts (errata) [rw]
+    Aux_Peripherals_MU_IER_ENAB_TRANS_INTS_FLAG  = (1u << 1u),  // enable transmit interrupts [rw]
+    Aux_Peripherals_MU_IER_ENAB_REC_INTS_FLAG    = (1u << 0u),  // enable recieve interrupts [rw]
 } Aux_Peripherals_MU_IER_Flags_enum;
 
 /*
@@ -259,7 +281,17 @@ typedef enum Aux_Peripherals_MU_STAT_Flags_Enumeration
 --|----------------------------------------------------------------------------|
 */
 
-/* None */
+/*
+--| NAME: MINI_UART_IER_<RX/TX>
+--| DESCRIPTION: MU_IER values for receive interrupts only, and for receive and 
+--|   transmit interrupts
+--| TYPE: uint32_t
+*/
+static const uint32_t MINI_UART_IER_RX = Aux_Peripherals_MU_IER_ENAB_REC_ERRATA_FLAGS | 
+                                         Aux_Peripherals_MU_IER_ENAB_REC_INTS_FLAG;
+static const uint32_t MINI_UART_IER_RX_TX = Aux_Peripherals_MU_IER_ENAB_REC_ERRATA_FLAGS | 
+                                            Aux_Peripherals_MU_IER_ENAB_REC_INTS_FLAG | 
+                                            Aux_Peripherals_MU_IER_ENAB_TRANS_INTS_FLAG;
 
 /*
 --|----------------------------------------------------------------------------|
@@ -267,7 +299,31 @@ typedef enum Aux_Peripherals_MU_STAT_Flags_Enumeration
 --|----------------------------------------------------------------------------|
 */
 
-/* None */
+/*
+--| NAME: interrupts_enabled
+--| DESCRIPTION: true once transmit and receive go through the ring buffers
+--| TYPE: uint32_t
+*/
+static uint32_t interrupts_enabled = 0u;
+
+/*
+--| NAME: <t/r>x_buffer
+--| DESCRIPTION: the transmit and receive ring buffers
+--| TYPE: uint8_t[]
+*/
+static uint8_t tx_buffer[PSP_AUX_MINI_UART_TX_BUFFER_SIZE];
+static uint8_t rx_buffer[PSP_AUX_MINI_UART_RX_BUFFER_SIZE];
+
+/*
+--| NAME: <t/r>x_<head/tail>
+--| DESCRIPTION: free running ring buffer indices, head is only written by the 
+--|   producer and tail only by the consumer, head - tail is the fill level
+--| TYPE: uint32_t
+*/
+static volatile uint32_t tx_head = 0u;
+static volatile uint32_t tx_tail = 0u;
+static volatile uint32_t rx_head = 0u;
+static volatile uint32_t rx_tail = 0u;
 
 /*
 --|----------------------------------------------------------------------------|
@@ -275,7 +331,45 @@ typedef enum Aux_Peripherals_MU_STAT_Flags_Enumeration
 --|----------------------------------------------------------------------------|
 */
 
-/* None */
+/*------------------------------------------------------------------------------
+Function Name:
+    Mini_Uart_IRQ_Handler
+
+Function Description:
+    Move received bytes from the uart FIFO to the receive ring buffer, and 
+    bytes to send from the transmit ring buffer to the uart FIFO.
+
+Parameters:
+    source: the interrupt source, always PSP_IRQ_SOURCE_AUX.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    The Aux interrupt is shared with the two aux SPIs, only the mini uart 
+    interrupt is handled.
+------------------------------------------------------------------------------*/
+void Mini_Uart_IRQ_Handler(uint32_t source);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    Mini_Uart_Fill_Tx_FIFO
+
+Function Description:
+    Move bytes from the transmit ring buffer to the uart FIFO until either is 
+    full or empty, and turn the transmit interrupt off once the ring buffer 
+    is empty.
+
+Parameters:
+    None
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    Only called from the interrupt handler, it is the only consumer.
+------------------------------------------------------------------------------*/
+void Mini_Uart_Fill_Tx_FIFO(void);
 
 /*
 --|----------------------------------------------------------------------------|
@@ -294,6 +388,7 @@ void PSP_AUX_Mini_Uart_Init(PSP_AUX_Mini_Uart_Baud_Rate_t baud_rate_enum)
 
     // disable mini uart interrupts
     AUX->MU_IER = 0u;
+    interrupts_enabled = 0u;
 
     // zero out the control register
     AUX->MU_CNTL = 0u;
@@ -318,6 +413,16 @@ void PSP_AUX_Mini_Uart_Set_Baud_Rate(PSP_AUX_Mini_Uart_Baud_Rate_t baud_rate_enu
 
 void PSP_AUX_Mini_Uart_Send_Byte(uint8_t value)
 {
+    if (interrupts_enabled)
+    {
+        while (!PSP_AUX_Mini_Uart_Write(&value, 1u))
+        {
+            // wait until the interrupt makes room in the ring buffer
+        }
+
+        return;
+    }
+
     while (!(AUX->MU_LSR & Aux_Peripherals_MU_LSR_TRANS_EMPTY_FLAG))
     {
         // wait until the transmitter can accept data
@@ -336,10 +441,137 @@ void PSP_AUX_Mini_Uart_Send_String(char * c_string)
     }
 }
 
+void PSP_AUX_Mini_Uart_Enable_Interrupts(void)
+{
+    // start from empty ring buffers
+    tx_head = 0u;
+    tx_tail = 0u;
+    rx_head = 0u;
+    rx_tail = 0u;
+    interrupts_enabled = 1u;
+
+    PSP_IRQ_Register_Handler(PSP_IRQ_SOURCE_AUX, Mini_Uart_IRQ_Handler);
+
+    // transmit interrupts are only turned on while there is something to send
+    AUX->MU_IER = MINI_UART_IER_RX;
+
+    PSP_IRQ_Enable_Source(PSP_IRQ_SOURCE_AUX);
+}
+
+uint32_t PSP_AUX_Mini_Uart_Write(const uint8_t * p_buffer, uint32_t length)
+{
+    uint32_t head = tx_head;
+    const uint32_t tail = tx_tail;
+    uint32_t num_queued = 0u;
+
+    while ((num_queued < length) && ((head - tail) < PSP_AUX_MINI_UART_TX_BUFFER_SIZE))
+    {
+        tx_buffer[head & MINI_UART_TX_BUFFER_MASK] = p_buffer[num_queued];
+        head++;
+        num_queued++;
+    }
+
+    if (num_queued)
+    {
+        // the bytes must be in the buffer before the handler can see them
+        MINI_UART_DMB();
+        tx_head = head;
+
+        AUX->MU_IER = MINI_UART_IER_RX_TX;
+    }
+
+    return num_queued;
+}
+
+uint32_t PSP_AUX_Mini_Uart_Read(uint8_t * p_buffer, uint32_t length)
+{
+    const uint32_t head = rx_head;
+    uint32_t tail = rx_tail;
+    uint32_t num_taken = 0u;
+
+    // the bytes up to head must be read after head is
+    MINI_UART_DMB();
+
+    while ((num_taken < length) && (tail != head))
+    {
+        p_buffer[num_taken] = rx_buffer[tail & MINI_UART_RX_BUFFER_MASK];
+        tail++;
+        num_taken++;
+    }
+
+    if (num_taken)
+    {
+        // the bytes must be read before the handler can overwrite them
+        MINI_UART_DMB();
+        rx_tail = tail;
+    }
+
+    return num_taken;
+}
+
 /*
 --|----------------------------------------------------------------------------|
 --| PRIVATE HELPER FUNCTION DEFINITIONS
 --|----------------------------------------------------------------------------|
 */
 
-/* None */
+void Mini_Uart_IRQ_Handler(uint32_t source)
+{
+    (void)source;
+
+    if (!(AUX->IRQ & Aux_Peripherals_IRQ_MUART_FLAG))
+    {
+        return;
+    }
+
+    // reading MU_IO clears the recieve interrupt
+    while (AUX->MU_LSR & Aux_Peripherals_MU_LSR_DATA_READY_FLAG)
+    {
+        const uint8_t value = AUX->MU_IO;
+        const uint32_t head = rx_head;
+
+        if ((head - rx_tail) < PSP_AUX_MINI_UART_RX_BUFFER_SIZE)
+        {
+            rx_buffer[head & MINI_UART_RX_BUFFER_MASK] = value;
+            MINI_UART_DMB();
+            rx_head = head + 1u;
+        }
+        else
+        {
+            /* ... do nothing, the ring buffer is full and the byte is dropped */
+        }
+    }
+
+    Mini_Uart_Fill_Tx_FIFO();
+}
+
+void Mini_Uart_Fill_Tx_FIFO(void)
+{
+    const uint32_t head = tx_head;
+    uint32_t tail = tx_tail;
+
+    // the bytes up to head must be read after head is
+    MINI_UART_DMB();
+
+    while ((tail != head) && (AUX->MU_STAT & Aux_Peripherals_MU_STAT_SPACE_AVAIL_FLAG))
+    {
+        AUX->MU_IO = tx_buffer[tail & MINI_UART_TX_BUFFER_MASK];
+        tail++;
+    }
+
+    MINI_UART_DMB();
+    tx_tail = tail;
+
+    if (tail == head)
+    {
+        // nothing left to send, so stop the transmit FIFO empty interrupt
+        AUX->MU_IER = MINI_UART_IER_RX;
+
+        // a write from another core may have queued bytes and turned the 
+        // interrupt on just before it was turned off
+        if (tx_head != tail)
+        {
+            AUX->MU_IER = MINI_UART_IER_RX_TX;
+        }
+    }
+}
@@ -0,0 +1,198 @@
+/*
+--|----------------------------------------------------------------------------|
+--| FILE DESCRIPTION:
+--|   PSP_Core.c provides the mailbox registers and the entry and stack tables
+--|   read by _secondary_start in start.s, as well as the implementation for
+--|   the core functions.
+--|
+--|----------------------------------------------------------------------------|
+--| REFERENCES:
+--|   QA7_rev3.4.pdf page 15 (mailboxes)
+--|   https://github.com/raspberrypi/tools/blob/master/armstubs/armstub7.S
+--|
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--|----------------------------------------------------------------------------|
+--| INCLUDE FILES
+--|----------------------------------------------------------------------------|
+*/
+
+#include "PSP_Core.h"
+#include "PSP_MMU.h"
+#include "PSP_REGS.h"
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE DEFINES
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--| NAME: Mailboxes
+--| DESCRIPTION: pointer to the ARM local mailbox registers
+--| TYPE: Core_Mailboxes_t *
+*/
+#define Mailboxes ((volatile Core_Mailboxes_t *)PSP_REGS_LOCAL_MAILBOX_BASE_ADDRESS)
+
+/*
+--| NAME: CORE_NUM_MAILBOXES
+--| DESCRIPTION: the number of mailboxes per core
+--| TYPE: uint32_t
+*/
+#define CORE_NUM_MAILBOXES (4u)
+
+/*
+--| NAME: CORE_START_MAILBOX
+--| DESCRIPTION: the mailbox the firmware spin loop waits on for a start address
+--| TYPE: uint32_t
+*/
+#define CORE_START_MAILBOX (3u)
+
+/*
+--| NAME: CORE_MPIDR_CPU_ID_MASK
+--| DESCRIPTION: the core number field of the Multiprocessor Affinity Register
+--| TYPE: uint32_t
+*/
+#define CORE_MPIDR_CPU_ID_MASK (0x3u)
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE TYPES
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--| NAME: Core_Mailboxes_t
+--| DESCRIPTION: structure for the ARM local mailbox registers, writing a 1 bit
+--|   to SET sets it in the mailbox and writing a 1 bit to CLEAR clears it
+*/
+typedef struct Core_Mailboxes_Type
+{
+    vuint32_t SET[PSP_CORE_NUM_CORES][CORE_NUM_MAILBOXES];   // Mailbox Write-Set, one row per core
+    vuint32_t CLEAR[PSP_CORE_NUM_CORES][CORE_NUM_MAILBOXES]; // Mailbox Read/Write-High-To-Clear
+} Core_Mailboxes_t;
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE CONSTANTS
+--|----------------------------------------------------------------------------|
+*/
+
+/* None */
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE VARIABLES
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--| NAME: __coreN_stack_top
+--| DESCRIPTION: the tops of the per core stack regions, from linker.ld
+--| TYPE: uint8_t[]
+*/
+extern uint8_t __core1_stack_top[];
+extern uint8_t __core2_stack_top[];
+extern uint8_t __core3_stack_top[];
+
+/*
+--| NAME: _secondary_start
+--| DESCRIPTION: where a released core starts, in start.s
+--| TYPE: function
+*/
+extern void _secondary_start(void);
+
+/*
+--| NAME: core_stack_tops, core_entries
+--| DESCRIPTION: the stack and entry function of each core, read by
+--|   _secondary_start so these can not be static
+--| TYPE: uint32_t[], PSP_Core_Entry_t[]
+*/
+uint32_t core_stack_tops[PSP_CORE_NUM_CORES];
+PSP_Core_Entry_t core_entries[PSP_CORE_NUM_CORES];
+
+/*
+--| NAME: started_cores
+--| DESCRIPTION: bit n is set once core n has been started, core 0 always runs
+--| TYPE: uint32_t
+*/
+static uint32_t started_cores = (1u << 0u);
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE HELPER FUNCTION PROTOTYPES
+--|----------------------------------------------------------------------------|
+*/
+
+/* None */
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC FUNCTION DEFINITIONS
+--|----------------------------------------------------------------------------|
+*/
+
+uint32_t PSP_Core_Get_ID(void)
+{
+    uint32_t mpidr;
+
+    __asm__ volatile ("mrc p15, 0, %0, c0, c0, 5" : "=r" (mpidr)); // MPIDR
+
+    return mpidr & CORE_MPIDR_CPU_ID_MASK;
+}
+
+uint32_t PSP_Core_Start(uint32_t core_id, PSP_Core_Entry_t entry, void * p_stack_top)
+{
+    uint32_t retval = 0u;
+
+    const uint32_t default_stack_tops[PSP_CORE_NUM_CORES] =
+    {
+        0u,
+        (uint32_t)__core1_stack_top,
+        (uint32_t)__core2_stack_top,
+        (uint32_t)__core3_stack_top,
+    };
+
+    if ((0u < core_id) && (core_id < PSP_CORE_NUM_CORES) && entry && !PSP_Core_Is_Started(core_id))
+    {
+        core_stack_tops[core_id] = p_stack_top ? (uint32_t)p_stack_top : default_stack_tops[core_id];
+        core_entries[core_id] = entry;
+
+        // the new core reads these before its caches are on
+        PSP_MMU_Clean_Data_Cache(&core_stack_tops[core_id], sizeof(core_stack_tops[core_id]));
+        PSP_MMU_Clean_Data_Cache(&core_entries[core_id], sizeof(core_entries[core_id]));
+
+        started_cores |= (1u << core_id);
+
+        Mailboxes->SET[core_id][CORE_START_MAILBOX] = (uint32_t)_secondary_start;
+
+        // the firmware spin loop sleeps on WFE
+        __asm__ volatile ("dsb\n\tsev" : : : "memory");
+
+        retval = 1u;
+    }
+
+    return retval;
+}
+
+uint32_t PSP_Core_Is_Started(uint32_t core_id)
+{
+    uint32_t retval = 0u;
+
+    if (core_id < PSP_CORE_NUM_CORES)
+    {
+        retval = (started_cores >> core_id) & 1u;
+    }
+
+    return retval;
+}
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE HELPER FUNCTION DEFINITIONS
+--|----------------------------------------------------------------------------|
+*/
+
+/* None */
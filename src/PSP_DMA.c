@@ -0,0 +1,478 @@
+/*
+--|----------------------------------------------------------------------------|
+--| FILE DESCRIPTION:
+--|   PSP_DMA.c provides the implementation for the DMA controller.
+--|
+--|----------------------------------------------------------------------------|
+--| REFERENCES:
+--|   see PSP_DMA.h
+--|
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--|----------------------------------------------------------------------------|
+--| INCLUDE FILES
+--|----------------------------------------------------------------------------|
+*/
+
+#include "PSP_DMA.h"
+#include "PSP_REGS.h"
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE DEFINES
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--| NAME: DMA
+--| DESCRIPTION: pointer to the DMA controller register structure
+--| TYPE: DMA_t *
+*/
+#define DMA ((volatile DMA_t *)PSP_REGS_DMA_BASE_ADDRESS)
+
+/*
+--| NAME: USABLE_CHANNELS_MASK
+--| DESCRIPTION: the channels not used by the GPU firmware, 0, 2, 4, 5, 8-14
+--| TYPE: uint32_t
+*/
+#define USABLE_CHANNELS_MASK (0x7F35u)
+
+/*
+--| NAME: FIRST_LITE_CHANNEL
+--| DESCRIPTION: channels at or above this number are lite channels
+--| TYPE: uint32_t
+*/
+#define FIRST_LITE_CHANNEL (7u)
+
+/*
+--| NAME: BUS_ADDRESS_UNCACHED_ALIAS
+--| DESCRIPTION: the bus alias for RAM that bypasses the GPU L2 cache
+--| TYPE: uint32_t
+*/
+#define BUS_ADDRESS_UNCACHED_ALIAS (0xC0000000u)
+
+/*
+--| NAME: BUS_ADDRESS_PERIPHERAL_BASE
+--| DESCRIPTION: the bus address of the start of the peripherals
+--| TYPE: uint32_t
+*/
+#define BUS_ADDRESS_PERIPHERAL_BASE (0x7E000000u)
+
+/*
+--| NAME: PERIPHERAL_OFFSET_MASK
+--| DESCRIPTION: masks off the offset of a register into the peripheral space
+--| TYPE: uint32_t
+*/
+#define PERIPHERAL_OFFSET_MASK (0x00FFFFFFu)
+
+/*
+--| NAME: DEFAULT_PRIORITY
+--| DESCRIPTION: AXI priority level used for normal and panic transfers
+--| TYPE: uint32_t
+*/
+#define DEFAULT_PRIORITY       (8u)
+#define DEFAULT_PANIC_PRIORITY (15u)
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE TYPES
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--| NAME: DMA_Channel_t
+--| DESCRIPTION: structure for the registers of a single DMA channel
+*/
+typedef struct DMA_Channel_Type
+{
+    vuint32_t CS;            // Control and Status
+    vuint32_t CONBLK_AD;     // Control Block Address
+    vuint32_t TI;            // CB Word 0 (Transfer Information)
+    vuint32_t SOURCE_AD;     // CB Word 1 (Source Address)
+    vuint32_t DEST_AD;       // CB Word 2 (Destination Address)
+    vuint32_t TXFR_LEN;      // CB Word 3 (Transfer Length)
+    vuint32_t STRIDE;        // CB Word 4 (2D Stride)
+    vuint32_t NEXTCONBK;     // CB Word 5 (Next CB Address)
+    vuint32_t DEBUG;         // Debug
+    vuint32_t RESERVED[55u]; // pads each channel out to 0x100 bytes
+} DMA_Channel_t;
+
+/*
+--| NAME: DMA_t
+--| DESCRIPTION: structure for the DMA controller registers
+*/
+typedef struct DMA_Type
+{
+    DMA_Channel_t CHANNEL[PSP_DMA_NUM_CHANNELS]; // channels 0 through 14
+    vuint32_t RESERVED_1[56u];                   //
+    vuint32_t INT_STATUS;                        // Interrupt status of each DMA channel
+    vuint32_t RESERVED_2[3u];                    //
+    vuint32_t ENABLE;                            // Global enable bits for each DMA channel
+} DMA_t;
+
+/*
+--| NAME: DMA_CS_Flags_enum
+--| DESCRIPTION: DMA channel Control and Status register flags
+*/
+typedef enum DMA_CS_Flags_Enumeration
+{
+    DMA_CS_RESET_FLAG        = (1u << 31u), // DMA Channel Reset [w1sc]
+    DMA_CS_ABORT_FLAG        = (1u << 30u), // Abort DMA [w1sc]
+    DMA_CS_DISDEBUG_FLAG     = (1u << 29u), // Disable debug pause signal [rw]
+    DMA_CS_WAIT_WRITES_FLAG  = (1u << 28u), // Wait for outstanding writes [rw]
+    DMA_CS_ERROR_FLAG        = (1u << 8u),  // DMA Error [r]
+    DMA_CS_WAITING_FLAG      = (1u << 6u),  // Waiting for outstanding writes [r]
+    DMA_CS_DREQ_STOPS_FLAG   = (1u << 5u),  // DMA Paused by DREQ State [r]
+    DMA_CS_PAUSED_FLAG       = (1u << 4u),  // DMA Paused State [r]
+    DMA_CS_DREQ_FLAG         = (1u << 3u),  // DREQ State [r]
+    DMA_CS_INT_FLAG          = (1u << 2u),  // Interrupt Status [w1c]
+    DMA_CS_END_FLAG          = (1u << 1u),  // DMA End Flag [w1c]
+    DMA_CS_ACTIVE_FLAG       = (1u << 0u),  // Activate the DMA [rw]
+} DMA_CS_Flags_enum;
+
+/*
+--| NAME: DMA_CS_Masks_enum
+--| DESCRIPTION: DMA channel Control and Status register multi-bit field masks
+*/
+typedef enum DMA_CS_Masks_Enumeration
+{
+    DMA_CS_PANIC_PRIORITY_MASK      = 0xFu, // AXI Panic Priority Level [4 bits]
+    DMA_CS_PANIC_PRIORITY_SHIFT_AMT = 20u,  // position of PANIC_PRIORITY in CS
+    DMA_CS_PRIORITY_MASK            = 0xFu, // AXI Priority Level [4 bits]
+    DMA_CS_PRIORITY_SHIFT_AMT       = 16u,  // position of PRIORITY in CS
+} DMA_CS_Masks_enum;
+
+/*
+--| NAME: DMA_DEBUG_Flags_enum
+--| DESCRIPTION: DMA channel Debug register flags
+*/
+typedef enum DMA_DEBUG_Flags_Enumeration
+{
+    DMA_DEBUG_LITE_FLAG               = (1u << 28u), // DMA Lite [r]
+    DMA_DEBUG_READ_ERROR_FLAG         = (1u << 2u),  // Slave Read Response Error [w1c]
+    DMA_DEBUG_FIFO_ERROR_FLAG         = (1u << 1u),  // Fifo Error [w1c]
+    DMA_DEBUG_READ_LAST_NOT_SET_FLAG  = (1u << 0u),  // Read Last Not Set Error [w1c]
+} DMA_DEBUG_Flags_enum;
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE CONSTANTS
+--|----------------------------------------------------------------------------|
+*/
+
+/* None */
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE VARIABLES
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--| NAME: allocated_channels
+--| DESCRIPTION: bit n is set if channel n has been handed out
+--| TYPE: uint32_t
+*/
+static uint32_t allocated_channels = 0u;
+
+/*
+--| NAME: channel_callbacks
+--| DESCRIPTION: the completion callback for each channel, 0 for none
+--| TYPE: PSP_DMA_Callback_t[]
+*/
+static PSP_DMA_Callback_t channel_callbacks[PSP_DMA_NUM_CHANNELS];
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE HELPER FUNCTION PROTOTYPES
+--|----------------------------------------------------------------------------|
+*/
+
+/*------------------------------------------------------------------------------
+Function Name:
+    is_valid_DMA_channel
+
+Function Description:
+    test a given channel number for validity
+
+Parameters:
+    channel: the channel to test for validity
+
+Returns:
+    Boolean: true if the channel is one this module can hand out, else false
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+uint32_t is_valid_DMA_channel(uint32_t channel);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    DMA_Reset_Channel
+
+Function Description:
+    Reset a channel and clear any stale status and error flags.
+
+Parameters:
+    channel: the channel to reset
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+void DMA_Reset_Channel(uint32_t channel);
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC FUNCTION DEFINITIONS
+--|----------------------------------------------------------------------------|
+*/
+
+uint32_t PSP_DMA_Channel_Allocate(void)
+{
+    uint32_t channel = PSP_DMA_NO_CHANNEL;
+
+    for (uint32_t i = 0u; i < PSP_DMA_NUM_CHANNELS; i++)
+    {
+        const uint32_t channel_bit = 1u << i;
+
+        if ((USABLE_CHANNELS_MASK & channel_bit) && !(allocated_channels & channel_bit))
+        {
+            allocated_channels |= channel_bit;
+            channel_callbacks[i] = 0;
+
+            // make sure the channel is globally enabled, then start it from a clean slate
+            DMA->ENABLE |= channel_bit;
+            DMA_Reset_Channel(i);
+
+            channel = i;
+            break;
+        }
+    }
+
+    return channel;
+}
+
+void PSP_DMA_Channel_Free(uint32_t channel)
+{
+    if (is_valid_DMA_channel(channel))
+    {
+        PSP_DMA_Abort(channel);
+        channel_callbacks[channel] = 0;
+        allocated_channels &= ~(1u << channel);
+    }
+    else
+    {
+        /* invalid channel, do nothing */
+    }
+}
+
+uint32_t PSP_DMA_Channel_Is_Lite(uint32_t channel)
+{
+    return channel >= FIRST_LITE_CHANNEL;
+}
+
+void PSP_DMA_Set_Callback(uint32_t channel, PSP_DMA_Callback_t callback)
+{
+    if (is_valid_DMA_channel(channel))
+    {
+        channel_callbacks[channel] = callback;
+    }
+    else
+    {
+        /* invalid channel, do nothing */
+    }
+}
+
+void PSP_DMA_Set_Control_Block(PSP_DMA_Control_Block_t * p_control_block,
+                               uint32_t transfer_info,
+                               uint32_t source,
+                               uint32_t dest,
+                               uint32_t length)
+{
+    p_control_block->TI          = transfer_info;
+    p_control_block->SOURCE_AD   = source;
+    p_control_block->DEST_AD     = dest;
+    p_control_block->TXFR_LEN    = length;
+    p_control_block->STRIDE      = 0u;
+    p_control_block->NEXTCONBK   = 0u;
+    p_control_block->RESERVED[0] = 0u;
+    p_control_block->RESERVED[1] = 0u;
+}
+
+void PSP_DMA_Link_Control_Blocks(PSP_DMA_Control_Block_t * p_control_blocks,
+                                 uint32_t num_blocks,
+                                 uint32_t is_loop)
+{
+    for (uint32_t i = 0u; (i + 1u) < num_blocks; i++)
+    {
+        p_control_blocks[i].NEXTCONBK = PSP_DMA_Bus_Address(&p_control_blocks[i + 1u]);
+    }
+
+    if (is_loop && (num_blocks > 0u))
+    {
+        p_control_blocks[num_blocks - 1u].NEXTCONBK = PSP_DMA_Bus_Address(&p_control_blocks[0]);
+    }
+    else
+    {
+        /* end of the chain, do nothing */
+    }
+}
+
+void PSP_DMA_Start(uint32_t channel, PSP_DMA_Control_Block_t * p_control_block)
+{
+    if (is_valid_DMA_channel(channel))
+    {
+        volatile DMA_Channel_t * p_channel = &DMA->CHANNEL[channel];
+
+        // clear the end and interrupt flags left over from the last run, these clear by writing a 1
+        p_channel->CS = DMA_CS_END_FLAG | DMA_CS_INT_FLAG;
+
+        p_channel->CONBLK_AD = PSP_DMA_Bus_Address(p_control_block);
+
+        // start the channel, the first control block gets loaded from CONBLK_AD
+        p_channel->CS = DMA_CS_WAIT_WRITES_FLAG |
+                        (DEFAULT_PANIC_PRIORITY << DMA_CS_PANIC_PRIORITY_SHIFT_AMT) |
+                        (DEFAULT_PRIORITY << DMA_CS_PRIORITY_SHIFT_AMT) |
+                        DMA_CS_ACTIVE_FLAG;
+    }
+    else
+    {
+        /* invalid channel, do nothing */
+    }
+}
+
+uint32_t PSP_DMA_Is_Busy(uint32_t channel)
+{
+    uint32_t retval = 0u;
+
+    if (is_valid_DMA_channel(channel))
+    {
+        retval = DMA->CHANNEL[channel].CS & DMA_CS_ACTIVE_FLAG;
+    }
+
+    return retval;
+}
+
+uint32_t PSP_DMA_Get_Dest_Address(uint32_t channel)
+{
+    uint32_t retval = 0u;
+
+    if (is_valid_DMA_channel(channel))
+    {
+        retval = DMA->CHANNEL[channel].DEST_AD;
+    }
+
+    return retval;
+}
+
+uint32_t PSP_DMA_Get_Control_Block_Address(uint32_t channel)
+{
+    uint32_t retval = 0u;
+
+    if (is_valid_DMA_channel(channel))
+    {
+        retval = DMA->CHANNEL[channel].CONBLK_AD;
+    }
+
+    return retval;
+}
+
+void PSP_DMA_Clear_Interrupt(uint32_t channel)
+{
+    if (is_valid_DMA_channel(channel))
+    {
+        volatile DMA_Channel_t * p_channel = &DMA->CHANNEL[channel];
+
+        // INT clears by writing a 1, the rest of CS is written back as it is so the channel
+        // keeps running at the same priority, END is left alone
+        p_channel->CS = (p_channel->CS & ~DMA_CS_END_FLAG) | DMA_CS_INT_FLAG;
+    }
+    else
+    {
+        /* invalid channel, do nothing */
+    }
+}
+
+void PSP_DMA_Abort(uint32_t channel)
+{
+    if (is_valid_DMA_channel(channel))
+    {
+        volatile DMA_Channel_t * p_channel = &DMA->CHANNEL[channel];
+
+        // pause the channel, then abort the current control block
+        p_channel->CS &= ~DMA_CS_ACTIVE_FLAG;
+        p_channel->CS |= DMA_CS_ABORT_FLAG;
+
+        DMA_Reset_Channel(channel);
+    }
+    else
+    {
+        /* invalid channel, do nothing */
+    }
+}
+
+void PSP_DMA_Service(void)
+{
+    for (uint32_t channel = 0u; channel < PSP_DMA_NUM_CHANNELS; channel++)
+    {
+        if ((allocated_channels & (1u << channel)) && channel_callbacks[channel])
+        {
+            volatile DMA_Channel_t * p_channel = &DMA->CHANNEL[channel];
+
+            const uint32_t cs = p_channel->CS;
+
+            // END is set at the end of every control block, the chain is only done once the
+            // channel has also gone inactive
+            if ((cs & DMA_CS_END_FLAG) && !(cs & DMA_CS_ACTIVE_FLAG))
+            {
+                p_channel->CS = DMA_CS_END_FLAG | DMA_CS_INT_FLAG;
+                channel_callbacks[channel](channel);
+            }
+        }
+    }
+}
+
+uint32_t PSP_DMA_Bus_Address(const void * p_memory)
+{
+    return (uint32_t)p_memory | BUS_ADDRESS_UNCACHED_ALIAS;
+}
+
+uint32_t PSP_DMA_Peripheral_Bus_Address(uint32_t register_address)
+{
+    return (register_address & PERIPHERAL_OFFSET_MASK) | BUS_ADDRESS_PERIPHERAL_BASE;
+}
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE HELPER FUNCTION DEFINITIONS
+--|----------------------------------------------------------------------------|
+*/
+
+uint32_t is_valid_DMA_channel(uint32_t channel)
+{
+    return (channel < PSP_DMA_NUM_CHANNELS) && (USABLE_CHANNELS_MASK & (1u << channel));
+}
+
+void DMA_Reset_Channel(uint32_t channel)
+{
+    volatile DMA_Channel_t * p_channel = &DMA->CHANNEL[channel];
+
+    p_channel->CS = DMA_CS_RESET_FLAG;
+
+    while (p_channel->CS & DMA_CS_RESET_FLAG)
+    {
+        // wait for the reset to take
+    }
+
+    // clear any latched errors, these clear by writing a 1
+    p_channel->DEBUG = DMA_DEBUG_READ_ERROR_FLAG |
+                       DMA_DEBUG_FIFO_ERROR_FLAG |
+                       DMA_DEBUG_READ_LAST_NOT_SET_FLAG;
+
+    p_channel->CS = DMA_CS_END_FLAG | DMA_CS_INT_FLAG;
+}
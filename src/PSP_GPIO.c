@@ -60,6 +60,27 @@
 */
 #define HIGHEST_BIT_POSITION_IN_A_REGISTER (31u)
 
+/*
+--| NAME: NUM_GPFSEL_REGISTERS
+--| DESCRIPTION: The number of GPFSELn registers in use, 10 pins each
+--| TYPE: uint
+*/
+#define NUM_GPFSEL_REGISTERS ((NUM_GPIO_PINS + NUM_PINS_PER_GPFSEL - 1u) / NUM_PINS_PER_GPFSEL)
+
+/*
+--| NAME: GPFSEL_PIN_MASK
+--| DESCRIPTION: mask for the bits of a single pin in a GPFSELn register
+--| TYPE: uint
+*/
+#define GPFSEL_PIN_MASK (0b111u)
+
+/*
+--| NAME: VALID_PINS_MASK
+--| DESCRIPTION: a 64 bit pin mask with a bit set for every GPIO pin
+--| TYPE: uint64_t
+*/
+#define VALID_PINS_MASK ((1ull << NUM_GPIO_PINS) - 1ull)
+
 /*
 --| NAME: GPIO
 --| DESCRIPTION: pointer to the GPIO register structure
@@ -165,6 +186,24 @@ Assumptions/Limitations:
 ------------------------------------------------------------------------------*/
 uint32_t is_valid_GPIO_pin_mode(GPIO_Pin_Mode_enum pin_mode);
 
+/*------------------------------------------------------------------------------
+Function Name:
+    is_valid_GPIO_port
+
+Function Description:
+    test a given port for validity
+
+Parameters:
+    port: the port to test for validity
+
+Returns:
+    Boolean: true if the given port is valid, else false
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+uint32_t is_valid_GPIO_port(PSP_GPIO_Port_t port);
+
 /*------------------------------------------------------------------------------
 Function Name:
     is_valid_GPIO_edge_type
@@ -197,11 +236,10 @@ void PSP_GPIO_Set_Pin_Mode(uint32_t pin_num, GPIO_Pin_Mode_enum pin_mode)
 
         const uint32_t SHIFT_AMT = (pin_num % NUM_PINS_PER_GPFSEL) * NUM_BITS_USED_PER_PIN_IN_GPFSEL;
 
-        // clear out the old pin mode
-        GPIO->GPFSELn[FSEL_NUMBER] &= ~(0b111u << SHIFT_AMT);
-
-        // write the new pin mode
-        GPIO->GPFSELn[FSEL_NUMBER] |= (pin_mode << SHIFT_AMT);
+        // swap the old pin mode for the new one in a single write, so the pin never passes 
+        // through another mode on the way
+        GPIO->GPFSELn[FSEL_NUMBER] = (GPIO->GPFSELn[FSEL_NUMBER] & ~(GPFSEL_PIN_MASK << SHIFT_AMT)) | 
+                                     (pin_mode << SHIFT_AMT);
     }
     else
     {
@@ -219,13 +257,14 @@ void PSP_GPIO_Write_Pin(uint32_t pin_num, GPIO_Pin_Output_Write_enum value)
         // find the position of the bit in the GPSET/CLR register that controls the pin
         const uint32_t PIN_POSITION = pin_num & HIGHEST_BIT_POSITION_IN_A_REGISTER;
 
+        // GPSET/CLR are write only, and zero bits have no effect, so just write the one bit
         if (value == PSP_GPIO_PIN_WRITE_HIGH)
         {
-            GPIO->GPSETn[SET_OR_CLR_INDEX] |= 1u << PIN_POSITION;
+            GPIO->GPSETn[SET_OR_CLR_INDEX] = 1u << PIN_POSITION;
         }
         else /* it is write LOW */
         {
-            GPIO->GPCLRn[SET_OR_CLR_INDEX] |= 1u << PIN_POSITION;
+            GPIO->GPCLRn[SET_OR_CLR_INDEX] = 1u << PIN_POSITION;
         }
     }
     else
@@ -294,6 +333,101 @@ void PSP_GPIO_Pin_Enable_Edge_Detect(uint32_t pin_num, PSP_GPIO_Edge_Detect_enum
     }
 }
 
+void PSP_GPIO_Set_Pins_Mode(uint64_t pin_mask, GPIO_Pin_Mode_enum pin_mode)
+{
+    if (is_valid_GPIO_pin_mode(pin_mode))
+    {
+        pin_mask &= VALID_PINS_MASK;
+
+        for (uint32_t fsel_number = 0u; fsel_number < NUM_GPFSEL_REGISTERS; fsel_number++)
+        {
+            // the pins of this GPFSELn register, in the low bits
+            const uint32_t fsel_pins = (pin_mask >> (fsel_number * NUM_PINS_PER_GPFSEL)) & 
+                                       ((1u << NUM_PINS_PER_GPFSEL) - 1u);
+
+            if (fsel_pins)
+            {
+                uint32_t clear_bits = 0u;
+                uint32_t mode_bits = 0u;
+
+                for (uint32_t pin = 0u; pin < NUM_PINS_PER_GPFSEL; pin++)
+                {
+                    if (fsel_pins & (1u << pin))
+                    {
+                        const uint32_t SHIFT_AMT = pin * NUM_BITS_USED_PER_PIN_IN_GPFSEL;
+
+                        clear_bits |= GPFSEL_PIN_MASK << SHIFT_AMT;
+                        mode_bits |= pin_mode << SHIFT_AMT;
+                    }
+                }
+
+                GPIO->GPFSELn[fsel_number] = (GPIO->GPFSELn[fsel_number] & ~clear_bits) | mode_bits;
+            }
+        }
+    }
+    else
+    {
+        /* it was an invalid pin mode, do nothing */
+    }
+}
+
+void PSP_GPIO_Port_Set(PSP_GPIO_Port_t port, uint32_t pin_mask)
+{
+    if (is_valid_GPIO_port(port))
+    {
+        GPIO->GPSETn[port] = pin_mask;
+    }
+    else
+    {
+        /* it was an invalid port, do nothing */
+    }
+}
+
+void PSP_GPIO_Port_Clear(PSP_GPIO_Port_t port, uint32_t pin_mask)
+{
+    if (is_valid_GPIO_port(port))
+    {
+        GPIO->GPCLRn[port] = pin_mask;
+    }
+    else
+    {
+        /* it was an invalid port, do nothing */
+    }
+}
+
+void PSP_GPIO_Port_Write(PSP_GPIO_Port_t port, uint32_t pin_mask, uint32_t value)
+{
+    if (is_valid_GPIO_port(port))
+    {
+        GPIO->GPSETn[port] = pin_mask & value;
+        GPIO->GPCLRn[port] = pin_mask & ~value;
+    }
+    else
+    {
+        /* it was an invalid port, do nothing */
+    }
+}
+
+uint32_t PSP_GPIO_Port_Read(PSP_GPIO_Port_t port)
+{
+    uint32_t result = 0u;
+
+    if (is_valid_GPIO_port(port))
+    {
+        result = GPIO->GPLEVn[port];
+    }
+
+    return result;
+}
+
+uint64_t PSP_GPIO_Read_All_Pins(void)
+{
+    const uint32_t levels_0 = GPIO->GPLEVn[PSP_GPIO_PORT_0];
+    const uint32_t levels_1 = GPIO->GPLEVn[PSP_GPIO_PORT_1];
+
+    return ((uint64_t)levels_1 << REGISTER_WIDTH) | levels_0;
+}
+
 PSP_GPIO_Edge_Detect_Reading_enum PSP_GPIO_Event_Detected(uint32_t pin_num)
 {
     PSP_GPIO_Edge_Detect_Reading_enum result;
@@ -332,6 +466,11 @@ uint32_t is_valid_GPIO_pin_mode(GPIO_Pin_Mode_enum pin_mode)
     return 0 <= pin_mode && pin_mode <= PSP_GPIO_MAX_PINMODE_VAL;
 }
 
+uint32_t is_valid_GPIO_port(PSP_GPIO_Port_t port)
+{
+    return port <= PSP_GPIO_PORT_1;
+}
+
 uint32_t is_valid_GPIO_edge_type(PSP_GPIO_Edge_Detect_enum edge)
 {
     return  0 <= edge && edge <= GPIO_MAX_EDGE_TYPE_VAL; 
@@ -18,6 +18,7 @@
 
 #include "PSP_GPIO.h"
 #include "PSP_I2C.h"
+#include "PSP_IRQ.h"
 #include "PSP_REGS.h"
 
 /*
@@ -99,6 +100,23 @@ typedef enum I2C_S_Flags_Enumeration
     I2C_S_TA_FLAG   = (1u << 0u), // TA Transfer Active [r0]
 } I2C_S_Flags_enum;
 
+/*
+--| NAME: I2C_S_END_FLAGS
+--| DESCRIPTION: the status flags that mean the transfer is over
+--| TYPE: uint32_t
+*/
+#define I2C_S_END_FLAGS (I2C_S_DONE_FLAG | I2C_S_ERR_FLAG | I2C_S_CLKT_FLAG)
+
+/*
+--| NAME: I2C_Phase_enum
+--| DESCRIPTION: which part of a queued transaction is on the bus
+*/
+typedef enum I2C_Phase_Enumeration
+{
+    I2C_PHASE_WRITE = 0u,
+    I2C_PHASE_READ  = 1u,
+} I2C_Phase_enum;
+
 /*
 --|----------------------------------------------------------------------------|
 --| PRIVATE CONSTANTS
@@ -113,7 +131,38 @@ typedef enum I2C_S_Flags_Enumeration
 --|----------------------------------------------------------------------------|
 */
 
-/* None */
+/*
+--| NAME: current_xxx
+--| DESCRIPTION: what the address and timing registers hold, all ones until
+--|   they are first written
+--| TYPE: uint32_t
+*/
+static uint32_t current_address               = 0xFFFFFFFFu;
+static uint32_t current_divider               = 0xFFFFFFFFu;
+static uint32_t current_delay                 = 0xFFFFFFFFu;
+static uint32_t current_clock_stretch_timeout = 0xFFFFFFFFu;
+
+/*
+--| NAME: p_queue_head, p_queue_tail
+--| DESCRIPTION: the queued transactions, the head is the one on the bus
+--| TYPE: PSP_I2C_Transaction_t *
+*/
+static PSP_I2C_Transaction_t * volatile p_queue_head = 0;
+static PSP_I2C_Transaction_t * p_queue_tail = 0;
+
+/*
+--| NAME: phase
+--| DESCRIPTION: which part of the head transaction is on the bus
+--| TYPE: I2C_Phase_enum
+*/
+static uint32_t phase;
+
+/*
+--| NAME: num_moved
+--| DESCRIPTION: bytes written or read so far in this phase
+--| TYPE: uint32_t
+*/
+static uint32_t num_moved;
 
 /*
 --|----------------------------------------------------------------------------|
@@ -121,7 +170,156 @@ typedef enum I2C_S_Flags_Enumeration
 --|----------------------------------------------------------------------------|
 */
 
-/* None */
+/*------------------------------------------------------------------------------
+Function Name:
+    I2C_Prepare
+
+Function Description:
+    Get ready for a transfer: empty the FIFO, clear the status flags left
+    over from the last transfer and set the length.
+
+Parameters:
+    num_bytes: the number of bytes in the transfer.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    No transfer can be running.
+------------------------------------------------------------------------------*/
+void I2C_Prepare(uint32_t num_bytes);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    I2C_Fill_FIFO
+
+Function Description:
+    Write bytes to the FIFO for as long as it has room.
+
+Parameters:
+    p_buffer: the bytes to write.
+    num_bytes: the number of bytes left to write.
+
+Returns:
+    uint32_t: the number of bytes written.
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+uint32_t I2C_Fill_FIFO(const uint8_t * p_buffer, uint32_t num_bytes);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    I2C_Empty_FIFO
+
+Function Description:
+    Read bytes from the FIFO for as long as it has any.
+
+Parameters:
+    p_buffer: where to put the bytes.
+    num_bytes: the number of bytes still wanted.
+
+Returns:
+    uint32_t: the number of bytes read.
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+uint32_t I2C_Empty_FIFO(uint8_t * p_buffer, uint32_t num_bytes);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    I2C_Finish
+
+Function Description:
+    Work out how the transfer ended and clear its status flags.
+
+Parameters:
+    None
+
+Returns:
+    PSP_I2C_Status_t: how the transfer ended.
+
+Assumptions/Limitations:
+    Called once the transfer is over.
+------------------------------------------------------------------------------*/
+PSP_I2C_Status_t I2C_Finish(void);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    I2C_Start_Transaction
+
+Function Description:
+    Put a queued transaction on the bus.
+
+Parameters:
+    p_transaction: the transaction.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    The bus must be idle. Called with IRQs masked.
+------------------------------------------------------------------------------*/
+void I2C_Start_Transaction(PSP_I2C_Transaction_t * p_transaction);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    I2C_Start_Read
+
+Function Description:
+    Start the read part of a queued transaction.
+
+Parameters:
+    p_transaction: the transaction.
+    is_repeated_start: true to queue the read behind a write that is still
+    running, so it follows a repeated start. False to start from idle.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    Called with IRQs masked.
+------------------------------------------------------------------------------*/
+void I2C_Start_Read(PSP_I2C_Transaction_t * p_transaction, uint32_t is_repeated_start);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    I2C_Complete_Transaction
+
+Function Description:
+    End the head transaction, start the next one and call the callback.
+
+Parameters:
+    None
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    Called from the interrupt handler.
+------------------------------------------------------------------------------*/
+void I2C_Complete_Transaction(void);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    I2C_IRQ_Handler
+
+Function Description:
+    Move the head transaction along: top up the FIFO on TXW, queue the read
+    once the write is all in, empty the FIFO on RXR and finish on DONE or an
+    error.
+
+Parameters:
+    source: the interrupt source, always PSP_IRQ_SOURCE_I2C.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+void I2C_IRQ_Handler(uint32_t source);
 
 /*
 --|----------------------------------------------------------------------------|
@@ -144,38 +342,233 @@ void PSP_I2C_End(void)
 void PSP_I2C_Set_Clock_Divider(uint32_t divider)
 {
     I2C->DIV = divider;
+    current_divider = divider;
 }
 
 void PSP_I2C_Set_Slave_Address(uint32_t address)
 {
     I2C->A = address;
+    current_address = address;
+}
+
+void PSP_I2C_Device_Init(PSP_I2C_Device_t * p_device, uint32_t address, uint32_t divider)
+{
+    p_device->address = address;
+    p_device->divider = divider;
+    p_device->delay = PSP_I2C_DEFAULT_DELAY;
+    p_device->clock_stretch_timeout = PSP_I2C_DEFAULT_CLOCK_STRETCH_TIMEOUT;
+}
+
+void PSP_I2C_Select_Device(const PSP_I2C_Device_t * p_device)
+{
+    // devices usually share timing, so most changes of device are just the address
+    if (p_device->address != current_address)
+    {
+        I2C->A = p_device->address;
+        current_address = p_device->address;
+    }
+
+    if (p_device->divider != current_divider)
+    {
+        I2C->DIV = p_device->divider;
+        current_divider = p_device->divider;
+    }
+
+    if (p_device->delay != current_delay)
+    {
+        I2C->DEL = p_device->delay;
+        current_delay = p_device->delay;
+    }
+
+    if (p_device->clock_stretch_timeout != current_clock_stretch_timeout)
+    {
+        I2C->CLKT = p_device->clock_stretch_timeout;
+        current_clock_stretch_timeout = p_device->clock_stretch_timeout;
+    }
+}
+
+uint32_t PSP_I2C_Scan(uint8_t * p_addresses, uint32_t max_addresses)
+{
+    uint32_t num_found = 0u;
+
+    for (uint32_t address = PSP_I2C_SCAN_FIRST_ADDRESS; address <= PSP_I2C_SCAN_LAST_ADDRESS; address++)
+    {
+        uint8_t byte;
+
+        PSP_I2C_Set_Slave_Address(address);
+
+        // a device that is there acks its address, an empty address gives ERR
+        if (PSP_I2C_Read(&byte, 1u) == PSP_I2C_Status_OK)
+        {
+            if (num_found < max_addresses)
+            {
+                p_addresses[num_found] = (uint8_t)address;
+            }
+
+            num_found++;
+        }
+    }
+
+    return num_found;
 }
 
 void PSP_I2C_Write_Byte(uint8_t val)
 {
-    // clear the fifo
-    I2C->C |= I2C_C_CLEAR_FIFO << I2C_C_CLEAR_SHIFT_AMT;
+    (void)PSP_I2C_Write(&val, 1u);
+}
 
-    // clear the clock stretch timeout, no acknowledge error, and transfer done status flags 
-    // note that these flags are cleared by writing a 1
-    I2C->S |= I2C_S_CLKT_FLAG | I2C_S_ERR_FLAG | I2C_S_DONE_FLAG;
-    
-    // set data length to 1 byte
-    I2C->DLEN = 1u;
+PSP_I2C_Status_t PSP_I2C_Write(const uint8_t * p_buffer, uint32_t num_bytes)
+{
+    if ((num_bytes == 0u) || (num_bytes > PSP_I2C_MAX_LENGTH))
+    {
+        return PSP_I2C_Status_Invalid_Length;
+    }
+
+    I2C_Prepare(num_bytes);
+
+    // a full FIFO before the start, so the first bytes aren't waited on
+    uint32_t num_sent = I2C_Fill_FIFO(p_buffer, num_bytes);
+
+    // enable device and start transfer, the READ flag must be clear for a write
+    I2C->C = I2C_C_I2CEN_FLAG | I2C_C_ST_FLAG;
+
+    while (!(I2C->S & I2C_S_END_FLAGS))
+    {
+        // top the FIFO back up as the bus takes bytes out
+        num_sent += I2C_Fill_FIFO(&p_buffer[num_sent], num_bytes - num_sent);
+    }
+
+    return I2C_Finish();
+}
+
+PSP_I2C_Status_t PSP_I2C_Read(uint8_t * p_buffer, uint32_t num_bytes)
+{
+    if ((num_bytes == 0u) || (num_bytes > PSP_I2C_MAX_LENGTH))
+    {
+        return PSP_I2C_Status_Invalid_Length;
+    }
+
+    I2C_Prepare(num_bytes);
+
+    I2C->C = I2C_C_I2CEN_FLAG | I2C_C_ST_FLAG | I2C_C_READ_FLAG;
+
+    uint32_t num_received = 0u;
+
+    while (!(I2C->S & I2C_S_END_FLAGS))
+    {
+        // keep the FIFO from filling, the bus stretches the clock when it is full
+        num_received += I2C_Empty_FIFO(&p_buffer[num_received], num_bytes - num_received);
+    }
+
+    // the last bytes can still be in the FIFO when DONE is set
+    (void)I2C_Empty_FIFO(&p_buffer[num_received], num_bytes - num_received);
+
+    return I2C_Finish();
+}
+
+PSP_I2C_Status_t PSP_I2C_Write_Then_Read(const uint8_t * p_write_buffer, 
+                                         uint32_t num_write_bytes, 
+                                         uint8_t * p_read_buffer, 
+                                         uint32_t num_read_bytes)
+{
+    if ((num_write_bytes == 0u) || (num_write_bytes > PSP_I2C_FIFO_SIZE) || 
+        (num_read_bytes == 0u) || (num_read_bytes > PSP_I2C_MAX_LENGTH))
+    {
+        return PSP_I2C_Status_Invalid_Length;
+    }
+
+    I2C_Prepare(num_write_bytes);
+
+    // the whole write fits in the FIFO, nothing needs topping up once it starts
+    (void)I2C_Fill_FIFO(p_write_buffer, num_write_bytes);
+
+    // the read has to be queued before the write finishes, or the controller sends a stop
+    const uint32_t irq_state = PSP_IRQ_Save_And_Disable();
+
+    I2C->C = I2C_C_I2CEN_FLAG | I2C_C_ST_FLAG;
+
+    while (!(I2C->S & (I2C_S_TA_FLAG | I2C_S_END_FLAGS)))
+    {
+        // wait for the write to start
+    }
+
+    // a write that already ended has sent its stop, a read queued now would be a transfer of its own
+    if (I2C->S & I2C_S_END_FLAGS)
+    {
+        PSP_IRQ_Restore(irq_state);
+
+        return I2C_Finish();
+    }
+
+    // with the write under way, a new start is taken as a repeated start once it is done
+    I2C->DLEN = num_read_bytes;
+    I2C->C = I2C_C_I2CEN_FLAG | I2C_C_ST_FLAG | I2C_C_READ_FLAG;
+
+    PSP_IRQ_Restore(irq_state);
 
-    // write the value to the fifo
-    I2C->FIFO = val;
-    
-    // enable device and start transfer
-    I2C->C |= I2C_C_I2CEN_FLAG | I2C_C_ST_FLAG;
+    uint32_t num_received = 0u;
 
-    while (!(I2C->S & I2C_S_DONE_FLAG))
+    while (!(I2C->S & I2C_S_END_FLAGS))
     {
-        // wait for transfer to complete
+        num_received += I2C_Empty_FIFO(&p_read_buffer[num_received], num_read_bytes - num_received);
     }
 
-    // set the done flag inorder to clear it and end the transfer
-    I2C->S |= I2C_S_DONE_FLAG;
+    (void)I2C_Empty_FIFO(&p_read_buffer[num_received], num_read_bytes - num_received);
+
+    return I2C_Finish();
+}
+
+void PSP_I2C_Enable_Interrupts(void)
+{
+    p_queue_head = 0;
+    p_queue_tail = 0;
+
+    PSP_IRQ_Register_Handler(PSP_IRQ_SOURCE_I2C, I2C_IRQ_Handler);
+    PSP_IRQ_Enable_Source(PSP_IRQ_SOURCE_I2C);
+}
+
+uint32_t PSP_I2C_Submit(PSP_I2C_Transaction_t * p_transaction)
+{
+    uint32_t retval = 0u;
+
+    if (((p_transaction->num_write_bytes != 0u) || (p_transaction->num_read_bytes != 0u)) &&
+        (p_transaction->num_write_bytes <= PSP_I2C_MAX_LENGTH) && 
+        (p_transaction->num_read_bytes <= PSP_I2C_MAX_LENGTH))
+    {
+        p_transaction->status = PSP_I2C_Status_OK;
+        p_transaction->is_done = 0u;
+        p_transaction->p_next = 0;
+
+        const uint32_t irq_state = PSP_IRQ_Save_And_Disable();
+
+        if (p_queue_head)
+        {
+            p_queue_tail->p_next = p_transaction;
+            p_queue_tail = p_transaction;
+        }
+        else
+        {
+            p_queue_head = p_transaction;
+            p_queue_tail = p_transaction;
+
+            I2C_Start_Transaction(p_transaction);
+        }
+
+        PSP_IRQ_Restore(irq_state);
+
+        retval = 1u;
+    }
+    else
+    {
+        /* ... do nothing, the lengths are invalid */
+    }
+
+    return retval;
+}
+
+uint32_t PSP_I2C_Is_Busy(void)
+{
+    return (p_queue_head != 0);
 }
 
 /*
@@ -184,4 +577,224 @@ void PSP_I2C_Write_Byte(uint8_t val)
 --|----------------------------------------------------------------------------|
 */
 
-/* None */
+void I2C_Prepare(uint32_t num_bytes)
+{
+    // clear the fifo
+    I2C->C |= I2C_C_CLEAR_FIFO << I2C_C_CLEAR_SHIFT_AMT;
+
+    // clear the clock stretch timeout, no acknowledge error, and transfer done status flags 
+    // note that these flags are cleared by writing a 1
+    I2C->S = I2C_S_CLKT_FLAG | I2C_S_ERR_FLAG | I2C_S_DONE_FLAG;
+
+    I2C->DLEN = num_bytes;
+}
+
+uint32_t I2C_Fill_FIFO(const uint8_t * p_buffer, uint32_t num_bytes)
+{
+    uint32_t i = 0u;
+
+    while ((i < num_bytes) && (I2C->S & I2C_S_TXD_FLAG))
+    {
+        I2C->FIFO = p_buffer[i];
+        i++;
+    }
+
+    return i;
+}
+
+uint32_t I2C_Empty_FIFO(uint8_t * p_buffer, uint32_t num_bytes)
+{
+    uint32_t i = 0u;
+
+    while ((i < num_bytes) && (I2C->S & I2C_S_RXD_FLAG))
+    {
+        p_buffer[i] = (uint8_t)I2C->FIFO;
+        i++;
+    }
+
+    return i;
+}
+
+PSP_I2C_Status_t I2C_Finish(void)
+{
+    PSP_I2C_Status_t retval = PSP_I2C_Status_OK;
+    const uint32_t status = I2C->S;
+
+    if (status & I2C_S_ERR_FLAG)
+    {
+        retval = PSP_I2C_Status_No_Ack;
+    }
+    else if (status & I2C_S_CLKT_FLAG)
+    {
+        retval = PSP_I2C_Status_Clock_Stretch_Timeout;
+    }
+    else
+    {
+        /* ... do nothing, the transfer went through */
+    }
+
+    if (retval != PSP_I2C_Status_OK)
+    {
+        // stop the controller and throw away whatever is left in the FIFO
+        I2C->C = I2C_C_CLEAR_FIFO << I2C_C_CLEAR_SHIFT_AMT;
+    }
+
+    // set the flags in order to clear them and end the transfer
+    I2C->S = I2C_S_CLKT_FLAG | I2C_S_ERR_FLAG | I2C_S_DONE_FLAG;
+
+    return retval;
+}
+
+void I2C_Start_Transaction(PSP_I2C_Transaction_t * p_transaction)
+{
+    PSP_I2C_Select_Device(p_transaction->p_device);
+
+    if (p_transaction->num_write_bytes)
+    {
+        phase = I2C_PHASE_WRITE;
+
+        I2C_Prepare(p_transaction->num_write_bytes);
+        num_moved = I2C_Fill_FIFO(p_transaction->p_write_buffer, p_transaction->num_write_bytes);
+
+        // TXW stays set while the FIFO has room, so only ask for it while there is more to do
+        uint32_t control = I2C_C_I2CEN_FLAG | I2C_C_ST_FLAG | I2C_C_INTD_FLAG;
+
+        if ((num_moved < p_transaction->num_write_bytes) || p_transaction->num_read_bytes)
+        {
+            control |= I2C_C_INTT_FLAG;
+        }
+
+        I2C->C = control;
+    }
+    else
+    {
+        I2C_Start_Read(p_transaction, 0u);
+    }
+}
+
+void I2C_Start_Read(PSP_I2C_Transaction_t * p_transaction, uint32_t is_repeated_start)
+{
+    phase = I2C_PHASE_READ;
+    num_moved = 0u;
+
+    if (is_repeated_start)
+    {
+        // the write's last bytes are still in the FIFO, leave them be
+        I2C->DLEN = p_transaction->num_read_bytes;
+    }
+    else
+    {
+        I2C_Prepare(p_transaction->num_read_bytes);
+    }
+
+    I2C->C = I2C_C_I2CEN_FLAG | I2C_C_ST_FLAG | I2C_C_READ_FLAG | I2C_C_INTR_FLAG | I2C_C_INTD_FLAG;
+}
+
+void I2C_Complete_Transaction(void)
+{
+    PSP_I2C_Transaction_t * p_transaction = p_queue_head;
+
+    p_transaction->status = I2C_Finish();
+
+    if (p_transaction->status == PSP_I2C_Status_OK)
+    {
+        // leave the controller on with its interrupts off, I2C_Finish turns it off after an error
+        I2C->C = I2C_C_I2CEN_FLAG;
+    }
+
+    // keep the bus busy while the callback runs
+    p_queue_head = p_transaction->p_next;
+
+    if (p_queue_head)
+    {
+        I2C_Start_Transaction(p_queue_head);
+    }
+    else
+    {
+        p_queue_tail = 0;
+    }
+
+    p_transaction->is_done = 1u;
+
+    if (p_transaction->callback)
+    {
+        p_transaction->callback(p_transaction);
+    }
+}
+
+void I2C_IRQ_Handler(uint32_t source)
+{
+    (void)source;
+
+    PSP_I2C_Transaction_t * p_transaction = p_queue_head;
+
+    if (!p_transaction)
+    {
+        // nothing queued, turn the interrupts off
+        I2C->C = I2C_C_I2CEN_FLAG;
+        return;
+    }
+
+    const uint32_t status = I2C->S;
+
+    if (status & (I2C_S_ERR_FLAG | I2C_S_CLKT_FLAG))
+    {
+        I2C_Complete_Transaction();
+    }
+    else if (phase == I2C_PHASE_WRITE)
+    {
+        if (status & I2C_S_DONE_FLAG)
+        {
+            // the write is over, if there is a read it was too late for a repeated start
+            if (p_transaction->num_read_bytes)
+            {
+                I2C_Start_Read(p_transaction, 0u);
+            }
+            else
+            {
+                I2C_Complete_Transaction();
+            }
+        }
+        else
+        {
+            num_moved += I2C_Fill_FIFO(&p_transaction->p_write_buffer[num_moved], 
+                                       p_transaction->num_write_bytes - num_moved);
+
+            if (num_moved == p_transaction->num_write_bytes)
+            {
+                if (p_transaction->num_read_bytes)
+                {
+                    // setting ST before the write has started replaces it with the read
+                    if (status & I2C_S_TA_FLAG)
+                    {
+                        // the write is under way, so the read follows it with a repeated start
+                        I2C_Start_Read(p_transaction, 1u);
+                    }
+                    else
+                    {
+                        /* the write hasn't started, INTT stays armed to check again */
+                    }
+                }
+                else
+                {
+                    // all in the FIFO, only DONE is left to wait for
+                    I2C->C = I2C_C_I2CEN_FLAG | I2C_C_INTD_FLAG;
+                }
+            }
+        }
+    }
+    else
+    {
+        num_moved += I2C_Empty_FIFO(&p_transaction->p_read_buffer[num_moved], 
+                                    p_transaction->num_read_bytes - num_moved);
+
+        if (status & I2C_S_DONE_FLAG)
+        {
+            // the last bytes can arrive along with DONE
+            num_moved += I2C_Empty_FIFO(&p_transaction->p_read_buffer[num_moved], 
+                                        p_transaction->num_read_bytes - num_moved);
+
+            I2C_Complete_Transaction();
+        }
+    }
+}
@@ -0,0 +1,437 @@
+/*
+--|----------------------------------------------------------------------------|
+--| FILE DESCRIPTION:
+--|   PSP_IRQ.c provides the register addresses and pointers for the ARM
+--|   interrupt controller and the local interrupt routing, as well as the
+--|   handler table and the implementation for the interrupt functions.
+--|
+--|----------------------------------------------------------------------------|
+--| REFERENCES:
+--|   BCM2837-ARM-Peripherals.pdf page 109
+--|   QA7_rev3.4.pdf pages 13 to 18 (local interrupt routing)
+--|
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--|----------------------------------------------------------------------------|
+--| INCLUDE FILES
+--|----------------------------------------------------------------------------|
+*/
+
+#include "PSP_IRQ.h"
+#include "PSP_Core.h"
+#include "PSP_REGS.h"
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE DEFINES
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--| NAME: IRQ_Controller
+--| DESCRIPTION: pointer to the ARM interrupt controller registers
+--| TYPE: IRQ_Controller_t *
+*/
+#define IRQ_Controller ((volatile IRQ_Controller_t *)PSP_REGS_IRQ_BASE_ADDRESS)
+
+/*
+--| NAME: Local_IRQ
+--| DESCRIPTION: pointer to the ARM local peripheral registers
+--| TYPE: IRQ_Local_t *
+*/
+#define Local_IRQ ((volatile IRQ_Local_t *)PSP_REGS_LOCAL_PERIPHERAL_BASE_ADDRESS)
+
+/*
+--| NAME: IRQ_BASIC_SOURCES_MASK
+--| DESCRIPTION: the bits of the basic registers that are ARM basic sources,
+--|   the rest of the basic pending bits repeat GPU sources
+--| TYPE: uint32_t
+*/
+#define IRQ_BASIC_SOURCES_MASK (0xFFu)
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE TYPES
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--| NAME: IRQ_Controller_t
+--| DESCRIPTION: structure for the ARM interrupt controller registers
+*/
+typedef struct IRQ_Controller_Type
+{
+    vuint32_t BASIC_PENDING;  // IRQ basic pending
+    vuint32_t PENDING_1;      // IRQ pending, sources 0 to 31
+    vuint32_t PENDING_2;      // IRQ pending, sources 32 to 63
+    vuint32_t FIQ_CONTROL;    // FIQ control
+    vuint32_t ENABLE_1;       // Enable IRQs, sources 0 to 31
+    vuint32_t ENABLE_2;       // Enable IRQs, sources 32 to 63
+    vuint32_t ENABLE_BASIC;   // Enable basic IRQs
+    vuint32_t DISABLE_1;      // Disable IRQs, sources 0 to 31
+    vuint32_t DISABLE_2;      // Disable IRQs, sources 32 to 63
+    vuint32_t DISABLE_BASIC;  // Disable basic IRQs
+} IRQ_Controller_t;
+
+/*
+--| NAME: IRQ_Local_t
+--| DESCRIPTION: structure for the ARM local peripheral registers, up to the
+--|   per core interrupt sources
+*/
+typedef struct IRQ_Local_Type
+{
+    vuint32_t CONTROL;                                      // Control register
+    vuint32_t RESERVED_1;
+    vuint32_t CORE_TIMER_PRESCALER;                         // Core timer prescaler
+    vuint32_t GPU_INTERRUPT_ROUTING;                        // GPU interrupts routing
+    vuint32_t PMU_ROUTING_SET;                              // Performance Monitor Interrupts routing-set
+    vuint32_t PMU_ROUTING_CLEAR;                            // Performance Monitor Interrupts routing-clear
+    vuint32_t RESERVED_2;
+    vuint32_t CORE_TIMER_LS;                                // Core timer access LS 32 bits
+    vuint32_t CORE_TIMER_MS;                                // Core timer access MS 32 bits
+    vuint32_t LOCAL_INTERRUPT_ROUTING;                      // Local Interrupt 0 [1-7] routing
+    vuint32_t RESERVED_3;
+    vuint32_t AXI_OUTSTANDING_COUNTERS;                     // Axi outstanding counters
+    vuint32_t AXI_OUTSTANDING_IRQ;                          // Axi outstanding IRQ
+    vuint32_t LOCAL_TIMER_CONTROL;                          // Local timer control & status
+    vuint32_t LOCAL_TIMER_WRITE_FLAGS;                      // Local timer write flags
+    vuint32_t RESERVED_4;
+    vuint32_t CORE_TIMER_IRQ_CONTROL[PSP_CORE_NUM_CORES];   // Core n timers Interrupt control
+    vuint32_t CORE_MAILBOX_IRQ_CONTROL[PSP_CORE_NUM_CORES]; // Core n Mailboxes Interrupt control
+    vuint32_t CORE_IRQ_SOURCE[PSP_CORE_NUM_CORES];          // Core n IRQ Source
+    vuint32_t CORE_FIQ_SOURCE[PSP_CORE_NUM_CORES];          // Core n FIQ Source
+} IRQ_Local_t;
+
+/*
+--| NAME: IRQ_Local_Source_Bits_enum
+--| DESCRIPTION: bit numbers of the per core IRQ source register
+*/
+typedef enum IRQ_Local_Source_Bits_Enumeration
+{
+    IRQ_LOCAL_SOURCE_CORE_TIMERS  = 0u,  // 4 bits, one per core timer
+    IRQ_LOCAL_SOURCE_MAILBOXES    = 4u,  // 4 bits, one per mailbox
+    IRQ_LOCAL_SOURCE_GPU          = 8u,  // one of the GPU or basic sources
+    IRQ_LOCAL_SOURCE_PMU          = 9u,  // performance monitor
+} IRQ_Local_Source_Bits_enum;
+
+/*
+--| NAME: IRQ_CPSR_Flags_enum
+--| DESCRIPTION: Current Program Status Register bits
+*/
+typedef enum IRQ_CPSR_Flags_Enumeration
+{
+    IRQ_CPSR_I_FLAG = (1u << 7u), // IRQs masked
+} IRQ_CPSR_Flags_enum;
+
+/*
+--| NAME: IRQ_GPU_Routing_Masks_enum
+--| DESCRIPTION: fields of the GPU interrupts routing register
+*/
+typedef enum IRQ_GPU_Routing_Masks_Enumeration
+{
+    IRQ_GPU_ROUTING_IRQ_MASK = 0x3u, // the core GPU IRQs go to
+} IRQ_GPU_Routing_Masks_enum;
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE CONSTANTS
+--|----------------------------------------------------------------------------|
+*/
+
+/* None */
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE VARIABLES
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--| NAME: irq_handlers
+--| DESCRIPTION: the handler of each interrupt source, 0 for none
+--| TYPE: PSP_IRQ_Handler_t[]
+*/
+static PSP_IRQ_Handler_t irq_handlers[PSP_IRQ_NUM_SOURCES];
+
+/*
+--| NAME: enabled_gpu_sources, enabled_basic_sources
+--| DESCRIPTION: copies of the enabled GPU and basic sources, the pending
+--|   registers also show sources that are not enabled
+--| TYPE: uint32_t[], uint32_t
+*/
+static uint32_t enabled_gpu_sources[2];
+static uint32_t enabled_basic_sources;
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE HELPER FUNCTION PROTOTYPES
+--|----------------------------------------------------------------------------|
+*/
+
+/*------------------------------------------------------------------------------
+Function Name:
+    IRQ_Call_Handlers
+
+Function Description:
+    Call the handler of each source in a pending bit mask, lowest bit first.
+
+Parameters:
+    pending: the pending bits.
+    first_source: the source number of bit 0.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+void IRQ_Call_Handlers(uint32_t pending, uint32_t first_source);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    IRQ_Set_Local_Source
+
+Function Description:
+    Enable or disable a local source for the calling core.
+
+Parameters:
+    local_bit: the bit of the source in the core's IRQ source register.
+    enable: true to enable, false to disable.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    Sources other than the core timers, mailboxes and PMU are ignored.
+------------------------------------------------------------------------------*/
+void IRQ_Set_Local_Source(uint32_t local_bit, uint32_t enable);
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC FUNCTION DEFINITIONS
+--|----------------------------------------------------------------------------|
+*/
+
+void PSP_IRQ_Init(void)
+{
+    IRQ_Controller->DISABLE_1 = 0xFFFFFFFFu;
+    IRQ_Controller->DISABLE_2 = 0xFFFFFFFFu;
+    IRQ_Controller->DISABLE_BASIC = IRQ_BASIC_SOURCES_MASK;
+    IRQ_Controller->FIQ_CONTROL = 0u;
+
+    enabled_gpu_sources[0] = 0u;
+    enabled_gpu_sources[1] = 0u;
+    enabled_basic_sources = 0u;
+
+    for (uint32_t source = 0u; source < PSP_IRQ_NUM_SOURCES; source++)
+    {
+        irq_handlers[source] = 0;
+    }
+
+    // GPU IRQs and FIQs both to core 0
+    Local_IRQ->GPU_INTERRUPT_ROUTING = 0u;
+}
+
+void PSP_IRQ_Register_Handler(uint32_t source, PSP_IRQ_Handler_t handler)
+{
+    if (source < PSP_IRQ_NUM_SOURCES)
+    {
+        irq_handlers[source] = handler;
+    }
+}
+
+void PSP_IRQ_Enable_Source(uint32_t source)
+{
+    if (source < PSP_IRQ_BASIC_FIRST_SOURCE)
+    {
+        const uint32_t bit = 1u << (source % 32u);
+
+        if (source < 32u)
+        {
+            enabled_gpu_sources[0] |= bit;
+            IRQ_Controller->ENABLE_1 = bit;
+        }
+        else
+        {
+            enabled_gpu_sources[1] |= bit;
+            IRQ_Controller->ENABLE_2 = bit;
+        }
+    }
+    else if (source < PSP_IRQ_LOCAL_FIRST_SOURCE)
+    {
+        const uint32_t bit = 1u << (source - PSP_IRQ_BASIC_FIRST_SOURCE);
+
+        enabled_basic_sources |= bit;
+        IRQ_Controller->ENABLE_BASIC = bit;
+    }
+    else if (source < PSP_IRQ_NUM_SOURCES)
+    {
+        IRQ_Set_Local_Source(source - PSP_IRQ_LOCAL_FIRST_SOURCE, 1u);
+    }
+    else
+    {
+        /* invalid source, do nothing */
+    }
+}
+
+void PSP_IRQ_Disable_Source(uint32_t source)
+{
+    if (source < PSP_IRQ_BASIC_FIRST_SOURCE)
+    {
+        const uint32_t bit = 1u << (source % 32u);
+
+        if (source < 32u)
+        {
+            enabled_gpu_sources[0] &= ~bit;
+            IRQ_Controller->DISABLE_1 = bit;
+        }
+        else
+        {
+            enabled_gpu_sources[1] &= ~bit;
+            IRQ_Controller->DISABLE_2 = bit;
+        }
+    }
+    else if (source < PSP_IRQ_LOCAL_FIRST_SOURCE)
+    {
+        const uint32_t bit = 1u << (source - PSP_IRQ_BASIC_FIRST_SOURCE);
+
+        enabled_basic_sources &= ~bit;
+        IRQ_Controller->DISABLE_BASIC = bit;
+    }
+    else if (source < PSP_IRQ_NUM_SOURCES)
+    {
+        IRQ_Set_Local_Source(source - PSP_IRQ_LOCAL_FIRST_SOURCE, 0u);
+    }
+    else
+    {
+        /* invalid source, do nothing */
+    }
+}
+
+void PSP_IRQ_Route_GPU_To_Core(uint32_t core_id)
+{
+    if (core_id < PSP_CORE_NUM_CORES)
+    {
+        Local_IRQ->GPU_INTERRUPT_ROUTING = (Local_IRQ->GPU_INTERRUPT_ROUTING & ~IRQ_GPU_ROUTING_IRQ_MASK) | core_id;
+    }
+}
+
+void PSP_IRQ_Enable(void)
+{
+    __asm__ volatile ("cpsie i" : : : "memory");
+}
+
+void PSP_IRQ_Disable(void)
+{
+    __asm__ volatile ("cpsid i" : : : "memory");
+}
+
+uint32_t PSP_IRQ_Save_And_Disable(void)
+{
+    uint32_t cpsr;
+
+    __asm__ volatile ("mrs %0, cpsr\n\tcpsid i" : "=r" (cpsr) : : "memory");
+
+    return cpsr & IRQ_CPSR_I_FLAG;
+}
+
+void PSP_IRQ_Restore(uint32_t state)
+{
+    if (!(state & IRQ_CPSR_I_FLAG))
+    {
+        __asm__ volatile ("cpsie i" : : : "memory");
+    }
+}
+
+void PSP_IRQ_Dispatch(void)
+{
+    uint32_t local_pending = Local_IRQ->CORE_IRQ_SOURCE[PSP_Core_Get_ID()];
+
+    // the GPU bit only says one of the GPU or basic sources is pending, find which
+    if (local_pending & (1u << IRQ_LOCAL_SOURCE_GPU))
+    {
+        local_pending &= ~(1u << IRQ_LOCAL_SOURCE_GPU);
+
+        IRQ_Call_Handlers(IRQ_Controller->PENDING_1 & enabled_gpu_sources[0], PSP_IRQ_GPU_FIRST_SOURCE);
+        IRQ_Call_Handlers(IRQ_Controller->PENDING_2 & enabled_gpu_sources[1], PSP_IRQ_GPU_FIRST_SOURCE + 32u);
+        IRQ_Call_Handlers(IRQ_Controller->BASIC_PENDING & enabled_basic_sources, PSP_IRQ_BASIC_FIRST_SOURCE);
+    }
+
+    IRQ_Call_Handlers(local_pending, PSP_IRQ_LOCAL_FIRST_SOURCE);
+}
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE HELPER FUNCTION DEFINITIONS
+--|----------------------------------------------------------------------------|
+*/
+
+void IRQ_Call_Handlers(uint32_t pending, uint32_t first_source)
+{
+    while (pending)
+    {
+        const uint32_t source = first_source + (uint32_t)__builtin_ctz(pending);
+
+        // clear the lowest set bit
+        pending &= pending - 1u;
+
+        if (irq_handlers[source])
+        {
+            irq_handlers[source](source);
+        }
+        else
+        {
+            // nobody will clear it, stop it from firing forever
+            PSP_IRQ_Disable_Source(source);
+        }
+    }
+}
+
+void IRQ_Set_Local_Source(uint32_t local_bit, uint32_t enable)
+{
+    const uint32_t core_id = PSP_Core_Get_ID();
+
+    if (local_bit < IRQ_LOCAL_SOURCE_MAILBOXES)
+    {
+        const uint32_t bit = 1u << (local_bit - IRQ_LOCAL_SOURCE_CORE_TIMERS);
+
+        if (enable)
+        {
+            Local_IRQ->CORE_TIMER_IRQ_CONTROL[core_id] |= bit;
+        }
+        else
+        {
+            Local_IRQ->CORE_TIMER_IRQ_CONTROL[core_id] &= ~bit;
+        }
+    }
+    else if (local_bit < IRQ_LOCAL_SOURCE_GPU)
+    {
+        const uint32_t bit = 1u << (local_bit - IRQ_LOCAL_SOURCE_MAILBOXES);
+
+        if (enable)
+        {
+            Local_IRQ->CORE_MAILBOX_IRQ_CONTROL[core_id] |= bit;
+        }
+        else
+        {
+            Local_IRQ->CORE_MAILBOX_IRQ_CONTROL[core_id] &= ~bit;
+        }
+    }
+    else if (local_bit == IRQ_LOCAL_SOURCE_PMU)
+    {
+        if (enable)
+        {
+            Local_IRQ->PMU_ROUTING_SET = (1u << core_id);
+        }
+        else
+        {
+            Local_IRQ->PMU_ROUTING_CLEAR = (1u << core_id);
+        }
+    }
+    else
+    {
+        /* the GPU source is always on, AXI and local timer are not supported, do nothing */
+    }
+}
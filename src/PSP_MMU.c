@@ -0,0 +1,434 @@
+/*
+--|----------------------------------------------------------------------------|
+--| FILE DESCRIPTION:
+--|   PSP_MMU.c provides the translation table and the coprocessor 15
+--|   accesses for turning on the MMU and caches, as well as the data cache
+--|   maintenance by address functions.
+--|
+--|----------------------------------------------------------------------------|
+--| REFERENCES:
+--|   ARM Architecture Reference Manual ARMv7-A, B3.5 (short descriptors)
+--|   ARM Architecture Reference Manual ARMv7-A, B4.2 (cache maintenance)
+--|   Cortex-A53 MPCore Technical Reference Manual, 4.3 (AArch32 registers)
+--|
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--|----------------------------------------------------------------------------|
+--| INCLUDE FILES
+--|----------------------------------------------------------------------------|
+*/
+
+#include "PSP_MMU.h"
+#include "PSP_REGS.h"
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE DEFINES
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--| NAME: MMU_NUM_SECTIONS
+--| DESCRIPTION: the number of 1 MB sections covering the 4 GB address space
+--| TYPE: uint32_t
+*/
+#define MMU_NUM_SECTIONS (4096u)
+
+/*
+--| NAME: MMU_SECTION_SHIFT_AMT
+--| DESCRIPTION: shift from a section number to its base address
+--| TYPE: uint32_t
+*/
+#define MMU_SECTION_SHIFT_AMT (20u)
+
+/*
+--| NAME: MMU_TRANSLATION_TABLE_ALIGNMENT
+--| DESCRIPTION: TTBR0 needs the table aligned to its own size, 16 KB
+--| TYPE: uint32_t
+*/
+#define MMU_TRANSLATION_TABLE_ALIGNMENT (16384u)
+
+/*
+--| NAME: MMU_ALL_CACHE_LEVELS
+--| DESCRIPTION: passed to MMU_Invalidate_Data_Caches to go up to the point of
+--|   coherency, the most levels CLIDR can describe is 7
+--| TYPE: uint32_t
+*/
+#define MMU_ALL_CACHE_LEVELS (7u)
+
+/*
+--| NAME: MMU_DOMAINS_ALL_CLIENT
+--| DESCRIPTION: DACR value making all 16 domains check the access permissions
+--|   in the translation table
+--| TYPE: uint32_t
+*/
+#define MMU_DOMAINS_ALL_CLIENT (0x55555555u)
+
+/*
+--| NAME: MMU_SECTION_NORMAL
+--| DESCRIPTION: section attributes for RAM, normal memory, inner and outer
+--|   write back write allocate, shareable so the other cores see it coherently
+--| TYPE: uint32_t
+*/
+#define MMU_SECTION_NORMAL (MMU_SECTION_DESCRIPTOR | \
+                            MMU_SECTION_AP_FULL_ACCESS | \
+                            MMU_SECTION_TEX_0_FLAG | \
+                            MMU_SECTION_C_FLAG | \
+                            MMU_SECTION_B_FLAG | \
+                            MMU_SECTION_S_FLAG)
+
+/*
+--| NAME: MMU_SECTION_DEVICE
+--| DESCRIPTION: section attributes for peripherals, shareable device memory
+--|   that can not be executed from
+--| TYPE: uint32_t
+*/
+#define MMU_SECTION_DEVICE (MMU_SECTION_DESCRIPTOR | \
+                            MMU_SECTION_AP_FULL_ACCESS | \
+                            MMU_SECTION_B_FLAG | \
+                            MMU_SECTION_XN_FLAG)
+
+/*
+--| NAME: MMU_DSB, MMU_ISB
+--| DESCRIPTION: data synchronization and instruction synchronization barriers
+--| TYPE: macro
+*/
+#define MMU_DSB() __asm__ volatile ("dsb" : : : "memory")
+#define MMU_ISB() __asm__ volatile ("isb" : : : "memory")
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE TYPES
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--| NAME: MMU_Section_Flags_enum
+--| DESCRIPTION: bits of a short descriptor section entry
+*/
+typedef enum MMU_Section_Flags_Enumeration
+{
+    MMU_SECTION_DESCRIPTOR     = (2u << 0u),  // entry type, 1 MB section
+    MMU_SECTION_B_FLAG         = (1u << 2u),  // bufferable
+    MMU_SECTION_C_FLAG         = (1u << 3u),  // cacheable
+    MMU_SECTION_XN_FLAG        = (1u << 4u),  // execute never
+    MMU_SECTION_AP_FULL_ACCESS = (3u << 10u), // read/write at all privilege levels
+    MMU_SECTION_TEX_0_FLAG     = (1u << 12u), // with C and B, write back write allocate
+    MMU_SECTION_S_FLAG         = (1u << 16u), // shareable
+} MMU_Section_Flags_enum;
+
+/*
+--| NAME: MMU_SCTLR_Flags_enum
+--| DESCRIPTION: System Control Register bits
+*/
+typedef enum MMU_SCTLR_Flags_Enumeration
+{
+    MMU_SCTLR_M_FLAG = (1u << 0u),  // MMU enable
+    MMU_SCTLR_A_FLAG = (1u << 1u),  // alignment fault checking
+    MMU_SCTLR_C_FLAG = (1u << 2u),  // data and unified cache enable
+    MMU_SCTLR_Z_FLAG = (1u << 11u), // branch prediction enable
+    MMU_SCTLR_I_FLAG = (1u << 12u), // instruction cache enable
+} MMU_SCTLR_Flags_enum;
+
+/*
+--| NAME: MMU_TTBR0_Flags_enum
+--| DESCRIPTION: Translation Table Base Register 0 attribute bits, the
+--|   cacheability of the table walks themselves
+*/
+typedef enum MMU_TTBR0_Flags_Enumeration
+{
+    MMU_TTBR0_S_FLAG         = (1u << 1u), // shareable
+    MMU_TTBR0_RGN_WBWA_FLAG  = (1u << 3u), // outer write back write allocate
+    MMU_TTBR0_IRGN_WBWA_FLAG = (1u << 6u), // inner write back write allocate
+} MMU_TTBR0_Flags_enum;
+
+/*
+--| NAME: MMU_Cache_Masks_enum
+--| DESCRIPTION: fields of the cache ID registers
+*/
+typedef enum MMU_Cache_Masks_Enumeration
+{
+    MMU_CTR_DMINLINE_MASK        = 0xFu,   // log2 of the smallest data cache line in words
+    MMU_CTR_DMINLINE_SHIFT_AMT   = 16u,
+    MMU_CLIDR_CTYPE_MASK         = 0x7u,   // cache type at each level
+    MMU_CLIDR_CTYPE_BITS         = 3u,
+    MMU_CLIDR_LOC_MASK           = 0x7u,   // level of coherency
+    MMU_CLIDR_LOC_SHIFT_AMT      = 24u,
+    MMU_CCSIDR_LINE_SIZE_MASK    = 0x7u,   // log2 of the line size in words, minus 2
+    MMU_CCSIDR_WAYS_MASK         = 0x3FFu, // number of ways, minus 1
+    MMU_CCSIDR_WAYS_SHIFT_AMT    = 3u,
+    MMU_CCSIDR_SETS_MASK         = 0x7FFFu, // number of sets, minus 1
+    MMU_CCSIDR_SETS_SHIFT_AMT    = 13u,
+} MMU_Cache_Masks_enum;
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE CONSTANTS
+--|----------------------------------------------------------------------------|
+*/
+
+/* None */
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE VARIABLES
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--| NAME: translation_table
+--| DESCRIPTION: the level 1 translation table, one entry per 1 MB section
+--| TYPE: uint32_t[]
+*/
+static uint32_t translation_table[MMU_NUM_SECTIONS]
+    __attribute__((aligned(MMU_TRANSLATION_TABLE_ALIGNMENT)));
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE HELPER FUNCTION PROTOTYPES
+--|----------------------------------------------------------------------------|
+*/
+
+/*------------------------------------------------------------------------------
+Function Name:
+    MMU_Invalidate_Data_Caches
+
+Function Description:
+    Invalidate the data and unified caches by set/way, so nothing left over 
+    from before reset can be hit once the caches are turned on.
+
+Parameters:
+    num_levels: how many cache levels to invalidate, starting from L1. Levels
+    past the point of coherency are never touched.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    Must only be called with the data cache off, dirty lines are thrown away.
+    The L2 cache is shared by all cores, so only core 0 may invalidate it.
+------------------------------------------------------------------------------*/
+void MMU_Invalidate_Data_Caches(uint32_t num_levels);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    MMU_Enable
+
+Function Description:
+    Invalidate the instruction cache, branch predictor and TLBs, point the 
+    calling core at the translation table, then turn on the MMU, caches and
+    branch prediction.
+
+Parameters:
+    None
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    The translation table must already be built and in memory.
+------------------------------------------------------------------------------*/
+void MMU_Enable(void);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    MMU_Data_Cache_Line_Size
+
+Function Description:
+    Get the smallest data cache line size of any cache in the system.
+
+Parameters:
+    None
+
+Returns:
+    uint32_t: the line size in bytes.
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+uint32_t MMU_Data_Cache_Line_Size(void);
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC FUNCTION DEFINITIONS
+--|----------------------------------------------------------------------------|
+*/
+
+void PSP_MMU_Init(void)
+{
+    // flat map, RAM is cacheable and everything from the peripherals up is device memory
+    for (uint32_t section = 0u; section < MMU_NUM_SECTIONS; section++)
+    {
+        const uint32_t address = section << MMU_SECTION_SHIFT_AMT;
+
+        if (address < PSP_REGS_PERIPHERAL_BASE_ADDRESS)
+        {
+            translation_table[section] = address | MMU_SECTION_NORMAL;
+        }
+        else
+        {
+            translation_table[section] = address | MMU_SECTION_DEVICE;
+        }
+    }
+
+    // nothing from before reset can be left in the caches
+    MMU_Invalidate_Data_Caches(MMU_ALL_CACHE_LEVELS);
+
+    MMU_Enable();
+}
+
+void PSP_MMU_Init_Secondary_Core(void)
+{
+    // the L2 cache is shared and already in use by core 0, only this core's L1 is invalidated
+    MMU_Invalidate_Data_Caches(1u);
+
+    MMU_Enable();
+}
+
+uint32_t PSP_MMU_Is_Enabled(void)
+{
+    uint32_t sctlr;
+
+    __asm__ volatile ("mrc p15, 0, %0, c1, c0, 0" : "=r" (sctlr));
+
+    return (sctlr & MMU_SCTLR_M_FLAG) ? 1u : 0u;
+}
+
+void PSP_MMU_Clean_Data_Cache(const void * p_start, uint32_t num_bytes)
+{
+    const uint32_t line_size = MMU_Data_Cache_Line_Size();
+    const uint32_t end = (uint32_t)p_start + num_bytes;
+
+    for (uint32_t address = (uint32_t)p_start & ~(line_size - 1u); address < end; address += line_size)
+    {
+        __asm__ volatile ("mcr p15, 0, %0, c7, c10, 1" : : "r" (address) : "memory"); // DCCMVAC
+    }
+
+    MMU_DSB();
+}
+
+void PSP_MMU_Invalidate_Data_Cache(const void * p_start, uint32_t num_bytes)
+{
+    const uint32_t line_size = MMU_Data_Cache_Line_Size();
+    const uint32_t end = (uint32_t)p_start + num_bytes;
+
+    for (uint32_t address = (uint32_t)p_start & ~(line_size - 1u); address < end; address += line_size)
+    {
+        __asm__ volatile ("mcr p15, 0, %0, c7, c6, 1" : : "r" (address) : "memory"); // DCIMVAC
+    }
+
+    MMU_DSB();
+}
+
+void PSP_MMU_Clean_And_Invalidate_Data_Cache(const void * p_start, uint32_t num_bytes)
+{
+    const uint32_t line_size = MMU_Data_Cache_Line_Size();
+    const uint32_t end = (uint32_t)p_start + num_bytes;
+
+    for (uint32_t address = (uint32_t)p_start & ~(line_size - 1u); address < end; address += line_size)
+    {
+        __asm__ volatile ("mcr p15, 0, %0, c7, c14, 1" : : "r" (address) : "memory"); // DCCIMVAC
+    }
+
+    MMU_DSB();
+}
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE HELPER FUNCTION DEFINITIONS
+--|----------------------------------------------------------------------------|
+*/
+
+void MMU_Invalidate_Data_Caches(uint32_t num_levels)
+{
+    uint32_t clidr;
+
+    __asm__ volatile ("mrc p15, 1, %0, c0, c0, 1" : "=r" (clidr)); // CLIDR
+
+    uint32_t level_of_coherency = (clidr >> MMU_CLIDR_LOC_SHIFT_AMT) & MMU_CLIDR_LOC_MASK;
+
+    if (num_levels < level_of_coherency)
+    {
+        level_of_coherency = num_levels;
+    }
+
+    for (uint32_t level = 0u; level < level_of_coherency; level++)
+    {
+        const uint32_t cache_type = (clidr >> (level * MMU_CLIDR_CTYPE_BITS)) & MMU_CLIDR_CTYPE_MASK;
+
+        // 0 is no cache, 1 is instruction cache only
+        if (cache_type < 2u)
+        {
+            continue;
+        }
+
+        uint32_t ccsidr;
+
+        __asm__ volatile ("mcr p15, 2, %0, c0, c0, 0" : : "r" (level << 1u)); // CSSELR
+        MMU_ISB();
+        __asm__ volatile ("mrc p15, 1, %0, c0, c0, 0" : "=r" (ccsidr));       // CCSIDR
+
+        const uint32_t line_shift = (ccsidr & MMU_CCSIDR_LINE_SIZE_MASK) + 4u;
+        const uint32_t max_way = (ccsidr >> MMU_CCSIDR_WAYS_SHIFT_AMT) & MMU_CCSIDR_WAYS_MASK;
+        const uint32_t max_set = (ccsidr >> MMU_CCSIDR_SETS_SHIFT_AMT) & MMU_CCSIDR_SETS_MASK;
+
+        // the way number sits in the top bits of the set/way operand
+        const uint32_t way_shift = max_way ? (uint32_t)__builtin_clz(max_way) : 0u;
+
+        for (uint32_t way = 0u; way <= max_way; way++)
+        {
+            for (uint32_t set = 0u; set <= max_set; set++)
+            {
+                const uint32_t set_way = (way << way_shift) | (set << line_shift) | (level << 1u);
+
+                __asm__ volatile ("mcr p15, 0, %0, c7, c6, 2" : : "r" (set_way)); // DCISW
+            }
+        }
+    }
+
+    MMU_DSB();
+}
+
+void MMU_Enable(void)
+{
+    __asm__ volatile ("mcr p15, 0, %0, c7, c5, 0" : : "r" (0u)); // ICIALLU
+    __asm__ volatile ("mcr p15, 0, %0, c7, c5, 6" : : "r" (0u)); // BPIALL
+    __asm__ volatile ("mcr p15, 0, %0, c8, c7, 0" : : "r" (0u)); // TLBIALL
+
+    MMU_DSB();
+
+    const uint32_t ttbr0 = (uint32_t)translation_table |
+                           MMU_TTBR0_S_FLAG |
+                           MMU_TTBR0_RGN_WBWA_FLAG |
+                           MMU_TTBR0_IRGN_WBWA_FLAG;
+
+    __asm__ volatile ("mcr p15, 0, %0, c3, c0, 0" : : "r" (MMU_DOMAINS_ALL_CLIENT)); // DACR
+    __asm__ volatile ("mcr p15, 0, %0, c2, c0, 2" : : "r" (0u));                     // TTBCR, TTBR0 only
+    __asm__ volatile ("mcr p15, 0, %0, c2, c0, 0" : : "r" (ttbr0));                  // TTBR0
+
+    MMU_ISB();
+
+    uint32_t sctlr;
+
+    __asm__ volatile ("mrc p15, 0, %0, c1, c0, 0" : "=r" (sctlr));
+
+    // unaligned accesses are fine in normal memory, don't fault on them
+    sctlr &= ~MMU_SCTLR_A_FLAG;
+    sctlr |= MMU_SCTLR_M_FLAG | MMU_SCTLR_C_FLAG | MMU_SCTLR_Z_FLAG | MMU_SCTLR_I_FLAG;
+
+    __asm__ volatile ("mcr p15, 0, %0, c1, c0, 0" : : "r" (sctlr) : "memory");
+
+    MMU_ISB();
+}
+
+uint32_t MMU_Data_Cache_Line_Size(void)
+{
+    uint32_t ctr;
+
+    __asm__ volatile ("mrc p15, 0, %0, c0, c0, 1" : "=r" (ctr)); // CTR
+
+    // DminLine is in words
+    return 4u << ((ctr >> MMU_CTR_DMINLINE_SHIFT_AMT) & MMU_CTR_DMINLINE_MASK);
+}
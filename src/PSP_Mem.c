@@ -0,0 +1,405 @@
+/*
+--|----------------------------------------------------------------------------|
+--| FILE DESCRIPTION:
+--|   PSP_Mem.c provides the implementation for the heap, arenas and pools.
+--|
+--|----------------------------------------------------------------------------|
+--| REFERENCES:
+--|   see PSP_Mem.h
+--|
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--|----------------------------------------------------------------------------|
+--| INCLUDE FILES
+--|----------------------------------------------------------------------------|
+*/
+
+#include "PSP_Mem.h"
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE DEFINES
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--| NAME: MEM_IS_POWER_OF_2
+--| DESCRIPTION: true if a non zero value is a power of 2
+--| TYPE: uint32_t
+*/
+#define MEM_IS_POWER_OF_2(value) ((value) && !((value) & ((value) - 1u)))
+
+/*
+--| NAME: MEM_ALIGN_UP
+--| DESCRIPTION: round a value up to a power of 2 alignment
+--| TYPE: uint32_t
+*/
+#define MEM_ALIGN_UP(value, alignment) (((value) + (alignment) - 1u) & ~((alignment) - 1u))
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE TYPES
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--| NAME: Mem_Free_Block_t
+--| DESCRIPTION: the link stored in the first word of a free pool block
+*/
+typedef struct Mem_Free_Block_Type
+{
+    struct Mem_Free_Block_Type * p_next; // next free block, 0 at the end
+} Mem_Free_Block_t;
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE CONSTANTS
+--|----------------------------------------------------------------------------|
+*/
+
+/* None */
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE VARIABLES
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--| NAME: __heap_start, __heap_end
+--| DESCRIPTION: the bounds of the heap, from linker.ld
+--| TYPE: uint8_t[]
+*/
+extern uint8_t __heap_start[];
+extern uint8_t __heap_end[];
+
+/*
+--| NAME: p_heap_next
+--| DESCRIPTION: the first heap byte not yet handed out
+--| TYPE: uint8_t *
+*/
+static uint8_t * p_heap_next = __heap_start;
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE HELPER FUNCTION PROTOTYPES
+--|----------------------------------------------------------------------------|
+*/
+
+/*------------------------------------------------------------------------------
+Function Name:
+    Mem_Pool_Owns
+
+Function Description:
+    Check whether a block lies in a pool's buffer.
+
+Parameters:
+    p_pool: the pool.
+    p_block: the block.
+
+Returns:
+    uint32_t: true if the block is in the pool's buffer.
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+uint32_t Mem_Pool_Owns(const PSP_Mem_Pool_t * p_pool, const void * p_block);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    Mem_Core_Pools_Reclaim
+
+Function Description:
+    Take back every block other cores have freed to a core's pool.
+
+Parameters:
+    p_core_pools: the core pools.
+    core_id: the core, which must be the calling core.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    The core's free list must be empty. Each reclaimed block is walked once,
+    to count it, so the cost per block stays O(1).
+------------------------------------------------------------------------------*/
+void Mem_Core_Pools_Reclaim(PSP_Mem_Core_Pools_t * p_core_pools, uint32_t core_id);
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC FUNCTION DEFINITIONS
+--|----------------------------------------------------------------------------|
+*/
+
+void * PSP_Mem_Heap_Alloc(uint32_t num_bytes, uint32_t alignment)
+{
+    void * retval = 0;
+
+    if (MEM_IS_POWER_OF_2(alignment))
+    {
+        const uint32_t start = MEM_ALIGN_UP((uint32_t)p_heap_next, alignment);
+
+        if ((start >= (uint32_t)p_heap_next) && (num_bytes <= ((uint32_t)__heap_end - start)))
+        {
+            retval = (void *)start;
+            p_heap_next = (uint8_t *)(start + num_bytes);
+        }
+        else
+        {
+            /* ... do nothing, the heap is out of memory */
+        }
+    }
+    else
+    {
+        /* ... do nothing */
+    }
+
+    return retval;
+}
+
+uint32_t PSP_Mem_Heap_Get_Free(void)
+{
+    return (uint32_t)(__heap_end - p_heap_next);
+}
+
+void PSP_Mem_Arena_Init(PSP_Mem_Arena_t * p_arena, void * p_buffer, uint32_t size)
+{
+    p_arena->p_start = (uint8_t *)p_buffer;
+    p_arena->size = p_buffer ? size : 0u;
+    p_arena->used = 0u;
+    p_arena->high_water = 0u;
+}
+
+void * PSP_Mem_Arena_Alloc(PSP_Mem_Arena_t * p_arena, uint32_t num_bytes, uint32_t alignment)
+{
+    void * retval = 0;
+
+    if (MEM_IS_POWER_OF_2(alignment))
+    {
+        // align the address rather than the offset, the buffer may be less aligned than asked for
+        const uint32_t next = (uint32_t)p_arena->p_start + p_arena->used;
+        const uint32_t offset = p_arena->used + (MEM_ALIGN_UP(next, alignment) - next);
+
+        if ((offset <= p_arena->size) && (num_bytes <= (p_arena->size - offset)))
+        {
+            retval = p_arena->p_start + offset;
+            p_arena->used = offset + num_bytes;
+
+            if (p_arena->used > p_arena->high_water)
+            {
+                p_arena->high_water = p_arena->used;
+            }
+        }
+        else
+        {
+            /* ... do nothing, the arena is full */
+        }
+    }
+    else
+    {
+        /* ... do nothing */
+    }
+
+    return retval;
+}
+
+void PSP_Mem_Arena_Reset(PSP_Mem_Arena_t * p_arena)
+{
+    p_arena->used = 0u;
+}
+
+uint32_t PSP_Mem_Arena_Get_High_Water(const PSP_Mem_Arena_t * p_arena)
+{
+    return p_arena->high_water;
+}
+
+uint32_t PSP_Mem_Pool_Init(PSP_Mem_Pool_t * p_pool, void * p_buffer, uint32_t block_size, uint32_t num_blocks)
+{
+    uint32_t retval = 0u;
+
+    if (p_buffer && !((uint32_t)p_buffer & (PSP_MEM_POOL_ALIGNMENT - 1u)) && block_size && num_blocks)
+    {
+        p_pool->block_size = MEM_ALIGN_UP(block_size, PSP_MEM_POOL_ALIGNMENT);
+        p_pool->p_start = (uint8_t *)p_buffer;
+        p_pool->p_end = p_pool->p_start + (p_pool->block_size * num_blocks);
+        p_pool->num_used = 0u;
+        p_pool->high_water = 0u;
+
+        // link the blocks in address order, so the first ones handed out are at the start
+        Mem_Free_Block_t * p_next = 0;
+
+        for (uint8_t * p_block = p_pool->p_end; p_block != p_pool->p_start; )
+        {
+            p_block -= p_pool->block_size;
+            ((Mem_Free_Block_t *)p_block)->p_next = p_next;
+            p_next = (Mem_Free_Block_t *)p_block;
+        }
+
+        p_pool->p_free = p_next;
+
+        retval = 1u;
+    }
+    else
+    {
+        /* ... do nothing */
+    }
+
+    return retval;
+}
+
+void * PSP_Mem_Pool_Alloc(PSP_Mem_Pool_t * p_pool)
+{
+    Mem_Free_Block_t * p_block = (Mem_Free_Block_t *)p_pool->p_free;
+
+    if (p_block)
+    {
+        p_pool->p_free = p_block->p_next;
+        p_pool->num_used++;
+
+        if (p_pool->num_used > p_pool->high_water)
+        {
+            p_pool->high_water = p_pool->num_used;
+        }
+    }
+    else
+    {
+        /* ... do nothing, every block is in use */
+    }
+
+    return p_block;
+}
+
+void PSP_Mem_Pool_Free(PSP_Mem_Pool_t * p_pool, void * p_block)
+{
+    if (p_block)
+    {
+        ((Mem_Free_Block_t *)p_block)->p_next = (Mem_Free_Block_t *)p_pool->p_free;
+        p_pool->p_free = p_block;
+        p_pool->num_used--;
+    }
+    else
+    {
+        /* ... do nothing */
+    }
+}
+
+uint32_t PSP_Mem_Pool_Get_High_Water(const PSP_Mem_Pool_t * p_pool)
+{
+    return p_pool->high_water;
+}
+
+uint32_t PSP_Mem_Core_Pools_Init(PSP_Mem_Core_Pools_t * p_core_pools, uint32_t block_size, uint32_t num_blocks)
+{
+    uint32_t retval = 0u;
+
+    if (block_size && num_blocks)
+    {
+        retval = 1u;
+
+        for (uint32_t core_id = 0u; core_id < PSP_CORE_NUM_CORES; core_id++)
+        {
+            void * p_buffer = PSP_Mem_Heap_Alloc(PSP_MEM_POOL_BUFFER_SIZE(block_size, num_blocks), PSP_MEM_POOL_ALIGNMENT);
+
+            p_core_pools->p_remote_free[core_id] = 0;
+
+            if (!PSP_Mem_Pool_Init(&p_core_pools->pools[core_id], p_buffer, block_size, num_blocks))
+            {
+                retval = 0u;
+            }
+        }
+    }
+    else
+    {
+        /* ... do nothing */
+    }
+
+    return retval;
+}
+
+void * PSP_Mem_Core_Pools_Alloc(PSP_Mem_Core_Pools_t * p_core_pools)
+{
+    const uint32_t core_id = PSP_Core_Get_ID();
+    PSP_Mem_Pool_t * p_pool = &p_core_pools->pools[core_id];
+
+    if (!p_pool->p_free)
+    {
+        Mem_Core_Pools_Reclaim(p_core_pools, core_id);
+    }
+
+    return PSP_Mem_Pool_Alloc(p_pool);
+}
+
+void PSP_Mem_Core_Pools_Free(PSP_Mem_Core_Pools_t * p_core_pools, void * p_block)
+{
+    const uint32_t core_id = PSP_Core_Get_ID();
+
+    if (!p_block)
+    {
+        /* ... do nothing */
+    }
+    else if (Mem_Pool_Owns(&p_core_pools->pools[core_id], p_block))
+    {
+        PSP_Mem_Pool_Free(&p_core_pools->pools[core_id], p_block);
+    }
+    else
+    {
+        for (uint32_t owner = 0u; owner < PSP_CORE_NUM_CORES; owner++)
+        {
+            if (Mem_Pool_Owns(&p_core_pools->pools[owner], p_block))
+            {
+                Mem_Free_Block_t * p_free = (Mem_Free_Block_t *)p_block;
+                void ** p_head = &p_core_pools->p_remote_free[owner];
+
+                // push with LDREX/STREX, the release orders the link before the block is published
+                p_free->p_next = __atomic_load_n(p_head, __ATOMIC_RELAXED);
+
+                while (!__atomic_compare_exchange_n(p_head, (void **)&p_free->p_next, p_free, 1,
+                                                    __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+                {
+                    /* ... the head moved, p_next now holds the new head, try again */
+                }
+            }
+        }
+    }
+}
+
+uint32_t PSP_Mem_Core_Pools_Get_High_Water(const PSP_Mem_Core_Pools_t * p_core_pools, uint32_t core_id)
+{
+    uint32_t retval = 0u;
+
+    if (core_id < PSP_CORE_NUM_CORES)
+    {
+        retval = PSP_Mem_Pool_Get_High_Water(&p_core_pools->pools[core_id]);
+    }
+
+    return retval;
+}
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE HELPER FUNCTION DEFINITIONS
+--|----------------------------------------------------------------------------|
+*/
+
+uint32_t Mem_Pool_Owns(const PSP_Mem_Pool_t * p_pool, const void * p_block)
+{
+    return ((const uint8_t *)p_block >= p_pool->p_start) && ((const uint8_t *)p_block < p_pool->p_end);
+}
+
+void Mem_Core_Pools_Reclaim(PSP_Mem_Core_Pools_t * p_core_pools, uint32_t core_id)
+{
+    PSP_Mem_Pool_t * p_pool = &p_core_pools->pools[core_id];
+
+    // only the owner takes the list, and always all of it, so pushes never see a reused head
+    Mem_Free_Block_t * p_list = __atomic_exchange_n((Mem_Free_Block_t **)&p_core_pools->p_remote_free[core_id],
+                                                    (Mem_Free_Block_t *)0, __ATOMIC_ACQUIRE);
+
+    p_pool->p_free = p_list;
+
+    for (Mem_Free_Block_t * p_block = p_list; p_block; p_block = p_block->p_next)
+    {
+        p_pool->num_used--;
+    }
+}
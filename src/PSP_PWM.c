@@ -17,7 +17,10 @@
 */
 
 #include "PSP_Clock_Manager.h"
+#include "PSP_DMA.h"
 #include "PSP_GPIO.h"
+#include "PSP_IRQ.h"
+#include "PSP_MMU.h"
 #include "PSP_PWM.h"
 #include "PSP_REGS.h"
 
@@ -34,6 +37,42 @@
 */
 #define PWM ((volatile PWM_t *)PSP_REGS_PWM_BASE_ADDRESS)
 
+/*
+--| NAME: PWM_FIFO_ADDRESS
+--| DESCRIPTION: ARM address of the PWM FIFO register, the DMA target
+--| TYPE: uint32_t
+*/
+#define PWM_FIFO_ADDRESS (PSP_REGS_PWM_BASE_ADDRESS + 0x18u)
+
+/*
+--| NAME: STREAM_BLOCK_WORDS
+--| DESCRIPTION: FIFO words in a stream block, one per sample
+--| TYPE: uint32_t
+*/
+#define STREAM_BLOCK_WORDS (PSP_PWM_STREAM_BLOCK_FRAMES * 2u)
+
+/*
+--| NAME: STREAM_NO_BLOCK
+--| DESCRIPTION: returned instead of a block when there is none
+--| TYPE: uint32_t
+*/
+#define STREAM_NO_BLOCK (PSP_PWM_STREAM_NUM_BLOCKS)
+
+/*
+--| NAME: DMA_FIFO_THRESHOLD
+--| DESCRIPTION: the PWM asks for DMA while the FIFO holds fewer words than
+--|   this, out of 8
+--| TYPE: uint32_t
+*/
+#define DMA_FIFO_THRESHOLD (7u)
+
+/*
+--| NAME: SERIALIZER_BITS_PER_WORD
+--| DESCRIPTION: the range in serializer mode, the bits sent from each word
+--| TYPE: uint32_t
+*/
+#define SERIALIZER_BITS_PER_WORD (32u)
+
 /*
 --|----------------------------------------------------------------------------|
 --| PRIVATE TYPES
@@ -102,6 +141,17 @@ typedef enum PWM_STA_Flags_Enumeration
     PWM_STA_FULL1_FLAG = (1u << 0u),  // Fifo Full Flag [rw]
 } PWM_STA_Flags_enum;
 
+/*
+--| NAME: PWM_DMAC_Masks_enum
+--| DESCRIPTION: PWM DMA Configuration register flags and masks
+*/
+typedef enum PWM_DMAC_Masks_Enumeration
+{
+    PWM_DMAC_ENAB_FLAG       = (1u << 31u), // DMA Enable [rw]
+    PWM_DMAC_PANIC_SHIFT_AMT = 8u,          // position of the PANIC threshold [8 bits]
+    PWM_DMAC_DREQ_SHIFT_AMT  = 0u,          // position of the DREQ threshold [8 bits]
+} PWM_DMAC_Masks_enum;
+
 /*
 --|----------------------------------------------------------------------------|
 --| PRIVATE CONSTANTS
@@ -116,7 +166,86 @@ typedef enum PWM_STA_Flags_Enumeration
 --|----------------------------------------------------------------------------|
 */
 
-/* None */
+/*
+--| NAME: stream_dma_channel
+--| DESCRIPTION: the DMA channel feeding the FIFO
+--| TYPE: uint32_t
+*/
+static uint32_t stream_dma_channel = PSP_DMA_NO_CHANNEL;
+
+/*
+--| NAME: stream_control_blocks
+--| DESCRIPTION: one control block per stream block, the last links back to
+--|   the first so the DMA never stops
+--| TYPE: PSP_DMA_Control_Block_t[]
+*/
+static PSP_DMA_Control_Block_t stream_control_blocks[PSP_PWM_STREAM_NUM_BLOCKS];
+
+/*
+--| NAME: stream_words
+--| DESCRIPTION: the stream blocks as FIFO words, left and right in turn,
+--|   cache line aligned so cleaning a block never touches anything else
+--| TYPE: uint32_t[][]
+*/
+static uint32_t stream_words[PSP_PWM_STREAM_NUM_BLOCKS][STREAM_BLOCK_WORDS] __attribute__((aligned(64)));
+
+/*
+--| NAME: stream_silence_word
+--| DESCRIPTION: the middle of the range, a silent block reads this word over
+--|   and over instead of a buffer
+--| TYPE: uint32_t
+*/
+static uint32_t stream_silence_word __attribute__((aligned(64)));
+
+/*
+--| NAME: stream_range
+--| DESCRIPTION: the range of both channels, samples are scaled to it
+--| TYPE: uint32_t
+*/
+static uint32_t stream_range;
+
+/*
+--| NAME: stream_is_block_queued
+--| DESCRIPTION: set by PSP_PWM_Stream_Write_Block, cleared by the interrupt
+--|   handler once the block has played
+--| TYPE: vuint32_t[]
+*/
+static vuint32_t stream_is_block_queued[PSP_PWM_STREAM_NUM_BLOCKS];
+
+/*
+--| NAME: stream_next_block
+--| DESCRIPTION: the block PSP_PWM_Stream_Write_Block fills next
+--| TYPE: uint32_t
+*/
+static uint32_t stream_next_block;
+
+/*
+--| NAME: stream_finishing_block
+--| DESCRIPTION: the block the interrupt handler expects to finish next
+--| TYPE: uint32_t
+*/
+static uint32_t stream_finishing_block;
+
+/*
+--| NAME: stream_num_underruns
+--| DESCRIPTION: times a queued block was followed by one that wasn't
+--| TYPE: vuint32_t
+*/
+static vuint32_t stream_num_underruns;
+
+/*
+--| NAME: serializer_dma_channel
+--| DESCRIPTION: the DMA channel feeding the FIFO in serializer mode
+--| TYPE: uint32_t
+*/
+static uint32_t serializer_dma_channel = PSP_DMA_NO_CHANNEL;
+
+/*
+--| NAME: serializer_control_block
+--| DESCRIPTION: the control block for a serializer write
+--| TYPE: PSP_DMA_Control_Block_t
+*/
+static PSP_DMA_Control_Block_t serializer_control_block;
 
 /*
 --|----------------------------------------------------------------------------|
@@ -124,7 +253,83 @@ typedef enum PWM_STA_Flags_Enumeration
 --|----------------------------------------------------------------------------|
 */
 
-/* None */
+/*------------------------------------------------------------------------------
+Function Name:
+    PWM_Stream_Set_Block_Source
+
+Function Description:
+    Point a block's control block at its words, or at the silence word, and
+    clean it from the cache for the DMA.
+
+Parameters:
+    block: the block.
+    is_silent: true to play silence, false to play the block's words.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    The block must not be the one playing.
+------------------------------------------------------------------------------*/
+void PWM_Stream_Set_Block_Source(uint32_t block, uint32_t is_silent);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PWM_Stream_Get_Playing_Block
+
+Function Description:
+    Find the block the DMA is playing from its current control block.
+
+Parameters:
+    None
+
+Returns:
+    uint32_t: the block.
+
+Assumptions/Limitations:
+    The stream must be running.
+------------------------------------------------------------------------------*/
+uint32_t PWM_Stream_Get_Playing_Block(void);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PWM_Stream_Get_Write_Block
+
+Function Description:
+    Pick the block PSP_PWM_Stream_Write_Block writes next. Normally that is
+    the block after the last one queued, but never the block playing or the
+    block after it, which the DMA loads the moment the playing one ends.
+
+Parameters:
+    None
+
+Returns:
+    uint32_t: the block, or STREAM_NO_BLOCK if the ring is full.
+
+Assumptions/Limitations:
+    The stream must be running.
+------------------------------------------------------------------------------*/
+uint32_t PWM_Stream_Get_Write_Block(void);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    PWM_Stream_IRQ_Handler
+
+Function Description:
+    Called at the end of each block. Turns every block that has finished
+    back to silence and counts an underrun when a queued block is followed
+    by one that isn't.
+
+Parameters:
+    source: the interrupt source, unused.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+void PWM_Stream_IRQ_Handler(uint32_t source);
 
 /*
 --|----------------------------------------------------------------------------|
@@ -213,10 +418,313 @@ void PSP_PWM_Ch2_Set_GPIO19_To_PWM_Mode(void)
     PSP_GPIO_Set_Pin_Mode(19u, PSP_GPIO_PINMODE_ALT5); 
 }
 
+uint32_t PSP_PWM_Stream_Start(uint32_t range)
+{
+    uint32_t retval = 0u;
+
+    if (stream_dma_channel == PSP_DMA_NO_CHANNEL)
+    {
+        stream_dma_channel = PSP_DMA_Channel_Allocate();
+    }
+
+    // only channels 0 to 12 have an interrupt of their own
+    if ((stream_dma_channel != PSP_DMA_NO_CHANNEL) &&
+        ((PSP_IRQ_SOURCE_DMA_0 + stream_dma_channel) > PSP_IRQ_SOURCE_DMA_12))
+    {
+        PSP_DMA_Channel_Free(stream_dma_channel);
+        stream_dma_channel = PSP_DMA_NO_CHANNEL;
+    }
+
+    if (stream_dma_channel != PSP_DMA_NO_CHANNEL)
+    {
+        const uint32_t irq_source = PSP_IRQ_SOURCE_DMA_0 + stream_dma_channel;
+
+        PSP_DMA_Abort(stream_dma_channel);
+
+        stream_range = range;
+        stream_silence_word = range / 2u;
+        PSP_MMU_Clean_Data_Cache(&stream_silence_word, sizeof(stream_silence_word));
+
+        // TI and the source are filled in by PWM_Stream_Set_Block_Source
+        for (uint32_t block = 0u; block < PSP_PWM_STREAM_NUM_BLOCKS; block++)
+        {
+            PSP_DMA_Set_Control_Block(&stream_control_blocks[block],
+                                      0u,
+                                      0u,
+                                      PSP_DMA_Peripheral_Bus_Address(PWM_FIFO_ADDRESS),
+                                      STREAM_BLOCK_WORDS * sizeof(uint32_t));
+        }
+
+        PSP_DMA_Link_Control_Blocks(stream_control_blocks, PSP_PWM_STREAM_NUM_BLOCKS, 1u);
+
+        for (uint32_t block = 0u; block < PSP_PWM_STREAM_NUM_BLOCKS; block++)
+        {
+            stream_is_block_queued[block] = 0u;
+            PWM_Stream_Set_Block_Source(block, 1u);
+        }
+
+        stream_next_block = 0u;
+        stream_finishing_block = 0u;
+        stream_num_underruns = 0u;
+
+        // stop both channels and empty the FIFO before the DMA starts filling it
+        PWM->CTL = 0u;
+        PWM->CTL = PWM_CTL_CLRF1_FLAG;
+        PWM->RNG1 = range;
+        PWM->RNG2 = range;
+        PWM->DMAC = PWM_DMAC_ENAB_FLAG |
+                    (DMA_FIFO_THRESHOLD << PWM_DMAC_PANIC_SHIFT_AMT) |
+                    (DMA_FIFO_THRESHOLD << PWM_DMAC_DREQ_SHIFT_AMT);
+
+        PSP_IRQ_Register_Handler(irq_source, PWM_Stream_IRQ_Handler);
+        PSP_IRQ_Enable_Source(irq_source);
+
+        PSP_DMA_Start(stream_dma_channel, &stream_control_blocks[0]);
+
+        // with both channels on the FIFO the words go to channel 1 and channel 2 in turn
+        PWM->CTL = PWM_CTL_MSEN1_FLAG | PWM_CTL_USEF1_FLAG | PWM_CTL_PWEN1_FLAG |
+                   PWM_CTL_MSEN2_FLAG | PWM_CTL_USEF2_FLAG | PWM_CTL_PWEN2_FLAG;
+
+        retval = 1u;
+    }
+
+    return retval;
+}
+
+void PSP_PWM_Stream_Stop(void)
+{
+    if (stream_dma_channel != PSP_DMA_NO_CHANNEL)
+    {
+        PWM->CTL = 0u;
+        PWM->DMAC = 0u;
+
+        PSP_IRQ_Disable_Source(PSP_IRQ_SOURCE_DMA_0 + stream_dma_channel);
+        PSP_DMA_Channel_Free(stream_dma_channel);
+        stream_dma_channel = PSP_DMA_NO_CHANNEL;
+    }
+    else
+    {
+        /* not running, do nothing */
+    }
+}
+
+uint32_t PSP_PWM_Stream_Write_Block(const int16_t * p_frames)
+{
+    uint32_t retval = 0u;
+
+    if (stream_dma_channel != PSP_DMA_NO_CHANNEL)
+    {
+        uint32_t converted_block = STREAM_NO_BLOCK;
+        uint32_t block = PWM_Stream_Get_Write_Block();
+
+        // the DMA may move on while the samples are converted, so the block is picked again
+        // afterwards and only queued if it is still clear of the DMA. A block that isn't queued
+        // plays the silence word, so converting into its words is safe whatever the DMA does
+        while ((block != STREAM_NO_BLOCK) && (block != converted_block))
+        {
+            uint32_t * p_words = stream_words[block];
+
+            // move the signed samples up to [0, 65535] then scale them to [0, range)
+            for (uint32_t i = 0u; i < STREAM_BLOCK_WORDS; i++)
+            {
+                p_words[i] = ((uint32_t)((int32_t)p_frames[i] + 32768) * stream_range) >> 16u;
+            }
+
+            PSP_MMU_Clean_Data_Cache(p_words, STREAM_BLOCK_WORDS * sizeof(uint32_t));
+
+            converted_block = block;
+            block = PWM_Stream_Get_Write_Block();
+        }
+
+        if (block != STREAM_NO_BLOCK)
+        {
+            PWM_Stream_Set_Block_Source(block, 0u);
+
+            stream_is_block_queued[block] = 1u;
+            stream_next_block = (block + 1u) % PSP_PWM_STREAM_NUM_BLOCKS;
+
+            retval = 1u;
+        }
+    }
+
+    return retval;
+}
+
+uint32_t PSP_PWM_Stream_Get_Num_Queued_Blocks(void)
+{
+    uint32_t num_queued = 0u;
+
+    for (uint32_t block = 0u; block < PSP_PWM_STREAM_NUM_BLOCKS; block++)
+    {
+        num_queued += stream_is_block_queued[block];
+    }
+
+    return num_queued;
+}
+
+uint32_t PSP_PWM_Stream_Get_Num_Underruns(void)
+{
+    return stream_num_underruns;
+}
+
+uint32_t PSP_PWM_Serializer_Start(PSP_PWM_Channel_t channel)
+{
+    uint32_t retval = 0u;
+
+    if (serializer_dma_channel == PSP_DMA_NO_CHANNEL)
+    {
+        serializer_dma_channel = PSP_DMA_Channel_Allocate();
+    }
+
+    if (serializer_dma_channel != PSP_DMA_NO_CHANNEL)
+    {
+        // channel 2 has the same flags as channel 1, 8 bits up
+        const uint32_t shift_amt = (channel == PSP_PWM_Channel_1) ? 0u : 8u;
+
+        // the silence bit and repeat last data stay clear, so the output idles low
+        const uint32_t channel_flags = PWM_CTL_MODE1_FLAG | PWM_CTL_USEF1_FLAG | PWM_CTL_PWEN1_FLAG;
+
+        PWM->CTL &= ~(0xFFu << shift_amt);
+        PWM->CTL |= PWM_CTL_CLRF1_FLAG;
+
+        if (channel == PSP_PWM_Channel_1)
+        {
+            PWM->RNG1 = SERIALIZER_BITS_PER_WORD;
+        }
+        else
+        {
+            PWM->RNG2 = SERIALIZER_BITS_PER_WORD;
+        }
+
+        PWM->DMAC = PWM_DMAC_ENAB_FLAG |
+                    (DMA_FIFO_THRESHOLD << PWM_DMAC_PANIC_SHIFT_AMT) |
+                    (DMA_FIFO_THRESHOLD << PWM_DMAC_DREQ_SHIFT_AMT);
+
+        PWM->CTL |= channel_flags << shift_amt;
+
+        retval = 1u;
+    }
+
+    return retval;
+}
+
+uint32_t PSP_PWM_Serializer_Write(const uint32_t * p_words, uint32_t num_words)
+{
+    uint32_t retval = 0u;
+
+    const uint32_t length = num_words * sizeof(uint32_t);
+
+    if ((serializer_dma_channel != PSP_DMA_NO_CHANNEL) &&
+        !PSP_PWM_Serializer_Is_Busy() &&
+        !(PSP_DMA_Channel_Is_Lite(serializer_dma_channel) && (length > PSP_DMA_LITE_MAX_TRANSFER_LENGTH)))
+    {
+        PSP_DMA_Set_Control_Block(&serializer_control_block,
+                                  PSP_DMA_TI_DEST_DREQ_FLAG |
+                                  PSP_DMA_TI_WAIT_RESP_FLAG |
+                                  PSP_DMA_TI_SRC_INC_FLAG |
+                                  (PSP_DMA_PERIPHERAL_PWM << PSP_DMA_TI_PERMAP_SHIFT_AMT),
+                                  PSP_DMA_Bus_Address(p_words),
+                                  PSP_DMA_Peripheral_Bus_Address(PWM_FIFO_ADDRESS),
+                                  length);
+
+        PSP_MMU_Clean_Data_Cache(p_words, length);
+        PSP_MMU_Clean_Data_Cache(&serializer_control_block, sizeof(serializer_control_block));
+
+        PSP_DMA_Start(serializer_dma_channel, &serializer_control_block);
+
+        retval = 1u;
+    }
+
+    return retval;
+}
+
+uint32_t PSP_PWM_Serializer_Is_Busy(void)
+{
+    return PSP_DMA_Is_Busy(serializer_dma_channel) || !(PWM->STA & PWM_STA_EMPT1_FLAG);
+}
+
 /*
 --|----------------------------------------------------------------------------|
 --| PRIVATE HELPER FUNCTION DEFINITIONS
 --|----------------------------------------------------------------------------|
 */
 
-/* None */
+void PWM_Stream_Set_Block_Source(uint32_t block, uint32_t is_silent)
+{
+    PSP_DMA_Control_Block_t * p_control_block = &stream_control_blocks[block];
+
+    const uint32_t transfer_info = PSP_DMA_TI_DEST_DREQ_FLAG |
+                                   PSP_DMA_TI_WAIT_RESP_FLAG |
+                                   PSP_DMA_TI_INTEN_FLAG |
+                                   (PSP_DMA_PERIPHERAL_PWM << PSP_DMA_TI_PERMAP_SHIFT_AMT);
+
+    if (is_silent)
+    {
+        p_control_block->TI = transfer_info;
+        p_control_block->SOURCE_AD = PSP_DMA_Bus_Address(&stream_silence_word);
+    }
+    else
+    {
+        p_control_block->TI = transfer_info | PSP_DMA_TI_SRC_INC_FLAG;
+        p_control_block->SOURCE_AD = PSP_DMA_Bus_Address(stream_words[block]);
+    }
+
+    PSP_MMU_Clean_Data_Cache(p_control_block, sizeof(PSP_DMA_Control_Block_t));
+}
+
+uint32_t PWM_Stream_Get_Playing_Block(void)
+{
+    const uint32_t first_address = PSP_DMA_Bus_Address(&stream_control_blocks[0]);
+    const uint32_t current_address = PSP_DMA_Get_Control_Block_Address(stream_dma_channel);
+
+    return ((current_address - first_address) / sizeof(PSP_DMA_Control_Block_t)) % PSP_PWM_STREAM_NUM_BLOCKS;
+}
+
+uint32_t PWM_Stream_Get_Write_Block(void)
+{
+    const uint32_t playing_block = PWM_Stream_Get_Playing_Block();
+    const uint32_t loading_block = (playing_block + 1u) % PSP_PWM_STREAM_NUM_BLOCKS;
+
+    uint32_t block = stream_next_block;
+
+    // after an underrun, or if the interrupt for the block that just ended hasn't been taken
+    // yet, the next block may be the one playing silence. If only the playing block is left
+    // the next block is the one the DMA loads next. Either way start two blocks on
+    if ((PSP_PWM_Stream_Get_Num_Queued_Blocks() == 0u) ||
+        ((block == playing_block) && !stream_is_block_queued[playing_block]) ||
+        (block == loading_block))
+    {
+        block = (playing_block + 2u) % PSP_PWM_STREAM_NUM_BLOCKS;
+    }
+
+    return stream_is_block_queued[block] ? STREAM_NO_BLOCK : block;
+}
+
+void PWM_Stream_IRQ_Handler(uint32_t source)
+{
+    (void)source;
+
+    PSP_DMA_Clear_Interrupt(stream_dma_channel);
+
+    const uint32_t playing_block = PWM_Stream_Get_Playing_Block();
+
+    // more than one block can have ended if the interrupt was held off
+    while (stream_finishing_block != playing_block)
+    {
+        const uint32_t block = stream_finishing_block;
+        const uint32_t next_block = (block + 1u) % PSP_PWM_STREAM_NUM_BLOCKS;
+
+        if (stream_is_block_queued[block])
+        {
+            PWM_Stream_Set_Block_Source(block, 1u);
+            stream_is_block_queued[block] = 0u;
+
+            if (!stream_is_block_queued[next_block])
+            {
+                stream_num_underruns++;
+            }
+        }
+
+        stream_finishing_block = next_block;
+    }
+}
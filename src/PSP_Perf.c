@@ -0,0 +1,353 @@
+/*
+--|----------------------------------------------------------------------------|
+--| FILE DESCRIPTION:
+--|   PSP_Perf.c provides the coprocessor 15 accesses for the Performance
+--|   Monitor Unit, as well as the implementation for the region statistics
+--|   and the dump.
+--|
+--|----------------------------------------------------------------------------|
+--| REFERENCES:
+--|   Cortex-A53 MPCore Technical Reference Manual, chapter 12 (PMU)
+--|   ARM Architecture Reference Manual ARMv7-A, C12 (Performance Monitors)
+--|
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--|----------------------------------------------------------------------------|
+--| INCLUDE FILES
+--|----------------------------------------------------------------------------|
+*/
+
+#include "PSP_Perf.h"
+#include "PSP_Aux_Mini_UART.h"
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE DEFINES
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--| NAME: PERF_NUM_EVENT_COUNTERS
+--| DESCRIPTION: the event counters used, all counters but the cycle counter
+--| TYPE: uint32_t
+*/
+#define PERF_NUM_EVENT_COUNTERS (PSP_PERF_NUM_COUNTERS - 1u)
+
+/*
+--| NAME: PERF_CYCLE_COUNTER_ENABLE_FLAG
+--| DESCRIPTION: the cycle counter bit of PMCNTENSET, the event counters are
+--|   bits 0 to 5
+--| TYPE: uint32_t
+*/
+#define PERF_CYCLE_COUNTER_ENABLE_FLAG (1u << 31u)
+
+/*
+--| NAME: PERF_ISB
+--| DESCRIPTION: instruction synchronization barrier, makes a PMSELR write
+--|   take effect before the selected counter is accessed
+--| TYPE: macro
+*/
+#define PERF_ISB() __asm__ volatile ("isb" : : : "memory")
+
+/*
+--| NAME: PERF_DECIMAL_DIGITS
+--| DESCRIPTION: the most decimal digits in a uint64_t
+--| TYPE: uint32_t
+*/
+#define PERF_DECIMAL_DIGITS (20u)
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE TYPES
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--| NAME: Perf_PMCR_Flags_enum
+--| DESCRIPTION: Performance Monitors Control Register bits
+*/
+typedef enum Perf_PMCR_Flags_Enumeration
+{
+    PERF_PMCR_E_FLAG = (1u << 0u), // enable all counters
+    PERF_PMCR_P_FLAG = (1u << 1u), // reset the event counters
+    PERF_PMCR_C_FLAG = (1u << 2u), // reset the cycle counter
+    PERF_PMCR_D_FLAG = (1u << 3u), // cycle counter counts every 64th cycle
+} Perf_PMCR_Flags_enum;
+
+/*
+--| NAME: Perf_Event_enum
+--| DESCRIPTION: Cortex-A53 PMU event numbers
+*/
+typedef enum Perf_Event_Enumeration
+{
+    PERF_EVENT_L1I_CACHE_REFILL = 0x01u,
+    PERF_EVENT_L1D_CACHE_REFILL = 0x03u,
+    PERF_EVENT_INST_RETIRED     = 0x08u,
+    PERF_EVENT_BR_MIS_PRED      = 0x10u,
+    PERF_EVENT_L2D_CACHE_REFILL = 0x17u,
+} Perf_Event_enum;
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE CONSTANTS
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--| NAME: perf_events
+--| DESCRIPTION: the event counted by each event counter, counter n counts
+--|   PSP_Perf_Counter_t n + 1
+--| TYPE: uint32_t[]
+*/
+static const uint32_t perf_events[PERF_NUM_EVENT_COUNTERS] =
+{
+    PERF_EVENT_INST_RETIRED,
+    PERF_EVENT_L1D_CACHE_REFILL,
+    PERF_EVENT_L1I_CACHE_REFILL,
+    PERF_EVENT_L2D_CACHE_REFILL,
+    PERF_EVENT_BR_MIS_PRED,
+};
+
+/*
+--| NAME: perf_counter_names
+--| DESCRIPTION: the name of each counter in the dump
+--| TYPE: char *[]
+*/
+static const char * const perf_counter_names[PSP_PERF_NUM_COUNTERS] =
+{
+    "cycles",
+    "instructions",
+    "L1D misses",
+    "L1I misses",
+    "L2 misses",
+    "branch mispredicts",
+};
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE VARIABLES
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--| NAME: p_first_region
+--| DESCRIPTION: the list of regions measured, for the dump
+--| TYPE: PSP_Perf_Region_t *
+*/
+static PSP_Perf_Region_t * p_first_region = 0;
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE HELPER FUNCTION PROTOTYPES
+--|----------------------------------------------------------------------------|
+*/
+
+/*------------------------------------------------------------------------------
+Function Name:
+    Perf_Read_Event_Counter
+
+Function Description:
+    Read one of the event counters.
+
+Parameters:
+    counter: the event counter, 0 to PERF_NUM_EVENT_COUNTERS - 1.
+
+Returns:
+    uint32_t: the count.
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+uint32_t Perf_Read_Event_Counter(uint32_t counter);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    Perf_Send_Decimal
+
+Function Description:
+    Send a number over the mini UART in decimal.
+
+Parameters:
+    value: the number to send.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+void Perf_Send_Decimal(uint64_t value);
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC FUNCTION DEFINITIONS
+--|----------------------------------------------------------------------------|
+*/
+
+void PSP_Perf_Init(void)
+{
+    for (uint32_t counter = 0u; counter < PERF_NUM_EVENT_COUNTERS; counter++)
+    {
+        __asm__ volatile ("mcr p15, 0, %0, c9, c12, 5" : : "r" (counter));              // PMSELR
+        PERF_ISB();
+        __asm__ volatile ("mcr p15, 0, %0, c9, c13, 1" : : "r" (perf_events[counter])); // PMXEVTYPER
+    }
+
+    const uint32_t counters_to_enable = PERF_CYCLE_COUNTER_ENABLE_FLAG | ((1u << PERF_NUM_EVENT_COUNTERS) - 1u);
+
+    __asm__ volatile ("mcr p15, 0, %0, c9, c12, 1" : : "r" (counters_to_enable)); // PMCNTENSET
+
+    // count every cycle, and start everything from 0
+    uint32_t pmcr;
+
+    __asm__ volatile ("mrc p15, 0, %0, c9, c12, 0" : "=r" (pmcr)); // PMCR
+
+    pmcr &= ~PERF_PMCR_D_FLAG;
+    pmcr |= PERF_PMCR_E_FLAG | PERF_PMCR_P_FLAG | PERF_PMCR_C_FLAG;
+
+    __asm__ volatile ("mcr p15, 0, %0, c9, c12, 0" : : "r" (pmcr));
+    PERF_ISB();
+
+    p_first_region = 0;
+}
+
+uint32_t PSP_Perf_Get_Cycles(void)
+{
+    uint32_t cycles;
+
+    __asm__ volatile ("mrc p15, 0, %0, c9, c13, 0" : "=r" (cycles) : : "memory"); // PMCCNTR
+
+    return cycles;
+}
+
+void PSP_Perf_Region_Begin(PSP_Perf_Region_t * p_region)
+{
+    if (!p_region->is_listed)
+    {
+        p_region->p_next = p_first_region;
+        p_first_region = p_region;
+        p_region->is_listed = 1u;
+    }
+
+    for (uint32_t counter = 0u; counter < PERF_NUM_EVENT_COUNTERS; counter++)
+    {
+        p_region->start[counter + 1u] = Perf_Read_Event_Counter(counter);
+    }
+
+    // cycles last, so reading the event counters isn't counted
+    p_region->start[PSP_PERF_CYCLES] = PSP_Perf_Get_Cycles();
+}
+
+void PSP_Perf_Region_End(PSP_Perf_Region_t * p_region)
+{
+    uint32_t end[PSP_PERF_NUM_COUNTERS];
+
+    // cycles first, so reading the event counters isn't counted
+    end[PSP_PERF_CYCLES] = PSP_Perf_Get_Cycles();
+
+    for (uint32_t counter = 0u; counter < PERF_NUM_EVENT_COUNTERS; counter++)
+    {
+        end[counter + 1u] = Perf_Read_Event_Counter(counter);
+    }
+
+    for (uint32_t i = 0u; i < PSP_PERF_NUM_COUNTERS; i++)
+    {
+        // unsigned subtraction copes with the counter wrapping
+        const uint32_t count = end[i] - p_region->start[i];
+
+        if ((p_region->num_runs == 0u) || (count < p_region->min[i]))
+        {
+            p_region->min[i] = count;
+        }
+
+        if ((p_region->num_runs == 0u) || (count > p_region->max[i]))
+        {
+            p_region->max[i] = count;
+        }
+
+        p_region->total[i] += count;
+    }
+
+    p_region->num_runs++;
+}
+
+void PSP_Perf_Reset(void)
+{
+    for (PSP_Perf_Region_t * p_region = p_first_region; p_region; p_region = p_region->p_next)
+    {
+        for (uint32_t i = 0u; i < PSP_PERF_NUM_COUNTERS; i++)
+        {
+            p_region->min[i] = 0u;
+            p_region->max[i] = 0u;
+            p_region->total[i] = 0u;
+        }
+
+        p_region->num_runs = 0u;
+    }
+}
+
+void PSP_Perf_Dump(void)
+{
+    for (PSP_Perf_Region_t * p_region = p_first_region; p_region; p_region = p_region->p_next)
+    {
+        PSP_AUX_Mini_Uart_Send_String((char *)p_region->p_name);
+        PSP_AUX_Mini_Uart_Send_String(" (runs: ");
+        Perf_Send_Decimal(p_region->num_runs);
+        PSP_AUX_Mini_Uart_Send_String(")\r\n");
+
+        if (p_region->num_runs == 0u)
+        {
+            continue;
+        }
+
+        for (uint32_t i = 0u; i < PSP_PERF_NUM_COUNTERS; i++)
+        {
+            PSP_AUX_Mini_Uart_Send_String("    ");
+            PSP_AUX_Mini_Uart_Send_String((char *)perf_counter_names[i]);
+            PSP_AUX_Mini_Uart_Send_String(": min ");
+            Perf_Send_Decimal(p_region->min[i]);
+            PSP_AUX_Mini_Uart_Send_String(" mean ");
+            Perf_Send_Decimal(p_region->total[i] / p_region->num_runs);
+            PSP_AUX_Mini_Uart_Send_String(" max ");
+            Perf_Send_Decimal(p_region->max[i]);
+            PSP_AUX_Mini_Uart_Send_String("\r\n");
+        }
+    }
+}
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE HELPER FUNCTION DEFINITIONS
+--|----------------------------------------------------------------------------|
+*/
+
+uint32_t Perf_Read_Event_Counter(uint32_t counter)
+{
+    uint32_t count;
+
+    __asm__ volatile ("mcr p15, 0, %0, c9, c12, 5" : : "r" (counter));       // PMSELR
+    PERF_ISB();
+    __asm__ volatile ("mrc p15, 0, %0, c9, c13, 2" : "=r" (count) : : "memory"); // PMXEVCNTR
+
+    return count;
+}
+
+void Perf_Send_Decimal(uint64_t value)
+{
+    char digits[PERF_DECIMAL_DIGITS + 1u];
+    uint32_t i = PERF_DECIMAL_DIGITS;
+
+    digits[i] = '\0';
+
+    // fill from the right, least significant digit first
+    do
+    {
+        i--;
+        digits[i] = '0' + (char)(value % 10u);
+        value /= 10u;
+    } while (value);
+
+    PSP_AUX_Mini_Uart_Send_String(&digits[i]);
+}
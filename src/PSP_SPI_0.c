@@ -16,7 +16,9 @@
 --|----------------------------------------------------------------------------|
 */
 
+#include "PSP_DMA.h"
 #include "PSP_GPIO.h"
+#include "PSP_MMU.h"
 #include "PSP_REGS.h"
 #include "PSP_SPI_0.h"
 
@@ -33,6 +35,65 @@
 */
 #define SPI_0 ((volatile SPI_0_t *)PSP_REGS_SPI_0_BASE_ADDRESS)
 
+/*
+--| NAME: SPI_0_FIFO_ADDRESS
+--| DESCRIPTION: ARM address of the SPI 0 FIFO register, the DMA target
+--| TYPE: uint32_t
+*/
+#define SPI_0_FIFO_ADDRESS (PSP_REGS_SPI_0_BASE_ADDRESS + 0x4u)
+
+/*
+--| NAME: DMA_CHUNK_LENGTH
+--| DESCRIPTION: the most bytes sent per DMA header, DLEN is only 16 bits wide 
+--|   and every chunk but the last must be a whole number of 32 bit words
+--| TYPE: uint32_t
+*/
+#define DMA_CHUNK_LENGTH (0xFFFCu)
+
+/*
+--| NAME: DMA_MAX_CHUNKS
+--| DESCRIPTION: the most DMA chunks a single transfer can be split into
+--| TYPE: uint32_t
+*/
+#define DMA_MAX_CHUNKS (PSP_SPI0_DMA_MAX_TRANSFER_LENGTH / DMA_CHUNK_LENGTH)
+
+/*
+--| NAME: DMA_MAX_TX_BLOCKS
+--| DESCRIPTION: the most Tx control blocks in a chain, a header block per
+--|   chunk and a data block per chunk, or per row for a transfer of rows
+--| TYPE: uint32_t
+*/
+#define DMA_MAX_TX_BLOCKS (DMA_MAX_CHUNKS + PSP_SPI0_DMA_MAX_ROWS)
+
+/*
+--| NAME: DMA_RX_SCRATCH_WORDS
+--| DESCRIPTION: the number of words in dma_rx_scratch_words, one cache line
+--| TYPE: uint32_t
+*/
+#define DMA_RX_SCRATCH_WORDS (PSP_SPI0_DMA_RX_BUFFER_ALIGNMENT / sizeof(uint32_t))
+
+/*
+--| NAME: DMA_RX_<DISCARD/TAIL>_WORD
+--| DESCRIPTION: the words of dma_rx_scratch_words, the Rx destination when
+--|   there is no Rx buffer, and the catcher for the last partial word so the
+--|   Rx buffer isn't overrun
+--| TYPE: uint32_t
+*/
+#define DMA_RX_DISCARD_WORD (0u)
+#define DMA_RX_TAIL_WORD    (1u)
+
+/*
+--| NAME: DMA_<TX/RX>_TRANSFER_INFO
+--| DESCRIPTION: TI words for writing the Tx FIFO and reading the Rx FIFO,
+--|   paced by the SPI 0 DREQs
+--| TYPE: uint32_t
+*/
+#define DMA_TX_TRANSFER_INFO (PSP_DMA_TI_DEST_DREQ_FLAG | \
+                              PSP_DMA_TI_WAIT_RESP_FLAG | \
+                              (PSP_DMA_PERIPHERAL_SPI_TX << PSP_DMA_TI_PERMAP_SHIFT_AMT))
+#define DMA_RX_TRANSFER_INFO (PSP_DMA_TI_SRC_DREQ_FLAG | \
+                              (PSP_DMA_PERIPHERAL_SPI_RX << PSP_DMA_TI_PERMAP_SHIFT_AMT))
+
 /*
 --|----------------------------------------------------------------------------|
 --| PRIVATE TYPES
@@ -109,6 +170,33 @@ typedef enum SPI_0_CS_CHIP_SEL_Masks_Enumeration
     SPI_0_CS_CHIP_SEL_SHIFT_AMT = 0u,    // position of CHIP_SEL in SPI0 CS
 } SPI_0_CS_CHIP_SEL_Masks_enum;
 
+/*
+--| NAME: SPI_0_DC_Masks_enum
+--| DESCRIPTION: SPI 0 DMA DREQ Controls masks [8 bits each, rw]
+*/
+typedef enum SPI_0_DC_Masks_Enumeration
+{
+    SPI_0_DC_RPANIC_SHIFT_AMT = 24u,   // position of RPANIC (Rx panic threshold) in DC
+    SPI_0_DC_RDREQ_SHIFT_AMT  = 16u,   // position of RDREQ (Rx DREQ threshold) in DC
+    SPI_0_DC_TPANIC_SHIFT_AMT = 8u,    // position of TPANIC (Tx panic threshold) in DC
+    SPI_0_DC_TDREQ_SHIFT_AMT  = 0u,    // position of TDREQ (Tx DREQ threshold) in DC
+    SPI_0_DC_RPANIC_DEFAULT   = 0x30u, // panic the Rx DMA when the Rx FIFO is 48 bytes full
+    SPI_0_DC_RDREQ_DEFAULT    = 0x20u, // request the Rx DMA when the Rx FIFO is 32 bytes full
+    SPI_0_DC_TPANIC_DEFAULT   = 0x10u, // panic the Tx DMA when the Tx FIFO is down to 16 bytes
+    SPI_0_DC_TDREQ_DEFAULT    = 0x20u, // request the Tx DMA when the Tx FIFO is down to 32 bytes
+} SPI_0_DC_Masks_enum;
+
+/*
+--| NAME: SPI_0_DMA_Header_Masks_enum
+--| DESCRIPTION: masks for the word the DMA writes to the FIFO ahead of each
+--|   chunk, this word sets DLEN and CS[7:0] when DMAEN is set and TA is clear
+*/
+typedef enum SPI_0_DMA_Header_Masks_Enumeration
+{
+    SPI_0_DMA_HEADER_DLEN_SHIFT_AMT = 16u,  // position of the transfer length in the header
+    SPI_0_DMA_HEADER_CS_MASK        = 0x4Fu // CSPOL, CPOL, CPHA and CHIP_SEL are copied from CS
+} SPI_0_DMA_Header_Masks_enum;
+
 /*
 --|----------------------------------------------------------------------------|
 --| PRIVATE CONSTANTS
@@ -123,7 +211,77 @@ typedef enum SPI_0_CS_CHIP_SEL_Masks_Enumeration
 --|----------------------------------------------------------------------------|
 */
 
-/* None */
+/*
+--| NAME: dma_<tx/rx>_channel
+--| DESCRIPTION: the DMA channels feeding the Tx FIFO and draining the Rx FIFO
+--| TYPE: uint32_t
+*/
+static uint32_t dma_tx_channel = PSP_DMA_NO_CHANNEL;
+static uint32_t dma_rx_channel = PSP_DMA_NO_CHANNEL;
+
+/*
+--| NAME: dma_<tx/rx>_control_blocks
+--| DESCRIPTION: control block chains, Tx has a header block and a data block
+--|   per chunk or per row, Rx has a data block per chunk plus one for a
+--|   partial last word
+--| TYPE: PSP_DMA_Control_Block_t[]
+*/
+static PSP_DMA_Control_Block_t dma_tx_control_blocks[DMA_MAX_TX_BLOCKS];
+static PSP_DMA_Control_Block_t dma_rx_control_blocks[DMA_MAX_CHUNKS + 1u];
+
+/*
+--| NAME: dma_tx_headers
+--| DESCRIPTION: the DLEN/CS header word for each chunk
+--| TYPE: uint32_t[]
+*/
+static uint32_t dma_tx_headers[DMA_MAX_CHUNKS];
+
+/*
+--| NAME: dma_zero_word
+--| DESCRIPTION: Tx source when there is no Tx buffer
+--| TYPE: uint32_t
+*/
+static uint32_t dma_zero_word = 0u;
+
+/*
+--| NAME: dma_rx_scratch_words
+--| DESCRIPTION: the words the Rx DMA writes outside the Rx buffer, in a 
+--|   cache line of their own so no CPU write to a neighbouring variable can
+--|   be written back over them, or be thrown away when they are invalidated
+--| TYPE: uint32_t[]
+*/
+static uint32_t dma_rx_scratch_words[DMA_RX_SCRATCH_WORDS] __attribute__((aligned(PSP_SPI0_DMA_RX_BUFFER_ALIGNMENT)));
+
+/*
+--| NAME: p_dma_rx_tail, dma_rx_tail_length
+--| DESCRIPTION: where the bytes of the tail word go, and how many of them
+--| TYPE: uint8_t *, uint32_t
+*/
+static uint8_t *p_dma_rx_tail;
+static uint32_t dma_rx_tail_length;
+
+/*
+--| NAME: p_dma_rx_buffer, dma_rx_length
+--| DESCRIPTION: the Rx buffer of the running transfer, so it can be 
+--|   invalidated from the data cache once the DMA has filled it
+--| TYPE: uint8_t *, uint32_t
+*/
+static uint8_t *p_dma_rx_buffer;
+static uint32_t dma_rx_length;
+
+/*
+--| NAME: dma_transfer_pending
+--| DESCRIPTION: true from the start of a DMA transfer until it is cleaned up
+--| TYPE: uint32_t
+*/
+static volatile uint32_t dma_transfer_pending = 0u;
+
+/*
+--| NAME: dma_callback
+--| DESCRIPTION: the user completion callback, 0 for none
+--| TYPE: PSP_SPI0_DMA_Callback_t
+*/
+static PSP_SPI0_DMA_Callback_t dma_callback = 0;
 
 /*
 --|----------------------------------------------------------------------------|
@@ -131,7 +289,88 @@ typedef enum SPI_0_CS_CHIP_SEL_Masks_Enumeration
 --|----------------------------------------------------------------------------|
 */
 
-/* None */
+/*------------------------------------------------------------------------------
+Function Name:
+    SPI0_DMA_Set_Header_Block
+
+Function Description:
+    Fill in the header word of a chunk and the Tx control block that writes
+    it to the FIFO. The header sets DLEN and sets TA to kick off the chunk.
+
+Parameters:
+    p_control_block: the control block to fill in.
+    chunk: the chunk number.
+    chunk_length: the number of bytes in the chunk.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    Every chunk uses the chip select, polarity and phase settings currently
+    in CS.
+------------------------------------------------------------------------------*/
+void SPI0_DMA_Set_Header_Block(PSP_DMA_Control_Block_t * p_control_block,
+                               uint32_t chunk,
+                               uint32_t chunk_length);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    SPI0_DMA_Start_Chains
+
+Function Description:
+    Link the Tx and Rx control blocks, clean them from the data cache, hand
+    the FIFOs over to the DMA and start both channels.
+
+Parameters:
+    num_tx_blocks: the number of Tx control blocks filled in.
+    num_rx_blocks: the number of Rx control blocks filled in.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    The buffers must already be cleaned and invalidated as needed.
+------------------------------------------------------------------------------*/
+void SPI0_DMA_Start_Chains(uint32_t num_tx_blocks, uint32_t num_rx_blocks);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    SPI0_DMA_Finish
+
+Function Description:
+    Clean up after a DMA transfer. Copies the last partial Rx word into the
+    Rx buffer, puts SPI 0 back in polled mode and calls the user callback.
+
+    Does nothing if there is no transfer to clean up after.
+
+Parameters:
+    None
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    Both DMA channels must be done.
+------------------------------------------------------------------------------*/
+void SPI0_DMA_Finish(void);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    SPI0_DMA_Rx_Complete
+
+Function Description:
+    DMA completion callback for the Rx channel.
+
+Parameters:
+    channel: the channel that completed.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+void SPI0_DMA_Rx_Complete(uint32_t channel);
 
 /*
 --|----------------------------------------------------------------------------|
@@ -219,6 +458,52 @@ void PSP_SPI0_Send_16(uint16_t val)
     SPI_0->FIFO = low_byte;
 }
 
+void PSP_SPI0_Send_16_Repeated(uint16_t val, uint32_t count)
+{
+    const uint8_t bytes[2u] = { val >> 8u, val & 0xFFu };
+    uint32_t num_bytes = count * 2u;
+
+    while (num_bytes)
+    {
+        const uint32_t cs = SPI_0->CS;
+
+        // keep the Rx fifo from filling up, it would stop the clock
+        if (cs & SPI_0_CS_RXD_FLAG)
+        {
+            (void)SPI_0->FIFO;
+        }
+
+        if (cs & SPI_0_CS_TXD_FLAG)
+        {
+            // high byte first, an odd count of bytes left means the low byte is next
+            SPI_0->FIFO = bytes[num_bytes & 1u];
+            num_bytes--;
+        }
+    }
+}
+
+void PSP_SPI0_Send_Buffer(const uint8_t * p_tx_buffer, uint32_t num_bytes)
+{
+    uint32_t num_bytes_written = 0u;
+
+    while (num_bytes_written < num_bytes)
+    {
+        const uint32_t cs = SPI_0->CS;
+
+        // keep the Rx fifo from filling up, it would stop the clock
+        if (cs & SPI_0_CS_RXD_FLAG)
+        {
+            (void)SPI_0->FIFO;
+        }
+
+        if (cs & SPI_0_CS_TXD_FLAG)
+        {
+            SPI_0->FIFO = p_tx_buffer[num_bytes_written];
+            num_bytes_written++;
+        }
+    }
+}
+
 uint8_t PSP_SPI0_Transfer_Byte(uint8_t val)
 {
     PSP_SPI0_Begin_Transfer();
@@ -269,10 +554,313 @@ void PSP_SPI0_Set_Chip_Select(PSP_SPI_0_Chip_Select_t chip_select)
     SPI_0->CS |= chip_select;
 }
 
+uint32_t PSP_SPI0_DMA_Init(void)
+{
+    if (dma_tx_channel == PSP_DMA_NO_CHANNEL)
+    {
+        dma_tx_channel = PSP_DMA_Channel_Allocate();
+    }
+
+    if (dma_rx_channel == PSP_DMA_NO_CHANNEL)
+    {
+        dma_rx_channel = PSP_DMA_Channel_Allocate();
+    }
+
+    // the Rx channel is always the last to finish, so it signals completion
+    PSP_DMA_Set_Callback(dma_rx_channel, SPI0_DMA_Rx_Complete);
+
+    // DREQ thresholds, these are the reset values but make sure nobody changed them
+    SPI_0->DC = (SPI_0_DC_RPANIC_DEFAULT << SPI_0_DC_RPANIC_SHIFT_AMT) |
+                (SPI_0_DC_RDREQ_DEFAULT  << SPI_0_DC_RDREQ_SHIFT_AMT)  |
+                (SPI_0_DC_TPANIC_DEFAULT << SPI_0_DC_TPANIC_SHIFT_AMT) |
+                (SPI_0_DC_TDREQ_DEFAULT  << SPI_0_DC_TDREQ_SHIFT_AMT);
+
+    return (dma_tx_channel != PSP_DMA_NO_CHANNEL) && (dma_rx_channel != PSP_DMA_NO_CHANNEL);
+}
+
+uint32_t PSP_SPI0_DMA_Transfer(uint8_t *p_Tx_buffer, uint8_t *p_Rx_buffer, uint32_t num_bytes)
+{
+    uint32_t retval = 0u;
+
+    const uint32_t channels_ready = (dma_tx_channel != PSP_DMA_NO_CHANNEL) && 
+                                    (dma_rx_channel != PSP_DMA_NO_CHANNEL);
+
+    // the Rx buffer is invalidated when the transfer is done, so it can't share a cache line
+    const uint32_t is_rx_aligned = !((uint32_t)p_Rx_buffer & (PSP_SPI0_DMA_RX_BUFFER_ALIGNMENT - 1u));
+
+    if (channels_ready && is_rx_aligned && (0u < num_bytes) && (num_bytes <= PSP_SPI0_DMA_MAX_TRANSFER_LENGTH))
+    {
+        PSP_SPI0_DMA_Wait();
+
+        const uint32_t fifo_bus_address = PSP_DMA_Peripheral_Bus_Address(SPI_0_FIFO_ADDRESS);
+
+        uint32_t num_tx_blocks = 0u;
+        uint32_t num_rx_blocks = 0u;
+
+        dma_rx_tail_length = 0u;
+
+        for (uint32_t chunk = 0u, offset = 0u; offset < num_bytes; chunk++, offset += DMA_CHUNK_LENGTH)
+        {
+            const uint32_t remaining = num_bytes - offset;
+            const uint32_t chunk_length = (remaining < DMA_CHUNK_LENGTH) ? remaining : DMA_CHUNK_LENGTH;
+            
+            // the DMA moves whole words into the FIFO, the SPI only clocks out DLEN bytes of them
+            const uint32_t chunk_words_length = (chunk_length + 3u) & ~3u;
+
+            SPI0_DMA_Set_Header_Block(&dma_tx_control_blocks[num_tx_blocks++], chunk, chunk_length);
+
+            // Tx data
+            if (p_Tx_buffer)
+            {
+                PSP_DMA_Set_Control_Block(&dma_tx_control_blocks[num_tx_blocks++],
+                                          DMA_TX_TRANSFER_INFO | PSP_DMA_TI_SRC_INC_FLAG,
+                                          PSP_DMA_Bus_Address(&p_Tx_buffer[offset]),
+                                          fifo_bus_address,
+                                          chunk_words_length);
+            }
+            else
+            {
+                PSP_DMA_Set_Control_Block(&dma_tx_control_blocks[num_tx_blocks++],
+                                          DMA_TX_TRANSFER_INFO,
+                                          PSP_DMA_Bus_Address(&dma_zero_word),
+                                          fifo_bus_address,
+                                          chunk_words_length);
+            }
+
+            // Rx data
+            if (p_Rx_buffer)
+            {
+                const uint32_t whole_words_length = chunk_length & ~3u;
+
+                if (whole_words_length)
+                {
+                    PSP_DMA_Set_Control_Block(&dma_rx_control_blocks[num_rx_blocks++],
+                                              DMA_RX_TRANSFER_INFO | PSP_DMA_TI_DEST_INC_FLAG,
+                                              fifo_bus_address,
+                                              PSP_DMA_Bus_Address(&p_Rx_buffer[offset]),
+                                              whole_words_length);
+                }
+
+                // only the last chunk can end in a partial word
+                if (whole_words_length != chunk_length)
+                {
+                    p_dma_rx_tail = &p_Rx_buffer[offset + whole_words_length];
+                    dma_rx_tail_length = chunk_length - whole_words_length;
+
+                    PSP_DMA_Set_Control_Block(&dma_rx_control_blocks[num_rx_blocks++],
+                                              DMA_RX_TRANSFER_INFO,
+                                              fifo_bus_address,
+                                              PSP_DMA_Bus_Address(&dma_rx_scratch_words[DMA_RX_TAIL_WORD]),
+                                              sizeof(uint32_t));
+                }
+            }
+            else
+            {
+                PSP_DMA_Set_Control_Block(&dma_rx_control_blocks[num_rx_blocks++],
+                                          DMA_RX_TRANSFER_INFO,
+                                          fifo_bus_address,
+                                          PSP_DMA_Bus_Address(&dma_rx_scratch_words[DMA_RX_DISCARD_WORD]),
+                                          chunk_words_length);
+            }
+        }
+
+        // the DMA engine doesn't see the data cache, everything it reads has to be in memory
+        if (p_Tx_buffer)
+        {
+            PSP_MMU_Clean_Data_Cache(p_Tx_buffer, num_bytes);
+        }
+
+        // and nothing dirty may be written back over what it writes
+        p_dma_rx_buffer = p_Rx_buffer;
+        dma_rx_length = num_bytes;
+
+        if (p_Rx_buffer)
+        {
+            PSP_MMU_Clean_And_Invalidate_Data_Cache(p_Rx_buffer, num_bytes);
+        }
+
+        PSP_MMU_Clean_And_Invalidate_Data_Cache(dma_rx_scratch_words, sizeof(dma_rx_scratch_words));
+
+        SPI0_DMA_Start_Chains(num_tx_blocks, num_rx_blocks);
+
+        retval = 1u;
+    }
+
+    return retval;
+}
+
+uint32_t PSP_SPI0_DMA_Transfer_Rows(uint8_t *p_Tx_buffer, 
+                                    uint32_t row_length, 
+                                    uint32_t row_stride, 
+                                    uint32_t num_rows)
+{
+    uint32_t retval = 0u;
+
+    const uint32_t channels_ready = (dma_tx_channel != PSP_DMA_NO_CHANNEL) && 
+                                    (dma_rx_channel != PSP_DMA_NO_CHANNEL);
+
+    // every chunk holds whole rows, so a row never straddles a header
+    const uint32_t rows_per_chunk = (0u < row_length) && (row_length <= DMA_CHUNK_LENGTH) ? 
+                                    (DMA_CHUNK_LENGTH / row_length) : 0u;
+
+    const uint32_t is_word_aligned = !(((uint32_t)p_Tx_buffer | row_length | row_stride) & 3u);
+
+    if (channels_ready && is_word_aligned && (0u < rows_per_chunk) && 
+        (0u < num_rows) && (num_rows <= PSP_SPI0_DMA_MAX_ROWS) &&
+        (((num_rows + rows_per_chunk - 1u) / rows_per_chunk) <= DMA_MAX_CHUNKS))
+    {
+        PSP_SPI0_DMA_Wait();
+
+        const uint32_t fifo_bus_address = PSP_DMA_Peripheral_Bus_Address(SPI_0_FIFO_ADDRESS);
+
+        uint32_t num_tx_blocks = 0u;
+        uint32_t num_rx_blocks = 0u;
+
+        dma_rx_tail_length = 0u;
+
+        for (uint32_t chunk = 0u, row = 0u; row < num_rows; chunk++)
+        {
+            const uint32_t remaining = num_rows - row;
+            const uint32_t chunk_rows = (remaining < rows_per_chunk) ? remaining : rows_per_chunk;
+            const uint32_t chunk_length = chunk_rows * row_length;
+
+            SPI0_DMA_Set_Header_Block(&dma_tx_control_blocks[num_tx_blocks++], chunk, chunk_length);
+
+            // a data block per row, the rows are whole words so nothing pads them
+            for (uint32_t i = 0u; i < chunk_rows; i++, row++)
+            {
+                PSP_DMA_Set_Control_Block(&dma_tx_control_blocks[num_tx_blocks++],
+                                          DMA_TX_TRANSFER_INFO | PSP_DMA_TI_SRC_INC_FLAG,
+                                          PSP_DMA_Bus_Address(&p_Tx_buffer[row * row_stride]),
+                                          fifo_bus_address,
+                                          row_length);
+            }
+
+            PSP_DMA_Set_Control_Block(&dma_rx_control_blocks[num_rx_blocks++],
+                                      DMA_RX_TRANSFER_INFO,
+                                      fifo_bus_address,
+                                      PSP_DMA_Bus_Address(&dma_rx_scratch_words[DMA_RX_DISCARD_WORD]),
+                                      chunk_length);
+        }
+
+        // the DMA engine doesn't see the data cache, everything it reads has to be in memory
+        PSP_MMU_Clean_Data_Cache(p_Tx_buffer, (num_rows - 1u) * row_stride + row_length);
+
+        p_dma_rx_buffer = 0;
+        dma_rx_length = 0u;
+
+        PSP_MMU_Clean_And_Invalidate_Data_Cache(dma_rx_scratch_words, sizeof(dma_rx_scratch_words));
+
+        SPI0_DMA_Start_Chains(num_tx_blocks, num_rx_blocks);
+
+        retval = 1u;
+    }
+
+    return retval;
+}
+
+uint32_t PSP_SPI0_DMA_Is_Busy(void)
+{
+    return dma_transfer_pending && 
+          (PSP_DMA_Is_Busy(dma_rx_channel) || PSP_DMA_Is_Busy(dma_tx_channel));
+}
+
+void PSP_SPI0_DMA_Wait(void)
+{
+    while (PSP_SPI0_DMA_Is_Busy())
+    {
+        // wait for both channels to finish
+    }
+
+    SPI0_DMA_Finish();
+}
+
+void PSP_SPI0_DMA_Set_Callback(PSP_SPI0_DMA_Callback_t callback)
+{
+    dma_callback = callback;
+}
+
 /*
 --|----------------------------------------------------------------------------|
 --| PRIVATE HELPER FUNCTION DEFINITIONS
 --|----------------------------------------------------------------------------|
 */
 
-/* None */
+void SPI0_DMA_Set_Header_Block(PSP_DMA_Control_Block_t * p_control_block,
+                               uint32_t chunk,
+                               uint32_t chunk_length)
+{
+    // header word, sets DLEN and sets TA to kick off the chunk
+    dma_tx_headers[chunk] = (chunk_length << SPI_0_DMA_HEADER_DLEN_SHIFT_AMT) | 
+                            (SPI_0->CS & SPI_0_DMA_HEADER_CS_MASK) | 
+                            SPI_0_CS_TA_FLAG;
+
+    PSP_DMA_Set_Control_Block(p_control_block,
+                              DMA_TX_TRANSFER_INFO,
+                              PSP_DMA_Bus_Address(&dma_tx_headers[chunk]),
+                              PSP_DMA_Peripheral_Bus_Address(SPI_0_FIFO_ADDRESS),
+                              sizeof(uint32_t));
+}
+
+void SPI0_DMA_Start_Chains(uint32_t num_tx_blocks, uint32_t num_rx_blocks)
+{
+    PSP_DMA_Link_Control_Blocks(dma_tx_control_blocks, num_tx_blocks, 0u);
+    PSP_DMA_Link_Control_Blocks(dma_rx_control_blocks, num_rx_blocks, 0u);
+
+    // flag the end of the whole transfer
+    dma_rx_control_blocks[num_rx_blocks - 1u].TI |= PSP_DMA_TI_INTEN_FLAG;
+
+    PSP_MMU_Clean_Data_Cache(dma_tx_control_blocks, num_tx_blocks * sizeof(PSP_DMA_Control_Block_t));
+    PSP_MMU_Clean_Data_Cache(dma_rx_control_blocks, num_rx_blocks * sizeof(PSP_DMA_Control_Block_t));
+    PSP_MMU_Clean_Data_Cache(dma_tx_headers, sizeof(dma_tx_headers));
+    PSP_MMU_Clean_Data_Cache(&dma_zero_word, sizeof(dma_zero_word));
+
+    // clear the fifos and hand the FIFOs over to the DMA, TA stays low until the first header
+    SPI_0->CS = (SPI_0->CS & ~SPI_0_CS_TA_FLAG) | 
+                SPI_0_CS_DMAEN_FLAG | 
+                SPI_0_CS_ADCS_FLAG | 
+                (SPI_0_CS_CLEAR_RX_AND_TX_FIFO << SPI_0_CS_CLEAR_SHIFT_AMT);
+
+    dma_transfer_pending = 1u;
+
+    // start draining before filling, so the Rx FIFO never stalls the transfer
+    PSP_DMA_Start(dma_rx_channel, dma_rx_control_blocks);
+    PSP_DMA_Start(dma_tx_channel, dma_tx_control_blocks);
+}
+
+void SPI0_DMA_Finish(void)
+{
+    if (dma_transfer_pending)
+    {
+        dma_transfer_pending = 0u;
+
+        // drop anything the CPU fetched into the cache while the DMA was writing
+        if (p_dma_rx_buffer)
+        {
+            PSP_MMU_Invalidate_Data_Cache(p_dma_rx_buffer, dma_rx_length);
+            PSP_MMU_Invalidate_Data_Cache(dma_rx_scratch_words, sizeof(dma_rx_scratch_words));
+        }
+
+        // move the bytes of the partial last word into the Rx buffer
+        const uint8_t * p_tail_bytes = (const uint8_t *)&dma_rx_scratch_words[DMA_RX_TAIL_WORD];
+
+        for (uint32_t i = 0u; i < dma_rx_tail_length; i++)
+        {
+            p_dma_rx_tail[i] = p_tail_bytes[i];
+        }
+
+        // back to polled mode
+        SPI_0->CS &= ~(SPI_0_CS_DMAEN_FLAG | SPI_0_CS_ADCS_FLAG);
+
+        if (dma_callback)
+        {
+            dma_callback();
+        }
+    }
+}
+
+void SPI0_DMA_Rx_Complete(uint32_t channel)
+{
+    // the Tx channel finishes its last write before the last byte comes back in
+    SPI0_DMA_Finish();
+}
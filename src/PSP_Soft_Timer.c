@@ -0,0 +1,608 @@
+/*
+--|----------------------------------------------------------------------------|
+--| FILE DESCRIPTION:
+--|   PSP_Soft_Timer.c provides the timer wheel and the System Timer Compare 1
+--|   interrupt handler, as well as the implementation for the software timer
+--|   functions.
+--|
+--|----------------------------------------------------------------------------|
+--| REFERENCES:
+--|   Varghese and Lauck, "Hashed and Hierarchical Timing Wheels", 1987
+--|   BCM2837-ARM-Peripherals.pdf page 172
+--|
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--|----------------------------------------------------------------------------|
+--| INCLUDE FILES
+--|----------------------------------------------------------------------------|
+*/
+
+#include "PSP_Soft_Timer.h"
+#include "PSP_IRQ.h"
+#include "PSP_Time.h"
+
+#ifdef PSP_HOST_SIM
+#include "PSP_Sim.h"
+#endif
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE DEFINES
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--| NAME: WHEEL_NUM_LEVELS
+--| DESCRIPTION: the number of levels in the timer wheel
+--| TYPE: uint32_t
+*/
+#define WHEEL_NUM_LEVELS (6u)
+
+/*
+--| NAME: WHEEL_SLOT_BITS, WHEEL_NUM_SLOTS, WHEEL_SLOT_MASK
+--| DESCRIPTION: each level has 64 slots, picked by 6 bits of the expiry time
+--| TYPE: uint32_t
+*/
+#define WHEEL_SLOT_BITS (6u)
+#define WHEEL_NUM_SLOTS (1u << WHEEL_SLOT_BITS)
+#define WHEEL_SLOT_MASK (WHEEL_NUM_SLOTS - 1u)
+
+/*
+--| NAME: WHEEL_TOP_LEVEL
+--| DESCRIPTION: the last level, also holds everything past the range of the
+--|   levels below it so its slots wrap around
+--| TYPE: uint32_t
+*/
+#define WHEEL_TOP_LEVEL (WHEEL_NUM_LEVELS - 1u)
+
+/*
+--| NAME: TIMER_NOT_PENDING
+--| DESCRIPTION: wheel_slot of a timer that is not in the wheel, the slots of
+--|   pending timers are counted from 1 so a zeroed timer is not pending
+--| TYPE: uint32_t
+*/
+#define TIMER_NOT_PENDING (0u)
+
+/*
+--| NAME: MAX_COMPARE_DISTANCE_uSec
+--| DESCRIPTION: the compare register only holds the lower 32 bits of the
+--|   counter, events further away than this get an early interrupt that just
+--|   sets the compare again
+--| TYPE: uint32_t
+*/
+#define MAX_COMPARE_DISTANCE_uSec (0x80000000u)
+
+/*
+--| NAME: MIN_COMPARE_LEAD_uSec
+--| DESCRIPTION: the least time ahead of now the compare is set for, doubled
+--|   each time the time goes by before the compare is set
+--| TYPE: uint32_t
+*/
+#define MIN_COMPARE_LEAD_uSec (4u)
+
+/*
+--| NAME: WFI
+--| DESCRIPTION: sleep the core until an interrupt is pending, the host
+--|   register simulator moves its clock on and takes the interrupt instead
+--| TYPE: macro
+*/
+#ifdef PSP_HOST_SIM
+#define WFI() PSP_Sim_Wait_For_Interrupt()
+#else
+#define WFI() __asm__ volatile ("wfi" : : : "memory")
+#endif
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE TYPES
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--| NAME: Soft_Timer_Sleep_t
+--| DESCRIPTION: a timer and the flag its callback sets, for sleeping
+*/
+typedef struct Soft_Timer_Sleep_Type
+{
+    PSP_Soft_Timer_t timer;  // must be first, the callback gets a pointer to it
+    volatile uint32_t done;  // set when the timer expires
+} Soft_Timer_Sleep_t;
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE CONSTANTS
+--|----------------------------------------------------------------------------|
+*/
+
+/* None */
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE VARIABLES
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--| NAME: wheel
+--| DESCRIPTION: the first timer in each slot of each level, 0 for an empty slot
+--| TYPE: PSP_Soft_Timer_t *[][]
+*/
+static PSP_Soft_Timer_t * wheel[WHEEL_NUM_LEVELS][WHEEL_NUM_SLOTS];
+
+/*
+--| NAME: occupied_slots
+--| DESCRIPTION: bit n is set when slot n of a level has timers in it
+--| TYPE: uint64_t[]
+*/
+static uint64_t occupied_slots[WHEEL_NUM_LEVELS];
+
+/*
+--| NAME: wheel_time_uSec
+--| DESCRIPTION: the time the wheel has been processed up to
+--| TYPE: uint64_t
+*/
+static uint64_t wheel_time_uSec;
+
+/*
+--| NAME: num_pending_timers
+--| DESCRIPTION: the number of timers in the wheel
+--| TYPE: uint32_t
+*/
+static uint32_t num_pending_timers;
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE HELPER FUNCTION PROTOTYPES
+--|----------------------------------------------------------------------------|
+*/
+
+/*------------------------------------------------------------------------------
+Function Name:
+    Soft_Timer_Insert
+
+Function Description:
+    Put a timer in the wheel slot for its expiry time.
+
+Parameters:
+    p_timer: the timer, with its expiry time set.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    An expiry time already behind the wheel time is treated as due now.
+------------------------------------------------------------------------------*/
+void Soft_Timer_Insert(PSP_Soft_Timer_t * p_timer);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    Soft_Timer_Remove
+
+Function Description:
+    Take a pending timer out of its wheel slot.
+
+Parameters:
+    p_timer: the timer.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    Assumes the timer is pending.
+------------------------------------------------------------------------------*/
+void Soft_Timer_Remove(PSP_Soft_Timer_t * p_timer);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    Soft_Timer_Next_Event
+
+Function Description:
+    Find the next time something in the wheel is due, the earliest occupied
+    slot of the lowest occupied level. Every slot of a level comes due before
+    any slot of the level above it.
+
+Parameters:
+    p_event_time_uSec: where to put the time the slot comes due.
+    p_level, p_slot: where to put the level and slot.
+
+Returns:
+    uint32_t: true if the wheel has anything in it, else false.
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+uint32_t Soft_Timer_Next_Event(uint64_t * p_event_time_uSec, uint32_t * p_level, uint32_t * p_slot);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    Soft_Timer_Process
+
+Function Description:
+    Advance the wheel to a given time, calling back every timer that expires
+    and moving timers down a level as their slots come due.
+
+Parameters:
+    time_now_uSec: the time to advance to.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    Must be called with IRQs masked.
+------------------------------------------------------------------------------*/
+void Soft_Timer_Process(uint64_t time_now_uSec);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    Soft_Timer_Schedule
+
+Function Description:
+    Set the compare interrupt for the next event in the wheel, making sure the
+    compare time has not already gone by. The compare is set at least
+    MIN_COMPARE_LEAD_uSec ahead of now, and further ahead each time setting
+    it takes longer than that.
+
+Parameters:
+    None
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    Must be called with IRQs masked.
+------------------------------------------------------------------------------*/
+void Soft_Timer_Schedule(void);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    Soft_Timer_IRQ_Handler
+
+Function Description:
+    System Timer Compare 1 interrupt handler.
+
+Parameters:
+    source: the interrupt source.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+void Soft_Timer_IRQ_Handler(uint32_t source);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    Soft_Timer_Sleep_Callback
+
+Function Description:
+    Wakes up PSP_Soft_Timer_Sleep_Microseconds.
+
+Parameters:
+    p_timer: the sleep timer.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+void Soft_Timer_Sleep_Callback(PSP_Soft_Timer_t * p_timer);
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC FUNCTION DEFINITIONS
+--|----------------------------------------------------------------------------|
+*/
+
+void PSP_Soft_Timer_Init(void)
+{
+    for (uint32_t level = 0u; level < WHEEL_NUM_LEVELS; level++)
+    {
+        for (uint32_t slot = 0u; slot < WHEEL_NUM_SLOTS; slot++)
+        {
+            wheel[level][slot] = 0;
+        }
+
+        occupied_slots[level] = 0u;
+    }
+
+    num_pending_timers = 0u;
+    wheel_time_uSec = PSP_Time_Get_Ticks();
+
+    PSP_IRQ_Register_Handler(PSP_IRQ_SOURCE_SYSTEM_TIMER_1, Soft_Timer_IRQ_Handler);
+    PSP_IRQ_Enable_Source(PSP_IRQ_SOURCE_SYSTEM_TIMER_1);
+}
+
+void PSP_Soft_Timer_Start(PSP_Soft_Timer_t * p_timer,
+                          uint32_t delay_uSec,
+                          uint32_t period_uSec,
+                          PSP_Soft_Timer_Callback_t callback)
+{
+    const uint32_t irq_state = PSP_IRQ_Save_And_Disable();
+
+    if (p_timer->wheel_slot != TIMER_NOT_PENDING)
+    {
+        Soft_Timer_Remove(p_timer);
+    }
+
+    const uint64_t time_now_uSec = PSP_Time_Get_Ticks();
+
+    // an empty wheel isn't kept up to date, catch it up
+    if (num_pending_timers == 0u)
+    {
+        wheel_time_uSec = time_now_uSec;
+    }
+
+    p_timer->expiry_time_uSec = time_now_uSec + delay_uSec;
+    p_timer->period_uSec = period_uSec;
+    p_timer->callback = callback;
+
+    Soft_Timer_Insert(p_timer);
+    Soft_Timer_Schedule();
+
+    PSP_IRQ_Restore(irq_state);
+}
+
+void PSP_Soft_Timer_Cancel(PSP_Soft_Timer_t * p_timer)
+{
+    const uint32_t irq_state = PSP_IRQ_Save_And_Disable();
+
+    if (p_timer->wheel_slot != TIMER_NOT_PENDING)
+    {
+        Soft_Timer_Remove(p_timer);
+    }
+
+    // the compare interrupt is left as is, if it fires early it finds nothing due
+
+    PSP_IRQ_Restore(irq_state);
+}
+
+uint32_t PSP_Soft_Timer_Is_Pending(const PSP_Soft_Timer_t * p_timer)
+{
+    return (p_timer->wheel_slot != TIMER_NOT_PENDING) ? 1u : 0u;
+}
+
+void PSP_Soft_Timer_Sleep_Microseconds(uint32_t delay_time_uSec)
+{
+    Soft_Timer_Sleep_t sleep;
+
+    sleep.timer.wheel_slot = TIMER_NOT_PENDING;
+    sleep.done = 0u;
+
+    const uint32_t irq_state = PSP_IRQ_Save_And_Disable();
+
+    PSP_Soft_Timer_Start(&sleep.timer, delay_time_uSec, 0u, Soft_Timer_Sleep_Callback);
+
+    // WFI wakes on a pending IRQ even while masked, the IRQ is taken once unmasked,
+    // so there is no gap between checking the flag and sleeping where the wake up is missed
+    while (!sleep.done)
+    {
+        WFI();
+        PSP_IRQ_Enable();
+        PSP_IRQ_Disable();
+    }
+
+    PSP_IRQ_Restore(irq_state);
+}
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE HELPER FUNCTION DEFINITIONS
+--|----------------------------------------------------------------------------|
+*/
+
+void Soft_Timer_Insert(PSP_Soft_Timer_t * p_timer)
+{
+    if (p_timer->expiry_time_uSec < wheel_time_uSec)
+    {
+        p_timer->expiry_time_uSec = wheel_time_uSec;
+    }
+
+    // the level is picked by the highest 6 bit group where the expiry and wheel times differ
+    const uint64_t differing_bits = p_timer->expiry_time_uSec ^ wheel_time_uSec;
+
+    uint32_t level = 0u;
+
+    if (differing_bits)
+    {
+        level = (63u - (uint32_t)__builtin_clzll(differing_bits)) / WHEEL_SLOT_BITS;
+
+        if (level > WHEEL_TOP_LEVEL)
+        {
+            level = WHEEL_TOP_LEVEL;
+        }
+    }
+
+    const uint32_t slot = (uint32_t)(p_timer->expiry_time_uSec >> (level * WHEEL_SLOT_BITS)) & WHEEL_SLOT_MASK;
+
+    // push onto the front of the slot's list
+    p_timer->p_prev = 0;
+    p_timer->p_next = wheel[level][slot];
+
+    if (p_timer->p_next)
+    {
+        p_timer->p_next->p_prev = p_timer;
+    }
+
+    wheel[level][slot] = p_timer;
+    occupied_slots[level] |= ((uint64_t)1u << slot);
+
+    p_timer->wheel_slot = (level * WHEEL_NUM_SLOTS) + slot + 1u;
+    num_pending_timers++;
+}
+
+void Soft_Timer_Remove(PSP_Soft_Timer_t * p_timer)
+{
+    const uint32_t level = (p_timer->wheel_slot - 1u) / WHEEL_NUM_SLOTS;
+    const uint32_t slot = (p_timer->wheel_slot - 1u) % WHEEL_NUM_SLOTS;
+
+    if (p_timer->p_prev)
+    {
+        p_timer->p_prev->p_next = p_timer->p_next;
+    }
+    else
+    {
+        wheel[level][slot] = p_timer->p_next;
+    }
+
+    if (p_timer->p_next)
+    {
+        p_timer->p_next->p_prev = p_timer->p_prev;
+    }
+
+    if (wheel[level][slot] == 0)
+    {
+        occupied_slots[level] &= ~((uint64_t)1u << slot);
+    }
+
+    p_timer->wheel_slot = TIMER_NOT_PENDING;
+    num_pending_timers--;
+}
+
+uint32_t Soft_Timer_Next_Event(uint64_t * p_event_time_uSec, uint32_t * p_level, uint32_t * p_slot)
+{
+    for (uint32_t level = 0u; level < WHEEL_NUM_LEVELS; level++)
+    {
+        const uint64_t occupied = occupied_slots[level];
+
+        if (occupied == 0u)
+        {
+            continue;
+        }
+
+        const uint32_t shift = level * WHEEL_SLOT_BITS;
+        const uint32_t current_slot = (uint32_t)(wheel_time_uSec >> shift) & WHEEL_SLOT_MASK;
+
+        if (level < WHEEL_TOP_LEVEL)
+        {
+            // nothing below the current slot, those times have gone by
+            const uint32_t slot = (uint32_t)__builtin_ctzll(occupied);
+            const uint64_t level_start_uSec = wheel_time_uSec & ~(((uint64_t)1u << (shift + WHEEL_SLOT_BITS)) - 1u);
+
+            *p_event_time_uSec = level_start_uSec | ((uint64_t)slot << shift);
+            *p_slot = slot;
+        }
+        else
+        {
+            // the top level wraps, count the slots from the current one
+            const uint64_t rotated = (occupied >> current_slot) | (occupied << ((WHEEL_NUM_SLOTS - current_slot) & WHEEL_SLOT_MASK));
+            const uint32_t slots_ahead = (uint32_t)__builtin_ctzll(rotated);
+
+            *p_event_time_uSec = ((wheel_time_uSec >> shift) + slots_ahead) << shift;
+            *p_slot = (current_slot + slots_ahead) & WHEEL_SLOT_MASK;
+        }
+
+        *p_level = level;
+
+        return 1u;
+    }
+
+    return 0u;
+}
+
+void Soft_Timer_Process(uint64_t time_now_uSec)
+{
+    uint64_t event_time_uSec;
+    uint32_t level;
+    uint32_t slot;
+
+    while (Soft_Timer_Next_Event(&event_time_uSec, &level, &slot) && (event_time_uSec <= time_now_uSec))
+    {
+        wheel_time_uSec = event_time_uSec;
+
+        // take the timers out one at a time, callbacks may start or cancel any timer in the slot
+        PSP_Soft_Timer_t * p_timer;
+
+        while ((p_timer = wheel[level][slot]) != 0)
+        {
+            Soft_Timer_Remove(p_timer);
+
+            if (level == 0u)
+            {
+                // restart periodic timers first, so the callback can cancel them
+                if (p_timer->period_uSec)
+                {
+                    p_timer->expiry_time_uSec += p_timer->period_uSec;
+
+                    if (p_timer->expiry_time_uSec <= time_now_uSec)
+                    {
+                        p_timer->expiry_time_uSec = time_now_uSec + p_timer->period_uSec;
+                    }
+
+                    Soft_Timer_Insert(p_timer);
+                }
+
+                p_timer->callback(p_timer);
+            }
+            else
+            {
+                // the wheel time is now in this slot, the timer goes down to a lower level
+                Soft_Timer_Insert(p_timer);
+            }
+        }
+    }
+
+    // nothing is due before now, so every timer keeps its slot
+    if (wheel_time_uSec < time_now_uSec)
+    {
+        wheel_time_uSec = time_now_uSec;
+    }
+}
+
+void Soft_Timer_Schedule(void)
+{
+    uint64_t event_time_uSec;
+    uint32_t level;
+    uint32_t slot;
+
+    if (!Soft_Timer_Next_Event(&event_time_uSec, &level, &slot))
+    {
+        return;
+    }
+
+    uint64_t time_now_uSec = PSP_Time_Get_Ticks();
+    uint64_t compare_time_uSec;
+    uint32_t lead_uSec = MIN_COMPARE_LEAD_uSec;
+
+    do
+    {
+        compare_time_uSec = event_time_uSec;
+
+        if (compare_time_uSec < time_now_uSec + lead_uSec)
+        {
+            compare_time_uSec = time_now_uSec + lead_uSec;
+        }
+        else if ((compare_time_uSec - time_now_uSec) > MAX_COMPARE_DISTANCE_uSec)
+        {
+            compare_time_uSec = time_now_uSec + MAX_COMPARE_DISTANCE_uSec;
+        }
+        else
+        {
+            /* in range, do nothing */
+        }
+
+        // setting the compare clears its match flag, a match from here on is the one wanted
+        PSP_Time_Set_Compare(PSP_TIME_COMPARE_1, (uint32_t)compare_time_uSec);
+
+        // the compare only matches on equality, if the time went by while setting it and it
+        // didn't match on the way, try again with more room
+        time_now_uSec = PSP_Time_Get_Ticks();
+        lead_uSec *= 2u;
+    } while ((compare_time_uSec <= time_now_uSec) && !PSP_Time_Compare_Matched(PSP_TIME_COMPARE_1));
+}
+
+void Soft_Timer_IRQ_Handler(uint32_t source)
+{
+    PSP_Time_Clear_Compare_Match(PSP_TIME_COMPARE_1);
+
+    Soft_Timer_Process(PSP_Time_Get_Ticks());
+    Soft_Timer_Schedule();
+}
+
+void Soft_Timer_Sleep_Callback(PSP_Soft_Timer_t * p_timer)
+{
+    ((Soft_Timer_Sleep_t *)p_timer)->done = 1u;
+}
@@ -0,0 +1,302 @@
+/*
+--|----------------------------------------------------------------------------|
+--| FILE DESCRIPTION:
+--|   PSP_String.c provides the implementation for the memory functions.
+--|
+--|----------------------------------------------------------------------------|
+--| REFERENCES:
+--|   see PSP_String.h
+--|
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--|----------------------------------------------------------------------------|
+--| INCLUDE FILES
+--|----------------------------------------------------------------------------|
+*/
+
+#include "PSP_String.h"
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE DEFINES
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--| NAME: STRING_VECTOR_SIZE
+--| DESCRIPTION: bytes in a NEON Q register, and the destination alignment the
+--|   bulk loops work at
+--| TYPE: uint32_t
+*/
+#define STRING_VECTOR_SIZE (16u)
+
+/*
+--| NAME: STRING_BLOCK_SIZE
+--| DESCRIPTION: bytes moved per pass of the bulk loops, 4 Q registers
+--| TYPE: uint32_t
+*/
+#define STRING_BLOCK_SIZE (64u)
+
+/*
+--| NAME: STRING_LIBRARY_FUNCTION
+--| DESCRIPTION: keeps the C library functions when link-time optimization
+--|   would drop them, the compiler may only emit calls to them after that
+--| TYPE: attribute
+*/
+#define STRING_LIBRARY_FUNCTION __attribute__((used))
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE TYPES
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--| NAME: String_Vector_t
+--| DESCRIPTION: a Q register, for accesses 16 byte aligned
+--| TYPE: GCC vector
+*/
+typedef uint32_t String_Vector_t __attribute__((vector_size(16), may_alias));
+
+/*
+--| NAME: String_Unaligned_Vector_t
+--| DESCRIPTION: a Q register, for accesses of any alignment
+--| TYPE: GCC vector
+*/
+typedef uint32_t String_Unaligned_Vector_t __attribute__((vector_size(16), may_alias, aligned(1)));
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE CONSTANTS
+--|----------------------------------------------------------------------------|
+*/
+
+/* None */
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE VARIABLES
+--|----------------------------------------------------------------------------|
+*/
+
+/* None */
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE HELPER FUNCTION PROTOTYPES
+--|----------------------------------------------------------------------------|
+*/
+
+/*------------------------------------------------------------------------------
+Function Name:
+    String_Fill
+
+Function Description:
+    Fill a buffer with a repeating 32 bit pattern.
+
+Parameters:
+    p_dest: the buffer.
+    pattern: the pattern, as it would be stored at a 4 byte aligned address.
+    num_bytes: the number of bytes to fill.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    Each byte gets the byte of the pattern picked by the low 2 bits of its
+    address, so a memset16 or memset32 buffer must be aligned to its value
+    size.
+------------------------------------------------------------------------------*/
+void String_Fill(uint8_t * p_dest, uint32_t pattern, size_t num_bytes);
+
+/*------------------------------------------------------------------------------
+Function Name:
+    String_Copy_Backward
+
+Function Description:
+    Copy bytes from one buffer to another starting from the end, for an
+    overlapping destination above the source.
+
+Parameters:
+    p_dest: where to copy to.
+    p_src: where to copy from.
+    num_bytes: the number of bytes to copy.
+
+Returns:
+    None
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+void String_Copy_Backward(uint8_t * p_dest, const uint8_t * p_src, size_t num_bytes);
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC FUNCTION DEFINITIONS
+--|----------------------------------------------------------------------------|
+*/
+
+#ifndef PSP_HOST_SIM
+STRING_LIBRARY_FUNCTION void * memcpy(void * p_dest, const void * p_src, size_t num_bytes)
+{
+    uint8_t * p_d = (uint8_t *)p_dest;
+    const uint8_t * p_s = (const uint8_t *)p_src;
+
+    // bytes until the destination is on a Q register boundary
+    while (num_bytes && ((uint32_t)p_d & (STRING_VECTOR_SIZE - 1u)))
+    {
+        *p_d++ = *p_s++;
+        num_bytes--;
+    }
+
+    // all 4 loads before the stores, memmove relies on this for a lower destination
+    while (num_bytes >= STRING_BLOCK_SIZE)
+    {
+        const String_Vector_t a = ((const String_Unaligned_Vector_t *)p_s)[0];
+        const String_Vector_t b = ((const String_Unaligned_Vector_t *)p_s)[1];
+        const String_Vector_t c = ((const String_Unaligned_Vector_t *)p_s)[2];
+        const String_Vector_t d = ((const String_Unaligned_Vector_t *)p_s)[3];
+
+        ((String_Vector_t *)p_d)[0] = a;
+        ((String_Vector_t *)p_d)[1] = b;
+        ((String_Vector_t *)p_d)[2] = c;
+        ((String_Vector_t *)p_d)[3] = d;
+
+        p_d += STRING_BLOCK_SIZE;
+        p_s += STRING_BLOCK_SIZE;
+        num_bytes -= STRING_BLOCK_SIZE;
+    }
+
+    while (num_bytes >= STRING_VECTOR_SIZE)
+    {
+        *(String_Vector_t *)p_d = *(const String_Unaligned_Vector_t *)p_s;
+
+        p_d += STRING_VECTOR_SIZE;
+        p_s += STRING_VECTOR_SIZE;
+        num_bytes -= STRING_VECTOR_SIZE;
+    }
+
+    while (num_bytes)
+    {
+        *p_d++ = *p_s++;
+        num_bytes--;
+    }
+
+    return p_dest;
+}
+
+STRING_LIBRARY_FUNCTION void * memmove(void * p_dest, const void * p_src, size_t num_bytes)
+{
+    uint8_t * p_d = (uint8_t *)p_dest;
+    const uint8_t * p_s = (const uint8_t *)p_src;
+
+    // a forward copy is safe unless the destination starts inside the source
+    if ((p_d <= p_s) || (p_d >= (p_s + num_bytes)))
+    {
+        memcpy(p_dest, p_src, num_bytes);
+    }
+    else
+    {
+        String_Copy_Backward(p_d, p_s, num_bytes);
+    }
+
+    return p_dest;
+}
+
+STRING_LIBRARY_FUNCTION void * memset(void * p_dest, int value, size_t num_bytes)
+{
+    String_Fill((uint8_t *)p_dest, (uint32_t)(value & 0xFF) * 0x01010101u, num_bytes);
+
+    return p_dest;
+}
+#endif
+
+void * memset16(void * p_dest, uint16_t value, size_t count)
+{
+    String_Fill((uint8_t *)p_dest, (uint32_t)value * 0x00010001u, count * sizeof(uint16_t));
+
+    return p_dest;
+}
+
+void * memset32(void * p_dest, uint32_t value, size_t count)
+{
+    String_Fill((uint8_t *)p_dest, value, count * sizeof(uint32_t));
+
+    return p_dest;
+}
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE HELPER FUNCTION DEFINITIONS
+--|----------------------------------------------------------------------------|
+*/
+
+void String_Fill(uint8_t * p_dest, uint32_t pattern, size_t num_bytes)
+{
+    const String_Vector_t vector = { pattern, pattern, pattern, pattern };
+
+    // bytes until the destination is on a Q register boundary, taken from the pattern by address
+    while (num_bytes && ((uint32_t)p_dest & (STRING_VECTOR_SIZE - 1u)))
+    {
+        *p_dest = (uint8_t)(pattern >> (((uint32_t)p_dest & 3u) * 8u));
+        p_dest++;
+        num_bytes--;
+    }
+
+    while (num_bytes >= STRING_BLOCK_SIZE)
+    {
+        ((String_Vector_t *)p_dest)[0] = vector;
+        ((String_Vector_t *)p_dest)[1] = vector;
+        ((String_Vector_t *)p_dest)[2] = vector;
+        ((String_Vector_t *)p_dest)[3] = vector;
+
+        p_dest += STRING_BLOCK_SIZE;
+        num_bytes -= STRING_BLOCK_SIZE;
+    }
+
+    while (num_bytes >= STRING_VECTOR_SIZE)
+    {
+        *(String_Vector_t *)p_dest = vector;
+
+        p_dest += STRING_VECTOR_SIZE;
+        num_bytes -= STRING_VECTOR_SIZE;
+    }
+
+    while (num_bytes)
+    {
+        *p_dest = (uint8_t)(pattern >> (((uint32_t)p_dest & 3u) * 8u));
+        p_dest++;
+        num_bytes--;
+    }
+}
+
+void String_Copy_Backward(uint8_t * p_dest, const uint8_t * p_src, size_t num_bytes)
+{
+    uint8_t * p_d = p_dest + num_bytes;
+    const uint8_t * p_s = p_src + num_bytes;
+
+    // bytes until the end of the destination is on a Q register boundary
+    while (num_bytes && ((uint32_t)p_d & (STRING_VECTOR_SIZE - 1u)))
+    {
+        *--p_d = *--p_s;
+        num_bytes--;
+    }
+
+    // each load before its store, the store only overwrites source bytes already copied
+    while (num_bytes >= STRING_VECTOR_SIZE)
+    {
+        p_d -= STRING_VECTOR_SIZE;
+        p_s -= STRING_VECTOR_SIZE;
+        num_bytes -= STRING_VECTOR_SIZE;
+
+        *(String_Vector_t *)p_d = *(const String_Unaligned_Vector_t *)p_s;
+    }
+
+    while (num_bytes)
+    {
+        *--p_d = *--p_s;
+        num_bytes--;
+    }
+}
@@ -33,6 +33,14 @@
 */
 #define System_Timer ((volatile PSP_Time_System_Timer_t *)PSP_REGS_SYSCLK_BASE_ADDRESS)
 
+/*
+--| NAME: SYSTEM_TIMER_COMPARE
+--| DESCRIPTION: the compare register of a given channel, C0 to C3 follow each
+--|   other in the register block
+--| TYPE: vuint32_t
+*/
+#define SYSTEM_TIMER_COMPARE(channel) ((&System_Timer->C0)[(channel)])
+
 /*
 --|----------------------------------------------------------------------------|
 --| PRIVATE TYPES
@@ -119,15 +127,40 @@ uint32_t PSP_Time_Periodic_Timer_Timeout_Occured(PSP_Time_Periodic_Timer_t * pCo
 {
     uint32_t retval = 0;
 
-    if ((PSP_Time_Get_Ticks() - pCounter->last_timeout_time_uSec) > pCounter->timeout_period_uSec)
+    const uint64_t time_now_uSec = PSP_Time_Get_Ticks();
+
+    if ((time_now_uSec - pCounter->last_timeout_time_uSec) > pCounter->timeout_period_uSec)
     {
-        pCounter->last_timeout_time_uSec = PSP_Time_Get_Ticks();
+        pCounter->last_timeout_time_uSec = time_now_uSec;
         retval = 1u;
     }
 
     return retval;
 }
 
+void PSP_Time_Set_Compare(PSP_Time_Compare_t compare, uint32_t match_time_uSec)
+{
+    if ((compare == PSP_TIME_COMPARE_1) || (compare == PSP_TIME_COMPARE_3))
+    {
+        System_Timer->CS = (1u << compare);
+        SYSTEM_TIMER_COMPARE(compare) = match_time_uSec;
+    }
+}
+
+void PSP_Time_Clear_Compare_Match(PSP_Time_Compare_t compare)
+{
+    if ((compare == PSP_TIME_COMPARE_1) || (compare == PSP_TIME_COMPARE_3))
+    {
+        // the match flags are write 1 to clear
+        System_Timer->CS = (1u << compare);
+    }
+}
+
+uint32_t PSP_Time_Compare_Matched(PSP_Time_Compare_t compare)
+{
+    return (System_Timer->CS >> compare) & 1u;
+}
+
 /*
 --|----------------------------------------------------------------------------|
 --| PRIVATE HELPER FUNCTION DEFINITIONS
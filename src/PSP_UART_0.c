@@ -0,0 +1,553 @@
+/*
+--|----------------------------------------------------------------------------|
+--| FILE DESCRIPTION:
+--|   PSP_UART_0.c provides the implementation for UART 0.
+--|
+--|----------------------------------------------------------------------------|
+--| REFERENCES:
+--|   see PSP_UART_0.h
+--|
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--|----------------------------------------------------------------------------|
+--| INCLUDE FILES
+--|----------------------------------------------------------------------------|
+*/
+
+#include "PSP_DMA.h"
+#include "PSP_GPIO.h"
+#include "PSP_MMU.h"
+#include "PSP_REGS.h"
+#include "PSP_UART_0.h"
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE DEFINES
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--| NAME: UART_0
+--| DESCRIPTION: pointer to the UART 0 register structure
+--| TYPE: UART_0_t *
+*/
+#define UART_0 ((volatile UART_0_t *)PSP_REGS_UART_0_BASE_ADDRESS)
+
+/*
+--| NAME: UART_0_DR_ADDRESS
+--| DESCRIPTION: ARM address of the UART 0 data register, the DMA target
+--| TYPE: uint32_t
+*/
+#define UART_0_DR_ADDRESS (PSP_REGS_UART_0_BASE_ADDRESS + 0x00u)
+
+/*
+--| NAME: UART_0_MIN/MAX_DIVISOR
+--| DESCRIPTION: the range of the baud rate divisor in 64ths, IBRD must be
+--|   1 to 65535 and FBRD must be 0 when IBRD is 65535
+--| TYPE: uint32_t
+*/
+#define UART_0_MIN_DIVISOR (1u << 6u)
+#define UART_0_MAX_DIVISOR (0xFFFFu << 6u)
+
+/*
+--| NAME: DMA_NUM_TX_BUFFERS
+--| DESCRIPTION: Tx words buffers, one is filled while the other is sent
+--| TYPE: uint32_t
+*/
+#define DMA_NUM_TX_BUFFERS (2u)
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE TYPES
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--| NAME: UART_0_t
+--| DESCRIPTION: structure for the UART 0 registers
+*/
+typedef struct UART_0_Type
+{
+    vuint32_t DR;            // Data Register
+    vuint32_t RSRECR;        // Receive Status / Error Clear
+    vuint32_t RESERVED_0[4]; //
+    vuint32_t FR;            // Flag Register
+    vuint32_t RESERVED_1[1]; //
+    vuint32_t ILPR;          // IrDA Low-Power Counter (not used on the BCM2837)
+    vuint32_t IBRD;          // Integer Baud Rate Divisor
+    vuint32_t FBRD;          // Fractional Baud Rate Divisor
+    vuint32_t LCRH;          // Line Control
+    vuint32_t CR;            // Control
+    vuint32_t IFLS;          // Interrupt FIFO Level Select
+    vuint32_t IMSC;          // Interrupt Mask Set / Clear
+    vuint32_t RIS;           // Raw Interrupt Status
+    vuint32_t MIS;           // Masked Interrupt Status
+    vuint32_t ICR;           // Interrupt Clear
+    vuint32_t DMACR;         // DMA Control
+} UART_0_t;
+
+/*
+--| NAME: UART_0_DR_Masks_enum
+--| DESCRIPTION: UART 0 DR register masks
+*/
+typedef enum UART_0_DR_Masks_Enumeration
+{
+    UART_0_DR_DATA_MASK = 0xFFu, // the data byte, the bits above it are error flags [rw]
+} UART_0_DR_Masks_enum;
+
+/*
+--| NAME: UART_0_FR_Flags_enum
+--| DESCRIPTION: UART 0 FR register flags
+*/
+typedef enum UART_0_FR_Flags_Enumeration
+{
+    UART_0_FR_TXFE_FLAG = (1u << 7u), // Tx FIFO empty [r]
+    UART_0_FR_RXFF_FLAG = (1u << 6u), // Rx FIFO full [r]
+    UART_0_FR_TXFF_FLAG = (1u << 5u), // Tx FIFO full [r]
+    UART_0_FR_RXFE_FLAG = (1u << 4u), // Rx FIFO empty [r]
+    UART_0_FR_BUSY_FLAG = (1u << 3u), // UART busy sending data [r]
+    UART_0_FR_CTS_FLAG  = (1u << 0u), // Clear to send [r]
+} UART_0_FR_Flags_enum;
+
+/*
+--| NAME: UART_0_LCRH_Flags_enum
+--| DESCRIPTION: UART 0 LCRH register flags
+*/
+typedef enum UART_0_LCRH_Flags_Enumeration
+{
+    UART_0_LCRH_SPS_FLAG  = (1u << 7u), // Stick parity select [rw]
+    UART_0_LCRH_FEN_FLAG  = (1u << 4u), // Enable FIFOs [rw]
+    UART_0_LCRH_STP2_FLAG = (1u << 3u), // Two stop bits select [rw]
+    UART_0_LCRH_EPS_FLAG  = (1u << 2u), // Even parity select [rw]
+    UART_0_LCRH_PEN_FLAG  = (1u << 1u), // Parity enable [rw]
+    UART_0_LCRH_BRK_FLAG  = (1u << 0u), // Send break [rw]
+} UART_0_LCRH_Flags_enum;
+
+/*
+--| NAME: UART_0_LCRH_WLEN_Masks_enum
+--| DESCRIPTION: UART 0 LCRH register word length masks [2 bits, rw]
+*/
+typedef enum UART_0_LCRH_WLEN_Masks_Enumeration
+{
+    UART_0_LCRH_WLEN_5_BITS    = 0b00u, // 5 data bits
+    UART_0_LCRH_WLEN_6_BITS    = 0b01u, // 6 data bits
+    UART_0_LCRH_WLEN_7_BITS    = 0b10u, // 7 data bits
+    UART_0_LCRH_WLEN_8_BITS    = 0b11u, // 8 data bits
+    UART_0_LCRH_WLEN_SHIFT_AMT = 5u,    // position of WLEN in LCRH
+} UART_0_LCRH_WLEN_Masks_enum;
+
+/*
+--| NAME: UART_0_CR_Flags_enum
+--| DESCRIPTION: UART 0 CR register flags
+*/
+typedef enum UART_0_CR_Flags_Enumeration
+{
+    UART_0_CR_CTSEN_FLAG  = (1u << 15u), // CTS hardware flow control enable [rw]
+    UART_0_CR_RTSEN_FLAG  = (1u << 14u), // RTS hardware flow control enable [rw]
+    UART_0_CR_RTS_FLAG    = (1u << 11u), // Request to send [rw]
+    UART_0_CR_RXE_FLAG    = (1u << 9u),  // Receive enable [rw]
+    UART_0_CR_TXE_FLAG    = (1u << 8u),  // Transmit enable [rw]
+    UART_0_CR_LBE_FLAG    = (1u << 7u),  // Loopback enable [rw]
+    UART_0_CR_UARTEN_FLAG = (1u << 0u),  // UART enable [rw]
+} UART_0_CR_Flags_enum;
+
+/*
+--| NAME: UART_0_IFLS_Masks_enum
+--| DESCRIPTION: UART 0 IFLS register masks [3 bits each, rw]
+*/
+typedef enum UART_0_IFLS_Masks_Enumeration
+{
+    UART_0_IFLS_RXIFLSEL_SHIFT_AMT = 3u, // position of the Rx FIFO level in IFLS
+    UART_0_IFLS_TXIFLSEL_SHIFT_AMT = 0u, // position of the Tx FIFO level in IFLS
+} UART_0_IFLS_Masks_enum;
+
+/*
+--| NAME: UART_0_INT_Flags_enum
+--| DESCRIPTION: UART 0 IMSC, RIS, MIS and ICR register flags
+*/
+typedef enum UART_0_INT_Flags_Enumeration
+{
+    UART_0_INT_OE_FLAG   = (1u << 10u), // Overrun error
+    UART_0_INT_BE_FLAG   = (1u << 9u),  // Break error
+    UART_0_INT_PE_FLAG   = (1u << 8u),  // Parity error
+    UART_0_INT_FE_FLAG   = (1u << 7u),  // Framing error
+    UART_0_INT_RT_FLAG   = (1u << 6u),  // Receive timeout
+    UART_0_INT_TX_FLAG   = (1u << 5u),  // Transmit
+    UART_0_INT_RX_FLAG   = (1u << 4u),  // Receive
+    UART_0_INT_CTSM_FLAG = (1u << 1u),  // nUARTCTS modem
+    UART_0_INT_ALL_FLAGS = 0x7F2u,      // every interrupt
+} UART_0_INT_Flags_enum;
+
+/*
+--| NAME: UART_0_DMACR_Flags_enum
+--| DESCRIPTION: UART 0 DMACR register flags
+*/
+typedef enum UART_0_DMACR_Flags_Enumeration
+{
+    UART_0_DMACR_DMAONERR_FLAG = (1u << 2u), // stop Rx DMA requests on a receive error [rw]
+    UART_0_DMACR_TXDMAE_FLAG   = (1u << 1u), // Tx DMA enable [rw]
+    UART_0_DMACR_RXDMAE_FLAG   = (1u << 0u), // Rx DMA enable [rw]
+} UART_0_DMACR_Flags_enum;
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE CONSTANTS
+--|----------------------------------------------------------------------------|
+*/
+
+/* None */
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE VARIABLES
+--|----------------------------------------------------------------------------|
+*/
+
+/*
+--| NAME: dma_<tx/rx>_channel
+--| DESCRIPTION: the DMA channels feeding the Tx FIFO and draining the Rx FIFO
+--| TYPE: uint32_t
+*/
+static uint32_t dma_tx_channel = PSP_DMA_NO_CHANNEL;
+static uint32_t dma_rx_channel = PSP_DMA_NO_CHANNEL;
+
+/*
+--| NAME: dma_tx_control_blocks
+--| DESCRIPTION: one control block per Tx words buffer
+--| TYPE: PSP_DMA_Control_Block_t[]
+*/
+static PSP_DMA_Control_Block_t dma_tx_control_blocks[DMA_NUM_TX_BUFFERS];
+
+/*
+--| NAME: dma_rx_control_block
+--| DESCRIPTION: the Rx control block, it links back to itself so the Rx DMA
+--|   never stops
+--| TYPE: PSP_DMA_Control_Block_t
+*/
+static PSP_DMA_Control_Block_t dma_rx_control_block;
+
+/*
+--| NAME: dma_tx_words
+--| DESCRIPTION: the bytes to send spread out one per word, the DMA writes
+--|   whole words to DR
+--| TYPE: uint32_t[][]
+*/
+static uint32_t dma_tx_words[DMA_NUM_TX_BUFFERS][PSP_UART0_DMA_MAX_TRANSFER_LENGTH];
+
+/*
+--| NAME: dma_next_tx_buffer
+--| DESCRIPTION: the Tx words buffer the next write fills
+--| TYPE: uint32_t
+*/
+static uint32_t dma_next_tx_buffer = 0u;
+
+/*
+--| NAME: dma_rx_words
+--| DESCRIPTION: ring buffer the Rx DMA writes DR into, one word per byte,
+--|   cache line aligned so invalidating it never touches anything else
+--| TYPE: uint32_t[]
+*/
+static uint32_t dma_rx_words[PSP_UART0_DMA_RX_BUFFER_LENGTH] __attribute__((aligned(64)));
+
+/*
+--| NAME: dma_rx_tail
+--| DESCRIPTION: the next word of dma_rx_words to read
+--| TYPE: uint32_t
+*/
+static uint32_t dma_rx_tail = 0u;
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE HELPER FUNCTION PROTOTYPES
+--|----------------------------------------------------------------------------|
+*/
+
+/*------------------------------------------------------------------------------
+Function Name:
+    UART0_DMA_Rx_Head
+
+Function Description:
+    Find the word of the Rx ring buffer the Rx DMA writes next.
+
+Parameters:
+    None
+
+Returns:
+    uint32_t: index into dma_rx_words.
+
+Assumptions/Limitations:
+    None
+------------------------------------------------------------------------------*/
+uint32_t UART0_DMA_Rx_Head(void);
+
+/*
+--|----------------------------------------------------------------------------|
+--| PUBLIC FUNCTION DEFINITIONS
+--|----------------------------------------------------------------------------|
+*/
+
+uint32_t PSP_UART0_Init(uint32_t baud_rate, uint32_t flow_control)
+{
+    uint32_t retval = 0u;
+
+    // disable the UART while it is set up
+    UART_0->CR = 0u;
+
+    PSP_GPIO_Set_Pin_Mode(PSP_UART_0_TX_PIN, PSP_GPIO_PINMODE_ALT0);
+    PSP_GPIO_Set_Pin_Mode(PSP_UART_0_RX_PIN, PSP_GPIO_PINMODE_ALT0);
+
+    if (flow_control)
+    {
+        PSP_GPIO_Set_Pin_Mode(PSP_UART_0_CTS_PIN, PSP_GPIO_PINMODE_ALT3);
+        PSP_GPIO_Set_Pin_Mode(PSP_UART_0_RTS_PIN, PSP_GPIO_PINMODE_ALT3);
+    }
+
+    // no interrupts, and none left pending
+    UART_0->IMSC = 0u;
+    UART_0->ICR = UART_0_INT_ALL_FLAGS;
+    UART_0->DMACR = 0u;
+
+    PSP_UART0_Set_FIFO_Levels(PSP_UART0_FIFO_LEVEL_1_2, PSP_UART0_FIFO_LEVEL_1_2);
+
+    if (PSP_UART0_Set_Baud_Rate(baud_rate))
+    {
+        UART_0->CR = UART_0_CR_UARTEN_FLAG |
+                     UART_0_CR_TXE_FLAG |
+                     UART_0_CR_RXE_FLAG |
+                     (flow_control ? (UART_0_CR_CTSEN_FLAG | UART_0_CR_RTSEN_FLAG) : 0u);
+
+        retval = 1u;
+    }
+
+    return retval;
+}
+
+uint32_t PSP_UART0_Set_Baud_Rate(uint32_t baud_rate)
+{
+    uint32_t retval = 0u;
+
+    if (baud_rate)
+    {
+        // clock / (16 * baud) in 64ths, rounded to nearest
+        const uint64_t divisor = (4ull * PSP_UART0_CLOCK_HZ + (baud_rate / 2u)) / baud_rate;
+
+        if ((UART_0_MIN_DIVISOR <= divisor) && (divisor <= UART_0_MAX_DIVISOR))
+        {
+            const uint32_t control = UART_0->CR;
+
+            // stop the UART, once the byte being sent is out
+            UART_0->CR = 0u;
+
+            while (UART_0->FR & UART_0_FR_BUSY_FLAG)
+            {
+                // wait for the last byte to go out
+            }
+
+            // clearing FEN empties the FIFOs
+            UART_0->LCRH = 0u;
+
+            UART_0->IBRD = (uint32_t)(divisor >> 6u);
+            UART_0->FBRD = (uint32_t)(divisor & 0x3Fu);
+
+            // the divisors only take effect on a write to LCRH
+            UART_0->LCRH = (UART_0_LCRH_WLEN_8_BITS << UART_0_LCRH_WLEN_SHIFT_AMT) | UART_0_LCRH_FEN_FLAG;
+
+            UART_0->CR = control;
+
+            retval = 1u;
+        }
+    }
+
+    return retval;
+}
+
+void PSP_UART0_Set_FIFO_Levels(PSP_UART0_FIFO_Level_t tx_level, PSP_UART0_FIFO_Level_t rx_level)
+{
+    UART_0->IFLS = (rx_level << UART_0_IFLS_RXIFLSEL_SHIFT_AMT) |
+                   (tx_level << UART_0_IFLS_TXIFLSEL_SHIFT_AMT);
+}
+
+void PSP_UART0_Send_Byte(uint8_t value)
+{
+    while (UART_0->FR & UART_0_FR_TXFF_FLAG)
+    {
+        // wait for room in the Tx FIFO
+    }
+
+    UART_0->DR = value;
+}
+
+void PSP_UART0_Send_String(char * c_string)
+{
+    for (uint32_t i = 0u; c_string[i] != '\0'; i++)
+    {
+        PSP_UART0_Send_Byte(c_string[i]);
+    }
+}
+
+uint32_t PSP_UART0_Receive_Byte(uint8_t * p_value)
+{
+    uint32_t retval = 0u;
+
+    if (!(UART_0->FR & UART_0_FR_RXFE_FLAG))
+    {
+        *p_value = UART_0->DR & UART_0_DR_DATA_MASK;
+        retval = 1u;
+    }
+
+    return retval;
+}
+
+uint32_t PSP_UART0_DMA_Init(void)
+{
+    if (dma_tx_channel == PSP_DMA_NO_CHANNEL)
+    {
+        dma_tx_channel = PSP_DMA_Channel_Allocate();
+    }
+
+    if (dma_rx_channel == PSP_DMA_NO_CHANNEL)
+    {
+        dma_rx_channel = PSP_DMA_Channel_Allocate();
+    }
+
+    const uint32_t channels_ready = (dma_tx_channel != PSP_DMA_NO_CHANNEL) &&
+                                    (dma_rx_channel != PSP_DMA_NO_CHANNEL);
+
+    if (channels_ready)
+    {
+        const uint32_t dr_bus_address = PSP_DMA_Peripheral_Bus_Address(UART_0_DR_ADDRESS);
+
+        // write responses make DEST_AD trail the data actually in memory
+        PSP_DMA_Set_Control_Block(&dma_rx_control_block,
+                                  PSP_DMA_TI_SRC_DREQ_FLAG |
+                                  PSP_DMA_TI_DEST_INC_FLAG |
+                                  PSP_DMA_TI_WAIT_RESP_FLAG |
+                                  (PSP_DMA_PERIPHERAL_UART_RX << PSP_DMA_TI_PERMAP_SHIFT_AMT),
+                                  dr_bus_address,
+                                  PSP_DMA_Bus_Address(dma_rx_words),
+                                  sizeof(dma_rx_words));
+
+        // wrap around to the start of the ring buffer forever
+        PSP_DMA_Link_Control_Blocks(&dma_rx_control_block, 1u, 1u);
+
+        dma_rx_tail = 0u;
+        dma_next_tx_buffer = 0u;
+
+        PSP_MMU_Clean_Data_Cache(&dma_rx_control_block, sizeof(dma_rx_control_block));
+        PSP_MMU_Clean_And_Invalidate_Data_Cache(dma_rx_words, sizeof(dma_rx_words));
+
+        UART_0->DMACR = UART_0_DMACR_TXDMAE_FLAG | UART_0_DMACR_RXDMAE_FLAG;
+
+        PSP_DMA_Start(dma_rx_channel, &dma_rx_control_block);
+    }
+
+    return channels_ready;
+}
+
+uint32_t PSP_UART0_DMA_Write(const uint8_t * p_buffer, uint32_t length)
+{
+    uint32_t retval = 0u;
+
+    if ((dma_tx_channel != PSP_DMA_NO_CHANNEL) && (0u < length) && (length <= PSP_UART0_DMA_MAX_TRANSFER_LENGTH))
+    {
+        // the other buffer may still be going out, this one finished before it started
+        uint32_t * p_words = dma_tx_words[dma_next_tx_buffer];
+        PSP_DMA_Control_Block_t * p_control_block = &dma_tx_control_blocks[dma_next_tx_buffer];
+
+        for (uint32_t i = 0u; i < length; i++)
+        {
+            p_words[i] = p_buffer[i];
+        }
+
+        PSP_DMA_Set_Control_Block(p_control_block,
+                                  PSP_DMA_TI_DEST_DREQ_FLAG |
+                                  PSP_DMA_TI_SRC_INC_FLAG |
+                                  PSP_DMA_TI_WAIT_RESP_FLAG |
+                                  (PSP_DMA_PERIPHERAL_UART_TX << PSP_DMA_TI_PERMAP_SHIFT_AMT),
+                                  PSP_DMA_Bus_Address(p_words),
+                                  PSP_DMA_Peripheral_Bus_Address(UART_0_DR_ADDRESS),
+                                  length * sizeof(uint32_t));
+
+        // the DMA engine doesn't see the data cache, everything it reads has to be in memory
+        PSP_MMU_Clean_Data_Cache(p_control_block, sizeof(PSP_DMA_Control_Block_t));
+        PSP_MMU_Clean_Data_Cache(p_words, length * sizeof(uint32_t));
+
+        PSP_UART0_DMA_Tx_Wait();
+
+        PSP_DMA_Start(dma_tx_channel, p_control_block);
+
+        dma_next_tx_buffer = (dma_next_tx_buffer + 1u) % DMA_NUM_TX_BUFFERS;
+
+        retval = 1u;
+    }
+
+    return retval;
+}
+
+uint32_t PSP_UART0_DMA_Tx_Is_Busy(void)
+{
+    return PSP_DMA_Is_Busy(dma_tx_channel);
+}
+
+void PSP_UART0_DMA_Tx_Wait(void)
+{
+    while (PSP_UART0_DMA_Tx_Is_Busy())
+    {
+        // wait for the Tx channel to finish
+    }
+}
+
+uint32_t PSP_UART0_DMA_Read(uint8_t * p_buffer, uint32_t length)
+{
+    uint32_t num_taken = 0u;
+
+    if (dma_rx_channel != PSP_DMA_NO_CHANNEL)
+    {
+        const uint32_t head = UART0_DMA_Rx_Head();
+
+        // drop anything the CPU fetched into the cache before the DMA wrote it
+        if (head >= dma_rx_tail)
+        {
+            PSP_MMU_Invalidate_Data_Cache(&dma_rx_words[dma_rx_tail], (head - dma_rx_tail) * sizeof(uint32_t));
+        }
+        else
+        {
+            PSP_MMU_Invalidate_Data_Cache(&dma_rx_words[dma_rx_tail],
+                                          (PSP_UART0_DMA_RX_BUFFER_LENGTH - dma_rx_tail) * sizeof(uint32_t));
+            PSP_MMU_Invalidate_Data_Cache(dma_rx_words, head * sizeof(uint32_t));
+        }
+
+        while ((num_taken < length) && (dma_rx_tail != head))
+        {
+            p_buffer[num_taken] = dma_rx_words[dma_rx_tail] & UART_0_DR_DATA_MASK;
+            num_taken++;
+
+            dma_rx_tail = (dma_rx_tail + 1u) % PSP_UART0_DMA_RX_BUFFER_LENGTH;
+        }
+    }
+
+    return num_taken;
+}
+
+/*
+--|----------------------------------------------------------------------------|
+--| PRIVATE HELPER FUNCTION DEFINITIONS
+--|----------------------------------------------------------------------------|
+*/
+
+uint32_t UART0_DMA_Rx_Head(void)
+{
+    const uint32_t offset = PSP_DMA_Get_Dest_Address(dma_rx_channel) - PSP_DMA_Bus_Address(dma_rx_words);
+
+    uint32_t head = offset / sizeof(uint32_t);
+
+    // DEST_AD sits one past the end until the control block reloads
+    if (head >= PSP_UART0_DMA_RX_BUFFER_LENGTH)
+    {
+        head = 0u;
+    }
+
+    return head;
+}
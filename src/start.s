@@ -4,19 +4,176 @@
  *      main c function.
  * 
  * NOTES:
- *      None.
+ *      The firmware starts the kernel in HYP mode. HYP mode uses its own MMU
+ *      and cache controls, so the start routine drops to SVC mode first.
+ *
+ *      When built with PSP_MMU_ENABLE defined (MMU = 1 in the Makefile) the
+ *      MMU, caches and branch prediction are turned on before main.
+ *
+ *      The code is built for the hard-float ABI, so every core turns on the
+ *      FPU and NEON before it runs any C code. The IRQ handler saves the VFP
+ *      registers the C code may use, along with FPSCR.
+ *
+ *      Core 0 zeroes .bss before any C code runs, and calls the constructors
+ *      in .init_array (__attribute__((constructor))) just before main, once
+ *      the MMU and caches are on. .data needs no copying, the firmware loads
+ *      the whole image where it was linked to run.
+ *
+ *      The vector table is installed on each core as it starts. IRQs are
+ *      handled on the SVC stack of the interrupted core and passed to
+ *      PSP_IRQ_Dispatch. Any other exception hangs the core.
+ *
+ *      Only core 0 runs _start, any other core that gets here is parked. Cores
+ *      1 to 3 are released into _secondary_start by PSP_Core_Start, which
+ *      fills in core_stack_tops and core_entries first.
  * 
  * REFERENCES:
- *      None
+ *      ARM Architecture Reference Manual ARMv7-A, B9.1 (HYP mode)
+ *      ARM Architecture Reference Manual ARMv7-A, B1.11.2 (enabling the FPU)
  */
 
 .section ".text.boot"
 
 .global _start
+.global _secondary_start
+
+// drop from HYP mode to SVC mode with IRQ and FIQ masked, then point VBAR at the vector table
+.macro LEAVE_HYP_MODE_AND_SET_VECTORS
+mrs     r0,     cpsr
+and     r1,     r0,     #0x1F
+cmp     r1,     #0x1A
+bne     1f
+
+bic     r0,     r0,     #0x1F
+orr     r0,     r0,     #0xD3
+msr     spsr_hyp,       r0
+adr     r0,     1f
+msr     elr_hyp,        r0
+eret
+1:
+ldr     r0,     =vector_table
+mcr     p15,    0,      r0,     c12,    c0,     0
+.endm
+
+// give SVC mode full access to CP10 and CP11, then set FPEXC.EN
+.macro ENABLE_FPU_AND_NEON
+mrc     p15,    0,      r0,     c1,     c0,     2
+orr     r0,     r0,     #(0xF << 20)
+mcr     p15,    0,      r0,     c1,     c0,     2
+isb
+mov     r0,     #0x40000000
+vmsr    fpexc,  r0
+.endm
 
 _start:
-mov     sp,     #0x8000
+// only core 0 boots
+mrc     p15,    0,      r0,     c0,     c0,     5
+ands    r0,     r0,     #0x3
+bne     park_loop
+
+LEAVE_HYP_MODE_AND_SET_VECTORS
+ENABLE_FPU_AND_NEON
+
+ldr     sp,     =__core0_stack_top
+
+// zero .bss 32 bytes at a time, linker.ld aligns both ends to 32 bytes
+ldr     r0,     =__bss_start
+ldr     r1,     =__bss_end
+vmov.i8 q0,     #0
+vmov.i8 q1,     #0
+bss_loop:
+cmp     r0,     r1
+bhs     bss_done
+vst1.64 {d0-d3},        [r0:128]!
+b       bss_loop
+bss_done:
+
+#ifdef PSP_MMU_ENABLE
+bl      PSP_MMU_Init
+#endif
+
+// call the constructors, r4 and r5 survive the calls
+ldr     r4,     =__init_array_start
+ldr     r5,     =__init_array_end
+init_array_loop:
+cmp     r4,     r5
+bhs     init_array_done
+ldr     r0,     [r4],   #4
+blx     r0
+b       init_array_loop
+init_array_done:
+
 bl      main
 
 empty_loop:
 b empty_loop
+
+_secondary_start:
+LEAVE_HYP_MODE_AND_SET_VECTORS
+ENABLE_FPU_AND_NEON
+
+// r4 = core id, survives the calls below
+mrc     p15,    0,      r4,     c0,     c0,     5
+and     r4,     r4,     #0x3
+
+ldr     r0,     =core_stack_tops
+ldr     sp,     [r0,    r4,     lsl #2]
+
+#ifdef PSP_MMU_ENABLE
+bl      PSP_MMU_Init_Secondary_Core
+#endif
+
+ldr     r0,     =core_entries
+ldr     r0,     [r0,    r4,     lsl #2]
+blx     r0
+
+// the entry function returned, nothing left to do on this core
+park_loop:
+wfe
+b park_loop
+
+// VBAR needs the table 32 byte aligned
+.balign 32
+vector_table:
+b       _start                  // reset
+b       unhandled_exception     // undefined instruction
+b       unhandled_exception     // supervisor call
+b       unhandled_exception     // prefetch abort
+b       unhandled_exception     // data abort
+b       unhandled_exception     // not used
+b       irq_handler             // IRQ
+b       unhandled_exception     // FIQ
+
+irq_handler:
+// save the return address and SPSR on the SVC stack, then handle the IRQ in SVC mode
+sub     lr,     lr,     #4
+srsdb   sp!,    #0x13
+cps     #0x13
+push    {r0-r3, r12, lr}
+
+// the caller saved VFP registers and FPSCR, r1 keeps the stack 8 byte aligned
+vpush   {d0-d7}
+vpush   {d16-d31}
+vmrs    r0,     fpscr
+push    {r0, r1}
+
+// the C code needs an 8 byte aligned stack
+and     r1,     sp,     #4
+sub     sp,     sp,     r1
+push    {r1, r2}
+
+bl      PSP_IRQ_Dispatch
+
+pop     {r1, r2}
+add     sp,     sp,     r1
+
+pop     {r0, r1}
+vmsr    fpscr,  r0
+vpop    {d16-d31}
+vpop    {d0-d7}
+
+pop     {r0-r3, r12, lr}
+rfeia   sp!
+
+unhandled_exception:
+b unhandled_exception